@@ -182,7 +182,7 @@ Result<void> EditorAssetManager::AddAlwaysLoadImages() {
             }
             auto image = *res;
             m_images[file_name.string()] = image;
-            m_app->GetGraphicsManager()->RequestTexture(image.get());
+            m_app->GetGraphicsManager()->RequestTexture(image);
         }
     }
 
@@ -123,6 +123,19 @@ void RenderGraphViewer::UpdateInternal() {
 
     const auto graph = graphics_manager->GetActiveRenderGraph();
 
+    constexpr float MB = 1024.0f * 1024.0f;
+    const RenderGraphMemoryStats& stats = graph->GetMemoryStats();
+    ImGui::Text("resources: %u in %u textures, %.1f MB (%.1f MB without aliasing, %.1f MB peak live)",
+                stats.resourceCount,
+                stats.textureCount,
+                stats.allocatedBytes / MB,
+                stats.dedicatedBytes / MB,
+                stats.peakLiveBytes / MB);
+    ImGui::Text("passes: %d, culled: %d, levels: %d",
+                static_cast<int>(graph->GetRenderPasses().size()),
+                static_cast<int>(graph->GetCulledPasses().size()),
+                static_cast<int>(graph->GetLevels().size()));
+
     ImNodes::BeginNodeEditor();
 
     DrawNodes(*graph);
@@ -9,6 +9,8 @@
 #include "engine/renderer/path_tracer_render_system.h"
 #include "engine/runtime/application.h"
 #include "engine/runtime/common_dvars.h"
+#include "engine/runtime/render_system.h"
+#include "engine/runtime/scene_manager_interface.h"
 #include "engine/scene/scene.h"
 
 #include "editor/editor_dvars.h"
@@ -40,6 +42,12 @@ void RendererPanel::UpdateInternal() {
     ImGui::Text("Frame rate:%.2f", ImGui::GetIO().Framerate);
     ImGui::Checkbox("show editor", (bool*)DVAR_GET_POINTER(show_editor));
 
+    // the renderer keeps the culling and LOD stats per scene
+    auto find_scene_state = [&]() -> const SceneRenderState* {
+        Application* app = m_editor.GetApplication();
+        return app->GetRenderSystem()->FindSceneRenderState(app->GetSceneManager()->GetActiveScene());
+    };
+
     CollapseWindow("Shadow", []() {
         ImGui::Checkbox("debug", (bool*)DVAR_GET_POINTER(gfx_debug_shadow));
     });
@@ -58,6 +66,118 @@ void RendererPanel::UpdateInternal() {
         ImGui::DragFloat("kernel radius", (float*)DVAR_GET_POINTER(gfx_ssao_radius), 0.01f, 0.0f, 5.0f);
     });
 
+    CollapseWindow("Animation", [&]() {
+        Scene* scene = m_editor.GetApplication()->GetSceneManager()->GetActiveScene().get();
+        if (!scene) {
+            return;
+        }
+
+        AnimationLodSettings& settings = scene->m_animationLod;
+        ImGui::Checkbox("LOD", &settings.enabled);
+        ImGui::DragFloat3("screen size", settings.screen_size_thresholds, 0.001f, 0.0f, 1.0f);
+
+        const AnimationLodStats& stats = scene->m_animationLodStats;
+        ImGui::Text("skeletons: %u", stats.skeleton_count);
+        ImGui::Text("evaluated: %u", stats.evaluated_count);
+        ImGui::Text("interpolated: %u", stats.interpolated_count);
+        ImGui::Text("off-screen: %u", stats.offscreen_count);
+    });
+
+    CollapseWindow("Occlusion Culling", [&]() {
+        ImGui::Checkbox("enable", (bool*)DVAR_GET_POINTER(gfx_occlusion_culling));
+        const SceneRenderState* state = find_scene_state();
+        if (!state) {
+            return;
+        }
+
+        const OcclusionCuller::Stats& stats = state->occlusion_culler.GetStats();
+        ImGui::Text("occluders: %u", stats.occluder_count);
+        ImGui::Text("triangles: %u / %u", stats.triangle_count, state->occlusion_culler.GetTriangleBudget());
+        ImGui::Text("tested: %u", stats.tested_count);
+        ImGui::Text("culled: %u", stats.culled_count);
+    });
+
+    CollapseWindow("Clustered Lighting", [&]() {
+        ImGui::Checkbox("enable", (bool*)DVAR_GET_POINTER(gfx_clustered_lighting));
+        const SceneRenderState* state = find_scene_state();
+        if (!state) {
+            return;
+        }
+
+        const LightClusterBuilder::Stats& stats = state->light_clusters.GetStats();
+        ImGui::Text("point lights: %u / %u", stats.light_count, MAX_CLUSTERED_LIGHT_COUNT);
+        ImGui::Text("visible: %u", stats.visible_light_count);
+        ImGui::Text("indices: %u / %u", stats.index_count, MAX_LIGHT_INDEX_COUNT);
+        ImGui::Text("max per cluster: %u", stats.max_cluster_light_count);
+        ImGui::Text("dropped: %u", stats.overflow_count);
+    });
+
+    CollapseWindow("Mesh LOD", [&]() {
+        ImGui::Checkbox("enable", (bool*)DVAR_GET_POINTER(gfx_mesh_lod));
+        ImGui::DragFloat("pixel error", (float*)DVAR_GET_POINTER(gfx_mesh_lod_pixel_error), 0.05f, 0.1f, 16.0f);
+        ImGui::DragFloat("shadow bias", (float*)DVAR_GET_POINTER(gfx_shadow_lod_bias), 0.05f, 1.0f, 16.0f);
+        const SceneRenderState* state = find_scene_state();
+        if (!state) {
+            return;
+        }
+
+        const MeshLodStats& stats = state->mesh_lod_stats;
+        ImGui::Text("meshes: %u", stats.mesh_count);
+        ImGui::Text("triangles: %u / %u", stats.drawn_triangle_count, stats.full_triangle_count);
+        for (int level = 0; level <= MeshAsset::MAX_LOD_COUNT; ++level) {
+            ImGui::Text("level %d: %u", level, stats.level_counts[level]);
+        }
+    });
+
+    CollapseWindow("Frame Memory", [&]() {
+        const FrameData* framedata = m_editor.GetApplication()->GetRenderSystem()->GetFrameData();
+        if (!framedata) {
+            return;
+        }
+
+        constexpr float MB = 1024.0f * 1024.0f;
+        const FrameData::ArenaStats stats = framedata->GetArenaStats();
+        ImGui::Text("arena: %.2f MB", stats.capacity / MB);
+        ImGui::Text("last frame: %.2f MB", stats.lastFrameUsed / MB);
+        ImGui::Text("high water: %.2f MB", stats.highWaterMark / MB);
+        // allocations that fell back to the heap, the arena is too small
+        ImGui::Text("overflows: %u", stats.overflowCount);
+        // palettes of skeletons that changed and instance matrices
+        ImGui::Text("bone upload: %.1f KB", framedata->GetBoneUploadBytes() / 1024.0f);
+        // transient batches and the scene batches that changed
+        ImGui::Text("batch upload: %.1f KB", framedata->GetBatchUploadBytes() / 1024.0f);
+        // material constants no frame context has yet
+        ImGui::Text("material upload: %.1f KB", framedata->GetMaterialUploadBytes() / 1024.0f);
+    });
+
+    CollapseWindow("State Cache", [&]() {
+        auto gm = dynamic_cast<GraphicsManager*>(m_editor.GetApplication()->GetGraphicsManager());
+        if (!gm) {
+            return;
+        }
+
+        // calls that reached the backend / calls dropped as redundant, last frame
+        const RenderStateCache::Stats& stats = gm->GetRenderStateStats();
+        ImGui::Text("mesh: %u / %u", stats.mesh.issued, stats.mesh.filtered);
+        ImGui::Text("texture: %u / %u", stats.texture.issued, stats.texture.filtered);
+        ImGui::Text("constant buffer: %u / %u", stats.constant_buffer.issued, stats.constant_buffer.filtered);
+        ImGui::Text("pipeline: %u / %u", stats.pipeline_state.issued, stats.pipeline_state.filtered);
+    });
+
+    CollapseWindow("Uploads", [&]() {
+        ImGui::DragInt("budget (KB)", (int*)DVAR_GET_POINTER(gfx_upload_budget_kb), 64.0f, 0, 256 * 1024);
+        ImGui::DragFloat("budget (ms)", (float*)DVAR_GET_POINTER(gfx_upload_budget_ms), 0.1f, 0.0f, 33.0f);
+        auto gm = dynamic_cast<GraphicsManager*>(m_editor.GetApplication()->GetGraphicsManager());
+        if (!gm) {
+            return;
+        }
+
+        constexpr float MB = 1024.0f * 1024.0f;
+        const UploadQueue::Stats& stats = gm->GetUploadStats();
+        ImGui::Text("pending: %u (%.2f MB)", stats.pending_count, stats.pending_bytes / MB);
+        ImGui::Text("last batch: %u (%.2f MB, %.2f ms)", stats.uploaded_count, stats.uploaded_bytes / MB, stats.milliseconds);
+    });
+
     CollapseWindow("Path Tracer", [&]() {
         auto& gm = *m_editor.GetApplication()->GetGraphicsManager();
         int selected = (int)gm.GetActiveRenderGraphName();
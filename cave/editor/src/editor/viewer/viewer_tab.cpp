@@ -93,7 +93,8 @@ void ViewerTab::DrawMainView(const CameraComponent&) {
             ImGui::GetWindowDrawList()->AddImage((ImTextureID)handle, top_left, bottom_right, uv_min, uv_max);
         } break;
         case Backend::VULKAN:
-        case Backend::METAL: {
+        case Backend::METAL:
+        case Backend::SOFTWARE: {
         } break;
         default:
             CRASH_NOW();
@@ -37,4 +37,61 @@ Option<std::vector<int>> TopologicalSort(int N, const std::vector<TopoSortEdge>&
     return Some(sorted);
 }
 
+void RadixSortIndices(const uint64_t* p_keys, std::vector<uint32_t>& p_order, std::vector<uint32_t>& p_scratch) {
+    p_scratch.resize(p_order.size());
+    RadixSortIndices(p_keys, p_order.data(), p_scratch.data(), p_order.size());
+}
+
+void RadixSortIndices(const uint64_t* p_keys, uint32_t* p_order, uint32_t* p_scratch, size_t p_count) {
+    constexpr int RADIX_BITS = 8;
+    constexpr int BUCKET_COUNT = 1 << RADIX_BITS;
+    constexpr int PASS_COUNT = 64 / RADIX_BITS;
+
+    const size_t count = p_count;
+    if (count < 2) {
+        return;
+    }
+
+    // build every histogram in a single read of the keys
+    uint32_t histograms[PASS_COUNT][BUCKET_COUNT] = {};
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = p_keys[p_order[i]];
+        for (int pass = 0; pass < PASS_COUNT; ++pass) {
+            ++histograms[pass][key & (BUCKET_COUNT - 1)];
+            key >>= RADIX_BITS;
+        }
+    }
+
+    uint32_t* src = p_order;
+    uint32_t* dst = p_scratch;
+    for (int pass = 0; pass < PASS_COUNT; ++pass) {
+        uint32_t* histogram = histograms[pass];
+        const int shift = pass * RADIX_BITS;
+
+        const uint32_t first_bucket = (p_keys[src[0]] >> shift) & (BUCKET_COUNT - 1);
+        if (histogram[first_bucket] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+            const uint32_t bucket_size = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucket_size;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t index = src[i];
+            const uint32_t bucket = (p_keys[index] >> shift) & (BUCKET_COUNT - 1);
+            dst[histogram[bucket]++] = index;
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != p_order) {
+        std::copy(src, src + count, p_order);
+    }
+}
+
 }  // namespace cave
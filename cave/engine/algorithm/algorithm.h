@@ -6,4 +6,11 @@ using TopoSortEdge = std::pair<int, int>;
 
 Option<std::vector<int>> TopologicalSort(int N, const std::vector<TopoSortEdge>& p_edges);
 
+// Stable LSD radix sort of p_order (indices into p_keys) by key, one byte per pass. Passes where
+// every key has the same byte are skipped, so keys that only use a few bits sort in a few passes.
+// p_scratch is resized to p_order.size() and can be reused across calls to avoid allocations.
+void RadixSortIndices(const uint64_t* p_keys, std::vector<uint32_t>& p_order, std::vector<uint32_t>& p_scratch);
+// same as above on raw arrays, p_scratch must hold p_count indices
+void RadixSortIndices(const uint64_t* p_keys, uint32_t* p_order, uint32_t* p_scratch, size_t p_count);
+
 }  // namespace cave
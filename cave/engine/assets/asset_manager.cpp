@@ -222,11 +222,11 @@ AssetRef AssetManager::LoadAssetSync(const Guid& p_guid) {
     switch (asset->GetType()) {
         case AssetType::Image: {
             auto image = std::dynamic_pointer_cast<ImageAsset>(asset);
-            m_app->GetGraphicsManager()->RequestTexture(image.get());
+            m_app->GetGraphicsManager()->RequestTexture(image);
         } break;
         case AssetType::Mesh: {
             auto mesh = std::dynamic_pointer_cast<MeshAsset>(asset);
-            m_app->GetGraphicsManager()->RequestMesh(mesh.get());
+            m_app->GetGraphicsManager()->RequestMesh(mesh);
         } break;
         default:
             break;
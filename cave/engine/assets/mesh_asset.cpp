@@ -1,12 +1,19 @@
 #include "mesh_asset.h"
 
 #include "engine/assets/material_asset.h"
+#include "engine/assets/mesh_simplifier.h"
 #include "engine/core/io/archive.h"
-#include "engine/renderer/graphics_manager.h"
 #include "engine/runtime/asset_registry.h"
 
 namespace cave {
 
+// smaller meshes are drawn at full detail
+static constexpr uint32_t MIN_LOD_SOURCE_INDEX_COUNT = 3 * 256;
+// a level drops at least a quarter of the triangles of the one before, or it isn't worth a draw
+static constexpr uint32_t MAX_LOD_INDEX_PERCENT = 75;
+// largest error of a level, relative to the bounding radius
+static constexpr float MAX_LOD_ERROR = 0.1f;
+
 template<typename T>
 static void InitVertexAttrib(MeshAsset::VertexAttribute& p_attrib, const std::vector<T>& p_buffer) {
     p_attrib.offsetInByte = 0;
@@ -42,9 +49,70 @@ void MeshAsset::CreateRenderData() {
     return;
 }
 
-void MeshAsset::SerializeBinary(Archive& p_archive, uint32_t p_version) {
-    unused(p_version);
+void MeshAsset::GenerateLods() {
+    lods.clear();
+    lod_subsets.clear();
+    lod_indices.clear();
+    if ((flags & DYNAMIC) || positions.empty() || indices.size() < MIN_LOD_SOURCE_INDEX_COUNT) {
+        return;
+    }
+
+    AABB bound;
+    for (uint32_t index : indices) {
+        bound.ExpandPoint(positions[index]);
+    }
+    const float radius = 0.5f * length(bound.Size());
+    if (radius <= 0.0f) {
+        return;
+    }
 
+    // every level is simplified from the full mesh, errors don't add up across levels
+    const uint32_t base_offset = static_cast<uint32_t>(indices.size());
+    uint32_t previous_count = base_offset;
+    float previous_error = 0.0f;
+    for (int level = 1; level <= MAX_LOD_COUNT; ++level) {
+        MeshLod lod;
+        lod.index_offset = base_offset + static_cast<uint32_t>(lod_indices.size());
+        lod.error = previous_error;
+
+        const size_t level_begin = lod_indices.size();
+        for (const MeshSubset& subset : subsets) {
+            const uint32_t target = (subset.index_count >> level) / 3 * 3;
+            MeshSimplifier::Result result = MeshSimplifier::Simplify(positions,
+                                                                     std::span<const uint32_t>(indices).subspan(subset.index_offset, subset.index_count),
+                                                                     target,
+                                                                     MAX_LOD_ERROR * radius);
+
+            MeshSubset& lod_subset = lod_subsets.emplace_back(subset);
+            lod_subset.index_offset = base_offset + static_cast<uint32_t>(lod_indices.size());
+            lod_subset.index_count = static_cast<uint32_t>(result.indices.size());
+            lod_indices.insert(lod_indices.end(), result.indices.begin(), result.indices.end());
+            lod.error = glm::max(lod.error, result.error / radius);
+        }
+        lod.index_count = static_cast<uint32_t>(lod_indices.size() - level_begin);
+
+        // stalled on locked vertices or the error limit
+        if (lod.index_count * 100 > previous_count * MAX_LOD_INDEX_PERCENT) {
+            lod_indices.resize(level_begin);
+            lod_subsets.resize(lods.size() * subsets.size());
+            break;
+        }
+
+        lods.push_back(lod);
+        previous_count = lod.index_count;
+        previous_error = lod.error;
+    }
+}
+
+int MeshAsset::SelectLod(float p_max_error) const {
+    int lod = 0;
+    while (lod < static_cast<int>(lods.size()) && lods[lod].error <= p_max_error) {
+        ++lod;
+    }
+    return lod;
+}
+
+void MeshAsset::SerializeBinary(Archive& p_archive, uint32_t p_version) {
     size_t subset_count = subsets.size();
     p_archive.ArchiveValue(subset_count);
     p_archive.ArchiveValue(subsets);
@@ -58,15 +126,16 @@ void MeshAsset::SerializeBinary(Archive& p_archive, uint32_t p_version) {
     p_archive.ArchiveValue(joints_0);
     p_archive.ArchiveValue(weights_0);
     p_archive.ArchiveValue(color_0);
+    if (p_version >= 1) {
+        p_archive.ArchiveValue(lods);
+        p_archive.ArchiveValue(lod_subsets);
+        p_archive.ArchiveValue(lod_indices);
+    }
 }
 
+// the gpu mesh is requested by the asset manager once the load returns, the request owns the asset
 void MeshAsset::OnDeserialized() {
     CreateRenderData();
-
-    GraphicsManager* graphics_manager = GraphicsManager::GetSingletonPtr();
-    if (graphics_manager) {
-        graphics_manager->RequestMesh(this);
-    }
 }
 
 std::vector<Guid> MeshAsset::GetDependencies() const {
@@ -86,6 +155,8 @@ Result<void> MeshAsset::SaveToDisk(const AssetMetaData& p_meta) const {
 
     // the archive is write mode, so it's safe to const cast
     auto asset = const_cast<MeshAsset&>(*this);
+    archive.Write(ARCHIVE_MAGIC);
+    archive.Write(static_cast<uint32_t>(VERSION));
     asset.SerializeBinary(archive, VERSION);
     return Result<void>();
 }
@@ -96,7 +167,18 @@ Result<void> MeshAsset::LoadFromDisk(const AssetMetaData& p_meta) {
         return CAVE_ERROR(res.error());
     }
 
-    SerializeBinary(archive, VERSION);
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    if (archive.Read(magic) && magic == ARCHIVE_MAGIC) {
+        archive.Read(version);
+    } else {
+        archive.GetFileAccess()->Seek(0);
+    }
+    if (version > VERSION) {
+        return CAVE_ERROR(ErrorCode::ERR_FILE_CORRUPT, "mesh '{}' has version {}, newer than {}", p_meta.import_path, version, VERSION);
+    }
+
+    SerializeBinary(archive, version);
     OnDeserialized();
 
     return Result<void>();
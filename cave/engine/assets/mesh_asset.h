@@ -23,7 +23,7 @@ enum class VertexAttributeName : uint8_t {
 };
 
 class MeshAsset : public IAsset {
-    CAVE_ASSET(MeshAsset, AssetType::Mesh, 0)
+    CAVE_ASSET(MeshAsset, AssetType::Mesh, 1)
 
 public:
     enum : uint32_t {
@@ -58,6 +58,22 @@ public:
     };
     std::vector<MeshSubset> subsets;
 
+    struct MeshLod {
+        // the whole level, its subsets follow each other in the order of `subsets`
+        uint32_t index_offset = 0;
+        uint32_t index_count = 0;
+        // largest distance the simplified surface moved, over the bounding radius of the mesh
+        float error = 0.0f;
+    };
+    // Simplified levels after the full mesh, coarsest last. They index the same vertices, their
+    // indices follow `indices` in the gpu index buffer and the offsets count from there.
+    std::vector<MeshLod> lods;
+    // subsets.size() ranges per level
+    std::vector<MeshSubset> lod_subsets;
+    std::vector<uint32_t> lod_indices;
+
+    static constexpr int MAX_LOD_COUNT = 3;
+
     // Non-serialized
     mutable std::shared_ptr<GpuMesh> gpuResource;
     mutable std::shared_ptr<BvhAccel> bvh;
@@ -76,9 +92,37 @@ public:
 
     void CreateRenderData();
 
+    // Fills lods with up to MAX_LOD_COUNT levels, each about half the triangles of the one before.
+    void GenerateLods();
+
+    // Coarsest level whose error is within p_max_error, relative to the bounding radius. 0 is the
+    // full mesh, level i is lods[i - 1].
+    int SelectLod(float p_max_error) const;
+
+    const MeshSubset& GetSubset(int p_lod, size_t p_subset) const {
+        return p_lod ? lod_subsets[(p_lod - 1) * subsets.size() + p_subset] : subsets[p_subset];
+    }
+
+    uint32_t GetIndexOffset(int p_lod) const { return p_lod ? lods[p_lod - 1].index_offset : 0; }
+    uint32_t GetIndexCount(int p_lod) const {
+        return p_lod ? lods[p_lod - 1].index_count : static_cast<uint32_t>(indices.size());
+    }
+
+    // Archives start with ARCHIVE_MAGIC and their version since version 1. Older ones start with
+    // the subset count and are read as version 0.
+    static constexpr uint64_t ARCHIVE_MAGIC = 0x4853454d45564143;  // "CAVEMESH"
+
     void SerializeBinary(Archive& p_archive, uint32_t p_version);
 
     void OnDeserialized();
 };
 
+// triangles of the meshes drawn in the camera view, at full detail and at their selected level
+struct MeshLodStats {
+    uint32_t mesh_count = 0;
+    uint32_t full_triangle_count = 0;
+    uint32_t drawn_triangle_count = 0;
+    uint32_t level_counts[MeshAsset::MAX_LOD_COUNT + 1] = {};
+};
+
 }  // namespace cave
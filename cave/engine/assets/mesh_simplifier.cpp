@@ -0,0 +1,298 @@
+#include "mesh_simplifier.h"
+
+namespace cave {
+
+// Sum of squared distances to a set of planes, weighted by triangle area. Doubles, the terms of
+// large meshes far from the origin cancel out in floats.
+struct Quadric {
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0;
+    double a01 = 0.0, a02 = 0.0, a12 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;
+
+    void AddPlane(const Vector3f& p_normal, float p_distance, float p_weight) {
+        const double x = p_normal.x, y = p_normal.y, z = p_normal.z, d = p_distance, w = p_weight;
+        a00 += w * x * x;
+        a11 += w * y * y;
+        a22 += w * z * z;
+        a01 += w * x * y;
+        a02 += w * x * z;
+        a12 += w * y * z;
+        b0 += w * x * d;
+        b1 += w * y * d;
+        b2 += w * z * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    void Add(const Quadric& p_other) {
+        a00 += p_other.a00;
+        a11 += p_other.a11;
+        a22 += p_other.a22;
+        a01 += p_other.a01;
+        a02 += p_other.a02;
+        a12 += p_other.a12;
+        b0 += p_other.b0;
+        b1 += p_other.b1;
+        b2 += p_other.b2;
+        c += p_other.c;
+        weight += p_other.weight;
+    }
+
+    // mean squared distance of p_point to the planes
+    float Evaluate(const Vector3f& p_point) const {
+        const double x = p_point.x, y = p_point.y, z = p_point.z;
+        const double error = a00 * x * x + a11 * y * y + a22 * z * z +
+                             2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                             2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? static_cast<float>(glm::max(error, 0.0) / weight) : 0.0f;
+    }
+};
+
+// triangles may turn by about 75 degrees in one collapse, a flat sliver can't flip over in a few
+static constexpr float MIN_NORMAL_COSINE = 0.25f;
+
+struct Collapse {
+    float cost;
+    uint32_t from;
+    uint32_t to;
+};
+
+// triangles around every vertex, rebuilt every pass
+struct VertexFans {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+
+    void Build(uint32_t p_vertex_count, std::span<const uint32_t> p_indices) {
+        offsets.assign(p_vertex_count + 1, 0);
+        for (uint32_t index : p_indices) {
+            ++offsets[index + 1];
+        }
+        for (uint32_t i = 0; i < p_vertex_count; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        triangles.resize(p_indices.size());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (uint32_t i = 0; i < p_indices.size(); ++i) {
+            triangles[cursor[p_indices[i]]++] = i / 3;
+        }
+    }
+
+    std::span<const uint32_t> Get(uint32_t p_vertex) const {
+        return std::span<const uint32_t>(triangles).subspan(offsets[p_vertex], offsets[p_vertex + 1] - offsets[p_vertex]);
+    }
+};
+
+static bool IsDegenerate(const uint32_t* p_triangle) {
+    return p_triangle[0] == p_triangle[1] || p_triangle[1] == p_triangle[2] || p_triangle[0] == p_triangle[2];
+}
+
+// Open and non-manifold edges are used by one or more than two triangles. Seams count as open,
+// the triangles on either side index different vertices.
+static std::vector<bool> FindLockedVertices(uint32_t p_vertex_count, std::span<const uint32_t> p_indices) {
+    std::unordered_map<uint64_t, uint32_t> edge_counts;
+    edge_counts.reserve(p_indices.size());
+    for (size_t i = 0; i < p_indices.size(); i += 3) {
+        for (int corner = 0; corner < 3; ++corner) {
+            const uint32_t a = p_indices[i + corner];
+            const uint32_t b = p_indices[i + (corner + 1) % 3];
+            ++edge_counts[(uint64_t(glm::min(a, b)) << 32) | glm::max(a, b)];
+        }
+    }
+
+    std::vector<bool> locked(p_vertex_count, false);
+    for (auto [edge, count] : edge_counts) {
+        if (count != 2) {
+            locked[static_cast<uint32_t>(edge >> 32)] = true;
+            locked[static_cast<uint32_t>(edge)] = true;
+        }
+    }
+    return locked;
+}
+
+static void GatherNeighbours(const VertexFans& p_fans,
+                             std::span<const uint32_t> p_indices,
+                             uint32_t p_vertex,
+                             uint32_t p_exclude,
+                             std::vector<uint32_t>& p_out) {
+    p_out.clear();
+    for (uint32_t triangle : p_fans.Get(p_vertex)) {
+        for (int corner = 0; corner < 3; ++corner) {
+            const uint32_t other = p_indices[3 * triangle + corner];
+            if (other != p_vertex && other != p_exclude) {
+                p_out.push_back(other);
+            }
+        }
+    }
+    std::sort(p_out.begin(), p_out.end());
+    p_out.erase(std::unique(p_out.begin(), p_out.end()), p_out.end());
+}
+
+MeshSimplifier::Result MeshSimplifier::Simplify(std::span<const Vector3f> p_positions,
+                                                std::span<const uint32_t> p_indices,
+                                                uint32_t p_target_index_count,
+                                                float p_max_error) {
+    DEV_ASSERT(p_indices.size() % 3 == 0);
+    const uint32_t vertex_count = static_cast<uint32_t>(p_positions.size());
+
+    Result result;
+    for (size_t i = 0; i < p_indices.size(); i += 3) {
+        DEV_ASSERT(p_indices[i] < vertex_count && p_indices[i + 1] < vertex_count && p_indices[i + 2] < vertex_count);
+        if (!IsDegenerate(&p_indices[i])) {
+            result.indices.insert(result.indices.end(), &p_indices[i], &p_indices[i] + 3);
+        }
+    }
+    std::vector<uint32_t>& indices = result.indices;
+
+    const std::vector<bool> locked = FindLockedVertices(vertex_count, indices);
+
+    std::vector<Quadric> quadrics(vertex_count);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const Vector3f& a = p_positions[indices[i]];
+        const Vector3f& b = p_positions[indices[i + 1]];
+        const Vector3f& c = p_positions[indices[i + 2]];
+        const Vector3f normal = cross(b - a, c - a);
+        const float double_area = length(normal);
+        if (double_area <= 0.0f) {
+            continue;
+        }
+
+        const Vector3f unit_normal = normal / double_area;
+        const float distance = -dot(unit_normal, a);
+        for (int corner = 0; corner < 3; ++corner) {
+            quadrics[indices[i + corner]].AddPlane(unit_normal, distance, 0.5f * double_area);
+        }
+    }
+
+    const float max_cost = p_max_error * p_max_error;
+    float largest_cost = 0.0f;
+
+    VertexFans fans;
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> touched(vertex_count);
+    std::vector<uint32_t> from_neighbours, to_neighbours;
+
+    // A pass picks the cheapest collapse of every vertex and applies them in order. A collapse
+    // changes the fan of its vertices, any later collapse touching them waits for the next pass.
+    while (indices.size() > p_target_index_count) {
+        fans.Build(vertex_count, indices);
+
+        collapses.clear();
+        for (uint32_t vertex = 0; vertex < vertex_count; ++vertex) {
+            if (locked[vertex]) {
+                continue;
+            }
+
+            Collapse best{ std::numeric_limits<float>::max(), vertex, vertex };
+            for (uint32_t triangle : fans.Get(vertex)) {
+                for (int corner = 0; corner < 3; ++corner) {
+                    const uint32_t other = indices[3 * triangle + corner];
+                    if (other == vertex) {
+                        continue;
+                    }
+                    const float cost = quadrics[vertex].Evaluate(p_positions[other]);
+                    if (cost < best.cost) {
+                        best.cost = cost;
+                        best.to = other;
+                    }
+                }
+            }
+            if (best.to != vertex && best.cost <= max_cost) {
+                collapses.push_back(best);
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& p_lhs, const Collapse& p_rhs) {
+            return p_lhs.cost < p_rhs.cost;
+        });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t triangle_count = indices.size() / 3;
+        const size_t target_triangle_count = p_target_index_count / 3;
+        uint32_t applied = 0;
+
+        for (const Collapse& collapse : collapses) {
+            if (triangle_count <= target_triangle_count) {
+                break;
+            }
+            const uint32_t from = collapse.from;
+            const uint32_t to = collapse.to;
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+
+            // the two vertices may only share the neighbours across their shared triangles, or
+            // the collapse folds the surface onto itself
+            GatherNeighbours(fans, indices, from, to, from_neighbours);
+            GatherNeighbours(fans, indices, to, from, to_neighbours);
+            size_t shared_neighbours = 0;
+            for (uint32_t neighbour : from_neighbours) {
+                shared_neighbours += std::binary_search(to_neighbours.begin(), to_neighbours.end(), neighbour);
+            }
+
+            size_t shared_triangles = 0;
+            bool flips = false;
+            for (uint32_t triangle : fans.Get(from)) {
+                const uint32_t* corners = &indices[3 * triangle];
+                if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                    ++shared_triangles;
+                    continue;
+                }
+
+                // the triangles that stay must keep facing the same way
+                Vector3f before[3], after[3];
+                for (int corner = 0; corner < 3; ++corner) {
+                    before[corner] = p_positions[corners[corner]];
+                    after[corner] = corners[corner] == from ? p_positions[to] : before[corner];
+                }
+                const Vector3f normal_before = cross(before[1] - before[0], before[2] - before[0]);
+                const Vector3f normal_after = cross(after[1] - after[0], after[2] - after[0]);
+                if (dot(normal_before, normal_after) <= MIN_NORMAL_COSINE * length(normal_before) * length(normal_after)) {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips || shared_neighbours != shared_triangles) {
+                continue;
+            }
+
+            for (uint32_t triangle : fans.Get(from)) {
+                uint32_t* corners = &indices[3 * triangle];
+                for (int corner = 0; corner < 3; ++corner) {
+                    touched[corners[corner]] = 1;
+                    if (corners[corner] == from) {
+                        corners[corner] = to;
+                    }
+                }
+            }
+            touched[from] = 1;
+            touched[to] = 1;
+
+            quadrics[to].Add(quadrics[from]);
+            largest_cost = glm::max(largest_cost, collapse.cost);
+            triangle_count -= shared_triangles;
+            ++applied;
+        }
+
+        if (!applied) {
+            break;
+        }
+
+        size_t write = 0;
+        for (size_t read = 0; read < indices.size(); read += 3) {
+            if (!IsDegenerate(&indices[read])) {
+                indices[write++] = indices[read];
+                indices[write++] = indices[read + 1];
+                indices[write++] = indices[read + 2];
+            }
+        }
+        indices.resize(write);
+    }
+
+    result.error = glm::sqrt(largest_cost);
+    return result;
+}
+
+}  // namespace cave
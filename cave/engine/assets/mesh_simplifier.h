@@ -0,0 +1,25 @@
+#pragma once
+#include "engine/math/geomath.h"
+
+namespace cave {
+
+// Quadric error edge collapse. Every collapse moves a vertex onto one of its neighbours, so the
+// simplified triangles index the vertices of the source mesh and a LOD only needs its own index
+// buffer. Vertices on open edges stay in place, which keeps the outline of the mesh and the uv and
+// normal seams, where the indices of neighbouring triangles split.
+struct MeshSimplifier {
+    struct Result {
+        std::vector<uint32_t> indices;
+        // largest distance the surface moved, in the unit of the positions
+        float error = 0.0f;
+    };
+
+    // Collapses edges of the triangle list p_indices until it has at most p_target_index_count
+    // indices or the next collapse would move the surface more than p_max_error.
+    static Result Simplify(std::span<const Vector3f> p_positions,
+                           std::span<const uint32_t> p_indices,
+                           uint32_t p_target_index_count,
+                           float p_max_error);
+};
+
+}  // namespace cave
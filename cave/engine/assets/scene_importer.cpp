@@ -103,6 +103,8 @@ Result<Guid> SceneImporter::RegisterMaterial(std::string&& p_name,
 
 Result<Guid> SceneImporter::RegisterMesh(std::string&& p_name,
                                          std::shared_ptr<MeshAsset>&& p_mesh) {
+    p_mesh->GenerateLods();
+
     fs::path sys_path = m_dest_dir / std::format("{}.mesh", p_name);
 
     Guid guid = Guid::Create();
@@ -119,7 +121,7 @@ Result<Guid> SceneImporter::RegisterMesh(std::string&& p_name,
     AssetRegistry::GetSingleton().RegisterAsset(std::move(meta), p_mesh);
 
     // @TODO: move it to somewhere else, if it's headless, no need to create gpu data
-    GraphicsManager::GetSingleton().RequestMesh(p_mesh.get());
+    GraphicsManager::GetSingleton().RequestMesh(p_mesh);
 
     return Result<Guid>(guid);
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "engine/renderer/graphics_defines.h"
+#include "engine/renderer/graphics_manager.h"
 #include "engine/runtime/graphics_manager_interface.h"
 
 namespace cave {
@@ -7,8 +8,28 @@ namespace cave {
 WARNING_PUSH()
 WARNING_DISABLE(4100, "-Wunused-parameter")
 
+// keeps the description, so render graphs can be compiled and inspected without a device
+struct EmptyGpuTexture : GpuTexture {
+    using GpuTexture::GpuTexture;
+
+    uint64_t GetResidentHandle() const override { return 0; }
+    uint64_t GetHandle() const override { return 0; }
+    uint64_t GetUavHandle() const override { return 0; }
+};
+
 class EmptyGraphicsManager : public IGraphicsManager {
 public:
+    // state changes issued by the renderer, nothing is executed but the ordering can be measured
+    struct StateChangeCounters {
+        uint32_t setMesh = 0;
+        uint32_t bindTexture = 0;
+        uint32_t bindConstantBuffer = 0;
+        uint32_t setStencilRef = 0;
+        uint32_t draw = 0;
+        uint32_t drawInstanced = 0;
+        uint32_t instance = 0;
+    };
+
     EmptyGraphicsManager(std::string_view p_name = "EmptyGraphicsManager")
         : IGraphicsManager(p_name) {}
 
@@ -17,6 +38,9 @@ public:
 
     void Update(Scene* p_scene) override {}
 
+    void RenderFrame(const FrameData* p_framedata) override {}
+    void PublishCreatedResources() override {}
+
     // resource
     auto CreateConstantBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuConstantBuffer>> override { return nullptr; }
     auto CreateStructuredBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuStructuredBuffer>> override { return nullptr; }
@@ -41,10 +65,13 @@ public:
 
     auto CreateMesh(const MeshAsset& p_mesh) -> Result<std::shared_ptr<GpuMesh>> override { return nullptr; }
 
-    void SetMesh(const GpuMesh* p_mesh) override {}
+    void SetMesh(const GpuMesh* p_mesh) override { ++m_counters.setMesh; }
 
-    void DrawElements(uint32_t p_count, uint32_t p_offset = 0) override {}
-    void DrawElementsInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset = 0) override {}
+    void DrawElements(uint32_t p_count, uint32_t p_offset = 0) override { ++m_counters.draw; }
+    void DrawElementsInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset = 0) override {
+        ++m_counters.drawInstanced;
+        m_counters.instance += p_instance_count;
+    }
     void DrawArrays(uint32_t p_count, uint32_t p_offset = 0) override {}
     void DrawArraysInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset = 0) override {}
 
@@ -54,7 +81,7 @@ public:
 
     void SetPipelineState(PipelineStateName p_name) override {}
 
-    void SetStencilRef(uint32_t p_ref) override {}
+    void SetStencilRef(uint32_t p_ref) override { ++m_counters.setStencilRef; }
     void SetBlendState(const BlendDesc& p_desc, const float* p_factor, uint32_t p_mask) override {}
 
     void BindStructuredBuffer(int p_slot, const GpuStructuredBuffer* p_buffer) override {}
@@ -63,15 +90,18 @@ public:
     void UnbindStructuredBufferSRV(int p_slot) override {}
 
     void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) override {}
+    void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) override {}
 
-    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override {}
+    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override { ++m_counters.bindConstantBuffer; }
 
     std::shared_ptr<Framebuffer> CreateFramebuffer(const FramebufferDesc& p_desc) override { return nullptr; }
 
-    std::shared_ptr<GpuTexture> CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) override { return nullptr; }
+    std::shared_ptr<GpuTexture> CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) override {
+        return std::make_shared<EmptyGpuTexture>(p_texture_desc);
+    }
     std::shared_ptr<GpuTexture> CreateTexture(ImageAsset* p_image) override { return nullptr; }
     std::shared_ptr<GpuTexture> FindTexture(std::string_view p_name) const override { return nullptr; }
-    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) override {}
+    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) override { ++m_counters.bindTexture; }
     void UnbindTexture(Dimension p_dimension, int p_slot) override {}
 
     void BeginEvent(std::string_view p_event) override {}
@@ -79,8 +109,8 @@ public:
 
     void GenerateMipmap(const GpuTexture* p_texture) override {}
 
-    void RequestTexture(ImageAsset* p_image) override {}
-    void RequestMesh(MeshAsset* p_mesh) override {}
+    void RequestTexture(std::shared_ptr<ImageAsset> p_image) override {}
+    void RequestMesh(std::shared_ptr<MeshAsset> p_mesh) override {}
 
     uint64_t GetFinalImage() const override { return 0; }
 
@@ -90,15 +120,18 @@ public:
     bool SetActiveRenderGraph(RenderGraphName p_name) override { return true; }
     RenderGraph* GetActiveRenderGraph() override { return nullptr; }
 
-    FrameContext& GetCurrentFrame() override {
-        FrameContext* context = nullptr;
-        return *context;
-    }
+    FrameContext& GetCurrentFrame() override { return m_frameContext; }
+
+    int GetRecordingContextCount() const override { return 0; }
+    IGraphicsManager& BeginRecording(int p_index) override { return *this; }
 
     void DrawSkybox() override {}
 
     void EventReceived(std::shared_ptr<IEvent> p_event) override {}
 
+    const StateChangeCounters& GetStateChangeCounters() const { return m_counters; }
+    void ResetStateChangeCounters() { m_counters = {}; }
+
 protected:
     std::shared_ptr<GpuTexture> CreateTextureImpl(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) override { return nullptr; }
 
@@ -113,6 +146,9 @@ protected:
     void OnWindowResize(int p_width, int p_height) override {}
     void SetPipelineStateImpl(PipelineStateName p_name) override {}
     void UpdateEmitters(const Scene& p_scene) override {}
+
+    FrameContext m_frameContext;
+    StateChangeCounters m_counters;
 };
 
 WARNING_POP()
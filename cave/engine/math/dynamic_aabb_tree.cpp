@@ -0,0 +1,409 @@
+#include "dynamic_aabb_tree.h"
+
+namespace cave {
+
+// unlike Box3::SurfaceArea(), flat boxes still have an area
+static float Area(const AABB& p_aabb) {
+    const Vector3f size = p_aabb.Size();
+    return 2.0f * (size.x * size.y + size.x * size.z + size.y * size.z);
+}
+
+static AABB Union(const AABB& p_lhs, const AABB& p_rhs) {
+    AABB result = p_lhs;
+    result.UnionBox(p_rhs);
+    return result;
+}
+
+static bool Contains(const AABB& p_outer, const AABB& p_inner) {
+    const Vector3f& outer_min = p_outer.GetMin();
+    const Vector3f& outer_max = p_outer.GetMax();
+    const Vector3f& inner_min = p_inner.GetMin();
+    const Vector3f& inner_max = p_inner.GetMax();
+    return outer_min.x <= inner_min.x && outer_min.y <= inner_min.y && outer_min.z <= inner_min.z &&
+           inner_max.x <= outer_max.x && inner_max.y <= outer_max.y && inner_max.z <= outer_max.z;
+}
+
+DynamicAabbTree::DynamicAabbTree(float p_margin)
+    : m_margin(p_margin) {
+    DEV_ASSERT(p_margin >= 0.0f);
+}
+
+int DynamicAabbTree::CreateProxy(const AABB& p_aabb, uint32_t p_user_data) {
+    const int proxy = AllocateNode();
+    Node& node = m_nodes[proxy];
+    node.aabb = AABB(p_aabb.GetMin() - Vector3f(m_margin), p_aabb.GetMax() + Vector3f(m_margin));
+    node.user_data = p_user_data;
+    node.height = 0;
+
+    InsertLeaf(proxy);
+    ++m_proxyCount;
+    return proxy;
+}
+
+void DynamicAabbTree::DestroyProxy(int p_proxy) {
+    ERR_FAIL_COND(!IsProxy(p_proxy));
+
+    RemoveLeaf(p_proxy);
+    FreeNode(p_proxy);
+    --m_proxyCount;
+}
+
+bool DynamicAabbTree::MoveProxy(int p_proxy, const AABB& p_aabb) {
+    DEV_ASSERT(IsProxy(p_proxy));
+
+    const AABB old_aabb = m_nodes[p_proxy].aabb;
+    if (Contains(old_aabb, p_aabb)) {
+        return false;
+    }
+
+    // a box that left its fat box tends to keep moving the same way, so the new fat box is
+    // stretched along the move, by at most the size of the box in case it was teleported
+    const Vector3f size = p_aabb.Size();
+    const Vector3f displacement = min(max(p_aabb.Center() - old_aabb.Center(), Vector3f(0.0f) - size), size);
+    Vector3f fat_min = p_aabb.GetMin() - Vector3f(m_margin);
+    Vector3f fat_max = p_aabb.GetMax() + Vector3f(m_margin);
+    for (int axis = 0; axis < 3; ++axis) {
+        if (displacement[axis] < 0.0f) {
+            fat_min[axis] += displacement[axis];
+        } else {
+            fat_max[axis] += displacement[axis];
+        }
+    }
+
+    RemoveLeaf(p_proxy);
+    m_nodes[p_proxy].aabb = AABB(fat_min, fat_max);
+    InsertLeaf(p_proxy);
+    return true;
+}
+
+void DynamicAabbTree::Clear() {
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_proxyCount = 0;
+}
+
+bool DynamicAabbTree::IsProxy(int p_proxy) const {
+    return p_proxy >= 0 && p_proxy < GetCapacity() && m_nodes[p_proxy].height == 0;
+}
+
+uint32_t DynamicAabbTree::GetUserData(int p_proxy) const {
+    DEV_ASSERT(IsProxy(p_proxy));
+    return m_nodes[p_proxy].user_data;
+}
+
+void DynamicAabbTree::SetUserData(int p_proxy, uint32_t p_user_data) {
+    DEV_ASSERT(IsProxy(p_proxy));
+    m_nodes[p_proxy].user_data = p_user_data;
+}
+
+const AABB& DynamicAabbTree::GetFatAABB(int p_proxy) const {
+    DEV_ASSERT(IsProxy(p_proxy));
+    return m_nodes[p_proxy].aabb;
+}
+
+float DynamicAabbTree::GetAreaRatio() const {
+    if (m_root == NULL_NODE) {
+        return 0.0f;
+    }
+
+    float total_area = 0.0f;
+    for (const Node& node : m_nodes) {
+        if (node.height > 0) {
+            total_area += Area(node.aabb);
+        }
+    }
+    return total_area / Area(m_nodes[m_root].aabb);
+}
+
+bool DynamicAabbTree::Validate() const {
+    if (m_root != NULL_NODE && m_nodes[m_root].parent != NULL_NODE) {
+        return false;
+    }
+
+    const int leaf_count = m_root == NULL_NODE ? 0 : ValidateNode(m_root);
+    if (leaf_count != m_proxyCount) {
+        return false;
+    }
+
+    int free_count = 0;
+    for (int node = m_freeList; node != NULL_NODE; node = m_nodes[node].parent) {
+        if (m_nodes[node].height != -1) {
+            return false;
+        }
+        ++free_count;
+    }
+
+    // every node is either free or reachable, a leaf tree has proxy_count - 1 internal nodes
+    const int used_count = m_proxyCount ? 2 * m_proxyCount - 1 : 0;
+    return free_count + used_count == GetCapacity();
+}
+
+// returns the leaf count of the subtree, -1 if it is broken
+int DynamicAabbTree::ValidateNode(int p_node) const {
+    const Node& node = m_nodes[p_node];
+    if (node.IsLeaf()) {
+        return node.height == 0 && node.child2 == NULL_NODE ? 1 : -1;
+    }
+
+    const Node& child1 = m_nodes[node.child1];
+    const Node& child2 = m_nodes[node.child2];
+    if (child1.parent != p_node || child2.parent != p_node) {
+        return -1;
+    }
+    if (node.height != 1 + glm::max(child1.height, child2.height)) {
+        return -1;
+    }
+    if (!Contains(node.aabb, child1.aabb) || !Contains(node.aabb, child2.aabb)) {
+        return -1;
+    }
+
+    const int count1 = ValidateNode(node.child1);
+    const int count2 = ValidateNode(node.child2);
+    return count1 < 0 || count2 < 0 ? -1 : count1 + count2;
+}
+
+int DynamicAabbTree::AllocateNode() {
+    if (m_freeList == NULL_NODE) {
+        m_nodes.emplace_back();
+        return GetCapacity() - 1;
+    }
+
+    const int node = m_freeList;
+    m_freeList = m_nodes[node].parent;
+    m_nodes[node] = Node{};
+    return node;
+}
+
+void DynamicAabbTree::FreeNode(int p_node) {
+    Node& node = m_nodes[p_node];
+    node = Node{};
+    node.parent = m_freeList;
+    m_freeList = p_node;
+}
+
+void DynamicAabbTree::InsertLeaf(int p_leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = p_leaf;
+        m_nodes[p_leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down to the sibling with the lowest cost, the cost of a node is the area of the new
+    // parent plus the area it adds to the ancestors
+    const AABB leaf_aabb = m_nodes[p_leaf].aabb;
+    int index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        const float area = Area(node.aabb);
+        const float combined_area = Area(Union(node.aabb, leaf_aabb));
+
+        // a new parent of this node and the leaf
+        const float cost = 2.0f * combined_area;
+        // pushing the leaf further down grows this node
+        const float inheritance_cost = 2.0f * (combined_area - area);
+
+        auto descend_cost = [&](int p_child) {
+            const Node& child = m_nodes[p_child];
+            const float new_area = Area(Union(child.aabb, leaf_aabb));
+            return (child.IsLeaf() ? new_area : new_area - Area(child.aabb)) + inheritance_cost;
+        };
+        const float cost1 = descend_cost(node.child1);
+        const float cost2 = descend_cost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int sibling = index;
+    const int old_parent = m_nodes[sibling].parent;
+    // may grow m_nodes, so nodes are only accessed by index from here
+    const int new_parent = AllocateNode();
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].aabb = Union(leaf_aabb, m_nodes[sibling].aabb);
+    m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+    m_nodes[new_parent].child1 = sibling;
+    m_nodes[new_parent].child2 = p_leaf;
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[p_leaf].parent = new_parent;
+
+    if (old_parent == NULL_NODE) {
+        m_root = new_parent;
+    } else if (m_nodes[old_parent].child1 == sibling) {
+        m_nodes[old_parent].child1 = new_parent;
+    } else {
+        m_nodes[old_parent].child2 = new_parent;
+    }
+
+    Refit(new_parent);
+}
+
+void DynamicAabbTree::RemoveLeaf(int p_leaf) {
+    if (p_leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    const int parent = m_nodes[p_leaf].parent;
+    const int grand_parent = m_nodes[parent].parent;
+    const int sibling = m_nodes[parent].child1 == p_leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    // the sibling takes the place of the parent
+    m_nodes[sibling].parent = grand_parent;
+    FreeNode(parent);
+    m_nodes[p_leaf].parent = NULL_NODE;
+
+    if (grand_parent == NULL_NODE) {
+        m_root = sibling;
+        return;
+    }
+
+    if (m_nodes[grand_parent].child1 == parent) {
+        m_nodes[grand_parent].child1 = sibling;
+    } else {
+        m_nodes[grand_parent].child2 = sibling;
+    }
+    Refit(grand_parent);
+}
+
+void DynamicAabbTree::Refit(int p_node) {
+    for (int index = p_node; index != NULL_NODE;) {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.child1];
+        const Node& child2 = m_nodes[node.child2];
+        node.height = 1 + glm::max(child1.height, child2.height);
+        node.aabb = Union(child1.aabb, child2.aabb);
+
+        index = node.parent;
+    }
+}
+
+//      A            C
+//     / \          / \
+//    B   C   =>   A   F
+//       / \      / \
+//      F   G    B   G
+// and the mirrored rotation when B is the higher child
+int DynamicAabbTree::Balance(int p_node) {
+    const int a = p_node;
+    if (m_nodes[a].IsLeaf() || m_nodes[a].height < 2) {
+        return a;
+    }
+
+    auto rotate_up = [&](int p_up, int p_other, bool p_up_is_child2) {
+        Node& node_a = m_nodes[a];
+        Node& node_up = m_nodes[p_up];
+        const int f = node_up.child1;
+        const int g = node_up.child2;
+
+        // p_up takes the place of a
+        node_up.child1 = a;
+        node_up.parent = node_a.parent;
+        node_a.parent = p_up;
+        if (node_up.parent == NULL_NODE) {
+            m_root = p_up;
+        } else if (m_nodes[node_up.parent].child1 == a) {
+            m_nodes[node_up.parent].child1 = p_up;
+        } else {
+            m_nodes[node_up.parent].child2 = p_up;
+        }
+
+        // the higher grandchild stays under p_up, the lower one moves under a
+        const bool keep_f = m_nodes[f].height > m_nodes[g].height;
+        const int keep = keep_f ? f : g;
+        const int move = keep_f ? g : f;
+        node_up.child2 = keep;
+        if (p_up_is_child2) {
+            node_a.child2 = move;
+        } else {
+            node_a.child1 = move;
+        }
+        m_nodes[move].parent = a;
+
+        node_a.aabb = Union(m_nodes[p_other].aabb, m_nodes[move].aabb);
+        node_a.height = 1 + glm::max(m_nodes[p_other].height, m_nodes[move].height);
+        node_up.aabb = Union(node_a.aabb, m_nodes[keep].aabb);
+        node_up.height = 1 + glm::max(node_a.height, m_nodes[keep].height);
+        return p_up;
+    };
+
+    const int b = m_nodes[a].child1;
+    const int c = m_nodes[a].child2;
+    const int balance = m_nodes[c].height - m_nodes[b].height;
+    if (balance > 1) {
+        return rotate_up(c, b, true);
+    }
+    if (balance < -1) {
+        return rotate_up(b, c, false);
+    }
+    return a;
+}
+
+bool DynamicAabbTree::Overlaps(const AABB& p_lhs, const AABB& p_rhs) {
+    const Vector3f& lhs_min = p_lhs.GetMin();
+    const Vector3f& lhs_max = p_lhs.GetMax();
+    const Vector3f& rhs_min = p_rhs.GetMin();
+    const Vector3f& rhs_max = p_rhs.GetMax();
+    return lhs_min.x <= rhs_max.x && rhs_min.x <= lhs_max.x &&
+           lhs_min.y <= rhs_max.y && rhs_min.y <= lhs_max.y &&
+           lhs_min.z <= rhs_max.z && rhs_min.z <= lhs_max.z;
+}
+
+bool DynamicAabbTree::OverlapsSphere(const AABB& p_aabb, const Vector3f& p_center, float p_radius_squared) {
+    const Vector3f closest = min(max(p_center, p_aabb.GetMin()), p_aabb.GetMax());
+    const Vector3f delta = closest - p_center;
+    return dot(delta, delta) <= p_radius_squared;
+}
+
+DynamicAabbTree::Containment DynamicAabbTree::Classify(const Frustum& p_frustum, const AABB& p_aabb) {
+    const Vector3f& box_min = p_aabb.GetMin();
+    const Vector3f& box_max = p_aabb.GetMax();
+    Containment result = Containment::INSIDE;
+    for (int i = 0; i < 6; ++i) {
+        const Plane& plane = p_frustum[i];
+        // the corners farthest along and against the normal
+        Vector3f p, n;
+        p.x = plane.normal.x > 0.0f ? box_max.x : box_min.x;
+        p.y = plane.normal.y > 0.0f ? box_max.y : box_min.y;
+        p.z = plane.normal.z > 0.0f ? box_max.z : box_min.z;
+        n.x = plane.normal.x > 0.0f ? box_min.x : box_max.x;
+        n.y = plane.normal.y > 0.0f ? box_min.y : box_max.y;
+        n.z = plane.normal.z > 0.0f ? box_min.z : box_max.z;
+
+        if (plane.Distance(p) < 0.0f) {
+            return Containment::OUTSIDE;
+        }
+        if (plane.Distance(n) < 0.0f) {
+            result = Containment::INTERSECTS;
+        }
+    }
+    return result;
+}
+
+float DynamicAabbTree::RayFraction(const AABB& p_aabb, const Vector3f& p_start, const Vector3f& p_inv_direction, float p_max_fraction) {
+    const Vector3f& box_min = p_aabb.GetMin();
+    const Vector3f& box_max = p_aabb.GetMax();
+    // a segment starting inside the box enters it at 0
+    float t_min = 0.0f;
+    float t_max = p_max_fraction;
+    for (int axis = 0; axis < 3; ++axis) {
+        float t0 = (box_min[axis] - p_start[axis]) * p_inv_direction[axis];
+        float t1 = (box_max[axis] - p_start[axis]) * p_inv_direction[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        // written so a NaN, a segment parallel to and on a slab, keeps the current range
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+        if (t_min > t_max) {
+            return -1.0f;
+        }
+    }
+    return t_min;
+}
+
+}  // namespace cave
@@ -0,0 +1,233 @@
+#pragma once
+#include "engine/math/aabb.h"
+#include "engine/math/frustum.h"
+
+namespace cave {
+
+// Incremental bounding volume hierarchy over moving boxes. Leaves store a fat box, the tight box
+// grown by a margin, so small moves don't touch the tree. A leaf is only reinserted when its box
+// leaves the fat one, the insertion picks the sibling with the lowest surface area cost and the
+// ancestors are rotated on the way back up to keep the tree balanced.
+class DynamicAabbTree {
+public:
+    static constexpr int NULL_NODE = -1;
+    static constexpr float DEFAULT_MARGIN = 0.1f;
+    // deep enough for any balanced tree that fits in memory
+    static constexpr int STACK_SIZE = 128;
+
+    DynamicAabbTree(float p_margin = DEFAULT_MARGIN);
+
+    int CreateProxy(const AABB& p_aabb, uint32_t p_user_data);
+    void DestroyProxy(int p_proxy);
+
+    // Returns true if the proxy was reinserted, false if the box still fits in its fat box.
+    bool MoveProxy(int p_proxy, const AABB& p_aabb);
+
+    void Clear();
+
+    bool IsProxy(int p_proxy) const;
+    uint32_t GetUserData(int p_proxy) const;
+    void SetUserData(int p_proxy, uint32_t p_user_data);
+    const AABB& GetFatAABB(int p_proxy) const;
+
+    int GetProxyCount() const { return m_proxyCount; }
+    // proxies are indices below the capacity, for arrays indexed by proxy
+    int GetCapacity() const { return static_cast<int>(m_nodes.size()); }
+    int GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+    // sum of the node areas over the root area, lower is a better tree
+    float GetAreaRatio() const;
+
+    // checks parent links, heights and bounds, for tests
+    bool Validate() const;
+
+    // p_callback(int p_proxy) for every fat box overlapping p_aabb
+    template<typename CALLBACK>
+    void QueryAabb(const AABB& p_aabb, CALLBACK&& p_callback) const;
+
+    // p_callback(int p_proxy) for every fat box touching the sphere
+    template<typename CALLBACK>
+    void QuerySphere(const Vector3f& p_center, float p_radius, CALLBACK&& p_callback) const;
+
+    // p_callback(int p_proxy) for every fat box in the frustum, subtrees fully inside are
+    // reported without testing their leaves
+    template<typename CALLBACK>
+    void QueryFrustum(const Frustum& p_frustum, CALLBACK&& p_callback) const;
+
+    // p_callback(int p_proxy, float p_max_fraction) for every fat box hit by the segment before
+    // the max fraction, nearest subtrees first. The callback returns the new max fraction, 0 stops
+    // the cast.
+    template<typename CALLBACK>
+    void RayCast(const Vector3f& p_start, const Vector3f& p_end, CALLBACK&& p_callback) const;
+
+private:
+    enum class Containment {
+        OUTSIDE,
+        INTERSECTS,
+        INSIDE,
+    };
+
+    struct Node {
+        AABB aabb;
+        // next free node when the node is on the free list
+        int parent = NULL_NODE;
+        int child1 = NULL_NODE;
+        int child2 = NULL_NODE;
+        // 0 for leaves, -1 for free nodes
+        int height = -1;
+        uint32_t user_data = 0;
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    int AllocateNode();
+    void FreeNode(int p_node);
+
+    void InsertLeaf(int p_leaf);
+    void RemoveLeaf(int p_leaf);
+    // rotates p_node if its children heights differ by more than one, returns the new subtree root
+    int Balance(int p_node);
+
+    // fixes heights and boxes from p_node up to the root
+    void Refit(int p_node);
+
+    int ValidateNode(int p_node) const;
+
+    static bool Overlaps(const AABB& p_lhs, const AABB& p_rhs);
+    static bool OverlapsSphere(const AABB& p_aabb, const Vector3f& p_center, float p_radius_squared);
+    static Containment Classify(const Frustum& p_frustum, const AABB& p_aabb);
+    // entry fraction of the segment into p_aabb, or a negative value if it misses
+    static float RayFraction(const AABB& p_aabb, const Vector3f& p_start, const Vector3f& p_inv_direction, float p_max_fraction);
+
+    std::vector<Node> m_nodes;
+    int m_root = NULL_NODE;
+    int m_freeList = NULL_NODE;
+    int m_proxyCount = 0;
+    const float m_margin;
+};
+
+template<typename CALLBACK>
+void DynamicAabbTree::QueryAabb(const AABB& p_aabb, CALLBACK&& p_callback) const {
+    int stack[STACK_SIZE];
+    int count = 0;
+    if (m_root != NULL_NODE) {
+        stack[count++] = m_root;
+    }
+
+    while (count) {
+        const Node& node = m_nodes[stack[--count]];
+        if (!Overlaps(node.aabb, p_aabb)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            p_callback(stack[count]);
+            continue;
+        }
+        DEV_ASSERT(count + 2 <= STACK_SIZE);
+        stack[count++] = node.child1;
+        stack[count++] = node.child2;
+    }
+}
+
+template<typename CALLBACK>
+void DynamicAabbTree::QuerySphere(const Vector3f& p_center, float p_radius, CALLBACK&& p_callback) const {
+    const float radius_squared = p_radius * p_radius;
+    int stack[STACK_SIZE];
+    int count = 0;
+    if (m_root != NULL_NODE) {
+        stack[count++] = m_root;
+    }
+
+    while (count) {
+        const Node& node = m_nodes[stack[--count]];
+        if (!OverlapsSphere(node.aabb, p_center, radius_squared)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            p_callback(stack[count]);
+            continue;
+        }
+        DEV_ASSERT(count + 2 <= STACK_SIZE);
+        stack[count++] = node.child1;
+        stack[count++] = node.child2;
+    }
+}
+
+template<typename CALLBACK>
+void DynamicAabbTree::QueryFrustum(const Frustum& p_frustum, CALLBACK&& p_callback) const {
+    // the second element is set once an ancestor is known to be inside
+    std::pair<int, bool> stack[STACK_SIZE];
+    int count = 0;
+    if (m_root != NULL_NODE) {
+        stack[count++] = { m_root, false };
+    }
+
+    while (count) {
+        const auto [node_idx, inside] = stack[--count];
+        const Node& node = m_nodes[node_idx];
+
+        bool node_inside = inside;
+        if (!node_inside) {
+            const Containment containment = Classify(p_frustum, node.aabb);
+            if (containment == Containment::OUTSIDE) {
+                continue;
+            }
+            node_inside = containment == Containment::INSIDE;
+        }
+
+        if (node.IsLeaf()) {
+            p_callback(node_idx);
+            continue;
+        }
+        DEV_ASSERT(count + 2 <= STACK_SIZE);
+        stack[count++] = { node.child1, node_inside };
+        stack[count++] = { node.child2, node_inside };
+    }
+}
+
+template<typename CALLBACK>
+void DynamicAabbTree::RayCast(const Vector3f& p_start, const Vector3f& p_end, CALLBACK&& p_callback) const {
+    const Vector3f inv_direction = 1.0f / (p_end - p_start);
+    float max_fraction = 1.0f;
+
+    int stack[STACK_SIZE];
+    int count = 0;
+    if (m_root != NULL_NODE && RayFraction(m_nodes[m_root].aabb, p_start, inv_direction, max_fraction) >= 0.0f) {
+        stack[count++] = m_root;
+    }
+
+    while (count) {
+        const int node_idx = stack[--count];
+        const Node& node = m_nodes[node_idx];
+        // the fraction may have shrunk since the node was pushed
+        if (RayFraction(node.aabb, p_start, inv_direction, max_fraction) < 0.0f) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            max_fraction = p_callback(node_idx, max_fraction);
+            if (max_fraction <= 0.0f) {
+                return;
+            }
+            continue;
+        }
+
+        // push the farther child first, so the nearer one is visited first
+        const float fraction1 = RayFraction(m_nodes[node.child1].aabb, p_start, inv_direction, max_fraction);
+        const float fraction2 = RayFraction(m_nodes[node.child2].aabb, p_start, inv_direction, max_fraction);
+        const bool swap = fraction2 >= 0.0f && (fraction1 < 0.0f || fraction2 < fraction1);
+        const int near_child = swap ? node.child2 : node.child1;
+        const int far_child = swap ? node.child1 : node.child2;
+        const float near_fraction = swap ? fraction2 : fraction1;
+        const float far_fraction = swap ? fraction1 : fraction2;
+
+        DEV_ASSERT(count + 2 <= STACK_SIZE);
+        if (far_fraction >= 0.0f) {
+            stack[count++] = far_child;
+        }
+        if (near_fraction >= 0.0f) {
+            stack[count++] = near_child;
+        }
+    }
+}
+
+}  // namespace cave
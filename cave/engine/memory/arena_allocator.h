@@ -0,0 +1,66 @@
+#pragma once
+#include "linear_allocator.h"
+
+namespace cave::memory {
+
+// Std allocator on top of a LinearAllocator. Deallocation is a no-op for arena memory, it is
+// reclaimed all at once when the arena is reset. Without an arena, or once the arena is full, it
+// falls back to the heap.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() = default;
+
+    explicit ArenaAllocator(LinearAllocator* p_arena)
+        : m_arena(p_arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& p_other)
+        : m_arena(p_other.GetArena()) {}
+
+    T* allocate(size_t p_count) {
+        if (m_arena) {
+            if (void* ptr = m_arena->Allocate(p_count * sizeof(T), alignof(T)); ptr) {
+                return static_cast<T*>(ptr);
+            }
+        }
+        return std::allocator<T>().allocate(p_count);
+    }
+
+    void deallocate(T* p_ptr, size_t p_count) {
+        if (m_arena && m_arena->Owns(p_ptr)) {
+            return;
+        }
+        std::allocator<T>().deallocate(p_ptr, p_count);
+    }
+
+    LinearAllocator* GetArena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& p_other) const { return m_arena == p_other.GetArena(); }
+
+private:
+    LinearAllocator* m_arena = nullptr;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Moves p_vector to p_arena, empty but with room for as many elements as it had, so a container
+// refilled every frame doesn't grow through the arena again. The old storage is dropped, not
+// freed, it must stay valid until this returns.
+template<typename T>
+void RecycleArenaVector(ArenaVector<T>& p_vector, LinearAllocator* p_arena) {
+    const size_t size = p_vector.size();
+    p_vector = ArenaVector<T>(ArenaAllocator<T>(p_arena));
+    if (size) {
+        p_vector.reserve(size);
+    }
+}
+
+}  // namespace cave::memory
@@ -23,16 +23,19 @@ void* LinearAllocator::Allocate(size_t p_size, size_t p_alignment) {
     DEV_ASSERT(p_size);
     DEV_ASSERT(p_alignment && IsPow2(p_alignment));
 
-    const size_t alloc_size = AlignUp(p_size, p_alignment);
-    const size_t new_offset = m_offset + alloc_size;
+    // align the address rather than the size, allocations with different alignments can be mixed
+    const std::uintptr_t base = PtrToInt(m_base);
+    const size_t offset = AlignUp(base + m_offset, p_alignment) - base;
+    const size_t new_offset = offset + AlignUp(p_size, p_alignment);
 
     if (new_offset > m_capacity) {
+        ++m_overflowCount;
         return nullptr;
     }
 
-    char* ptr = (char*)m_base + m_offset;
-    m_offset += alloc_size;
-    return ptr;
+    m_offset = new_offset;
+    m_highWaterMark = std::max(m_highWaterMark, m_offset);
+    return (char*)m_base + offset;
 }
 
 void LinearAllocator::Deallocate(void*, size_t) {
@@ -40,10 +43,11 @@ void LinearAllocator::Deallocate(void*, size_t) {
 }
 
 void LinearAllocator::Reset() {
-    m_offset = 0;
     if constexpr (kDebug) {
-        std::memset(m_base, 0xDD, m_capacity);
+        // only the part used since the last reset, the rest still holds a fill pattern
+        std::memset(m_base, 0xDD, m_offset);
     }
+    m_offset = 0;
 }
 
 }  // namespace cave::memory
@@ -10,22 +10,37 @@ public:
     LinearAllocator(size_t p_capacity);
     ~LinearAllocator();
 
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+    // returns nullptr when the allocation doesn't fit
     void* Allocate(size_t p_size, size_t p_alignment = kDefaultAlignment) override;
     void Deallocate(void* p_ptr, size_t p_size) override;
 
     void Reset();
 
+    bool Owns(const void* p_ptr) const {
+        const std::uintptr_t ptr = reinterpret_cast<std::uintptr_t>(p_ptr);
+        return ptr >= PtrToInt(m_base) && ptr < PtrToInt(m_base) + m_capacity;
+    }
+
     size_t Capacity() const { return m_capacity; }
     size_t Used() const { return m_offset; }
+    // the most ever used between two resets
+    size_t HighWaterMark() const { return m_highWaterMark; }
+    // allocations that didn't fit since construction
+    uint32_t OverflowCount() const { return m_overflowCount; }
 
 private:
-    static std::uintptr_t PtrToInt(void* p) {
+    static std::uintptr_t PtrToInt(const void* p) {
         return reinterpret_cast<std::uintptr_t>(p);
     }
 
     const size_t m_capacity;
     void* m_base = nullptr;
     size_t m_offset = 0;
+    size_t m_highWaterMark = 0;
+    uint32_t m_overflowCount = 0;
 };
 
 }  // namespace cave::memory
@@ -8,6 +8,7 @@
 #include "generated/tile_set_asset.generated.cpp"
 #include "generated/collider_component.generated.cpp"
 #include "generated/camera_component.generated.cpp"
+#include "generated/compressed_animation_clip.generated.cpp"
 #include "generated/light_component.generated.cpp"
 #include "generated/lua_script_component.generated.cpp"
 #include "generated/material_component.generated.cpp"
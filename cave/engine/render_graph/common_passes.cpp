@@ -12,6 +12,7 @@
 #include "engine/renderer/renderer_misc.h"
 #include "engine/renderer/sampler.h"
 #include "engine/runtime/display_manager.h"
+#include "draw_commands.h"
 #include "render_graph_defines.h"
 #include "render_pass_builder.h"
 
@@ -25,81 +26,6 @@ namespace cave {
 
 namespace cave {
 
-// @TODO: generalize this
-#if 0
-static void DrawInstacedGeometry(const RenderSystem& p_data, const std::vector<InstanceContext>& p_instances, bool p_is_prepass) {
-    unused(p_is_prepass);
-
-    CAVE_PROFILE_EVENT();
-
-    auto& gm = IGraphicsManager::GetSingleton();
-    auto& frame = gm.GetCurrentFrame();
-
-    for (const auto& instance : p_instances) {
-        DEV_ASSERT(instance.instanceBufferIndex >= 0);
-        gm.BindConstantBufferSlot<BoneConstantBuffer>(frame.boneCb.get(), instance.instanceBufferIndex);
-
-        gm.BindConstantBufferSlot<PerBatchConstantBuffer>(frame.batchCb.get(), instance.batchIdx);
-
-        gm.SetMesh(instance.gpuMesh);
-
-        const MaterialConstantBuffer& material = p_data.materialCache.buffer[instance.materialIdx];
-        gm.BindTexture(Dimension::TEXTURE_2D, material.c_baseColorMapHandle, GetBaseColorMapSlot());
-        gm.BindTexture(Dimension::TEXTURE_2D, material.c_normalMapHandle, GetNormalMapSlot());
-        gm.BindTexture(Dimension::TEXTURE_2D, material.c_materialMapHandle, GetMaterialMapSlot());
-
-        gm.BindConstantBufferSlot<MaterialConstantBuffer>(frame.materialCb.get(), instance.materialIdx);
-
-        gm.DrawElementsInstanced(instance.instanceCount,
-                                 instance.indexCount,
-                                 instance.indexOffset);
-    }
-}
-#endif
-
-static void ExecuteDrawCommands(RenderPassExcutionContext& p_ctx,
-                                const std::vector<RenderCommand>& p_commands,
-                                bool p_is_prepass = false) {
-    CAVE_PROFILE_EVENT();
-
-    // @TODO: remove
-    auto& gm = p_ctx.cmd;
-    auto& frame = gm.GetCurrentFrame();
-    for (const RenderCommand& cmd : p_commands) {
-        if (cmd.type != RenderCommandType::Draw) continue;
-        const DrawCommand& draw = cmd.draw;
-
-        const bool has_bone = draw.bone_idx >= 0;
-        if (has_bone) {
-            gm.BindConstantBufferSlot<BoneConstantBuffer>(frame.boneCb.get(), draw.bone_idx);
-        }
-
-        gm.BindConstantBufferSlot<PerBatchConstantBuffer>(frame.batchCb.get(), draw.batch_idx);
-
-        gm.SetMesh(draw.mesh_data);
-
-        // @TODO: instead of dowing this,
-        // set flag directly from draw.flags
-        if (p_is_prepass && draw.flags) {
-            gm.SetStencilRef(draw.flags);
-        }
-
-        if (draw.mat_idx != -1) {
-            const MaterialConstantBuffer& material = p_ctx.frameData.materialCache.buffer[draw.mat_idx];
-            gm.BindTexture(Dimension::TEXTURE_2D, material.c_baseColorMapHandle, GetBaseColorMapSlot());
-            gm.BindTexture(Dimension::TEXTURE_2D, material.c_normalMapHandle, GetNormalMapSlot());
-            gm.BindTexture(Dimension::TEXTURE_2D, material.c_materialMapHandle, GetMaterialMapSlot());
-
-            gm.BindConstantBufferSlot<MaterialConstantBuffer>(frame.materialCb.get(), draw.mat_idx);
-        }
-        gm.DrawElements(draw.index_count, draw.index_offset);
-
-        if (p_is_prepass && draw.flags) {
-            gm.SetStencilRef(0);
-        }
-    }
-}
-
 struct ScopedEvent {
     IRenderCmdContext& m_ctx;
 
@@ -132,7 +58,7 @@ static void EarlyZPassFunc(RenderPassExcutionContext& p_ctx) {
     const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
     cmd.Clear(fb, CLEAR_DEPTH_BIT | CLEAR_STENCIL_BIT, clear_color, 0.0f, STENCIL_FLAG_SKY);
 
-    if (p_ctx.frameData.prepass_commands.empty()) {
+    if (p_ctx.frameData.prepass_commands.IsEmpty()) {
         return;
     }
 
@@ -140,7 +66,7 @@ static void EarlyZPassFunc(RenderPassExcutionContext& p_ctx) {
     cmd.BindConstantBufferSlot<PerPassConstantBuffer>(frame.passCb.get(), pass.pass_idx);
 
     cmd.SetPipelineState(PSO_PREPASS);
-    ExecuteDrawCommands(p_ctx, p_ctx.frameData.prepass_commands, true);
+    ExecuteDrawCommands(cmd, p_ctx.frameData, p_ctx.frameData.prepass_commands, true);
 }
 
 void RenderGraphBuilderExt::AddEarlyZPass() {
@@ -173,7 +99,7 @@ static void GbufferPassFunc(RenderPassExcutionContext& p_ctx) {
 #endif
     cmd.Clear(fb, CLEAR_COLOR_BIT, clear_color);
 
-    if (p_ctx.frameData.gbuffer_commands.empty()) {
+    if (p_ctx.frameData.gbuffer_commands.IsEmpty()) {
         return;
     }
 
@@ -181,8 +107,7 @@ static void GbufferPassFunc(RenderPassExcutionContext& p_ctx) {
     cmd.BindConstantBufferSlot<PerPassConstantBuffer>(frame.passCb.get(), pass.pass_idx);
 
     cmd.SetPipelineState(PSO_GBUFFER);
-    ExecuteDrawCommands(p_ctx, p_ctx.frameData.gbuffer_commands, false);
-    // DrawInstacedGeometry(p_ctx.render_system, p_ctx.render_system.instances, false);
+    ExecuteDrawCommands(cmd, p_ctx.frameData, p_ctx.frameData.gbuffer_commands);
     cmd.SetPipelineState(PSO_GBUFFER_DOUBLE_SIDED);
 }
 
@@ -208,7 +133,7 @@ void RenderGraphBuilderExt::AddGbufferPass() {
 }
 
 // textures generated by program
-static std::shared_ptr<GpuTexture> GenerateSsaoNoise() {
+static std::shared_ptr<GpuTexture> GenerateSsaoNoise(IGraphicsManager& p_graphics_manager) {
     // generate noise texture
     std::vector<Vector2f> ssao_noise;
     for (int i = 0; i < (SSAO_NOISE_SIZE * SSAO_NOISE_SIZE); ++i) {
@@ -232,14 +157,14 @@ static std::shared_ptr<GpuTexture> GenerateSsaoNoise() {
         .name = RG_RES_SSAO,
     };
 
-    return GraphicsManager::GetSingleton().CreateTexture(desc, PointWrapSampler());
+    return p_graphics_manager.CreateTexture(desc, PointWrapSampler());
 }
 
-static void SsaoPassFunc(RenderPassExcutionContext& p_ctx) {
-    if (!p_ctx.frameData.options.ssaoEnabled) {
-        return;
-    }
+static bool SsaoPassCondition(const RenderOptions& p_options) {
+    return p_options.ssaoEnabled;
+}
 
+static void SsaoPassFunc(RenderPassExcutionContext& p_ctx) {
     RENDER_PASS_FUNC();
 
     auto& cmd = p_ctx.cmd;
@@ -263,14 +188,15 @@ void RenderGraphBuilderExt::AddSsaoPass() {
 
     auto& pass = AddPass(RG_PASS_SSAO);
     pass.Create(RG_RES_SSAO, { color0_desc })
-        .Import(RG_RES_SSAO_NOISE, []() {
-            return GenerateSsaoNoise();
+        .Import(RG_RES_SSAO_NOISE, [&manager = m_graphicsManager]() {
+            return GenerateSsaoNoise(manager);
         })
         .Write(ResourceAccess::RTV, RG_RES_SSAO)
         .Read(ResourceAccess::SRV, RG_RES_GBUFFER_COLOR1)
         .Read(ResourceAccess::SRV, RG_RES_DEPTH_STENCIL)
         .Read(ResourceAccess::SRV, RG_RES_SSAO_NOISE)
-        .SetExecuteFunc(SsaoPassFunc);
+        .SetExecuteFunc(SsaoPassFunc)
+        .SetCondition(SsaoPassCondition);
 }
 
 static void HighlightPassFunc(RenderPassExcutionContext& p_ctx) {
@@ -333,7 +259,7 @@ void RenderGraphBuilderExt::AddHighlightPass() {
             cmd.SetViewport(Viewport(width, height));
 
             cmd.SetPipelineState(PSO_POINT_SHADOW);
-            ExecuteDrawCommands(p_ctx, p_ctx.frameData.shadow_pass_commands, false);
+            ExecuteDrawCommands(cmd, p_ctx.frameData, p_ctx.frameData.shadow_pass_commands);
         }
     }
 }
@@ -350,7 +276,7 @@ static void ShadowPassFunc(RenderPassExcutionContext& p_ctx) {
 
     cmd.Clear(framebuffer, CLEAR_DEPTH_BIT);
 
-    if (p_ctx.frameData.shadow_pass_commands.empty()) {
+    if (p_ctx.frameData.shadow_pass_commands.IsEmpty()) {
         return;
     }
 
@@ -360,7 +286,7 @@ static void ShadowPassFunc(RenderPassExcutionContext& p_ctx) {
     cmd.BindConstantBufferSlot<PerPassConstantBuffer>(frame.passCb.get(), pass.pass_idx);
 
     cmd.SetPipelineState(PSO_DPETH);
-    ExecuteDrawCommands(p_ctx, p_ctx.frameData.shadow_pass_commands);
+    ExecuteDrawCommands(cmd, p_ctx.frameData, p_ctx.frameData.shadow_pass_commands);
 }
 
 void RenderGraphBuilderExt::AddShadowPass() {
@@ -400,7 +326,7 @@ static void VoxelizationPassFunc(RenderPassExcutionContext& p_ctx) {
         cmd.SetViewport(Viewport(voxel_size, voxel_size));
         cmd.SetPipelineState(PSO_VOXELIZATION);
         cmd.SetBlendState(PipelineStateManager::GetBlendDescDisable(), nullptr, 0xFFFFFFFF);
-        ExecuteDrawCommands(p_ctx, p_ctx.frameData.voxelization_commands);
+        ExecuteDrawCommands(cmd, p_ctx.frameData, p_ctx.frameData.voxelization_commands);
 
         // glSubpixelPrecisionBiasNV(0, 0);
         cmd.SetBlendState(PipelineStateManager::GetBlendDescDefault(), nullptr, 0xFFFFFFFF);
@@ -436,8 +362,9 @@ void RenderGraphBuilderExt::AddVoxelizationPass() {
     SamplerDesc sampler(MinFilter::LINEAR_MIPMAP_LINEAR, MagFilter::POINT, AddressMode::BORDER);
 
     auto& pass = AddPass(RG_PASS_VOXELIZATION);
-    pass.Create(RG_RES_VOXEL_LIGHTING, { desc, sampler })
-        .Create(RG_RES_VOXEL_NORMAL, { desc, sampler })
+    // voxels are only revoxelized when the scene changes
+    pass.Create(RG_RES_VOXEL_LIGHTING, { desc, sampler, true })
+        .Create(RG_RES_VOXEL_NORMAL, { desc, sampler, true })
         .Read(ResourceAccess::SRV, RG_RES_SHADOW_MAP)
         //.Read(ResourceAccess::SRV, RG_RES_LTC1)
         //.Read(ResourceAccess::SRV, RG_RES_LTC2)
@@ -536,7 +463,7 @@ static void LightingPassFunc(RenderPassExcutionContext& p_ctx) {
     cmd.DrawArrays(6);
 }
 
-static std::shared_ptr<GpuTexture> GenerateLTC(std::string_view p_name, const float* p_matrix_table) {
+static std::shared_ptr<GpuTexture> GenerateLTC(IGraphicsManager& p_graphics_manager, std::string_view p_name, const float* p_matrix_table) {
     constexpr int LTC_SIZE = 64;
     GpuTextureDesc desc{
         .type = AttachmentType::NONE,
@@ -553,7 +480,7 @@ static std::shared_ptr<GpuTexture> GenerateLTC(std::string_view p_name, const fl
         .name = std::string(p_name),
     };
 
-    return GraphicsManager::GetSingleton().CreateTexture(desc, PointClampSampler());
+    return p_graphics_manager.CreateTexture(desc, PointClampSampler());
 }
 
 void RenderGraphBuilderExt::AddLightingPass() {
@@ -562,16 +489,16 @@ void RenderGraphBuilderExt::AddLightingPass() {
 
     auto& pass = AddPass(RG_PASS_LIGHTING);
     // @TODO: dynamic
-    pass.Import(RG_RES_BRDF, []() {
+    pass.Import(RG_RES_BRDF, [&manager = m_graphicsManager]() {
             auto handle = AssetRegistry::GetSingleton().FindByPath<ImageAsset>("@res://images/brdf.hdr");
             auto image = handle.unwrap().Wait();
-            return GraphicsManager::GetSingleton().CreateTexture(image.get());
+            return manager.CreateTexture(image.get());
         })
-        .Import(RG_RES_LTC1, []() {
-            return GenerateLTC(RG_RES_LTC1, LTC1);
+        .Import(RG_RES_LTC1, [&manager = m_graphicsManager]() {
+            return GenerateLTC(manager, RG_RES_LTC1, LTC1);
         })
-        .Import(RG_RES_LTC2, []() {
-            return GenerateLTC(RG_RES_LTC2, LTC2);
+        .Import(RG_RES_LTC2, [&manager = m_graphicsManager]() {
+            return GenerateLTC(manager, RG_RES_LTC2, LTC2);
         })
         .Create(RG_RES_LIGHTING, { lighting_desc })
         .Write(ResourceAccess::RTV, RG_RES_LIGHTING)
@@ -620,7 +547,7 @@ static void ForwardPassFunc(RenderPassExcutionContext& p_ctx) {
 
     // draw transparent objects
     gm.SetPipelineState(PSO_FORWARD_TRANSPARENT);
-    ExecuteDrawCommands(p_ctx, p_ctx.frameData.transparent_commands);
+    ExecuteDrawCommands(gm, p_ctx.frameData, p_ctx.frameData.transparent_commands);
 
     EmitterPassFunc(p_ctx);
 }
@@ -646,11 +573,11 @@ void RenderGraphBuilderExt::AddForwardPass() {
 }
 
 /// Bloom
-static void BloomSetupFunc(RenderPassExcutionContext& p_ctx) {
-    if (!p_ctx.frameData.options.bloomEnabled) {
-        return;
-    }
+static bool BloomPassCondition(const RenderOptions& p_options) {
+    return p_options.bloomEnabled;
+}
 
+static void BloomSetupFunc(RenderPassExcutionContext& p_ctx) {
     RENDER_PASS_FUNC();
 
     auto& cmd = p_ctx.cmd;
@@ -666,10 +593,6 @@ static void BloomSetupFunc(RenderPassExcutionContext& p_ctx) {
 }
 
 static void BloomDownSampleFunc(RenderPassExcutionContext& p_ctx) {
-    if (!p_ctx.frameData.options.bloomEnabled) {
-        return;
-    }
-
     RENDER_PASS_FUNC();
 
     auto& cmd = p_ctx.cmd;
@@ -685,10 +608,6 @@ static void BloomDownSampleFunc(RenderPassExcutionContext& p_ctx) {
 }
 
 static void BloomUpSampleFunc(RenderPassExcutionContext& p_ctx) {
-    if (!p_ctx.frameData.options.bloomEnabled) {
-        return;
-    }
-
     RENDER_PASS_FUNC();
 
     auto& cmd = p_ctx.cmd;
@@ -730,7 +649,8 @@ void RenderGraphBuilderExt::AddBloomPass() {
     setup_pass
         .Read(ResourceAccess::SRV, RG_RES_LIGHTING)
         .Read(ResourceAccess::UAV, bloom_res)
-        .SetExecuteFunc(BloomSetupFunc);
+        .SetExecuteFunc(BloomSetupFunc)
+        .SetCondition(BloomPassCondition);
 
     // Down Sample
     for (int i = 0, w = width, h = height; i < BLOOM_MIP_CHAIN_MAX - 1; ++i, w /= 2, h /= 2) {
@@ -740,7 +660,8 @@ void RenderGraphBuilderExt::AddBloomPass() {
         auto& pass = AddPass(pass_name);
         pass.Read(ResourceAccess::SRV, input)
             .Read(ResourceAccess::UAV, inout)
-            .SetExecuteFunc(BloomDownSampleFunc);
+            .SetExecuteFunc(BloomDownSampleFunc)
+            .SetCondition(BloomPassCondition);
         if (i == 0) {
             AddDependency(RG_PASS_BLOOM_SETUP, pass_name);
         } else {
@@ -758,7 +679,8 @@ void RenderGraphBuilderExt::AddBloomPass() {
         auto& pass = AddPass(pass_name);
         pass.Read(ResourceAccess::UAV, mip)
             .Read(ResourceAccess::SRV, mip_low)
-            .SetExecuteFunc(BloomUpSampleFunc);
+            .SetExecuteFunc(BloomUpSampleFunc)
+            .SetCondition(BloomPassCondition);
 
         if (i == BLOOM_MIP_CHAIN_MAX - 2) {
             auto down_sample_pass = std::format(RG_PASS_BLOOM_DOWN_PREFIX "{}", BLOOM_MIP_CHAIN_MAX - 2);
@@ -830,7 +752,8 @@ void RenderGraphBuilderExt::AddPostProcessPass() {
 
     AddDependency(RG_PASS_BLOOM_UP_PREFIX "0", RG_PASS_POST_PROCESS);
     auto& pass = AddPass(RG_PASS_POST_PROCESS);
-    pass.Create(RG_RES_POST_PROCESS, { desc })
+    // the final image, displayed after the graph ran
+    pass.Create(RG_RES_POST_PROCESS, { desc, PointClampSampler(), true })
         .Read(ResourceAccess::SRV, RG_RES_LIGHTING)
         .Read(ResourceAccess::SRV, RG_RES_OUTLINE)
         .Read(ResourceAccess::SRV, bloom_res);
@@ -932,12 +855,13 @@ void RenderGraphBuilderExt::AddGenerateSkylightPass() {
                                                       IBL_MIP_CHAIN_MAX);
 
         auto& pass = AddPass(RG_PASS_BAKE_SKYBOX);
-        pass.Import(RG_RES_IBL, []() {
+        pass.Import(RG_RES_IBL, [&manager = m_graphicsManager]() {
                 auto handle = AssetRegistry::GetSingleton().FindByPath<ImageAsset>("@res://images/sky.hdr");
                 auto image = handle.unwrap().Wait();
-                return GraphicsManager::GetSingleton().CreateTexture(image.get());
+                return manager.CreateTexture(image.get());
             })
-            .Create(RG_RES_ENV_SKYBOX_CUBE, { desc, CubemapSampler() })
+            // baked once, read every frame
+            .Create(RG_RES_ENV_SKYBOX_CUBE, { desc, CubemapSampler(), true })
             .Read(ResourceAccess::SRV, RG_RES_IBL)
             .Write(ResourceAccess::RTV, RG_RES_ENV_SKYBOX_CUBE)
             .SetExecuteFunc(ConvertToCubemapFunc);
@@ -950,7 +874,7 @@ void RenderGraphBuilderExt::AddGenerateSkylightPass() {
                                                       6);
 
         auto& pass = AddPass(RG_PASS_BAKE_DIFFUSE);
-        pass.Create(RG_RES_ENV_DIFFUSE_CUBE, { desc, CubemapNoMipSampler() })
+        pass.Create(RG_RES_ENV_DIFFUSE_CUBE, { desc, CubemapNoMipSampler(), true })
             .Read(ResourceAccess::SRV, RG_RES_ENV_SKYBOX_CUBE)
             .Write(ResourceAccess::RTV, RG_RES_ENV_DIFFUSE_CUBE)
             .SetExecuteFunc(DiffuseIrradianceFunc);
@@ -965,7 +889,7 @@ void RenderGraphBuilderExt::AddGenerateSkylightPass() {
                                                       IBL_MIP_CHAIN_MAX);
 
         auto& pass = AddPass(RG_PASS_BAKE_PREFILTERED);
-        pass.Create(RG_RES_ENV_PREFILTERED_CUBE, { desc, CubemapLodSampler() })
+        pass.Create(RG_RES_ENV_PREFILTERED_CUBE, { desc, CubemapLodSampler(), true })
             .Read(ResourceAccess::SRV, RG_RES_ENV_SKYBOX_CUBE)
             .Write(ResourceAccess::RTV, RG_RES_ENV_PREFILTERED_CUBE)
             .SetExecuteFunc(PrefilteredFunc);
@@ -1003,7 +927,8 @@ void RenderGraphBuilderExt::AddPathTracerPass() {
                                                           AttachmentType::COLOR_2D);
 
     auto& pass = AddPass(RG_PASS_PATHTRACER);
-    pass.Create(RG_RES_PATHTRACER, { texture_desc, LinearClampSampler() })
+    // accumulates samples across frames
+    pass.Create(RG_RES_PATHTRACER, { texture_desc, LinearClampSampler(), true })
         .Read(ResourceAccess::UAV, RG_RES_PATHTRACER)
         .SetExecuteFunc(PathTracerPassFunc);
 }
@@ -1040,11 +965,15 @@ void RenderGraphBuilderExt::AddPathTracerTonePass() {
 
 /// Create pre-defined passes
 auto RenderGraphBuilderExt::Create3D(RenderGraphBuilderConfig& p_config) -> Result<std::shared_ptr<RenderGraph>> {
+    return Create3D(p_config, GraphicsManager::GetSingleton());
+}
+
+auto RenderGraphBuilderExt::Create3D(RenderGraphBuilderConfig& p_config, IGraphicsManager& p_graphics_manager) -> Result<std::shared_ptr<RenderGraph>> {
     p_config.enableBloom = true;
     p_config.enableIbl = false;
-    p_config.enableVxgi = GraphicsManager::GetSingleton().GetBackend() == Backend::OPENGL;
+    p_config.enableVxgi = p_graphics_manager.GetBackend() == Backend::OPENGL;
 
-    RenderGraphBuilderExt builder(p_config);
+    RenderGraphBuilderExt builder(p_config, p_graphics_manager);
 
     builder.AddEarlyZPass();
     builder.AddGbufferPass();
@@ -1057,6 +986,7 @@ auto RenderGraphBuilderExt::Create3D(RenderGraphBuilderConfig& p_config) -> Resu
     builder.AddForwardPass();
     builder.AddBloomPass();
     builder.AddPostProcessPass();
+    builder.AddOutput(RG_RES_POST_PROCESS);
 
     return builder.Compile();
 }
@@ -1071,6 +1001,7 @@ auto RenderGraphBuilderExt::CreatePathTracer(RenderGraphBuilderConfig& p_config)
 
     creator.AddPathTracerPass();
     creator.AddPathTracerTonePass();
+    creator.AddOutput(RG_RES_POST_PROCESS);
 
     return creator.Compile();
 }
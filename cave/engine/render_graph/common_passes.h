@@ -5,8 +5,12 @@ namespace cave {
 
 class RenderGraphBuilderExt : public RenderGraphBuilder {
 public:
+    using RenderGraphBuilder::RenderGraphBuilder;
+
     // @TODO: create 2D
     [[nodiscard]] static auto Create3D(RenderGraphBuilderConfig& p_config) -> Result<std::shared_ptr<RenderGraph>>;
+    // resources are created on p_graphics_manager instead of the graphics manager of the application
+    [[nodiscard]] static auto Create3D(RenderGraphBuilderConfig& p_config, IGraphicsManager& p_graphics_manager) -> Result<std::shared_ptr<RenderGraph>>;
     [[nodiscard]] static auto CreatePathTracer(RenderGraphBuilderConfig& p_config) -> Result<std::shared_ptr<RenderGraph>>;
 
 private:
@@ -0,0 +1,173 @@
+#include "draw_commands.h"
+
+#include "engine/debugger/profiler.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/graphics_manager.h"
+
+namespace cave {
+#include "shader_resource_defines.hlsl.h"
+}  // namespace cave
+
+namespace cave {
+
+static bool CanInstance(const DrawCommand& p_draw) {
+    return p_draw.bone_offset < 0 && p_draw.instance_count == 1 && p_draw.mesh_data;
+}
+
+static bool IsSameInstance(const DrawCommand& p_lhs, const DrawCommand& p_rhs) {
+    return p_lhs.mesh_data == p_rhs.mesh_data &&
+           p_lhs.mat_idx == p_rhs.mat_idx &&
+           p_lhs.index_count == p_rhs.index_count &&
+           p_lhs.index_offset == p_rhs.index_offset &&
+           p_lhs.flags == p_rhs.flags;
+}
+
+static const PerBatchConstantBuffer& GetBatch(const FrameData& p_framedata,
+                                             const SceneBuffer<PerBatchConstantBuffer>* p_scene_batches,
+                                             int p_batch_idx) {
+    if (p_batch_idx < static_cast<int>(TRANSIENT_BATCH_COUNT)) {
+        DEV_ASSERT_INDEX(p_batch_idx, p_framedata.batchCache.buffer.size());
+        return p_framedata.batchCache.buffer[p_batch_idx];
+    }
+    DEV_ASSERT(p_scene_batches);
+    return p_scene_batches->Get(p_batch_idx - TRANSIENT_BATCH_COUNT);
+}
+
+void MergeInstancedDraws(RenderCommandList& p_commands,
+                         FrameData& p_framedata,
+                         const SceneBuffer<PerBatchConstantBuffer>* p_scene_batches) {
+    CAVE_PROFILE_EVENT();
+
+    const auto& commands = p_commands.GetCommands();
+    const auto& order = p_commands.GetOrder();
+    auto& instance_rows = p_framedata.instanceRows;
+
+    RenderCommandList merged(p_commands.GetArena());
+    merged.Reserve(order.size());
+    for (size_t begin = 0; begin < order.size();) {
+        const RenderCommand& first = commands[order[begin]];
+        size_t end = begin + 1;
+        if (first.type == RenderCommandType::Draw && CanInstance(first.draw)) {
+            while (end < order.size()) {
+                const RenderCommand& next = commands[order[end]];
+                if (next.type != RenderCommandType::Draw || !CanInstance(next.draw) || !IsSameInstance(first.draw, next.draw)) {
+                    break;
+                }
+                ++end;
+            }
+        }
+
+        // one instanced draw per MAX_BONE_COUNT world matrices, a lone draw is kept as it is
+        for (size_t chunk = begin; chunk < end; chunk += MAX_BONE_COUNT) {
+            const uint32_t count = static_cast<uint32_t>(std::min<size_t>(end - chunk, MAX_BONE_COUNT));
+            // chunks start on a bindable offset, like the palette ranges
+            const uint32_t row_offset = Align(static_cast<uint32_t>(instance_rows.size()), BonePalette::ROW_ALIGNMENT);
+            const uint32_t row_count = count * BonePalette::ROWS_PER_BONE;
+            if (count == 1 || row_offset + row_count > BONE_INSTANCE_ROW_COUNT) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    merged.Add(commands[order[chunk + i]]);
+                }
+                continue;
+            }
+
+            if (p_framedata.instanceBatchIdx < 0) {
+                PerBatchConstantBuffer batch_buffer;
+                batch_buffer.c_worldMatrix = Matrix4x4f(1.0f);
+                batch_buffer.c_meshFlag = MESH_HAS_INSTANCE;
+                p_framedata.instanceBatchIdx = p_framedata.AddTransientBatch(batch_buffer);
+            }
+            if (p_framedata.instanceBatchIdx < 0) {
+                // no transient slot left for the instance batch, the draws aren't merged
+                for (uint32_t i = 0; i < count; ++i) {
+                    merged.Add(commands[order[chunk + i]]);
+                }
+                continue;
+            }
+
+            instance_rows.resize(row_offset + row_count, Vector4f(0.0f));
+            for (uint32_t i = 0; i < count; ++i) {
+                const DrawCommand& draw = commands[order[chunk + i]].draw;
+                BonePalette::StoreMatrix(GetBatch(p_framedata, p_scene_batches, draw.batch_idx).c_worldMatrix,
+                                         instance_rows.data() + row_offset + i * BonePalette::ROWS_PER_BONE);
+            }
+
+            DrawCommand draw = first.draw;
+            draw.instance_count = count;
+            draw.bone_offset = static_cast<int>(p_framedata.instanceRowOffset + row_offset);
+            draw.bone_row_count = static_cast<uint16_t>(row_count);
+            draw.batch_idx = p_framedata.instanceBatchIdx;
+            merged.Add(RenderCommand::From(draw));
+        }
+
+        begin = end;
+    }
+
+    p_commands = std::move(merged);
+}
+
+// GL wants the bound range to cover the whole uniform block, the other backends only need the rows
+// of the range, rounded to the 256 byte constant buffer granularity
+static uint32_t BoneBindSize(const FrameData& p_framedata, const DrawCommand& p_draw) {
+    if (p_framedata.options.isOpengl) {
+        return sizeof(BoneConstantBuffer);
+    }
+    return Align<uint32_t>(p_draw.bone_row_count, BonePalette::ROW_ALIGNMENT) * sizeof(Vector4f);
+}
+
+void ExecuteDrawCommands(IRenderCmdContext& p_cmd,
+                         const FrameData& p_framedata,
+                         const RenderCommandList& p_commands,
+                         bool p_is_prepass) {
+    CAVE_PROFILE_EVENT();
+
+    auto& frame = p_cmd.GetCurrentFrame();
+    const auto& commands = p_commands.GetCommands();
+
+    // commands are sorted by state, the graphics manager drops the binds that didn't change.
+    // the stencil reference isn't cached there
+    uint32_t bound_stencil = 0;
+
+    for (uint32_t index : p_commands.GetOrder()) {
+        const RenderCommand& cmd = commands[index];
+        if (cmd.type != RenderCommandType::Draw) continue;
+        const DrawCommand& draw = cmd.draw;
+
+        if (draw.bone_offset >= 0) {
+            p_cmd.BindConstantBufferRange(frame.boneCb.get(),
+                                          BoneBindSize(p_framedata, draw),
+                                          draw.bone_offset * sizeof(Vector4f));
+        }
+
+        p_cmd.BindConstantBufferSlot<PerBatchConstantBuffer>(frame.batchCb.get(), draw.batch_idx);
+
+        p_cmd.SetMesh(draw.mesh_data);
+
+        // @TODO: instead of dowing this,
+        // set flag directly from draw.flags
+        if (p_is_prepass && draw.flags != bound_stencil) {
+            p_cmd.SetStencilRef(draw.flags);
+            bound_stencil = draw.flags;
+        }
+
+        if (draw.mat_idx != -1) {
+            const MaterialConstantBuffer& material = p_framedata.materials[draw.mat_idx];
+            p_cmd.BindTexture(Dimension::TEXTURE_2D, material.c_baseColorMapHandle, GetBaseColorMapSlot());
+            p_cmd.BindTexture(Dimension::TEXTURE_2D, material.c_normalMapHandle, GetNormalMapSlot());
+            p_cmd.BindTexture(Dimension::TEXTURE_2D, material.c_materialMapHandle, GetMaterialMapSlot());
+
+            p_cmd.BindConstantBufferSlot<MaterialConstantBuffer>(frame.materialCb.get(), draw.mat_idx);
+        }
+
+        if (draw.instance_count > 1) {
+            p_cmd.DrawElementsInstanced(draw.instance_count, draw.index_count, draw.index_offset);
+        } else {
+            p_cmd.DrawElements(draw.index_count, draw.index_offset);
+        }
+    }
+
+    if (bound_stencil) {
+        p_cmd.SetStencilRef(0);
+    }
+}
+
+}  // namespace cave
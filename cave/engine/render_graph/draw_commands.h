@@ -0,0 +1,25 @@
+#pragma once
+#include "render_pass.h"
+
+namespace cave {
+
+struct PerBatchConstantBuffer;
+template<typename T>
+class SceneBuffer;
+
+// Merges runs of sorted draws that only differ in their world matrix into instanced draws. The
+// world matrices of each instanced draw are appended to p_framedata.instanceRows and read through
+// the bone slot, so skinned draws are never merged. Batches past TRANSIENT_BATCH_COUNT are read
+// from p_scene_batches.
+void MergeInstancedDraws(RenderCommandList& p_commands,
+                         FrameData& p_framedata,
+                         const SceneBuffer<PerBatchConstantBuffer>* p_scene_batches = nullptr);
+
+// Draws p_commands in the order of their sort keys. Mesh, bone and material binds that are already
+// current are dropped by the graphics manager, stencil changes are skipped here.
+void ExecuteDrawCommands(IRenderCmdContext& p_cmd,
+                         const FrameData& p_framedata,
+                         const RenderCommandList& p_commands,
+                         bool p_is_prepass = false);
+
+}  // namespace cave
@@ -1,5 +1,9 @@
 #include "render_graph.h"
 
+#include "engine/renderer/frame_data.h"
+#include "engine/runtime/graphics_manager_interface.h"
+#include "engine/systems/job_system/job_system.h"
+
 namespace cave {
 
 void RenderGraph::AddResource(const std::string& p_name, const std::shared_ptr<GpuTexture>& p_resource) {
@@ -33,9 +37,107 @@ RenderPass* RenderGraph::FindPass(const std::string& p_name) {
 }
 
 void RenderGraph::Execute(const FrameData& p_data, IGraphicsManager& p_graphics_manager) {
-    for (auto pass : m_renderPasses) {
-        pass->Execute(p_data, p_graphics_manager);
+    const Schedule& schedule = FindSchedule(p_data.options);
+
+    for (const auto& level : schedule.levels) {
+#if USING(ENABLE_JOB_SYSTEM)
+        const int context_count = p_graphics_manager.GetRecordingContextCount();
+        const int pass_count = static_cast<int>(level.size());
+        // passes of a level don't touch each other's textures, every job records on its own context
+        if (context_count > 1 && pass_count > 1) {
+            for (int first = 0; first < pass_count; first += context_count) {
+                jobsystem::Context ctx;
+                ctx.Dispatch(static_cast<uint32_t>(glm::min(context_count, pass_count - first)), 1, [&](jobsystem::JobArgs p_args) {
+                    const int job = static_cast<int>(p_args.jobIndex);
+                    IRenderCmdContext& cmd = p_graphics_manager.BeginRecording(job);
+                    m_renderPasses[level[first + job]]->Execute(p_data, cmd);
+                });
+                ctx.Wait();
+            }
+            continue;
+        }
+#endif
+
+        for (int idx : level) {
+            m_renderPasses[idx]->Execute(p_data, p_graphics_manager);
+        }
+    }
+}
+
+const std::vector<int>& RenderGraph::GetSchedule(const RenderOptions& p_options) {
+    return FindSchedule(p_options).passes;
+}
+
+auto RenderGraph::FindSchedule(const RenderOptions& p_options) -> const Schedule& {
+    uint64_t key = 0;
+    int bit = 0;
+    for (const auto& pass : m_renderPasses) {
+        if (pass->m_condition) {
+            key |= uint64_t(pass->m_condition(p_options)) << bit++;
+        }
+    }
+
+    auto [it, inserted] = m_schedules.try_emplace(key);
+    Schedule& schedule = it->second;
+    if (!inserted) {
+        return schedule;
+    }
+
+    const int count = static_cast<int>(m_renderPasses.size());
+    std::vector<bool> enabled(count, true);
+    bit = 0;
+    for (int i = 0; i < count; ++i) {
+        if (m_renderPasses[i]->m_condition) {
+            enabled[i] = (key >> bit++) & 1;
+        }
+    }
+
+    const std::vector<bool> live = FindLivePasses(m_passInputs, m_outputPasses, enabled);
+    for (int i = 0; i < count; ++i) {
+        if (live[i]) {
+            schedule.passes.push_back(i);
+        }
+    }
+    for (const auto& level : m_levels) {
+        std::vector<int> passes;
+        for (int idx : level.passes) {
+            if (live[idx]) {
+                passes.push_back(idx);
+            }
+        }
+        if (!passes.empty()) {
+            schedule.levels.emplace_back(std::move(passes));
+        }
+    }
+    return schedule;
+}
+
+std::vector<bool> RenderGraph::FindLivePasses(const std::vector<std::vector<int>>& p_inputs,
+                                              const std::vector<bool>& p_outputs,
+                                              const std::vector<bool>& p_enabled) {
+    const int count = static_cast<int>(p_inputs.size());
+    DEV_ASSERT(p_outputs.size() == p_inputs.size() && p_enabled.size() == p_inputs.size());
+
+    std::vector<bool> live(count, false);
+    std::vector<int> stack;
+    for (int i = 0; i < count; ++i) {
+        if (p_outputs[i] && p_enabled[i]) {
+            live[i] = true;
+            stack.push_back(i);
+        }
+    }
+
+    while (!stack.empty()) {
+        const int idx = stack.back();
+        stack.pop_back();
+        for (int input : p_inputs[idx]) {
+            if (p_enabled[input] && !live[input]) {
+                live[input] = true;
+                stack.push_back(input);
+            }
+        }
     }
+    return live;
 }
 
 }  // namespace cave
@@ -1,6 +1,7 @@
 #pragma once
 #include "engine/core/base/noncopyable.h"
 #include "render_pass.h"
+#include "render_pass_builder.h"
 
 namespace cave {
 
@@ -21,6 +22,35 @@ enum class RenderGraphName : uint8_t {
 namespace cave {
 
 struct FrameData;
+struct RenderOptions;
+
+// A resource created by the graph, passes are counted in execution order.
+struct RenderGraphResourceInfo {
+    std::string name;
+    int firstPass;
+    int lastPass;
+    // transient resources with the same description and lifetimes that don't overlap share a texture
+    int textureIdx;
+    uint64_t sizeInByte;
+    bool persistent;
+};
+
+struct RenderGraphMemoryStats {
+    // every resource with a texture of its own
+    uint64_t dedicatedBytes = 0;
+    // the textures that were created
+    uint64_t allocatedBytes = 0;
+    // largest sum of the resources alive during one pass, what a shared heap would need
+    uint64_t peakLiveBytes = 0;
+    uint32_t resourceCount = 0;
+    uint32_t textureCount = 0;
+};
+
+// Passes without edges between them. Execute() records the passes of a level concurrently when the
+// backend has recording contexts, and waits for a level before starting the next.
+struct RenderGraphLevel {
+    std::vector<int> passes;
+};
 
 class RenderGraph : public NonCopyable {
 public:
@@ -35,17 +65,52 @@ public:
     void AddPass(const std::string& p_name, const std::shared_ptr<RenderPass>& p_pass);
     RenderPass* FindPass(const std::string& p_name);
 
+    // runs the scheduled passes level by level
     void Execute(const FrameData& p_data, IGraphicsManager& p_graphics_manager);
 
+    // The passes that run with p_options, indices into GetRenderPasses(). Conditional passes that
+    // are off and the passes only they need are skipped. Schedules are cached per combination of
+    // conditions, toggling an option doesn't touch the compiled graph.
+    const std::vector<int>& GetSchedule(const RenderOptions& p_options);
+
+    // A pass is live when it is enabled and writes an output or a live pass needs it.
+    // p_inputs holds the passes every pass needs.
+    static std::vector<bool> FindLivePasses(const std::vector<std::vector<int>>& p_inputs,
+                                            const std::vector<bool>& p_outputs,
+                                            const std::vector<bool>& p_enabled);
+
     const auto& GetRenderPasses() const { return m_renderPasses; }
+    const auto& GetCulledPasses() const { return m_culledPasses; }
+    const auto& GetLevels() const { return m_levels; }
+    const auto& GetResourceInfos() const { return m_resourceInfos; }
+    const RenderGraphMemoryStats& GetMemoryStats() const { return m_memoryStats; }
 
 private:
+    struct Schedule {
+        std::vector<int> passes;
+        // the levels with the passes of the schedule, levels left without passes are dropped
+        std::vector<std::vector<int>> levels;
+    };
+
+    const Schedule& FindSchedule(const RenderOptions& p_options);
+
     std::vector<std::shared_ptr<RenderPass>> m_renderPasses;
     std::map<std::string, int> m_renderPassLookup;
 
     std::vector<std::shared_ptr<GpuTexture>> m_resources;
     std::map<std::string, int> m_resourceLookup;
 
+    std::vector<RenderGraphResourceInfo> m_resourceInfos;
+    RenderGraphMemoryStats m_memoryStats;
+
+    std::vector<std::vector<int>> m_passInputs;
+    std::vector<bool> m_outputPasses;
+    // passes that never lead to an output, dropped when compiling
+    std::vector<std::string> m_culledPasses;
+    std::vector<RenderGraphLevel> m_levels;
+    // keyed by the results of the conditions, one bit per conditional pass
+    std::unordered_map<uint64_t, Schedule> m_schedules;
+
     friend class RenderGraphBuilder;
 };
 
@@ -81,11 +81,12 @@ auto RenderGraph2D(RenderGraphBuilderConfig& p_config) -> Result<std::shared_ptr
                                                       AttachmentType::DEPTH_STENCIL_2D);
 
     auto& pass = builder.AddPass(RG_PASS_2D);
-    pass.Create(RG_RES_POST_PROCESS, { color_desc })
+    pass.Create(RG_RES_POST_PROCESS, { color_desc, PointClampSampler(), true })
         .Create(RG_RES_DEPTH_STENCIL, { depth_desc })
         .Write(ResourceAccess::RTV, RG_RES_POST_PROCESS)
         .Write(ResourceAccess::DSV, RG_RES_DEPTH_STENCIL)
         .SetExecuteFunc(Pass2DDrawFunc);
+    builder.AddOutput(RG_RES_POST_PROCESS);
 
     return builder.Compile();
 }
@@ -11,7 +11,40 @@
 namespace cave {
 
 RenderGraphBuilder::RenderGraphBuilder(const RenderGraphBuilderConfig& p_config)
-    : m_config(p_config), m_graphicsManager(GraphicsManager::GetSingleton()) {
+    : RenderGraphBuilder(p_config, GraphicsManager::GetSingleton()) {
+}
+
+RenderGraphBuilder::RenderGraphBuilder(const RenderGraphBuilderConfig& p_config, IGraphicsManager& p_graphics_manager)
+    : m_config(p_config), m_graphicsManager(p_graphics_manager) {
+}
+
+// the memory a texture would take without compression or alignment
+static uint64_t EstimateTextureSize(const GpuTextureDesc& p_desc) {
+    uint64_t width = glm::max(p_desc.width, 1u);
+    uint64_t height = glm::max(p_desc.height, 1u);
+    uint64_t depth = p_desc.dimension == Dimension::TEXTURE_3D ? glm::max(p_desc.depth, 1u) : 1;
+
+    uint64_t texel_count = 0;
+    for (uint32_t mip = 0; mip < glm::max(p_desc.mipLevels, 1u); ++mip) {
+        texel_count += width * height * depth;
+        width = glm::max<uint64_t>(width / 2, 1);
+        height = glm::max<uint64_t>(height / 2, 1);
+        depth = glm::max<uint64_t>(depth / 2, 1);
+    }
+    return texel_count * glm::max(p_desc.arraySize, 1u) * PixelSize(p_desc.format);
+}
+
+// bind flags are merged, the rest has to match for two resources to use the same texture
+static bool IsSameLayout(const GpuTextureDesc& p_lhs, const GpuTextureDesc& p_rhs) {
+    return p_lhs.type == p_rhs.type &&
+           p_lhs.dimension == p_rhs.dimension &&
+           p_lhs.width == p_rhs.width &&
+           p_lhs.height == p_rhs.height &&
+           p_lhs.depth == p_rhs.depth &&
+           p_lhs.mipLevels == p_rhs.mipLevels &&
+           p_lhs.arraySize == p_rhs.arraySize &&
+           p_lhs.format == p_rhs.format &&
+           p_lhs.miscFlags == p_rhs.miscFlags;
 }
 
 RenderPassBuilder& RenderGraphBuilder::AddPass(std::string_view p_pass_name) {
@@ -24,6 +57,10 @@ void RenderGraphBuilder::AddDependency(std::string_view p_from, std::string_view
     m_dependencies.emplace_back(std::make_pair(p_from, p_to));
 }
 
+void RenderGraphBuilder::AddOutput(std::string_view p_resource) {
+    m_outputs.emplace_back(p_resource);
+}
+
 auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
 
 #define DEBUG_BUILDER NOT_IN_USE
@@ -53,17 +90,14 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
 
     std::unordered_map<std::string_view, int> lookup;
 
-    std::vector<std::pair<std::string_view, int>> reads;
-    std::vector<std::pair<std::string_view, int>> writes;
-
-    std::unordered_map<std::string_view, int> creates;
-
-    const int N = static_cast<int>(m_passes.size());
-    DEV_ASSERT(N);
-
-    std::unordered_map<std::string_view, ResourceAccess> accesses;
+    const int pass_count = static_cast<int>(m_passes.size());
+    DEV_ASSERT(pass_count);
 
-    for (int i = 0; i < N; ++i) {
+    // passes that create, import or write a resource
+    std::unordered_map<std::string_view, std::vector<int>> producers;
+    std::unordered_set<std::string_view> created;
+    int condition_count = 0;
+    for (int i = 0; i < pass_count; ++i) {
         const auto& pass = m_passes[i];
         {
             auto [_, inserted] = lookup.try_emplace(pass.m_name, i);
@@ -73,26 +107,31 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
         }
 
         for (const auto& create : pass.m_creates) {
-            auto [_, inserted] = creates.try_emplace(std::string_view(create.first), i);
-            if (!inserted) {
+            if (!created.insert(create.first).second) {
                 return CAVE_ERROR(ErrorCode::ERR_ALREADY_EXISTS, "resource '{}' is created multiple times", create.first);
             }
+            producers[create.first].push_back(i);
+        }
+        for (const auto& import : pass.m_imports) {
+            producers[import.first].push_back(i);
         }
-
-        // @TODO: figure out what access to give to resource
         for (const auto& read : pass.m_reads) {
-            reads.push_back(std::make_pair(std::string_view(read.name), i));
-            accesses[read.name] |= read.access;
+            if (read.access == ResourceAccess::UAV) {
+                producers[read.name].push_back(i);
+            }
         }
         for (const auto& write : pass.m_writes) {
-            writes.push_back(std::make_pair(std::string_view(write.name), i));
-            accesses[write.name] |= write.access;
+            producers[write.name].push_back(i);
         }
+        condition_count += pass.m_condition != nullptr;
     }
 
-    std::vector<std::pair<int, int>> edges;
-    edges.reserve(m_dependencies.size());
-    // add manual dependencies
+    if (condition_count > 64) {
+        return CAVE_ERROR(ErrorCode::ERR_INVALID_DATA, "{} conditional passes, at most 64 are supported", condition_count);
+    }
+
+    std::vector<std::pair<int, int>> dependencies;
+    dependencies.reserve(m_dependencies.size());
     for (const auto& [from, to] : m_dependencies) {
         auto it = lookup.find(from);
         if (it == lookup.end()) {
@@ -104,7 +143,94 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
             return CAVE_ERROR(ErrorCode::ERR_DOES_NOT_EXIST, "pass '{}' not found", to);
         }
         const int to_idx = it->second;
-        edges.push_back({ from_idx, to_idx });
+        dependencies.push_back({ from_idx, to_idx });
+    }
+
+    // 0. Cull passes that don't lead to an output. A pass needs every pass producing a resource it
+    // touches and the passes it was made to depend on. Without outputs every pass is kept.
+    std::vector<std::vector<int>> inputs(pass_count);
+    for (int i = 0; i < pass_count; ++i) {
+        const auto& pass = m_passes[i];
+        for (const auto* res : { &pass.m_reads, &pass.m_writes }) {
+            for (const auto& resource : *res) {
+                if (auto it = producers.find(resource.name); it != producers.end()) {
+                    for (int producer : it->second) {
+                        if (producer != i) {
+                            inputs[i].push_back(producer);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (const auto& [from, to] : dependencies) {
+        inputs[to].push_back(from);
+    }
+
+    std::vector<bool> outputs(pass_count, m_outputs.empty());
+    for (const auto& output : m_outputs) {
+        auto it = producers.find(output);
+        if (it == producers.end()) {
+            return CAVE_ERROR(ErrorCode::ERR_DOES_NOT_EXIST, "output '{}' is never written", output);
+        }
+        for (int producer : it->second) {
+            outputs[producer] = true;
+        }
+    }
+
+    const std::vector<bool> live = RenderGraph::FindLivePasses(inputs, outputs, std::vector<bool>(pass_count, true));
+
+    auto render_graph = std::make_shared<RenderGraph>();
+
+    // passes are numbered among the live ones from here on
+    std::vector<const RenderPassBuilder*> passes;
+    std::vector<int> remap(pass_count, -1);
+    for (int i = 0; i < pass_count; ++i) {
+        if (live[i]) {
+            remap[i] = static_cast<int>(passes.size());
+            passes.push_back(&m_passes[i]);
+        } else {
+            render_graph->m_culledPasses.push_back(m_passes[i].m_name);
+        }
+    }
+    if (!render_graph->m_culledPasses.empty()) {
+        LOG_VERBOSE("[RenderGraph] culled {} passes that don't lead to an output", render_graph->m_culledPasses.size());
+    }
+
+    std::vector<std::pair<std::string_view, int>> reads;
+    std::vector<std::pair<std::string_view, int>> writes;
+
+    std::unordered_map<std::string_view, int> creates;
+
+    const int N = static_cast<int>(passes.size());
+    DEV_ASSERT(N);
+
+    std::unordered_map<std::string_view, ResourceAccess> accesses;
+
+    for (int i = 0; i < N; ++i) {
+        const auto& pass = *passes[i];
+        for (const auto& create : pass.m_creates) {
+            creates.try_emplace(std::string_view(create.first), i);
+        }
+
+        // @TODO: figure out what access to give to resource
+        for (const auto& read : pass.m_reads) {
+            reads.push_back(std::make_pair(std::string_view(read.name), i));
+            accesses[read.name] |= read.access;
+        }
+        for (const auto& write : pass.m_writes) {
+            writes.push_back(std::make_pair(std::string_view(write.name), i));
+            accesses[write.name] |= write.access;
+        }
+    }
+
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(dependencies.size());
+    // add manual dependencies, a live pass only depends on live passes
+    for (const auto& [from, to] : dependencies) {
+        if (live[to]) {
+            edges.push_back({ remap[from], remap[to] });
+        }
     }
 
     auto add_edges = [&creates, &edges](const std::vector<std::pair<std::string_view, int>>& p_res) {
@@ -131,11 +257,32 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
     }
     auto sorted = res.unwrap_unchecked();
 
-    auto render_graph = std::make_shared<RenderGraph>();
+    // 1. Create/Import resources. A resource lives from the first to the last pass that touches
+    // it. Transient resources whose lifetimes don't overlap share a texture, a pass never reads
+    // and writes two resources in the same texture.
+    std::vector<int> pass_order(N);
+    for (int i = 0; i < N; ++i) {
+        pass_order[sorted[i]] = i;
+    }
 
-    // 1. Create/Import resources
-    for (const auto& pass : m_passes) {
-        for (const auto& create : pass.m_creates) {
+    std::unordered_map<std::string_view, std::pair<int, int>> lifetimes;
+    for (const auto& [name, pass_idx] : creates) {
+        lifetimes[name] = { pass_order[pass_idx], pass_order[pass_idx] };
+    }
+    for (const auto* res : { &reads, &writes }) {
+        for (const auto& [name, pass_idx] : *res) {
+            if (auto it = lifetimes.find(name); it != lifetimes.end()) {
+                it->second.first = glm::min(it->second.first, pass_order[pass_idx]);
+                it->second.second = glm::max(it->second.second, pass_order[pass_idx]);
+            }
+        }
+    }
+
+    std::vector<RenderGraphResourceInfo> infos;
+    std::vector<GpuTextureDesc> descs;
+    std::vector<SamplerDesc> samplers;
+    for (const auto* pass : passes) {
+        for (const auto& create : pass->m_creates) {
             const auto& name = create.first;
             const auto& create_info = create.second;
             GpuTextureDesc desc = create_info.resourceDesc;
@@ -158,10 +305,98 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
                 desc.bindFlags |= BIND_UNORDERED_ACCESS;
             }
 
-            auto texture = m_graphicsManager.CreateTexture(desc, create_info.samplerDesc);
-            render_graph->AddResource(name, texture);
+            const auto [first, last] = lifetimes.at(name);
+            infos.push_back(RenderGraphResourceInfo{
+                .name = name,
+                .firstPass = first,
+                .lastPass = last,
+                .textureIdx = -1,
+                .sizeInByte = EstimateTextureSize(desc),
+                .persistent = create_info.persistent || desc.initialData != nullptr,
+            });
+            descs.push_back(std::move(desc));
+            samplers.push_back(create_info.samplerDesc);
         }
-        for (const auto& import : pass.m_imports) {
+    }
+
+    struct TextureSlot {
+        int resourceIdx;
+        int lastPass;
+        bool shared;
+    };
+    std::vector<TextureSlot> slots;
+
+    std::vector<int> by_first_pass(infos.size());
+    for (int i = 0; i < (int)infos.size(); ++i) {
+        by_first_pass[i] = i;
+    }
+    std::stable_sort(by_first_pass.begin(), by_first_pass.end(), [&infos](int p_lhs, int p_rhs) {
+        return infos[p_lhs].firstPass < infos[p_rhs].firstPass;
+    });
+
+    for (int idx : by_first_pass) {
+        auto& info = infos[idx];
+        // the slot freed last is the tightest fit, older ones stay free for resources ending earlier
+        int best = -1;
+        for (int slot_idx = 0; !info.persistent && slot_idx < (int)slots.size(); ++slot_idx) {
+            const TextureSlot& slot = slots[slot_idx];
+            if (!slot.shared || slot.lastPass >= info.firstPass) {
+                continue;
+            }
+            if (!IsSameLayout(descs[slot.resourceIdx], descs[idx]) || samplers[slot.resourceIdx] != samplers[idx]) {
+                continue;
+            }
+            if (best < 0 || slot.lastPass > slots[best].lastPass) {
+                best = slot_idx;
+            }
+        }
+
+        if (best < 0) {
+            best = static_cast<int>(slots.size());
+            slots.push_back({ idx, info.lastPass, !info.persistent });
+        } else {
+            TextureSlot& slot = slots[best];
+            descs[slot.resourceIdx].bindFlags |= descs[idx].bindFlags;
+            slot.lastPass = info.lastPass;
+        }
+        info.textureIdx = best;
+    }
+
+    std::vector<std::shared_ptr<GpuTexture>> textures;
+    textures.reserve(slots.size());
+    for (const TextureSlot& slot : slots) {
+        textures.push_back(m_graphicsManager.CreateTexture(descs[slot.resourceIdx], samplers[slot.resourceIdx]));
+    }
+
+    RenderGraphMemoryStats& stats = render_graph->m_memoryStats;
+    stats.resourceCount = static_cast<uint32_t>(infos.size());
+    stats.textureCount = static_cast<uint32_t>(slots.size());
+    for (const auto& info : infos) {
+        render_graph->AddResource(info.name, textures[info.textureIdx]);
+        stats.dedicatedBytes += info.sizeInByte;
+    }
+    for (const TextureSlot& slot : slots) {
+        stats.allocatedBytes += infos[slot.resourceIdx].sizeInByte;
+    }
+    for (int order = 0; order < N; ++order) {
+        uint64_t live_bytes = 0;
+        for (const auto& info : infos) {
+            if (info.persistent || (info.firstPass <= order && order <= info.lastPass)) {
+                live_bytes += info.sizeInByte;
+            }
+        }
+        stats.peakLiveBytes = glm::max(stats.peakLiveBytes, live_bytes);
+    }
+    render_graph->m_resourceInfos = std::move(infos);
+
+    LOG_VERBOSE("[RenderGraph] {} resources in {} textures, {} KB instead of {} KB",
+                stats.resourceCount,
+                stats.textureCount,
+                stats.allocatedBytes / 1024,
+                stats.dedicatedBytes / 1024);
+
+    for (const auto* pass : passes) {
+        for (const auto& import : pass->m_imports) {
             const auto& name = import.first;
             auto texture = import.second();
             render_graph->AddResource(name, texture);
@@ -170,7 +405,7 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
 
     // 2. Create framebuffer (should only create it for opengl)
     for (int idx : sorted) {
-        const auto& pass = m_passes[idx];
+        const auto& pass = *passes[idx];
 
         std::vector<std::shared_ptr<GpuTexture>> srvs;
         std::vector<std::shared_ptr<GpuTexture>> uavs;
@@ -219,6 +454,7 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
         render_pass->m_name = pass.m_name;
         render_pass->m_framebuffer = m_graphicsManager.CreateFramebuffer(info);
         render_pass->m_executor = pass.m_func;
+        render_pass->m_condition = pass.m_condition;
 
         render_pass->m_srvs = std::move(srvs);
         render_pass->m_uavs = std::move(uavs);
@@ -228,6 +464,79 @@ auto RenderGraphBuilder::Compile() -> Result<std::shared_ptr<RenderGraph>> {
         render_graph->AddPass(pass.m_name, render_pass);
     }
 
+    // what the schedules need to skip passes, in execution order
+    render_graph->m_passInputs.resize(N);
+    render_graph->m_outputPasses.resize(N);
+    for (int i = 0; i < pass_count; ++i) {
+        if (!live[i]) {
+            continue;
+        }
+        const int order = pass_order[remap[i]];
+        render_graph->m_outputPasses[order] = outputs[i];
+        for (int input : inputs[i]) {
+            render_graph->m_passInputs[order].push_back(pass_order[remap[input]]);
+        }
+    }
+
+    // 3. Dependency levels. Besides the edges above, passes touching the same texture depend on
+    // each other unless both only read it, which also keeps resources sharing a texture apart.
+    // A pass goes one level after the last pass it depends on.
+    std::vector<std::vector<int>> predecessors(N);
+    for (const auto& [from, to] : edges) {
+        predecessors[pass_order[to]].push_back(pass_order[from]);
+    }
+
+    struct TextureState {
+        int lastWriter = -1;
+        std::vector<int> readers;
+    };
+    std::unordered_map<const GpuTexture*, TextureState> states;
+
+    std::vector<int> levels(N, 0);
+    for (int order = 0; order < N; ++order) {
+        const auto& pass = *passes[sorted[order]];
+        int level = 0;
+        auto depend_on = [&](int p_pass) {
+            if (p_pass >= 0 && p_pass != order) {
+                level = glm::max(level, levels[p_pass] + 1);
+            }
+        };
+
+        for (int predecessor : predecessors[order]) {
+            depend_on(predecessor);
+        }
+
+        for (const auto* res : { &pass.m_reads, &pass.m_writes }) {
+            for (const auto& resource : *res) {
+                const auto texture = render_graph->FindResource(resource.name);
+                if (!texture) {
+                    continue;
+                }
+
+                TextureState& state = states[texture.get()];
+                const bool write = resource.access != ResourceAccess::SRV;
+                depend_on(state.lastWriter);
+                if (write) {
+                    for (int reader : state.readers) {
+                        depend_on(reader);
+                    }
+                    state.lastWriter = order;
+                    state.readers.clear();
+                } else {
+                    state.readers.push_back(order);
+                }
+            }
+        }
+
+        levels[order] = level;
+        if (level >= (int)render_graph->m_levels.size()) {
+            render_graph->m_levels.resize(level + 1);
+        }
+        render_graph->m_levels[level].passes.push_back(order);
+    }
+
+    LOG_VERBOSE("[RenderGraph] {} passes in {} levels", N, render_graph->m_levels.size());
+
     return Result<std::shared_ptr<RenderGraph>>(render_graph);
 }
 
@@ -28,9 +28,13 @@ struct RenderGraphBuilderConfig {
 class RenderGraphBuilder {
 public:
     RenderGraphBuilder(const RenderGraphBuilderConfig& p_config);
+    RenderGraphBuilder(const RenderGraphBuilderConfig& p_config, IGraphicsManager& p_graphics_manager);
 
     RenderPassBuilder& AddPass(std::string_view p_name);
     void AddDependency(std::string_view p_from, std::string_view p_to);
+    // Resources read after the graph ran. When outputs are given, passes that don't lead to one
+    // are culled by Compile().
+    void AddOutput(std::string_view p_resource);
 
     [[nodiscard]] auto Compile() -> Result<std::shared_ptr<RenderGraph>>;
 
@@ -63,6 +67,7 @@ protected:
 
     std::vector<RenderPassBuilder> m_passes;
     std::vector<std::pair<std::string, std::string>> m_dependencies;
+    std::vector<std::string> m_outputs;
 };
 
 }  // namespace cave
@@ -17,6 +17,7 @@ using IRenderCmdContext = IGraphicsManager;
 namespace cave {
 
 struct FrameData;
+struct RenderOptions;
 
 struct RenderPassExcutionContext {
     const FrameData& frameData;
@@ -26,12 +27,15 @@ struct RenderPassExcutionContext {
 };
 
 using ExecuteFunc = void (*)(RenderPassExcutionContext& ctx);
+// a conditional pass only runs when it returns true for the options of the frame
+using RenderPassCondition = bool (*)(const RenderOptions& p_options);
 
 class RenderPass {
 public:
     void Execute(const FrameData& p_data, IRenderCmdContext& p_cmd);
 
     std::string_view GetName() const { return m_name; }
+    bool IsConditional() const { return m_condition != nullptr; }
 
     const auto& GetUavs() const { return m_uavs; }
     const auto& GetRtvs() const { return m_rtvs; }
@@ -50,6 +54,7 @@ protected:
     std::shared_ptr<Framebuffer> m_framebuffer;
 
     ExecuteFunc m_executor;
+    RenderPassCondition m_condition{ nullptr };
 
     friend class RenderPassBuilder;
     friend class RenderGraphBuilder;
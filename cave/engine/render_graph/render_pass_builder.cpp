@@ -28,4 +28,9 @@ RenderPassBuilder& RenderPassBuilder::SetExecuteFunc(ExecuteFunc p_func) {
     return *this;
 }
 
+RenderPassBuilder& RenderPassBuilder::SetCondition(RenderPassCondition p_func) {
+    m_condition = p_func;
+    return *this;
+}
+
 }  // namespace cave
@@ -11,6 +11,9 @@ namespace cave {
 struct RenderGraphResourceCreateInfo {
     GpuTextureDesc resourceDesc;
     SamplerDesc samplerDesc = PointClampSampler();
+    // Keeps its content across frames or is read outside the graph, never shares its texture.
+    // Transient resources are rewritten every frame before they are read.
+    bool persistent = false;
 };
 
 enum class ResourceAccess : uint8_t {
@@ -43,6 +46,7 @@ public:
     RenderPassBuilder& Read(ResourceAccess p_access, std::string_view p_name);
     RenderPassBuilder& Write(ResourceAccess p_access, std::string_view p_name);
     RenderPassBuilder& SetExecuteFunc(ExecuteFunc p_func);
+    RenderPassBuilder& SetCondition(RenderPassCondition p_func);
 
     std::string_view GetName() const { return m_name; }
 
@@ -56,6 +60,7 @@ private:
     std::vector<Resource> m_reads;
     std::vector<Resource> m_writes;
     ExecuteFunc m_func;
+    RenderPassCondition m_condition{ nullptr };
 
     friend class RenderGraphBuilder;
 };
@@ -0,0 +1,104 @@
+#include "asset_uploader.h"
+
+#include "engine/assets/image_asset.h"
+#include "engine/assets/mesh_asset.h"
+#include "engine/core/os/timer.h"
+#include "engine/debugger/profiler.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/gpu_resource.h"
+#include "engine/renderer/graphics_dvars.h"
+
+namespace cave {
+
+static size_t GetUploadSize(const MeshAsset& p_mesh) {
+    size_t bytes = (p_mesh.indices.size() + p_mesh.lod_indices.size()) * sizeof(uint32_t);
+    for (const auto& attribute : p_mesh.attributes) {
+        bytes += size_t(attribute.elementCount) * attribute.strideInByte;
+    }
+    return bytes;
+}
+
+void AssetUploader::RequestTexture(std::shared_ptr<ImageAsset> p_image) {
+    m_loadedImages.push(std::move(p_image));
+}
+
+void AssetUploader::RequestMesh(std::shared_ptr<MeshAsset> p_mesh) {
+    m_loadedMeshes.push(std::move(p_mesh));
+}
+
+void AssetUploader::CreateRequestedResources(const FrameData* p_framedata,
+                                             const CreateTextureFunc& p_create_texture,
+                                             const CreateMeshFunc& p_create_mesh) {
+    // whether the asset already has a resource is only checked when publishing, the asset
+    // belongs to the main thread
+    auto loaded_images = m_loadedImages.pop_all();
+    while (!loaded_images.empty()) {
+        std::shared_ptr<ImageAsset> image = std::move(loaded_images.front());
+        DEV_ASSERT(image);
+        loaded_images.pop();
+        const size_t bytes = image->buffer.size();
+        m_uploadQueue.Push(UploadQueue::Type::TEXTURE, std::move(image), bytes);
+    }
+    auto loaded_meshes = m_loadedMeshes.pop_all();
+    while (!loaded_meshes.empty()) {
+        std::shared_ptr<MeshAsset> mesh = std::move(loaded_meshes.front());
+        DEV_ASSERT(mesh);
+        loaded_meshes.pop();
+        const size_t bytes = GetUploadSize(*mesh);
+        m_uploadQueue.Push(UploadQueue::Type::MESH, std::move(mesh), bytes);
+    }
+
+    if (m_uploadQueue.IsEmpty()) {
+        return;
+    }
+
+    CAVE_PROFILE_EVENT();
+    if (p_framedata) {
+        m_uploadQueue.SetPriorities(p_framedata->uploadHints);
+    }
+
+    const UploadQueue::Budget budget{
+        .bytes = size_t(glm::max(DVAR_GET_INT(gfx_upload_budget_kb), 0)) * 1024,
+        .milliseconds = DVAR_GET_FLOAT(gfx_upload_budget_ms),
+    };
+
+    Timer timer;
+    auto upload = [&](const UploadQueue::Request& p_request) {
+        switch (p_request.type) {
+            case UploadQueue::Type::TEXTURE: {
+                auto image = std::static_pointer_cast<ImageAsset>(p_request.asset);
+                auto texture = p_create_texture(*image);
+                std::lock_guard lock(m_createdMutex);
+                m_createdTextures.emplace_back(std::move(image), std::move(texture));
+            } break;
+            case UploadQueue::Type::MESH: {
+                auto mesh = std::static_pointer_cast<MeshAsset>(p_request.asset);
+                auto res = p_create_mesh(*mesh);
+                if (!res) {
+                    return;
+                }
+                std::lock_guard lock(m_createdMutex);
+                m_createdMeshes.emplace_back(std::move(mesh), std::move(*res));
+            } break;
+        }
+    };
+    m_uploadQueue.Process(budget, upload, [&]() { return timer.GetDuration().ToMillisecond(); });
+}
+
+void AssetUploader::PublishCreatedResources() {
+    std::lock_guard lock(m_createdMutex);
+    for (auto& [image, texture] : m_createdTextures) {
+        if (!image->gpu_texture) {
+            image->gpu_texture = std::move(texture);
+        }
+    }
+    for (auto& [mesh, gpu_mesh] : m_createdMeshes) {
+        if (!mesh->gpuResource) {
+            mesh->gpuResource = std::move(gpu_mesh);
+        }
+    }
+    m_createdTextures.clear();
+    m_createdMeshes.clear();
+}
+
+}  // namespace cave
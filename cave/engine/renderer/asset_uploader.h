@@ -0,0 +1,47 @@
+#pragma once
+#include "engine/core/base/concurrent_queue.h"
+#include "engine/renderer/upload_queue.h"
+
+namespace cave {
+
+struct ImageAsset;
+class MeshAsset;
+struct FrameData;
+struct GpuMesh;
+struct GpuTexture;
+
+// The request -> upload -> publish pipeline of the loaded assets, shared by the backends. Loaders
+// request from any thread, the thread that renders creates a budgeted few per frame with the
+// backend's functions, and the main thread hands them to their assets.
+class AssetUploader {
+public:
+    using CreateTextureFunc = std::function<std::shared_ptr<GpuTexture>(const ImageAsset&)>;
+    using CreateMeshFunc = std::function<Result<std::shared_ptr<GpuMesh>>(const MeshAsset&)>;
+
+    void RequestTexture(std::shared_ptr<ImageAsset> p_image);
+    void RequestMesh(std::shared_ptr<MeshAsset> p_mesh);
+
+    // on the thread that renders, the hints of p_framedata decide what goes first
+    void CreateRequestedResources(const FrameData* p_framedata,
+                                  const CreateTextureFunc& p_create_texture,
+                                  const CreateMeshFunc& p_create_mesh);
+
+    // on the main thread, an asset that got a resource meanwhile keeps it
+    void PublishCreatedResources();
+
+    const UploadQueue::Stats& GetStats() const { return m_uploadQueue.GetStats(); }
+
+private:
+    ConcurrentQueue<std::shared_ptr<ImageAsset>> m_loadedImages;
+    ConcurrentQueue<std::shared_ptr<MeshAsset>> m_loadedMeshes;
+
+    UploadQueue m_uploadQueue;
+
+    // Resources are created on the thread that renders and only assigned to their assets by
+    // PublishCreatedResources(), so the main thread never sees an asset change while it builds a frame.
+    std::mutex m_createdMutex;
+    std::vector<std::pair<std::shared_ptr<ImageAsset>, std::shared_ptr<GpuTexture>>> m_createdTextures;
+    std::vector<std::pair<std::shared_ptr<MeshAsset>, std::shared_ptr<GpuMesh>>> m_createdMeshes;
+};
+
+}  // namespace cave
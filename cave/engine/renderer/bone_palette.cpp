@@ -0,0 +1,193 @@
+#include "bone_palette.h"
+
+#include "engine/runtime/graphics_manager_interface.h"
+
+namespace cave {
+
+static_assert(BonePalette::DEFAULT_COPY_COUNT >= IGraphicsManager::NUM_FRAMES_IN_FLIGHT);
+static_assert(BONE_PALETTE_ROW_COUNT % BonePalette::ROW_ALIGNMENT == 0);
+
+BonePalette::BonePalette(uint32_t p_row_count, uint32_t p_copy_count)
+    : m_rowCount(p_row_count),
+      m_copyCount(p_copy_count) {
+    DEV_ASSERT(p_row_count % ROW_ALIGNMENT == 0);
+    DEV_ASSERT(p_copy_count > 0);
+}
+
+void BonePalette::BeginFrame() {
+    ++m_frame;
+    m_stats.skeleton_count = 0;
+    m_stats.changed_count = 0;
+}
+
+bool BonePalette::Update(ecs::Entity p_id, const Matrix4x4f* p_transforms, uint32_t p_bone_count) {
+    DEV_ASSERT(p_bone_count <= MAX_BONE_COUNT);
+    if (p_bone_count == 0) {
+        return false;
+    }
+
+    // scenes without skeletons don't pay for the copy
+    if (m_rows.empty()) {
+        m_rows.resize(m_rowCount, Vector4f(0.0f));
+    }
+
+    const uint32_t row_count = p_bone_count * ROWS_PER_BONE;
+    auto [it, inserted] = m_entries.try_emplace(p_id);
+    Entry& entry = it->second;
+
+    bool changed = inserted;
+    if (!inserted && entry.range.row_count != row_count) {
+        Release(entry.range);
+        changed = true;
+    }
+    if (changed && !Allocate(row_count, entry.range)) {
+        m_entries.erase(it);
+        return false;
+    }
+
+    entry.frame = m_frame;
+    ++m_stats.skeleton_count;
+
+    // compare bone by bone, most idle skeletons are rejected on the first rows
+    Vector4f* dst = m_rows.data() + entry.range.offset;
+    for (uint32_t bone = 0; bone < p_bone_count; ++bone, dst += ROWS_PER_BONE) {
+        Vector4f rows[ROWS_PER_BONE];
+        StoreMatrix(p_transforms[bone], rows);
+        if (changed || memcmp(dst, rows, sizeof(rows)) != 0) {
+            memcpy(dst, rows, sizeof(rows));
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        entry.pending = m_copyCount;
+        ++m_stats.changed_count;
+    }
+    return true;
+}
+
+void BonePalette::EndFrame(memory::ArenaVector<Upload>& p_uploads, memory::ArenaVector<Vector4f>& p_rows) {
+    m_pending.clear();
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        Entry& entry = it->second;
+        if (entry.frame != m_frame) {
+            Release(entry.range);
+            it = m_entries.erase(it);
+            continue;
+        }
+        if (entry.pending) {
+            --entry.pending;
+            m_pending.push_back(entry.range);
+        }
+        ++it;
+    }
+
+    std::sort(m_pending.begin(), m_pending.end(), [](const Range& p_lhs, const Range& p_rhs) {
+        return p_lhs.offset < p_rhs.offset;
+    });
+
+    m_stats.uploaded_row_count = 0;
+    for (size_t i = 0; i < m_pending.size();) {
+        const uint32_t begin = m_pending[i].offset;
+        uint32_t end = begin + m_pending[i].row_count;
+        // the rows between two adjacent ranges are only padding, uploading them is cheaper than
+        // another copy
+        for (++i; i < m_pending.size() && m_pending[i].offset == Align(end, ROW_ALIGNMENT); ++i) {
+            end = m_pending[i].offset + m_pending[i].row_count;
+        }
+
+        p_uploads.push_back(Upload{ begin, static_cast<uint32_t>(p_rows.size()), end - begin });
+        p_rows.insert(p_rows.end(), m_rows.begin() + begin, m_rows.begin() + end);
+        m_stats.uploaded_row_count += end - begin;
+    }
+}
+
+void BonePalette::ReserveBuffer(uint32_t p_row_count, memory::ArenaVector<Upload>& p_uploads, memory::ArenaVector<Vector4f>& p_rows) {
+    if (p_row_count <= m_bufferRowCount) {
+        return;
+    }
+
+    // grow by whole blocks and at least double, so a slowly growing scene recreates few buffers
+    const uint32_t block_count = (p_row_count + BONE_BLOCK_ROW_COUNT - 1) / BONE_BLOCK_ROW_COUNT;
+    const uint32_t row_count = glm::max(block_count * BONE_BLOCK_ROW_COUNT, glm::max(2 * m_bufferRowCount, BONE_BUFFER_MIN_ROW_COUNT));
+    m_bufferRowCount = glm::min(row_count, BONE_BUFFER_ROW_COUNT);
+
+    // the current frame context receives every row now, the others over the next frames
+    p_uploads.clear();
+    p_rows.clear();
+    if (m_top > 0) {
+        p_uploads.push_back(Upload{ 0, 0, m_top });
+        p_rows.insert(p_rows.end(), m_rows.begin(), m_rows.begin() + m_top);
+    }
+    m_stats.uploaded_row_count = m_top;
+    for (auto& [id, entry] : m_entries) {
+        entry.pending = m_copyCount - 1;
+    }
+}
+
+const BonePalette::Range* BonePalette::Find(ecs::Entity p_id) const {
+    auto it = m_entries.find(p_id);
+    return it != m_entries.end() ? &it->second.range : nullptr;
+}
+
+void BonePalette::StoreMatrix(const Matrix4x4f& p_matrix, Vector4f* p_rows) {
+    // Matrix4x4f is column major
+    for (int row = 0; row < 3; ++row) {
+        p_rows[row] = Vector4f(p_matrix[0][row], p_matrix[1][row], p_matrix[2][row], p_matrix[3][row]);
+    }
+}
+
+bool BonePalette::Allocate(uint32_t p_row_count, Range& p_out_range) {
+    const uint32_t size = Align(p_row_count, ROW_ALIGNMENT);
+    for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it) {
+        if (it->row_count < size) {
+            continue;
+        }
+
+        p_out_range = Range{ it->offset, p_row_count };
+        it->offset += size;
+        it->row_count -= size;
+        if (it->row_count == 0) {
+            m_freeRanges.erase(it);
+        }
+        m_stats.used_row_count += size;
+        return true;
+    }
+
+    if (m_top + size > m_rowCount) {
+        return false;
+    }
+
+    p_out_range = Range{ m_top, p_row_count };
+    m_top += size;
+    m_stats.used_row_count += size;
+    return true;
+}
+
+void BonePalette::Release(const Range& p_range) {
+    Range range{ p_range.offset, Align(p_range.row_count, ROW_ALIGNMENT) };
+    DEV_ASSERT(m_stats.used_row_count >= range.row_count);
+    m_stats.used_row_count -= range.row_count;
+
+    auto it = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), range, [](const Range& p_lhs, const Range& p_rhs) {
+        return p_lhs.offset < p_rhs.offset;
+    });
+
+    if (it != m_freeRanges.end() && range.offset + range.row_count == it->offset) {
+        range.row_count += it->row_count;
+        it = m_freeRanges.erase(it);
+    }
+    if (it != m_freeRanges.begin() && std::prev(it)->offset + std::prev(it)->row_count == range.offset) {
+        std::prev(it)->row_count += range.row_count;
+    } else {
+        m_freeRanges.insert(it, range);
+    }
+
+    // a free range at the top goes back to the bump allocation
+    if (!m_freeRanges.empty() && m_freeRanges.back().offset + m_freeRanges.back().row_count == m_top) {
+        m_top = m_freeRanges.back().offset;
+        m_freeRanges.pop_back();
+    }
+}
+
+}  // namespace cave
@@ -0,0 +1,105 @@
+#pragma once
+#include "engine/ecs/entity.h"
+#include "engine/math/geomath.h"
+#include "engine/memory/arena_allocator.h"
+
+#include "shader_defines.hlsl.h"
+
+namespace cave {
+
+// Rows of the bone constant buffer, a bone is a 3x4 matrix stored as 3 rows. The skeleton palettes
+// persist at the start of the buffer (at most BONE_PALETTE_ROW_COUNT rows), the world matrices of
+// instanced draws are written after the last palette every frame. The buffer grows with the rows
+// a scene uses, up to BONE_BUFFER_ROW_COUNT. One block past the used rows is kept free, so a whole
+// BoneConstantBuffer can be bound at any offset.
+inline constexpr uint32_t BONE_BLOCK_ROW_COUNT = MAX_BONE_COUNT * 3;
+inline constexpr uint32_t BONE_PALETTE_ROW_COUNT = 256 * BONE_BLOCK_ROW_COUNT;
+inline constexpr uint32_t BONE_BUFFER_ROW_COUNT = 512 * BONE_BLOCK_ROW_COUNT;
+inline constexpr uint32_t BONE_INSTANCE_ROW_COUNT = BONE_BUFFER_ROW_COUNT - BONE_PALETTE_ROW_COUNT - BONE_BLOCK_ROW_COUNT;
+// size of a bone buffer before any frame asked for more
+inline constexpr uint32_t BONE_BUFFER_MIN_ROW_COUNT = 8 * BONE_BLOCK_ROW_COUNT;
+
+// Persistent allocation of the skeleton palettes in the bone constant buffer. Each skeleton owns a
+// range sized to its bone count, the GPU buffer keeps the rows between frames and a range is only
+// uploaded again when its rows change.
+class BonePalette {
+public:
+    static constexpr uint32_t ROWS_PER_BONE = 3;
+    // ranges start on 256 bytes, the constant buffer offset alignment of D3D12
+    static constexpr uint32_t ROW_ALIGNMENT = 16;
+    // every frame context has its own bone buffer, a change is uploaded to each of them in turn
+    static constexpr uint32_t DEFAULT_COPY_COUNT = 2;
+
+    struct Range {
+        uint32_t offset = 0;
+        uint32_t row_count = 0;
+    };
+
+    // p_rows[src_row, src_row + row_count) goes to the buffer at dst_row
+    struct Upload {
+        uint32_t dst_row;
+        uint32_t src_row;
+        uint32_t row_count;
+    };
+
+    struct Stats {
+        uint32_t skeleton_count = 0;
+        // skeletons whose rows changed this frame
+        uint32_t changed_count = 0;
+        uint32_t uploaded_row_count = 0;
+        uint32_t used_row_count = 0;
+    };
+
+    BonePalette(uint32_t p_row_count = BONE_PALETTE_ROW_COUNT, uint32_t p_copy_count = DEFAULT_COPY_COUNT);
+
+    void BeginFrame();
+
+    // Writes the palette of p_id, false if there is no room left for it.
+    bool Update(ecs::Entity p_id, const Matrix4x4f* p_transforms, uint32_t p_bone_count);
+
+    // Releases the skeletons that weren't updated since BeginFrame() and appends the rows the
+    // buffers still have to receive. Adjacent ranges are merged into one upload.
+    void EndFrame(memory::ArenaVector<Upload>& p_uploads, memory::ArenaVector<Vector4f>& p_rows);
+
+    // Grows the bone buffer size of the frame contexts to hold p_row_count rows. A frame context
+    // recreates its buffer when it grows, so the used rows are uploaded again to each of them.
+    void ReserveBuffer(uint32_t p_row_count, memory::ArenaVector<Upload>& p_uploads, memory::ArenaVector<Vector4f>& p_rows);
+
+    // nullptr if p_id has no range, safe to call from several threads
+    const Range* Find(ecs::Entity p_id) const;
+
+    const Stats& GetStats() const { return m_stats; }
+    uint32_t GetRowCount() const { return m_rowCount; }
+    // end of the last range, the rows after it are free for the frame
+    uint32_t GetTop() const { return m_top; }
+    uint32_t GetBufferRowCount() const { return m_bufferRowCount; }
+
+    // the first three rows of p_matrix, the last one is always (0, 0, 0, 1)
+    static void StoreMatrix(const Matrix4x4f& p_matrix, Vector4f* p_rows);
+
+private:
+    struct Entry {
+        Range range;
+        uint32_t frame = 0;
+        // uploads left before every copy has the current rows
+        uint32_t pending = 0;
+    };
+
+    bool Allocate(uint32_t p_row_count, Range& p_out_range);
+    void Release(const Range& p_range);
+
+    std::unordered_map<ecs::Entity, Entry> m_entries;
+    // sorted by offset, adjacent ranges are merged
+    std::vector<Range> m_freeRanges;
+    std::vector<Range> m_pending;
+    // CPU copy of the buffer, compared against to detect unchanged palettes
+    std::vector<Vector4f> m_rows;
+    uint32_t m_top = 0;
+    uint32_t m_bufferRowCount = 0;
+    uint32_t m_frame = 0;
+    const uint32_t m_rowCount;
+    const uint32_t m_copyCount;
+    Stats m_stats;
+};
+
+}  // namespace cave
@@ -1,5 +1,6 @@
 #pragma once
 #include "engine/math/geomath.h"
+#include "engine/memory/arena_allocator.h"
 
 namespace cave {
 
@@ -28,11 +29,22 @@ public:
 
     void Batch();
 
+    void Clear() {
+        m_items.clear();
+        m_mesh.reset();
+    }
+
+    // Clear(), and the items move to p_arena
+    void Recycle(memory::LinearAllocator* p_arena) {
+        memory::RecycleArenaVector(m_items, p_arena);
+        m_mesh.reset();
+    }
+
     const GpuMesh* GetGpuMesh() const { return m_mesh.get(); }
 
 private:
     std::shared_ptr<GpuMesh> m_mesh;
-    std::vector<Item> m_items;
+    memory::ArenaVector<Item> m_items;
 };
 
 }  // namespace cave
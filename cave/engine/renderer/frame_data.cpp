@@ -0,0 +1,112 @@
+#include "frame_data.h"
+
+namespace cave {
+
+FrameData::FrameData(const RenderOptions& p_options, size_t p_arena_size)
+    : m_arena(std::make_unique<memory::LinearAllocator>(p_arena_size)),
+      options(p_options) {
+    BindArena(m_arena.get());
+}
+
+void FrameData::Reset(const RenderOptions& p_options) {
+    options = p_options;
+
+    // The containers don't read their old storage when they move, the arena is reused right away.
+    // A frame that overflowed to the heap gets a larger one, the old arena goes once every
+    // container left it.
+    std::unique_ptr<memory::LinearAllocator> old_arena;
+    if (m_arena->OverflowCount() > 0) {
+        old_arena = std::move(m_arena);
+        m_arena = std::make_unique<memory::LinearAllocator>(2 * old_arena->Capacity());
+    } else {
+        m_arena->Reset();
+    }
+    BindArena(m_arena.get());
+
+    perFrameCache = PerFrameConstantBuffer{};
+    instanceBatchIdx = -1;
+    droppedBatchCount = 0;
+    instanceRowOffset = 0;
+    boneBufferRowCount = BONE_BUFFER_MIN_ROW_COUNT;
+
+    for (auto& pass : pointShadowPasses) {
+        pass.reset();
+    }
+    shadowPasses.fill(PassContext{});
+    voxelPass = PassContext{};
+    mainPass = PassContext{};
+
+    retainedResources.clear();
+
+    bakeIbl = false;
+    voxel_gi_bound.MakeInvalid();
+}
+
+void FrameData::BindArena(memory::LinearAllocator* p_arena) {
+    batchCache.Recycle(p_arena);
+    memory::RecycleArenaVector(materials, p_arena);
+    memory::RecycleArenaVector(materialUploads, p_arena);
+    memory::RecycleArenaVector(materialUploadValues, p_arena);
+    memory::RecycleArenaVector(passCache, p_arena);
+    memory::RecycleArenaVector(boneUploads, p_arena);
+    memory::RecycleArenaVector(boneUploadRows, p_arena);
+    memory::RecycleArenaVector(batchUploads, p_arena);
+    memory::RecycleArenaVector(batchUploadValues, p_arena);
+    memory::RecycleArenaVector(instanceRows, p_arena);
+    memory::RecycleArenaVector(pointLights, p_arena);
+    memory::RecycleArenaVector(lightClusters, p_arena);
+    memory::RecycleArenaVector(lightIndices, p_arena);
+    memory::RecycleArenaVector(uploadHints, p_arena);
+
+    shadow_pass_commands.Recycle(p_arena);
+    prepass_commands.Recycle(p_arena);
+    gbuffer_commands.Recycle(p_arena);
+    transparent_commands.Recycle(p_arena);
+    voxelization_commands.Recycle(p_arena);
+    memory::RecycleArenaVector(tile_maps, p_arena);
+    memory::RecycleArenaVector(sprites, p_arena);
+
+    m_debug_draw.Recycle(p_arena);
+}
+
+bool FrameData::IsTransientBatchFull() {
+    if (batchCache.buffer.size() < TRANSIENT_BATCH_COUNT) {
+        return false;
+    }
+
+    if (droppedBatchCount++ == 0) {
+        LOG_WARN("all {} transient batches are used, draws are dropped this frame", TRANSIENT_BATCH_COUNT);
+    }
+    return true;
+}
+
+int FrameData::AddTransientBatch(const PerBatchConstantBuffer& p_batch) {
+    if (IsTransientBatchFull()) {
+        return -1;
+    }
+
+    batchCache.buffer.emplace_back(p_batch);
+    return static_cast<int>(batchCache.buffer.size()) - 1;
+}
+
+int FrameData::FindOrAddTransientBatch(ecs::Entity p_id, const PerBatchConstantBuffer& p_batch) {
+    if (const int index = batchCache.Find(p_id); index >= 0) {
+        return index;
+    }
+    if (IsTransientBatchFull()) {
+        return -1;
+    }
+
+    return static_cast<int>(batchCache.FindOrAdd(p_id, p_batch));
+}
+
+FrameData::ArenaStats FrameData::GetArenaStats() const {
+    ArenaStats stats;
+    stats.capacity = m_arena->Capacity();
+    stats.lastFrameUsed = m_arena->Used();
+    stats.highWaterMark = m_arena->HighWaterMark();
+    stats.overflowCount = m_arena->OverflowCount();
+    return stats;
+}
+
+}  // namespace cave
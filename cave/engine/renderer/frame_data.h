@@ -5,13 +5,18 @@
 #include "engine/math/angle.h"
 #include "engine/math/color.h"
 #include "engine/math/geomath.h"
+#include "engine/memory/arena_allocator.h"
+#include "engine/renderer/bone_palette.h"
 #include "engine/renderer/debug_draw.h"
 #include "engine/renderer/gpu_resource.h"
 #include "engine/renderer/graphics_defines.h"
+#include "engine/renderer/material_table.h"
 #include "engine/renderer/render_command.h"
+#include "engine/renderer/scene_buffer.h"
+#include "engine/renderer/upload_queue.h"
 
 namespace cave {
-#include "cbuffer.hlsl.h"
+#include "structured_buffer.hlsl.h"
 }  // namespace cave
 
 namespace cave {
@@ -24,41 +29,114 @@ struct RenderOptions {
     bool vxgiEnabled{ false };
     bool bloomEnabled{ false };
     bool iblEnabled{ false };
+    bool occlusionCullingEnabled{ false };
+    bool clusteredLightingEnabled{ false };
+    bool meshLodEnabled{ false };
     int debugVoxelId{ 0 };
     int debugBvhDepth{ -1 };
     int voxelTextureSize{ 0 };
     float ssaoKernelRadius{ 0.0f };
+    float meshLodPixelError{ 1.0f };
+    float shadowLodBias{ 1.0f };
 };
 
 struct PassContext {
     int pass_idx{ 0 };
 };
 
-// @TODO: refactor this
+// Per frame buffer with an id -> index lookup. Ids index a paged sparse array instead of a hash
+// map, a slot only counts if its stamp matches the current frame, so Clear() bumps the stamp and
+// keeps the pages and the buffer capacity for the next frame.
 template<typename BUFFER, typename ID = ::cave::ecs::Entity>
 struct BufferCache {
-    std::vector<BUFFER> buffer;
-    std::unordered_map<ID, uint32_t> lookup;
+    static constexpr uint32_t PAGE_BITS = 10;
+    static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
 
-    uint32_t FindOrAdd(ID p_entity, const BUFFER& p_buffer) {
-        auto it = lookup.find(p_entity);
-        if (it != lookup.end()) {
-            return it->second;
+    struct Slot {
+        uint32_t stamp = 0;
+        uint32_t index = 0;
+    };
+
+    memory::ArenaVector<BUFFER> buffer;
+
+    uint32_t FindOrAdd(ID p_id, const BUFFER& p_buffer) {
+        Slot& slot = GetSlot(p_id.GetId());
+        if (slot.stamp != m_stamp) {
+            slot.stamp = m_stamp;
+            slot.index = static_cast<uint32_t>(buffer.size());
+            buffer.emplace_back(p_buffer);
+        }
+        return slot.index;
+    }
+
+    // default constructs the buffer when the id is new, for buffers too large to copy around
+    uint32_t FindOrAdd(ID p_id) {
+        Slot& slot = GetSlot(p_id.GetId());
+        if (slot.stamp != m_stamp) {
+            slot.stamp = m_stamp;
+            slot.index = static_cast<uint32_t>(buffer.size());
+            buffer.emplace_back();
+        }
+        return slot.index;
+    }
+
+    // -1 if the id wasn't added this frame, safe to call from several threads
+    int Find(ID p_id) const {
+        const uint32_t id = p_id.GetId();
+        const uint32_t page = id >> PAGE_BITS;
+        if (page >= m_pages.size() || !m_pages[page]) {
+            return -1;
         }
 
-        uint32_t index = static_cast<uint32_t>(buffer.size());
-        lookup[p_entity] = index;
-        buffer.emplace_back(p_buffer);
-        return index;
+        const Slot& slot = m_pages[page][id & (PAGE_SIZE - 1)];
+        return slot.stamp == m_stamp ? static_cast<int>(slot.index) : -1;
     }
 
     void Clear() {
         buffer.clear();
-        lookup.clear();
+        BumpStamp();
+    }
+
+    // Clear(), and the buffer moves to p_arena. The pages are kept on the heap, they outlive frames.
+    void Recycle(memory::LinearAllocator* p_arena) {
+        memory::RecycleArenaVector(buffer, p_arena);
+        BumpStamp();
+    }
+
+private:
+    void BumpStamp() {
+        if (++m_stamp == 0) {
+            // wrapped around, old stamps could match again
+            for (auto& page : m_pages) {
+                for (uint32_t i = 0; page && i < PAGE_SIZE; ++i) {
+                    page[i] = Slot{};
+                }
+            }
+            m_stamp = 1;
+        }
+    }
+
+    Slot& GetSlot(uint32_t p_id) {
+        const uint32_t page = p_id >> PAGE_BITS;
+        if (page >= m_pages.size()) {
+            m_pages.resize(page + 1);
+        }
+        if (!m_pages[page]) {
+            m_pages[page] = std::make_unique<Slot[]>(PAGE_SIZE);
+        }
+        return m_pages[page][p_id & (PAGE_SIZE - 1)];
     }
+
+    std::vector<std::unique_ptr<Slot[]>> m_pages;
+    uint32_t m_stamp = 1;
 };
 
 struct FrameData {
+private:
+    // declared first, the containers allocated from it are destroyed before it
+    std::unique_ptr<memory::LinearAllocator> m_arena;
+
+public:
     struct Camera {
         Matrix4x4f viewMatrix;
         Matrix4x4f projectionMatrixRendering;
@@ -75,22 +153,77 @@ struct FrameData {
         Degree fovy;
     };
 
-    FrameData(const RenderOptions& p_options)
-        : options(p_options) {
-    }
+    struct ArenaStats {
+        size_t capacity;
+        size_t lastFrameUsed;
+        size_t highWaterMark;
+        uint32_t overflowCount;
+    };
 
-    const RenderOptions options;
+    // initial arena size, it doubles after a frame that didn't fit
+    static constexpr size_t ARENA_SIZE = 4 * 1024 * 1024;
+
+    FrameData(const RenderOptions& p_options, size_t p_arena_size = ARENA_SIZE);
+
+    // Recycles the frame data of an earlier frame. The transient containers are allocated from one
+    // arena, a container only keeps its size when the arena is reset and reserves what it used last
+    // frame, so no heap allocation happens once the sizes are stable.
+    void Reset(const RenderOptions& p_options);
+
+    ArenaStats GetArenaStats() const;
+
+    // Slot of p_batch in the transient batches, -1 once all TRANSIENT_BATCH_COUNT are used, the
+    // draw must be dropped then, a slot past them belongs to the scene batches.
+    int AddTransientBatch(const PerBatchConstantBuffer& p_batch);
+    // same, but an id that already has a slot this frame keeps it
+    int FindOrAddTransientBatch(ecs::Entity p_id, const PerBatchConstantBuffer& p_batch);
+
+    // bytes written to the bone constant buffer by this frame
+    size_t GetBoneUploadBytes() const { return (boneUploadRows.size() + instanceRows.size()) * sizeof(Vector4f); }
+    // bytes written to the material constant buffer by this frame
+    size_t GetMaterialUploadBytes() const { return materialUploadValues.size() * sizeof(MaterialConstantBuffer); }
+    // bytes written to the batch constant buffer by this frame
+    size_t GetBatchUploadBytes() const { return (batchCache.buffer.size() + batchUploadValues.size()) * sizeof(PerBatchConstantBuffer); }
+
+    RenderOptions options;
 
     Camera mainCamera;
 
     // @TODO: multi camera & viewport
 
     PerFrameConstantBuffer perFrameCache;
+    // batches written every frame, they live in the first TRANSIENT_BATCH_COUNT slots
     BufferCache<PerBatchConstantBuffer> batchCache;
-    BufferCache<MaterialConstantBuffer> materialCache;
-    std::vector<PerPassConstantBuffer> passCache;
+    // the material table by mat_idx, only the entries in materialUploads go to the GPU
+    memory::ArenaVector<MaterialConstantBuffer> materials;
+    memory::ArenaVector<MaterialTable::Upload> materialUploads;
+    memory::ArenaVector<MaterialConstantBuffer> materialUploadValues;
+    memory::ArenaVector<PerPassConstantBuffer> passCache;
     std::array<PointShadowConstantBuffer, MAX_POINT_LIGHT_SHADOW_COUNT * 6> pointShadowCache;
-    BufferCache<BoneConstantBuffer> boneCache;
+    // palette ranges that changed, their rows are packed in boneUploadRows
+    memory::ArenaVector<BonePalette::Upload> boneUploads;
+    memory::ArenaVector<Vector4f> boneUploadRows;
+    // scene batch slots that changed, their values are packed in batchUploadValues
+    memory::ArenaVector<SceneBuffer<PerBatchConstantBuffer>::Upload> batchUploads;
+    memory::ArenaVector<PerBatchConstantBuffer> batchUploadValues;
+    // world matrices of instanced draws, written after the palettes at instanceRowOffset
+    memory::ArenaVector<Vector4f> instanceRows;
+    uint32_t instanceRowOffset{ 0 };
+    // rows the bone buffer must hold, it's recreated when it's smaller
+    uint32_t boneBufferRowCount{ BONE_BUFFER_MIN_ROW_COUNT };
+    // batch with MESH_HAS_INSTANCE set, shared by every instanced draw
+    int instanceBatchIdx{ -1 };
+    // batches that didn't fit in the transient slots, their draws were dropped
+    uint32_t droppedBatchCount{ 0 };
+    // point lights of clustered lighting, lightClusters index lightIndices, which index pointLights
+    memory::ArenaVector<GpuPointLight> pointLights;
+    memory::ArenaVector<uint32_t> lightClusters;
+    memory::ArenaVector<uint32_t> lightIndices;
+    // meshes and textures the frame needs but doesn't have yet, decides what is uploaded first
+    memory::ArenaVector<UploadHint> uploadHints;
+    // Gpu meshes and textures the commands point to. A pipelined render thread draws the frame
+    // after the main thread moved on, the frame keeps them alive until it's reset.
+    std::vector<std::shared_ptr<const void>> retainedResources;
     // std::vector<EmitterConstantBuffer> emitterCache;
 
     // @TODO: rename
@@ -100,20 +233,18 @@ struct FrameData {
     PassContext voxelPass;
     PassContext mainPass;
 
-    std::vector<RenderCommand> shadow_pass_commands;
-    std::vector<RenderCommand> prepass_commands;
-    std::vector<RenderCommand> gbuffer_commands;
-    std::vector<RenderCommand> transparent_commands;
-    std::vector<RenderCommand> voxelization_commands;
-    std::vector<RenderCommand> tile_maps;
-    std::vector<RenderCommand> sprites;
-
-    // std::vector<InstanceContext> instances;
+    RenderCommandList shadow_pass_commands;
+    RenderCommandList prepass_commands;
+    RenderCommandList gbuffer_commands;
+    RenderCommandList transparent_commands;
+    RenderCommandList voxelization_commands;
+    memory::ArenaVector<RenderCommand> tile_maps;
+    memory::ArenaVector<RenderCommand> sprites;
 
     // std::vector<ParticleEmitterComponent> emitters;
 
     // @TODO: refactor
-    bool bakeIbl;
+    bool bakeIbl{ false };
 
     struct UpdateBuffer {
         std::vector<Vector3f> positions;
@@ -127,6 +258,9 @@ struct FrameData {
     const DebugDraw& GetDebugDraw() const { return m_debug_draw; }
 
 private:
+    void BindArena(memory::LinearAllocator* p_arena);
+    bool IsTransientBatchFull();
+
     DebugDraw m_debug_draw;
 };
 
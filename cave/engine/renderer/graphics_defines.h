@@ -3,13 +3,14 @@
 namespace cave {
 
 // clang-format off
-#define BACKEND_LIST                                \
-    BACKEND_DECLARE(EMPTY,  "Empty",        empty)  \
-    BACKEND_DECLARE(OPENGL, "OpenGL",       opengl) \
-    BACKEND_DECLARE(D3D11,  "Direct3D 11",  d3d11)  \
-    BACKEND_DECLARE(D3D12,  "Direct3D 12",  d3d12)  \
-    BACKEND_DECLARE(VULKAN, "Vulkan",       vulkan) \
-    BACKEND_DECLARE(METAL,  "Metal",        metal)
+#define BACKEND_LIST                                    \
+    BACKEND_DECLARE(EMPTY,    "Empty",        empty)    \
+    BACKEND_DECLARE(OPENGL,   "OpenGL",       opengl)   \
+    BACKEND_DECLARE(D3D11,    "Direct3D 11",  d3d11)    \
+    BACKEND_DECLARE(D3D12,    "Direct3D 12",  d3d12)    \
+    BACKEND_DECLARE(VULKAN,   "Vulkan",       vulkan)   \
+    BACKEND_DECLARE(METAL,    "Metal",        metal)    \
+    BACKEND_DECLARE(SOFTWARE, "Software",     software)
 // clang-format on
 
 enum class Backend : uint8_t {
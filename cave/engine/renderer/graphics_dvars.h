@@ -13,10 +13,25 @@ DVAR_STRING(gfx_backend, DVAR_FLAG_NONE, "Renderer backend", "empty");
 DVAR_STRING(gfx_render_graph, DVAR_FLAG_NONE, "Renderer graph", "scene3d");
 DVAR_BOOL(gfx_gpu_validation, DVAR_FLAG_NONE, "Enable GPU validation", true);
 
+// Pipelining
+DVAR_BOOL(gfx_pipelined_render, DVAR_FLAG_CACHE, "Render frame N on a render thread while frame N + 1 is simulated", false);
+DVAR_INT(gfx_frame_buffering, DVAR_FLAG_CACHE, "Frame data buffers in pipelined mode, 2 or 3", 2);
+
 // Switches
 DVAR_BOOL(gfx_debug_shadow, DVAR_FLAG_CACHE, "Debug shadow", false);
 DVAR_BOOL(gfx_enable_bloom, DVAR_FLAG_CACHE, "Enable Bloom", true);
 DVAR_BOOL(gfx_enable_ibl, DVAR_FLAG_CACHE, "Enable IBL", false);
+DVAR_BOOL(gfx_occlusion_culling, DVAR_FLAG_CACHE, "Cull meshes hidden behind large occluders on the CPU", true);
+DVAR_BOOL(gfx_clustered_lighting, DVAR_FLAG_CACHE, "Assign point lights to view frustum clusters, lifts the point light limit", true);
+
+// Mesh LOD
+DVAR_BOOL(gfx_mesh_lod, DVAR_FLAG_CACHE, "Draw simplified levels of meshes that are small on screen", true);
+DVAR_FLOAT(gfx_mesh_lod_pixel_error, DVAR_FLAG_CACHE, "Largest error of a mesh LOD on screen, in pixels", 1.0f);
+DVAR_FLOAT(gfx_shadow_lod_bias, DVAR_FLAG_CACHE, "Scales the LOD error allowed in shadow maps", 4.0f);
+
+// resource upload
+DVAR_INT(gfx_upload_budget_kb, DVAR_FLAG_CACHE, "Bytes of requested textures and meshes created per frame, in KB", 16 * 1024);
+DVAR_FLOAT(gfx_upload_budget_ms, DVAR_FLAG_CACHE, "Time spent creating requested textures and meshes per frame", 4.0f);
 
 // SSAO
 DVAR_BOOL(gfx_ssao_enabled, DVAR_FLAG_CACHE, "Enable SSAO", true);
@@ -49,7 +49,7 @@ const char* ToString(RenderGraphName p_name) {
 }
 
 template<typename T>
-static auto CreateUniformCheckSize(GraphicsManager& p_graphics_manager, uint32_t p_max_count) {
+static auto CreateUniformCheckSize(IGraphicsManager& p_graphics_manager, uint32_t p_max_count) {
     static_assert(sizeof(T) % 256 == 0);
     GpuBufferDesc buffer_desc{};
     buffer_desc.slot = T::GetUniformBufferSlot();
@@ -58,6 +58,124 @@ static auto CreateUniformCheckSize(GraphicsManager& p_graphics_manager, uint32_t
     return p_graphics_manager.CreateConstantBuffer(buffer_desc);
 }
 
+template<typename T>
+static auto CreateStructuredBufferCheckSize(IGraphicsManager& p_graphics_manager, uint32_t p_max_count) {
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0);
+    GpuBufferDesc buffer_desc{};
+    buffer_desc.element_count = p_max_count;
+    buffer_desc.element_size = sizeof(T);
+    return p_graphics_manager.CreateStructuredBuffer(buffer_desc);
+}
+
+template<typename T>
+static void UpdateStructuredBuffer(IGraphicsManager& p_graphics_manager, const GpuStructuredBuffer* p_buffer, std::span<const T> p_data) {
+    if (p_data.empty()) {
+        return;
+    }
+
+    DEV_ASSERT(p_data.size() <= p_buffer->desc.element_count);
+    GpuBufferDesc buffer_desc{};
+    buffer_desc.element_count = static_cast<uint32_t>(p_data.size());
+    buffer_desc.element_size = sizeof(T);
+    buffer_desc.initial_data = p_data.data();
+    p_graphics_manager.UpdateBufferData(buffer_desc, p_buffer);
+}
+
+// Only the palette ranges that changed and the instance rows are written, the rest of the buffer
+// keeps what earlier frames uploaded.
+static void UpdateBoneBuffer(IGraphicsManager& p_graphics_manager, const GpuConstantBuffer* p_buffer, const FrameData& p_framedata) {
+    constexpr size_t ROW_SIZE = sizeof(Vector4f);
+    for (const BonePalette::Upload& upload : p_framedata.boneUploads) {
+        p_graphics_manager.UpdateConstantBufferRange(p_buffer,
+                                                     p_framedata.boneUploadRows.data() + upload.src_row,
+                                                     upload.row_count * ROW_SIZE,
+                                                     upload.dst_row * ROW_SIZE);
+    }
+
+    const auto& instance_rows = p_framedata.instanceRows;
+    if (!instance_rows.empty()) {
+        p_graphics_manager.UpdateConstantBufferRange(p_buffer,
+                                                     instance_rows.data(),
+                                                     instance_rows.size() * ROW_SIZE,
+                                                     p_framedata.instanceRowOffset * ROW_SIZE);
+    }
+}
+
+// Writes the slots of a SceneBuffer that changed, p_first_slot is where its slots start in p_buffer.
+// Ranges only, a whole buffer update would drop what earlier frames uploaded.
+template<typename T, typename UPLOAD>
+static void UpdateSceneBuffer(IGraphicsManager& p_graphics_manager,
+                              const GpuConstantBuffer* p_buffer,
+                              std::span<const UPLOAD> p_uploads,
+                              const T* p_values,
+                              uint32_t p_first_slot) {
+    for (const UPLOAD& upload : p_uploads) {
+        p_graphics_manager.UpdateConstantBufferRange(p_buffer,
+                                                     p_values + upload.src_index,
+                                                     upload.count * sizeof(T),
+                                                     (p_first_slot + upload.dst_index) * sizeof(T));
+    }
+}
+
+// the transient batches are written every frame, the scene batches only where they changed
+static void UpdateBatchBuffer(IGraphicsManager& p_graphics_manager, const GpuConstantBuffer* p_buffer, const FrameData& p_framedata) {
+    const auto& transient = p_framedata.batchCache.buffer;
+    size_t transient_count = transient.size();
+    if (transient_count > TRANSIENT_BATCH_COUNT) {
+        // the slots past the transient ones belong to the scene batches
+        LOG_ERROR("{} transient batches written, only {} fit", transient_count, TRANSIENT_BATCH_COUNT);
+        transient_count = TRANSIENT_BATCH_COUNT;
+    }
+    if (transient_count) {
+        p_graphics_manager.UpdateConstantBufferRange(p_buffer, transient.data(), transient_count * sizeof(PerBatchConstantBuffer), 0);
+    }
+
+    UpdateSceneBuffer<PerBatchConstantBuffer, SceneBuffer<PerBatchConstantBuffer>::Upload>(
+        p_graphics_manager, p_buffer, p_framedata.batchUploads, p_framedata.batchUploadValues.data(), TRANSIENT_BATCH_COUNT);
+}
+
+void CreateFrameConstantBuffers(IGraphicsManager& p_graphics_manager, FrameContext& p_frame) {
+    p_frame.batchCb = *::cave::CreateUniformCheckSize<PerBatchConstantBuffer>(p_graphics_manager, BATCH_BUFFER_COUNT);
+    p_frame.passCb = *::cave::CreateUniformCheckSize<PerPassConstantBuffer>(p_graphics_manager, 32);
+    p_frame.materialCb = *::cave::CreateUniformCheckSize<MaterialConstantBuffer>(p_graphics_manager, MATERIAL_BUFFER_COUNT);
+    p_frame.boneCb = *::cave::CreateUniformCheckSize<BoneConstantBuffer>(p_graphics_manager, BONE_BUFFER_MIN_ROW_COUNT / BONE_BLOCK_ROW_COUNT);
+    p_frame.emitterCb = *::cave::CreateUniformCheckSize<EmitterConstantBuffer>(p_graphics_manager, 32);
+    p_frame.pointShadowCb = *::cave::CreateUniformCheckSize<PointShadowConstantBuffer>(p_graphics_manager, 6 * MAX_POINT_LIGHT_SHADOW_COUNT);
+    p_frame.perFrameCb = *::cave::CreateUniformCheckSize<PerFrameConstantBuffer>(p_graphics_manager, 1);
+}
+
+void UploadFrameData(IGraphicsManager& p_graphics_manager, FrameContext& p_frame, const FrameData& p_framedata) {
+    UpdateBatchBuffer(p_graphics_manager, p_frame.batchCb.get(), p_framedata);
+    UpdateSceneBuffer<MaterialConstantBuffer, MaterialTable::Upload>(
+        p_graphics_manager, p_frame.materialCb.get(), p_framedata.materialUploads, p_framedata.materialUploadValues.data(), 0);
+    // the bone buffer grows with the palettes and instanced draws, the palette uploads every row
+    // again in the frame it grows
+    if (p_frame.boneCb->desc.element_count * BONE_BLOCK_ROW_COUNT < p_framedata.boneBufferRowCount) {
+        p_frame.boneCb = *::cave::CreateUniformCheckSize<BoneConstantBuffer>(p_graphics_manager, p_framedata.boneBufferRowCount / BONE_BLOCK_ROW_COUNT);
+    }
+    UpdateBoneBuffer(p_graphics_manager, p_frame.boneCb.get(), p_framedata);
+    p_graphics_manager.UpdateConstantBuffer(p_frame.passCb.get(), p_framedata.passCache);
+    // p_graphics_manager.UpdateConstantBuffer(p_frame.emitterCb.get(), p_framedata.emitterCache);
+
+    p_graphics_manager.UpdateConstantBuffer<PointShadowConstantBuffer, 6 * MAX_POINT_LIGHT_SHADOW_COUNT>(
+        p_frame.pointShadowCb.get(),
+        p_framedata.pointShadowCache);
+    p_graphics_manager.UpdateConstantBuffer(p_frame.perFrameCb.get(),
+                                            &p_framedata.perFrameCache,
+                                            sizeof(PerFrameConstantBuffer));
+
+    p_graphics_manager.BindConstantBufferSlot<PerFrameConstantBuffer>(p_frame.perFrameCb.get(), 0);
+
+    if (p_framedata.options.clusteredLightingEnabled && p_frame.pointLightBuffer) {
+        UpdateStructuredBuffer<GpuPointLight>(p_graphics_manager, p_frame.pointLightBuffer.get(), p_framedata.pointLights);
+        UpdateStructuredBuffer<uint32_t>(p_graphics_manager, p_frame.lightClusterBuffer.get(), p_framedata.lightClusters);
+        UpdateStructuredBuffer<uint32_t>(p_graphics_manager, p_frame.lightIndexBuffer.get(), p_framedata.lightIndices);
+        p_graphics_manager.BindStructuredBuffer(GetGlobalPointLightsSlot(), p_frame.pointLightBuffer.get());
+        p_graphics_manager.BindStructuredBuffer(GetGlobalLightClustersSlot(), p_frame.lightClusterBuffer.get());
+        p_graphics_manager.BindStructuredBuffer(GetGlobalLightIndicesSlot(), p_frame.lightIndexBuffer.get());
+    }
+}
+
 auto GraphicsManager::InitializeImpl() -> Result<void> {
     m_enableValidationLayer = DVAR_GET_BOOL(gfx_gpu_validation);
 
@@ -80,13 +198,15 @@ auto GraphicsManager::InitializeImpl() -> Result<void> {
 
     for (int i = 0; i < num_frames; ++i) {
         FrameContext& frame_context = *m_frameContexts[i].get();
-        frame_context.batchCb = *::cave::CreateUniformCheckSize<PerBatchConstantBuffer>(*this, 4096 * 16);
-        frame_context.passCb = *::cave::CreateUniformCheckSize<PerPassConstantBuffer>(*this, 32);
-        frame_context.materialCb = *::cave::CreateUniformCheckSize<MaterialConstantBuffer>(*this, 2048 * 16);
-        frame_context.boneCb = *::cave::CreateUniformCheckSize<BoneConstantBuffer>(*this, 16);
-        frame_context.emitterCb = *::cave::CreateUniformCheckSize<EmitterConstantBuffer>(*this, 32);
-        frame_context.pointShadowCb = *::cave::CreateUniformCheckSize<PointShadowConstantBuffer>(*this, 6 * MAX_POINT_LIGHT_SHADOW_COUNT);
-        frame_context.perFrameCb = *::cave::CreateUniformCheckSize<PerFrameConstantBuffer>(*this, 1);
+        CreateFrameConstantBuffers(*this, frame_context);
+
+        if constexpr (!USING(PLATFORM_WASM)) {
+            if (m_backend == Backend::OPENGL) {
+                frame_context.pointLightBuffer = *::cave::CreateStructuredBufferCheckSize<GpuPointLight>(*this, MAX_CLUSTERED_LIGHT_COUNT);
+                frame_context.lightClusterBuffer = *::cave::CreateStructuredBufferCheckSize<uint32_t>(*this, LIGHT_CLUSTER_COUNT);
+                frame_context.lightIndexBuffer = *::cave::CreateStructuredBufferCheckSize<uint32_t>(*this, MAX_LIGHT_INDEX_COUNT);
+            }
+        }
     }
 
     DEV_ASSERT(m_pipelineStateManager);
@@ -106,20 +226,68 @@ auto GraphicsManager::InitializeImpl() -> Result<void> {
 
 void GraphicsManager::EventReceived(std::shared_ptr<IEvent> p_event) {
     if (ResizeEvent* e = dynamic_cast<ResizeEvent*>(p_event.get()); e) {
-        OnWindowResize(e->GetWidth(), e->GetHeight());
+        std::lock_guard lock(m_resizeMutex);
+        m_pendingResize = Vector2i(e->GetWidth(), e->GetHeight());
     }
 }
 
 void GraphicsManager::SetPipelineState(PipelineStateName p_name) {
-    SetPipelineStateImpl(p_name);
+    if (m_renderStateCache.SetPipelineState(p_name)) {
+        SetPipelineStateImpl(p_name);
+    }
 }
 
-void GraphicsManager::RequestTexture(ImageAsset* p_image) {
-    m_loadedImages.push(p_image);
+void GraphicsManager::SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
+    // d3d11 unbinds shader resources that become render targets
+    m_renderStateCache.InvalidateTextures();
+    SetRenderTargetImpl(p_framebuffer, p_index, p_mip_level);
 }
 
-void GraphicsManager::RequestMesh(MeshAsset* p_mesh) {
-    m_loadedMeshes.push(p_mesh);
+void GraphicsManager::SetMesh(const GpuMesh* p_mesh) {
+    if (m_renderStateCache.SetMesh(p_mesh)) {
+        SetMeshImpl(p_mesh);
+    }
+}
+
+void GraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
+    if (m_renderStateCache.BindConstantBufferRange(p_buffer, p_size, p_offset)) {
+        BindConstantBufferRangeImpl(p_buffer, p_size, p_offset);
+    }
+}
+
+void GraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
+    m_renderStateCache.InvalidateConstantBuffer(p_buffer);
+    UpdateConstantBufferImpl(p_buffer, p_data, p_size);
+}
+
+void GraphicsManager::UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) {
+    m_renderStateCache.InvalidateConstantBuffer(p_buffer);
+    UpdateConstantBufferRangeImpl(p_buffer, p_data, p_size, p_offset);
+}
+
+void GraphicsManager::BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) {
+    if (m_renderStateCache.BindTexture(p_dimension, p_handle, p_slot)) {
+        BindTextureImpl(p_dimension, p_handle, p_slot);
+    }
+}
+
+void GraphicsManager::UnbindTexture(Dimension p_dimension, int p_slot) {
+    m_renderStateCache.InvalidateTexture(p_slot);
+    UnbindTextureImpl(p_dimension, p_slot);
+}
+
+void GraphicsManager::GenerateMipmap(const GpuTexture* p_texture) {
+    // opengl binds the texture to the active slot to generate the mips
+    m_renderStateCache.InvalidateTextures();
+    GenerateMipmapImpl(p_texture);
+}
+
+void GraphicsManager::RequestTexture(std::shared_ptr<ImageAsset> p_image) {
+    m_assetUploader.RequestTexture(std::move(p_image));
+}
+
+void GraphicsManager::RequestMesh(std::shared_ptr<MeshAsset> p_mesh) {
+    m_assetUploader.RequestMesh(std::move(p_mesh));
 }
 
 void GraphicsManager::UpdateBuffer(const GpuBufferDesc& p_desc, GpuBuffer* p_buffer) {
@@ -129,6 +297,15 @@ void GraphicsManager::UpdateBuffer(const GpuBufferDesc& p_desc, GpuBuffer* p_buf
 }
 
 auto GraphicsManager::CreateMesh(const MeshAsset& p_mesh) -> Result<std::shared_ptr<GpuMesh>> {
+    std::vector<uint32_t> staging_indices;
+    auto ret = CreateGpuMesh(p_mesh, staging_indices);
+    if (ret) {
+        p_mesh.gpuResource = *ret;
+    }
+    return ret;
+}
+
+auto GraphicsManager::CreateGpuMesh(const MeshAsset& p_mesh, std::vector<uint32_t>& p_staging_indices) -> Result<std::shared_ptr<GpuMesh>> {
     constexpr uint32_t count = std::to_underlying(VertexAttributeName::COUNT);
     std::array<VertexAttributeName, count> attribs = {
         VertexAttributeName::POSITION,
@@ -176,29 +353,37 @@ auto GraphicsManager::CreateMesh(const MeshAsset& p_mesh) -> Result<std::shared_
         buffer_desc.dynamic = is_dynamic;
     }
 
+    // the LOD levels follow the full mesh in the same index buffer
+    p_staging_indices.clear();
+    if (!p_mesh.lod_indices.empty()) {
+        p_staging_indices.insert(p_staging_indices.end(), p_mesh.indices.begin(), p_mesh.indices.end());
+        p_staging_indices.insert(p_staging_indices.end(), p_mesh.lod_indices.begin(), p_mesh.lod_indices.end());
+    }
+    const std::vector<uint32_t>& indices = p_staging_indices.empty() ? p_mesh.indices : p_staging_indices;
+
     GpuBufferDesc ib_desc;
     GpuBufferDesc* ib_desc_ptr = nullptr;
-    if (!p_mesh.indices.empty()) {
+    if (!indices.empty()) {
         ib_desc = GpuBufferDesc{
             .type = GpuBufferType::INDEX,
             .element_size = sizeof(uint32_t),
-            .element_count = (uint32_t)p_mesh.indices.size(),
-            .initial_data = p_mesh.indices.data(),
+            .element_count = (uint32_t)indices.size(),
+            .initial_data = indices.data(),
         };
         ib_desc_ptr = &ib_desc;
     }
 
     auto ret = CreateMeshImpl(desc, count, vb_descs.data(), ib_desc_ptr);
+    m_renderStateCache.InvalidateMesh();
     if (!ret) {
         return CAVE_ERROR(ret.error());
     }
 
-    p_mesh.gpuResource = *ret;
     return ret;
 }
 
 // @TODO: refactor this
-static void FillTextureAndSamplerDesc(const ImageAsset* p_image, GpuTextureDesc& p_texture_desc, SamplerDesc& p_sampler_desc) {
+void FillTextureAndSamplerDesc(const ImageAsset* p_image, GpuTextureDesc& p_texture_desc, SamplerDesc& p_sampler_desc) {
     DEV_ASSERT(p_image);
     bool is_hdr_file = false;
 
@@ -241,69 +426,60 @@ static void FillTextureAndSamplerDesc(const ImageAsset* p_image, GpuTextureDesc&
 }
 
 std::shared_ptr<GpuTexture> GraphicsManager::CreateTexture(ImageAsset* p_image) {
+    p_image->gpu_texture = CreateGpuTexture(p_image);
+    return p_image->gpu_texture;
+}
+
+std::shared_ptr<GpuTexture> GraphicsManager::CreateGpuTexture(const ImageAsset* p_image) {
     DEV_ASSERT(p_image);
 
     GpuTextureDesc texture_desc{};
     SamplerDesc sampler_desc{};
     FillTextureAndSamplerDesc(p_image, texture_desc, sampler_desc);
 
-    p_image->gpu_texture = CreateTexture(texture_desc, sampler_desc);
-    return p_image->gpu_texture;
+    return CreateTexture(texture_desc, sampler_desc);
 }
 
 void GraphicsManager::Update(Scene* p_scene) {
-    CAVE_PROFILE_EVENT();
     unused(p_scene);
 
-    // @TODO: make it a function
-    auto loaded_images = m_loadedImages.pop_all();
-    while (!loaded_images.empty()) {
-        ImageAsset* image = loaded_images.front();
-        DEV_ASSERT(image);
-        loaded_images.pop();
+    RenderFrame(m_app->GetRenderSystem()->GetFrameData());
+    PublishCreatedResources();
+}
 
-        if (!image->gpu_texture) {
-            CreateTexture(image);
-        }
-    }
-    auto loaded_meshes = m_loadedMeshes.pop_all();
-    while (!loaded_meshes.empty()) {
-        MeshAsset* mesh = loaded_meshes.front();
-        DEV_ASSERT(mesh);
-        loaded_meshes.pop();
+void GraphicsManager::PublishCreatedResources() {
+    m_assetUploader.PublishCreatedResources();
+}
 
-        if (!mesh->gpuResource) {
-            CreateMesh(*mesh);
-        }
+void GraphicsManager::RenderFrame(const FrameData* p_framedata) {
+    CAVE_PROFILE_EVENT();
+
+    m_assetUploader.CreateRequestedResources(
+        p_framedata,
+        [&](const ImageAsset& p_image) { return CreateGpuTexture(&p_image); },
+        [&](const MeshAsset& p_mesh) { return CreateGpuMesh(p_mesh, m_stagingIndices); });
+
+    Vector2i resize(0, 0);
+    {
+        std::lock_guard lock(m_resizeMutex);
+        std::swap(resize, m_pendingResize);
+    }
+    if (resize.x > 0 && resize.y > 0) {
+        OnWindowResize(resize.x, resize.y);
     }
 
     {
         CAVE_PROFILE_EVENT("Render");
         BeginFrame();
-
-        auto data = m_app->GetRenderSystem()->GetFrameData();
+        m_renderStateCache.NewFrame();
 
         // @TODO: remove this
         // if (p_scene) {
         //    UpdateEmitters(*p_scene);
         //}
 
-        if (data) {
-            auto& frame = GetCurrentFrame();
-            UpdateConstantBuffer(frame.batchCb.get(), data->batchCache.buffer);
-            UpdateConstantBuffer(frame.materialCb.get(), data->materialCache.buffer);
-            UpdateConstantBuffer(frame.boneCb.get(), data->boneCache.buffer);
-            UpdateConstantBuffer(frame.passCb.get(), data->passCache);
-            // UpdateConstantBuffer(frame.emitterCb.get(), data->emitterCache);
-
-            UpdateConstantBuffer<PointShadowConstantBuffer, 6 * MAX_POINT_LIGHT_SHADOW_COUNT>(
-                frame.pointShadowCb.get(),
-                data->pointShadowCache);
-            UpdateConstantBuffer(frame.perFrameCb.get(),
-                                 &data->perFrameCache,
-                                 sizeof(PerFrameConstantBuffer));
-
-            BindConstantBufferSlot<PerFrameConstantBuffer>(frame.perFrameCb.get(), 0);
+        if (const FrameData* data = p_framedata) {
+            UploadFrameData(*this, GetCurrentFrame(), *data);
 
             // @HACK
             switch (m_backend) {
@@ -460,6 +636,7 @@ RenderGraph* GraphicsManager::GetActiveRenderGraph() {
 
 std::shared_ptr<GpuTexture> GraphicsManager::CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) {
     auto texture = CreateTextureImpl(p_texture_desc, p_sampler_desc);
+    m_renderStateCache.InvalidateTextures();
     if (p_texture_desc.type != AttachmentType::NONE) {
         auto [_, inserted] = m_resourceLookup.try_emplace(texture->desc.name, texture);
         if (!inserted) {
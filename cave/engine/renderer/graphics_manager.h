@@ -1,11 +1,12 @@
 #pragma once
-#include "engine/core/base/concurrent_queue.h"
 #include "engine/core/base/singleton.h"
 #include "engine/math/geomath.h"
 #include "engine/render_graph/framebuffer.h"
 #include "engine/render_graph/render_graph.h"
+#include "engine/renderer/asset_uploader.h"
 #include "engine/renderer/gpu_resource.h"
 #include "engine/renderer/pipeline_state.h"
+#include "engine/renderer/render_state_cache.h"
 #include "engine/runtime/graphics_manager_interface.h"
 #include "engine/runtime/pipeline_state_manager.h"
 
@@ -37,8 +38,20 @@ struct FrameContext {
     std::shared_ptr<GpuConstantBuffer> emitterCb;
     std::shared_ptr<GpuConstantBuffer> pointShadowCb;
     std::shared_ptr<GpuConstantBuffer> perFrameCb;
+    // clustered lighting, only where the lighting shader reads storage buffers
+    std::shared_ptr<GpuStructuredBuffer> pointLightBuffer;
+    std::shared_ptr<GpuStructuredBuffer> lightClusterBuffer;
+    std::shared_ptr<GpuStructuredBuffer> lightIndexBuffer;
 };
 
+// the constant buffers of a frame, shared by every backend that runs the render graphs
+void CreateFrameConstantBuffers(IGraphicsManager& p_graphics_manager, FrameContext& p_frame);
+// writes what changed in p_framedata to the buffers of p_frame and binds the per frame constants
+void UploadFrameData(IGraphicsManager& p_graphics_manager, FrameContext& p_frame, const FrameData& p_framedata);
+
+// @TODO: refactor this
+void FillTextureAndSamplerDesc(const ImageAsset* p_image, GpuTextureDesc& p_texture_desc, SamplerDesc& p_sampler_desc);
+
 class GraphicsManager : public IGraphicsManager,
                         public Singleton<GraphicsManager> {
 public:
@@ -50,9 +63,13 @@ public:
     auto InitializeImpl() -> Result<void> final;
     void Update(Scene* p_scene) override;
 
+    void RenderFrame(const FrameData* p_framedata) override;
+    void PublishCreatedResources() override;
+
     // resource
     void UpdateBufferData(const GpuBufferDesc& p_desc, const GpuStructuredBuffer* p_buffer) override;
 
+    void SetRenderTarget(const Framebuffer* p_framebuffer, int p_index = 0, int p_mip_level = 0) final;
     void BeginDrawPass(const Framebuffer* p_framebuffer) override;
     void EndDrawPass(const Framebuffer* p_framebuffer) override;
 
@@ -65,14 +82,23 @@ public:
                                 const GpuBufferDesc* p_vb_descs,
                                 const GpuBufferDesc* p_ib_desc) -> Result<std::shared_ptr<GpuMesh>> = 0;
 
+    // redundant calls are dropped here, backends implement the *Impl functions
+    void SetMesh(const GpuMesh* p_mesh) final;
     void SetPipelineState(PipelineStateName p_name) override;
+    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) final;
+    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) final;
+    void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) final;
+    using IGraphicsManager::UpdateConstantBuffer;
+    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) final;
+    void UnbindTexture(Dimension p_dimension, int p_slot) final;
+    void GenerateMipmap(const GpuTexture* p_texture) final;
 
     std::shared_ptr<GpuTexture> CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) override;
     std::shared_ptr<GpuTexture> CreateTexture(ImageAsset* p_image) override;
     std::shared_ptr<GpuTexture> FindTexture(std::string_view p_name) const override;
 
-    void RequestTexture(ImageAsset* p_image) override;
-    void RequestMesh(MeshAsset* p_mesh) override;
+    void RequestTexture(std::shared_ptr<ImageAsset> p_image) override;
+    void RequestMesh(std::shared_ptr<MeshAsset> p_mesh) override;
 
     void BeginEvent(std::string_view p_event) override { unused(p_event); }
     void EndEvent() override {}
@@ -88,12 +114,31 @@ public:
     RenderGraph* GetActiveRenderGraph() override;
     FrameContext& GetCurrentFrame() override { return *(m_frameContexts[m_frameIndex].get()); }
 
+    // the passes are recorded on the device context
+    int GetRecordingContextCount() const override { return 0; }
+    IGraphicsManager& BeginRecording(int p_index) override {
+        unused(p_index);
+        return *this;
+    }
+
     void DrawSkybox() override;
 
     void EventReceived(std::shared_ptr<IEvent> p_event) final;
 
+    // issued and filtered calls of the last frame
+    const RenderStateCache::Stats& GetRenderStateStats() const { return m_renderStateCache.GetLastFrameStats(); }
+    const UploadQueue::Stats& GetUploadStats() const { return m_assetUploader.GetStats(); }
+
 protected:
     virtual auto InitializeInternal() -> Result<void> = 0;
+    virtual void SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) = 0;
+    virtual void SetMeshImpl(const GpuMesh* p_mesh) = 0;
+    virtual void BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) = 0;
+    virtual void UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) = 0;
+    virtual void UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) = 0;
+    virtual void BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) = 0;
+    virtual void UnbindTextureImpl(Dimension p_dimension, int p_slot) = 0;
+    virtual void GenerateMipmapImpl(const GpuTexture* p_texture) = 0;
     void BeginFrame() override;
     void EndFrame() override;
     void MoveToNextFrame() override;
@@ -107,14 +152,22 @@ protected:
 
     std::unordered_map<std::string_view, std::shared_ptr<GpuTexture>> m_resourceLookup;
 
-    ConcurrentQueue<ImageAsset*> m_loadedImages;
-    ConcurrentQueue<MeshAsset*> m_loadedMeshes;
+    // requested resources are created a few per frame, on the thread that renders
+    AssetUploader m_assetUploader;
+    // indices of a mesh and its LOD levels are copied together, the buffer is kept across uploads
+    std::vector<uint32_t> m_stagingIndices;
+
+    // window resizes are applied by the next RenderFrame(), which can run on the render thread
+    std::mutex m_resizeMutex;
+    Vector2i m_pendingResize{ 0, 0 };
 
     std::shared_ptr<PipelineStateManager> m_pipelineStateManager;
     std::vector<std::shared_ptr<FrameContext>> m_frameContexts;
     int m_frameIndex{ 0 };
     const int m_frameCount;
 
+    RenderStateCache m_renderStateCache;
+
     std::shared_ptr<GpuMesh> m_screenQuadBuffers;
     std::shared_ptr<GpuMesh> m_skyboxBuffers;
 
@@ -123,6 +176,10 @@ protected:
 
 protected:
     void UpdateEmitters(const Scene& p_scene) override;
+
+private:
+    auto CreateGpuMesh(const MeshAsset& p_mesh, std::vector<uint32_t>& p_staging_indices) -> Result<std::shared_ptr<GpuMesh>>;
+    std::shared_ptr<GpuTexture> CreateGpuTexture(const ImageAsset* p_image);
 };
 
 }  // namespace cave
@@ -0,0 +1,236 @@
+#include "light_clusters.h"
+
+#include <bit>
+
+#include "engine/debugger/profiler.h"
+#include "engine/systems/job_system/job_system.h"
+
+#if USING(MATH_ENABLE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+namespace cave {
+
+static_assert(LIGHT_CLUSTER_X % 4 == 0 && LIGHT_CLUSTER_X <= 32, "a row is tested 4 tiles at a time into a 32 bit mask");
+static_assert(MAX_LIGHT_INDEX_COUNT <= (1 << LIGHT_CLUSTER_OFFSET_BITS));
+static_assert(MAX_CLUSTERED_LIGHT_COUNT < (1 << (32 - LIGHT_CLUSTER_OFFSET_BITS)));
+
+// distance from p_value to [p_min, p_max], 0 inside
+static float AxisDistance(float p_value, float p_min, float p_max) {
+    return glm::max(glm::max(p_min - p_value, p_value - p_max), 0.0f);
+}
+
+static int ToTile(float p_ndc, int p_tile_count) {
+    const int tile = static_cast<int>(glm::floor((0.5f * p_ndc + 0.5f) * p_tile_count));
+    return glm::clamp(tile, 0, p_tile_count - 1);
+}
+
+void LightClusterBuilder::Build(const Matrix4x4f& p_view_matrix,
+                                const Matrix4x4f& p_projection,
+                                float p_near,
+                                float p_far,
+                                std::span<const GpuPointLight> p_lights,
+                                memory::ArenaVector<uint32_t>& p_out_clusters,
+                                memory::ArenaVector<uint32_t>& p_out_indices) {
+    CAVE_PROFILE_EVENT();
+    DEV_ASSERT(p_near > 0.0f && p_far > p_near);
+    DEV_ASSERT(p_lights.size() <= MAX_CLUSTERED_LIGHT_COUNT);
+
+    SetupSlices(p_projection, p_near, p_far);
+    m_stats = Stats{};
+    m_stats.light_count = static_cast<uint32_t>(p_lights.size());
+
+    m_bounds.clear();
+    for (uint32_t light_idx = 0; light_idx < p_lights.size(); ++light_idx) {
+        LightBounds bounds;
+        if (ComputeBounds(p_view_matrix, p_lights[light_idx], bounds)) {
+            bounds.index = light_idx;
+            m_bounds.push_back(bounds);
+        }
+    }
+    m_stats.visible_light_count = static_cast<uint32_t>(m_bounds.size());
+
+    m_clusterLights.resize(LIGHT_CLUSTER_COUNT);
+    for (auto& lights : m_clusterLights) {
+        lights.clear();
+    }
+
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(LIGHT_CLUSTER_Z, 1, [&](jobsystem::JobArgs p_args) { AssignSlice(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    for (int z = 0; z < LIGHT_CLUSTER_Z; ++z) {
+        AssignSlice(z);
+    }
+#endif
+
+    // compact the lists in cluster order
+    p_out_clusters.clear();
+    p_out_clusters.reserve(LIGHT_CLUSTER_COUNT);
+    p_out_indices.clear();
+    for (const auto& lights : m_clusterLights) {
+        const uint32_t offset = static_cast<uint32_t>(p_out_indices.size());
+        uint32_t count = static_cast<uint32_t>(lights.size());
+        if (offset + count > MAX_LIGHT_INDEX_COUNT) {
+            m_stats.overflow_count += offset + count - MAX_LIGHT_INDEX_COUNT;
+            count = MAX_LIGHT_INDEX_COUNT - offset;
+        }
+
+        p_out_indices.insert(p_out_indices.end(), lights.begin(), lights.begin() + count);
+        p_out_clusters.push_back((count << LIGHT_CLUSTER_OFFSET_BITS) | offset);
+        m_stats.max_cluster_light_count = glm::max(m_stats.max_cluster_light_count, count);
+    }
+    m_stats.index_count = static_cast<uint32_t>(p_out_indices.size());
+}
+
+void LightClusterBuilder::SetupSlices(const Matrix4x4f& p_projection, float p_near, float p_far) {
+    // with d the view depth, ndc.x = x * P[0][0] / d - P[2][0], same for y
+    m_projectionX[0] = p_projection[0][0];
+    m_projectionX[1] = p_projection[2][0];
+    m_projectionY[0] = p_projection[1][1];
+    m_projectionY[1] = p_projection[2][1];
+
+    m_sliceScale = LIGHT_CLUSTER_Z / glm::log2(p_far / p_near);
+    m_sliceBias = -glm::log2(p_near) * m_sliceScale;
+
+    // the edge of a tile is a plane through the camera, the box of a cluster spans it at both depths
+    auto fill_range = [](const float* p_projection_terms, int p_tile_count, float p_near_depth, float p_far_depth, float* p_min, float* p_max) {
+        for (int tile = 0; tile < p_tile_count; ++tile) {
+            const float lo = (-1.0f + 2.0f * tile / p_tile_count + p_projection_terms[1]) / p_projection_terms[0];
+            const float hi = (-1.0f + 2.0f * (tile + 1) / p_tile_count + p_projection_terms[1]) / p_projection_terms[0];
+            p_min[tile] = lo * (lo >= 0.0f ? p_near_depth : p_far_depth);
+            p_max[tile] = hi * (hi >= 0.0f ? p_far_depth : p_near_depth);
+        }
+    };
+
+    for (int z = 0; z < LIGHT_CLUSTER_Z; ++z) {
+        Slice& slice = m_slices[z];
+        slice.near_depth = z == 0 ? p_near : m_slices[z - 1].far_depth;
+        slice.far_depth = z == LIGHT_CLUSTER_Z - 1 ? p_far : glm::exp2((z + 1 - m_sliceBias) / m_sliceScale);
+        fill_range(m_projectionX, LIGHT_CLUSTER_X, slice.near_depth, slice.far_depth, slice.min_x, slice.max_x);
+        fill_range(m_projectionY, LIGHT_CLUSTER_Y, slice.near_depth, slice.far_depth, slice.min_y, slice.max_y);
+    }
+}
+
+bool LightClusterBuilder::ComputeBounds(const Matrix4x4f& p_view_matrix, const GpuPointLight& p_light, LightBounds& p_out_bounds) const {
+    const Vector4f center = p_view_matrix * Vector4f(p_light.position, 1.0f);
+    const float radius = p_light.max_distance;
+    const float depth = -center.z;
+
+    // only the part of the sphere between the near and the far plane is lit on screen
+    const float min_depth = glm::max(depth - radius, m_slices.front().near_depth);
+    const float max_depth = glm::min(depth + radius, m_slices.back().far_depth);
+    if (min_depth > max_depth) {
+        return false;
+    }
+
+    // x / d is monotonic in x and d, the extremes of the sphere's box are at its corners
+    auto ndc_range = [&](float p_center, const float* p_projection_terms, float& p_min, float& p_max) {
+        const float lo = p_center - radius;
+        const float hi = p_center + radius;
+        p_min = glm::min(lo / min_depth, lo / max_depth) * p_projection_terms[0] - p_projection_terms[1];
+        p_max = glm::max(hi / min_depth, hi / max_depth) * p_projection_terms[0] - p_projection_terms[1];
+        return p_max >= -1.0f && p_min <= 1.0f;
+    };
+
+    float min_x, max_x, min_y, max_y;
+    if (!ndc_range(center.x, m_projectionX, min_x, max_x) || !ndc_range(center.y, m_projectionY, min_y, max_y)) {
+        return false;
+    }
+
+    p_out_bounds.center = center.xyz;
+    p_out_bounds.radius = radius;
+    p_out_bounds.min_x = ToTile(min_x, LIGHT_CLUSTER_X);
+    p_out_bounds.max_x = ToTile(max_x, LIGHT_CLUSTER_X);
+    p_out_bounds.min_y = ToTile(min_y, LIGHT_CLUSTER_Y);
+    p_out_bounds.max_y = ToTile(max_y, LIGHT_CLUSTER_Y);
+    p_out_bounds.min_z = glm::clamp(static_cast<int>(glm::floor(glm::log2(min_depth) * m_sliceScale + m_sliceBias)), 0, LIGHT_CLUSTER_Z - 1);
+    p_out_bounds.max_z = glm::clamp(static_cast<int>(glm::floor(glm::log2(max_depth) * m_sliceScale + m_sliceBias)), 0, LIGHT_CLUSTER_Z - 1);
+    return true;
+}
+
+void LightClusterBuilder::AssignSlice(int p_z) {
+    const Slice& slice = m_slices[p_z];
+
+    for (const LightBounds& bounds : m_bounds) {
+        if (p_z < bounds.min_z || p_z > bounds.max_z) {
+            continue;
+        }
+
+        const float depth = -bounds.center.z;
+        const float dz = AxisDistance(depth, slice.near_depth, slice.far_depth);
+        const float remaining = bounds.radius * bounds.radius - dz * dz;
+        if (remaining < 0.0f) {
+            continue;
+        }
+
+        // tiles outside the screen rectangle of the light are skipped
+        const uint32_t column_mask = static_cast<uint32_t>((uint64_t(2) << bounds.max_x) - (uint64_t(1) << bounds.min_x));
+
+        for (int y = bounds.min_y; y <= bounds.max_y; ++y) {
+            const float dy = AxisDistance(bounds.center.y, slice.min_y[y], slice.max_y[y]);
+            const float threshold = remaining - dy * dy;
+            if (threshold < 0.0f) {
+                continue;
+            }
+
+            uint32_t mask = 0;
+#if USING(MATH_ENABLE_SIMD_SSE)
+            const __m128 center_x = _mm_set1_ps(bounds.center.x);
+            const __m128 threshold4 = _mm_set1_ps(threshold);
+            const __m128 zero = _mm_setzero_ps();
+            for (int x = 0; x < LIGHT_CLUSTER_X; x += 4) {
+                const __m128 below = _mm_sub_ps(_mm_load_ps(slice.min_x + x), center_x);
+                const __m128 above = _mm_sub_ps(center_x, _mm_load_ps(slice.max_x + x));
+                const __m128 dx = _mm_max_ps(_mm_max_ps(below, above), zero);
+                const __m128 inside = _mm_cmple_ps(_mm_mul_ps(dx, dx), threshold4);
+                mask |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << x;
+            }
+#else
+            for (int x = 0; x < LIGHT_CLUSTER_X; ++x) {
+                const float dx = AxisDistance(bounds.center.x, slice.min_x[x], slice.max_x[x]);
+                mask |= static_cast<uint32_t>(dx * dx <= threshold) << x;
+            }
+#endif
+
+            mask &= column_mask;
+            while (mask) {
+                const int x = std::countr_zero(mask);
+                mask &= mask - 1;
+                m_clusterLights[ClusterIndex(x, y, p_z)].push_back(bounds.index);
+            }
+        }
+    }
+}
+
+int LightClusterBuilder::FindCluster(const Vector3f& p_view_position) const {
+    const float depth = -p_view_position.z;
+    if (depth <= 0.0f) {
+        return -1;
+    }
+
+    const float ndc_x = p_view_position.x * m_projectionX[0] / depth - m_projectionX[1];
+    const float ndc_y = p_view_position.y * m_projectionY[0] / depth - m_projectionY[1];
+    if (glm::abs(ndc_x) > 1.0f || glm::abs(ndc_y) > 1.0f) {
+        return -1;
+    }
+
+    const int z = glm::clamp(static_cast<int>(glm::floor(glm::log2(depth) * m_sliceScale + m_sliceBias)), 0, LIGHT_CLUSTER_Z - 1);
+    return ClusterIndex(ToTile(ndc_x, LIGHT_CLUSTER_X), ToTile(ndc_y, LIGHT_CLUSTER_Y), z);
+}
+
+bool LightClusterBuilder::Intersects(int p_cluster, const Vector3f& p_view_center, float p_radius) const {
+    DEV_ASSERT_INDEX(p_cluster, LIGHT_CLUSTER_COUNT);
+    const int x = p_cluster % LIGHT_CLUSTER_X;
+    const int y = (p_cluster / LIGHT_CLUSTER_X) % LIGHT_CLUSTER_Y;
+    const Slice& slice = m_slices[p_cluster / (LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y)];
+
+    // same order of operations as AssignSlice()
+    const float dz = AxisDistance(-p_view_center.z, slice.near_depth, slice.far_depth);
+    const float dy = AxisDistance(p_view_center.y, slice.min_y[y], slice.max_y[y]);
+    const float dx = AxisDistance(p_view_center.x, slice.min_x[x], slice.max_x[x]);
+    return dx * dx <= (p_radius * p_radius - dz * dz) - dy * dy;
+}
+
+}  // namespace cave
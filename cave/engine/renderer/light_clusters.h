@@ -0,0 +1,90 @@
+#pragma once
+#include "engine/math/geomath.h"
+#include "engine/memory/arena_allocator.h"
+
+namespace cave {
+#include "structured_buffer.hlsl.h"
+}  // namespace cave
+
+namespace cave {
+
+// Clustered light assignment. The camera frustum is cut into LIGHT_CLUSTER_X x LIGHT_CLUSTER_Y
+// screen tiles and LIGHT_CLUSTER_Z slices, exponential in view depth, and every cluster gets the
+// list of point lights whose sphere touches its view space box. Slices are assigned on the job
+// system, the rows of a slice are tested against a light four tiles at a time.
+class LightClusterBuilder {
+public:
+    struct Stats {
+        uint32_t light_count = 0;
+        // lights touching at least one cluster
+        uint32_t visible_light_count = 0;
+        uint32_t index_count = 0;
+        uint32_t max_cluster_light_count = 0;
+        // indices dropped because the list was full
+        uint32_t overflow_count = 0;
+    };
+
+    // p_projection is the perspective projection of the camera, only its x and y terms are used,
+    // the slices go from p_near to p_far. p_out_clusters gets LIGHT_CLUSTER_COUNT packed clusters
+    // indexing p_out_indices, which indexes p_lights.
+    void Build(const Matrix4x4f& p_view_matrix,
+               const Matrix4x4f& p_projection,
+               float p_near,
+               float p_far,
+               std::span<const GpuPointLight> p_lights,
+               memory::ArenaVector<uint32_t>& p_out_clusters,
+               memory::ArenaVector<uint32_t>& p_out_indices);
+
+    // cluster of a view space position, the lighting shaders do the same lookup
+    int FindCluster(const Vector3f& p_view_position) const;
+
+    // true if the sphere touches the view space box of the cluster, the test the lists are built with
+    bool Intersects(int p_cluster, const Vector3f& p_view_center, float p_radius) const;
+
+    // the slice of a view depth d is log2(d) * scale + bias
+    float GetSliceScale() const { return m_sliceScale; }
+    float GetSliceBias() const { return m_sliceBias; }
+
+    const Stats& GetStats() const { return m_stats; }
+
+    static int ClusterIndex(int p_x, int p_y, int p_z) {
+        return (p_z * LIGHT_CLUSTER_Y + p_y) * LIGHT_CLUSTER_X + p_x;
+    }
+
+private:
+    // view space sphere and the clusters its screen rectangle and depth range cover
+    struct LightBounds {
+        Vector3f center;
+        float radius;
+        int min_x, max_x;
+        int min_y, max_y;
+        int min_z, max_z;
+        uint32_t index;
+    };
+
+    // x and y ranges of the cluster boxes of a slice, laid out for 4 wide loads
+    struct Slice {
+        alignas(16) float min_x[LIGHT_CLUSTER_X];
+        alignas(16) float max_x[LIGHT_CLUSTER_X];
+        alignas(16) float min_y[LIGHT_CLUSTER_Y];
+        alignas(16) float max_y[LIGHT_CLUSTER_Y];
+        float near_depth;
+        float far_depth;
+    };
+
+    void SetupSlices(const Matrix4x4f& p_projection, float p_near, float p_far);
+    bool ComputeBounds(const Matrix4x4f& p_view_matrix, const GpuPointLight& p_light, LightBounds& p_out_bounds) const;
+    void AssignSlice(int p_z);
+
+    std::array<Slice, LIGHT_CLUSTER_Z> m_slices;
+    std::vector<LightBounds> m_bounds;
+    // light indices of every cluster, kept between frames for their capacity
+    std::vector<std::vector<uint32_t>> m_clusterLights;
+    float m_projectionX[2] = { 1.0f, 0.0f };
+    float m_projectionY[2] = { 1.0f, 0.0f };
+    float m_sliceScale = 0.0f;
+    float m_sliceBias = 0.0f;
+    Stats m_stats;
+};
+
+}  // namespace cave
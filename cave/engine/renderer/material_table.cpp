@@ -0,0 +1,88 @@
+#include "material_table.h"
+
+namespace cave {
+
+static size_t HashConstants(const MaterialConstantBuffer& p_constants) {
+    const std::string_view bytes(reinterpret_cast<const char*>(&p_constants), sizeof(p_constants));
+    return std::hash<std::string_view>{}(bytes);
+}
+
+MaterialTable::MaterialTable(uint32_t p_capacity, uint32_t p_copy_count)
+    : m_buffer(p_capacity, p_copy_count) {
+}
+
+void MaterialTable::BeginFrame() {
+    ++m_frame;
+    m_buffer.BeginFrame();
+}
+
+int MaterialTable::Update(ecs::Entity p_id, const MaterialConstantBuffer& p_constants) {
+    Material& material = m_materials[p_id];
+
+    // most materials don't change, the entry they had last frame still holds their constants
+    const bool unchanged = material.index >= 0 &&
+                           m_buffer.Find(material.key) == material.index &&
+                           memcmp(&m_buffer.Get(material.index), &p_constants, sizeof(p_constants)) == 0;
+    if (!unchanged) {
+        material.key = FindKey(p_constants, HashConstants(p_constants));
+    }
+
+    material.frame = m_frame;
+    material.index = m_buffer.Update(material.key, p_constants);
+    return material.index;
+}
+
+void MaterialTable::EndFrame(memory::ArenaVector<Upload>& p_uploads,
+                             memory::ArenaVector<MaterialConstantBuffer>& p_values,
+                             memory::ArenaVector<MaterialConstantBuffer>& p_table) {
+    const bool retire = m_frame % Buffer::RETIRE_FRAME_COUNT == 0;
+    if (retire) {
+        std::erase_if(m_materials, [&](const auto& p_pair) {
+            return m_frame - p_pair.second.frame >= Buffer::RETIRE_FRAME_COUNT;
+        });
+    }
+
+    m_buffer.EndFrame(p_uploads, p_values);
+
+    if (retire) {
+        std::erase_if(m_keys, [&](const auto& p_pair) { return m_buffer.Find(p_pair.second) < 0; });
+    }
+
+    const std::span<const MaterialConstantBuffer> values = m_buffer.GetValues();
+    p_table.assign(values.begin(), values.end());
+
+    const Buffer::Stats& stats = m_buffer.GetStats();
+    m_stats.material_count = static_cast<uint32_t>(m_materials.size());
+    m_stats.entry_count = stats.entry_count;
+    m_stats.uploaded_count = stats.uploaded_count;
+}
+
+int MaterialTable::Find(ecs::Entity p_id) const {
+    auto it = m_materials.find(p_id);
+    if (it == m_materials.end() || it->second.frame != m_frame) {
+        return -1;
+    }
+    return it->second.index;
+}
+
+uint32_t MaterialTable::FindKey(const MaterialConstantBuffer& p_constants, size_t p_hash) {
+    auto [begin, end] = m_keys.equal_range(p_hash);
+    for (auto it = begin; it != end;) {
+        const int index = m_buffer.Find(it->second);
+        if (index < 0) {
+            // retired, or the table was full when it was added
+            it = m_keys.erase(it);
+            continue;
+        }
+        if (memcmp(&m_buffer.Get(index), &p_constants, sizeof(p_constants)) == 0) {
+            return it->second;
+        }
+        ++it;
+    }
+
+    const uint32_t key = m_nextKey++;
+    m_keys.emplace(p_hash, key);
+    return key;
+}
+
+}  // namespace cave
@@ -0,0 +1,66 @@
+#pragma once
+#include "engine/renderer/scene_buffer.h"
+
+namespace cave {
+#include "cbuffer.hlsl.h"
+}  // namespace cave
+
+namespace cave {
+
+inline constexpr uint32_t MATERIAL_BUFFER_COUNT = 2048 * 16;
+
+// Material constants shared by every material that resolves to the same values. Objects usually
+// get their own instance of a material asset, the instances land on one entry, so draws of the
+// same asset have the same mat_idx and sort, instance and bind together. An entry never changes,
+// a material whose constants change moves to another entry, so only new entries are uploaded.
+// Entries and materials that aren't used for SceneBuffer::RETIRE_FRAME_COUNT frames are released.
+class MaterialTable {
+public:
+    using Buffer = SceneBuffer<MaterialConstantBuffer, uint32_t>;
+    using Upload = Buffer::Upload;
+
+    struct Stats {
+        uint32_t material_count = 0;
+        uint32_t entry_count = 0;
+        // entries sent to the GPU this frame
+        uint32_t uploaded_count = 0;
+    };
+
+    MaterialTable(uint32_t p_capacity = MATERIAL_BUFFER_COUNT, uint32_t p_copy_count = Buffer::DEFAULT_COPY_COUNT);
+
+    void BeginFrame();
+
+    // Resolves p_id to the entry with p_constants, -1 if the table is full.
+    int Update(ecs::Entity p_id, const MaterialConstantBuffer& p_constants);
+
+    // Appends the entries the buffers still have to receive, and the whole table to p_table for
+    // the draws, which need the texture handles.
+    void EndFrame(memory::ArenaVector<Upload>& p_uploads,
+                  memory::ArenaVector<MaterialConstantBuffer>& p_values,
+                  memory::ArenaVector<MaterialConstantBuffer>& p_table);
+
+    // -1 if p_id wasn't updated this frame, safe to call from several threads
+    int Find(ecs::Entity p_id) const;
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    // the live key with p_constants, a new one if there is none
+    uint32_t FindKey(const MaterialConstantBuffer& p_constants, size_t p_hash);
+
+    struct Material {
+        uint32_t key = 0;
+        int index = -1;
+        uint32_t frame = 0;
+    };
+
+    std::unordered_map<ecs::Entity, Material> m_materials;
+    // hash of the constants to the keys with these constants
+    std::unordered_multimap<size_t, uint32_t> m_keys;
+    Buffer m_buffer;
+    uint32_t m_nextKey = 0;
+    uint32_t m_frame = 0;
+    Stats m_stats;
+};
+
+}  // namespace cave
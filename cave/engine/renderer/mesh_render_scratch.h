@@ -0,0 +1,75 @@
+#pragma once
+#include "engine/assets/mesh_asset.h"
+#include "engine/ecs/entity.h"
+#include "engine/renderer/render_command.h"
+#include "engine/renderer/upload_queue.h"
+
+namespace cave {
+#include "cbuffer.hlsl.h"
+}  // namespace cave
+
+namespace cave {
+
+enum MeshPass : uint32_t {
+    MESH_PASS_SHADOW,
+    MESH_PASS_PREPASS,
+    MESH_PASS_GBUFFER,
+    MESH_PASS_TRANSPARENT,
+    MESH_PASS_VOXELIZATION,
+    MESH_PASS_COUNT,
+};
+
+// Output of one job. Batch indices are local to the chunk until the chunks are merged in job
+// order, so the command lists don't depend on which worker ran which job.
+struct MeshCommandChunk {
+    std::vector<PerBatchConstantBuffer> batches;
+    // the renderer of each batch, it owns a slot of the scene batch buffer
+    std::vector<ecs::Entity> batch_ids;
+    std::array<std::vector<RenderCommand>, MESH_PASS_COUNT> commands;
+    std::vector<std::pair<ecs::Entity, float>> visible_skeletons;
+    std::vector<UploadHint> upload_hints;
+    // meshes drawn by the chunk, repeats of the previous one are skipped
+    std::vector<const MeshAsset*> meshes;
+    uint32_t occlusion_tested_count = 0;
+    uint32_t occlusion_culled_count = 0;
+    MeshLodStats lod_stats;
+
+    void Clear() {
+        batches.clear();
+        batch_ids.clear();
+        for (auto& list : commands) {
+            list.clear();
+        }
+        visible_skeletons.clear();
+        upload_hints.clear();
+        meshes.clear();
+        occlusion_tested_count = 0;
+        occlusion_culled_count = 0;
+        lod_stats = {};
+    }
+};
+
+// Working memory of the mesh render system. It keeps its capacity across frames so a steady scene
+// doesn't allocate, every scene has its own, the buffers are only touched while the scene renders.
+struct MeshRenderScratch {
+    struct Occluder {
+        float screen_size;
+        const MeshAsset* mesh;
+        const Matrix4x4f* world_matrix;
+    };
+
+    std::vector<MeshCommandChunk> chunks;
+    // MeshCullFlag per leaf of Scene::m_meshTree, read by the jobs through MeshPassContext
+    std::vector<uint8_t> cull_flags;
+    // renderers in the view and the ones picked to fill the occlusion buffer
+    std::vector<ecs::Entity> occluder_candidates;
+    std::vector<Occluder> occluders;
+    // skeletons of the renderers that passed the tree culling
+    std::vector<ecs::Entity> skeletons;
+    // batch index of a chunk to its slot in the batch buffer, -1 if the batch didn't fit
+    std::vector<int> batch_slots;
+    // meshes drawn by every chunk, their gpu resources are retained once by the frame
+    std::vector<const MeshAsset*> meshes;
+};
+
+}  // namespace cave
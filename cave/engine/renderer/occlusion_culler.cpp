@@ -0,0 +1,274 @@
+#include "occlusion_culler.h"
+
+#include "engine/systems/job_system/job_system.h"
+
+namespace cave {
+
+// twice the signed area of (p_a, p_b, p_point)
+static float EdgeFunction(const Vector2f& p_a, const Vector2f& p_b, float p_x, float p_y) {
+    return (p_b.x - p_a.x) * (p_y - p_a.y) - (p_b.y - p_a.y) * (p_x - p_a.x);
+}
+
+OcclusionCuller::OcclusionCuller(int p_width, int p_height, uint32_t p_triangle_budget)
+    : m_width(p_width),
+      m_height(p_height),
+      m_triangleBudget(p_triangle_budget) {
+    DEV_ASSERT(p_width > 0 && p_height > 0);
+}
+
+void OcclusionCuller::BeginFrame(const Matrix4x4f& p_view_projection) {
+    // scenes that are never rendered don't pay for the buffers
+    if (m_levels.empty()) {
+        // each level halves the previous one, rounded up so the last row and column are covered
+        int width = m_width;
+        int height = m_height;
+        for (;;) {
+            m_levels.push_back(Level{ width, height, std::vector<float>(width * height, 0.0f) });
+            if (width == 1 && height == 1) {
+                break;
+            }
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+        }
+    }
+
+    m_viewProjection = p_view_projection;
+    m_triangles.clear();
+    m_stats = Stats{};
+    std::fill(m_levels[0].depth.begin(), m_levels[0].depth.end(), 0.0f);
+}
+
+bool OcclusionCuller::AddOccluder(const Matrix4x4f& p_world_matrix,
+                                  const std::vector<Vector3f>& p_positions,
+                                  const std::vector<uint32_t>& p_indices) {
+    const uint32_t triangle_count = static_cast<uint32_t>(p_indices.size() / 3);
+    if (m_stats.triangle_count + triangle_count > m_triangleBudget) {
+        return false;
+    }
+
+    const Matrix4x4f matrix = m_viewProjection * p_world_matrix;
+    for (size_t i = 0; i + 2 < p_indices.size(); i += 3) {
+        const Vector4f a = matrix * Vector4f(p_positions[p_indices[i]], 1.0f);
+        const Vector4f b = matrix * Vector4f(p_positions[p_indices[i + 1]], 1.0f);
+        const Vector4f c = matrix * Vector4f(p_positions[p_indices[i + 2]], 1.0f);
+
+        const int inside_count = (a.w >= NEAR_W) + (b.w >= NEAR_W) + (c.w >= NEAR_W);
+        if (inside_count == 3) {
+            AddClippedTriangle(a, b, c);
+            continue;
+        }
+        if (inside_count == 0) {
+            continue;
+        }
+
+        // clip the polygon against w = NEAR_W, one or two vertices are cut, so the result has
+        // three or four vertices
+        const Vector4f input[3] = { a, b, c };
+        Vector4f output[4];
+        int output_count = 0;
+        for (int j = 0; j < 3; ++j) {
+            const Vector4f& current = input[j];
+            const Vector4f& next = input[(j + 1) % 3];
+            if (current.w >= NEAR_W) {
+                output[output_count++] = current;
+            }
+            if ((current.w >= NEAR_W) != (next.w >= NEAR_W)) {
+                const float t = (NEAR_W - current.w) / (next.w - current.w);
+                output[output_count++] = current + t * (next - current);
+            }
+        }
+
+        for (int j = 1; j + 1 < output_count; ++j) {
+            AddClippedTriangle(output[0], output[j], output[j + 1]);
+        }
+    }
+
+    ++m_stats.occluder_count;
+    m_stats.triangle_count += triangle_count;
+    return true;
+}
+
+void OcclusionCuller::AddClippedTriangle(const Vector4f& p_a, const Vector4f& p_b, const Vector4f& p_c) {
+    Triangle triangle;
+    auto to_screen = [&](const Vector4f& p_clip, Vector2f& p_out, float& p_out_inv_w) {
+        p_out_inv_w = 1.0f / p_clip.w;
+        p_out.x = (0.5f * p_clip.x * p_out_inv_w + 0.5f) * m_width;
+        p_out.y = (0.5f * p_clip.y * p_out_inv_w + 0.5f) * m_height;
+    };
+    to_screen(p_a, triangle.v0, triangle.inv_w0);
+    to_screen(p_b, triangle.v1, triangle.inv_w1);
+    to_screen(p_c, triangle.v2, triangle.inv_w2);
+
+    // pixels are covered when their center is inside
+    const float min_x = glm::min(triangle.v0.x, glm::min(triangle.v1.x, triangle.v2.x));
+    const float max_x = glm::max(triangle.v0.x, glm::max(triangle.v1.x, triangle.v2.x));
+    const float min_y = glm::min(triangle.v0.y, glm::min(triangle.v1.y, triangle.v2.y));
+    const float max_y = glm::max(triangle.v0.y, glm::max(triangle.v1.y, triangle.v2.y));
+    if (max_x < 0.5f || min_x > m_width - 0.5f || max_y < 0.5f || min_y > m_height - 0.5f) {
+        return;
+    }
+
+    triangle.min_y = glm::max(0, static_cast<int>(glm::ceil(min_y - 0.5f)));
+    triangle.max_y = glm::min(m_height - 1, static_cast<int>(glm::floor(max_y - 0.5f)));
+    if (triangle.min_y <= triangle.max_y) {
+        m_triangles.push_back(triangle);
+    }
+}
+
+void OcclusionCuller::Rasterize() {
+    DEV_ASSERT(!m_levels.empty());
+    const int band_count = (m_height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(band_count, 1, [&](jobsystem::JobArgs p_args) { RasterizeBand(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    for (int band = 0; band < band_count; ++band) {
+        RasterizeBand(band);
+    }
+#endif
+
+    BuildHierarchy();
+}
+
+void OcclusionCuller::RasterizeBand(int p_band) {
+    const int band_min_y = p_band * BAND_HEIGHT;
+    const int band_max_y = glm::min(band_min_y + BAND_HEIGHT, m_height) - 1;
+    float* depth = m_levels[0].depth.data();
+
+    for (const Triangle& triangle : m_triangles) {
+        const int min_y = glm::max(triangle.min_y, band_min_y);
+        const int max_y = glm::min(triangle.max_y, band_max_y);
+        if (min_y > max_y) {
+            continue;
+        }
+
+        const float area = EdgeFunction(triangle.v0, triangle.v1, triangle.v2.x, triangle.v2.y);
+        if (area == 0.0f) {
+            continue;
+        }
+        // dividing by the signed area accepts both windings
+        const float inv_area = 1.0f / area;
+
+        const float min_x = glm::min(triangle.v0.x, glm::min(triangle.v1.x, triangle.v2.x));
+        const float max_x = glm::max(triangle.v0.x, glm::max(triangle.v1.x, triangle.v2.x));
+        const int begin_x = glm::max(0, static_cast<int>(glm::ceil(min_x - 0.5f)));
+        const int end_x = glm::min(m_width - 1, static_cast<int>(glm::floor(max_x - 0.5f)));
+
+        // barycentrics and depth step linearly along a row
+        const float step0 = -(triangle.v2.y - triangle.v1.y) * inv_area;
+        const float step1 = -(triangle.v0.y - triangle.v2.y) * inv_area;
+        const float step2 = -(triangle.v1.y - triangle.v0.y) * inv_area;
+
+        for (int y = min_y; y <= max_y; ++y) {
+            const float px = begin_x + 0.5f;
+            const float py = y + 0.5f;
+            float w0 = EdgeFunction(triangle.v1, triangle.v2, px, py) * inv_area;
+            float w1 = EdgeFunction(triangle.v2, triangle.v0, px, py) * inv_area;
+            float w2 = EdgeFunction(triangle.v0, triangle.v1, px, py) * inv_area;
+
+            float* row = depth + y * m_width;
+            for (int x = begin_x; x <= end_x; ++x, w0 += step0, w1 += step1, w2 += step2) {
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                    continue;
+                }
+                const float inv_w = w0 * triangle.inv_w0 + w1 * triangle.inv_w1 + w2 * triangle.inv_w2;
+                row[x] = glm::max(row[x], inv_w);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::BuildHierarchy() {
+    // a texel keeps the farthest depth of the four below it
+    for (size_t level_idx = 1; level_idx < m_levels.size(); ++level_idx) {
+        const Level& src = m_levels[level_idx - 1];
+        Level& dst = m_levels[level_idx];
+        for (int y = 0; y < dst.height; ++y) {
+            const int y0 = 2 * y;
+            const int y1 = glm::min(2 * y + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x) {
+                const int x0 = 2 * x;
+                const int x1 = glm::min(2 * x + 1, src.width - 1);
+                const float depth = glm::min(glm::min(src.depth[y0 * src.width + x0], src.depth[y0 * src.width + x1]),
+                                             glm::min(src.depth[y1 * src.width + x0], src.depth[y1 * src.width + x1]));
+                dst.depth[y * dst.width + x] = depth;
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsOccluded(const AABB& p_aabb) const {
+    if (m_triangles.empty()) {
+        return false;
+    }
+
+    const Vector3f& box_min = p_aabb.GetMin();
+    const Vector3f& box_max = p_aabb.GetMax();
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = -std::numeric_limits<float>::max();
+    float max_y = -std::numeric_limits<float>::max();
+    float min_w = std::numeric_limits<float>::max();
+    for (int i = 0; i < 8; ++i) {
+        const Vector4f corner((i & 1) ? box_max.x : box_min.x,
+                              (i & 2) ? box_max.y : box_min.y,
+                              (i & 4) ? box_max.z : box_min.z,
+                              1.0f);
+        const Vector4f clip = m_viewProjection * corner;
+        // boxes crossing the near plane are treated as visible
+        if (clip.w < NEAR_W) {
+            return false;
+        }
+
+        const float inv_w = 1.0f / clip.w;
+        const float x = (0.5f * clip.x * inv_w + 0.5f) * m_width;
+        const float y = (0.5f * clip.y * inv_w + 0.5f) * m_height;
+        min_x = glm::min(min_x, x);
+        max_x = glm::max(max_x, x);
+        min_y = glm::min(min_y, y);
+        max_y = glm::max(max_y, y);
+        min_w = glm::min(min_w, clip.w);
+    }
+
+    // every pixel the screen rectangle touches
+    const int x0 = glm::max(0, static_cast<int>(glm::floor(min_x)));
+    const int x1 = glm::min(m_width - 1, static_cast<int>(glm::floor(max_x)));
+    const int y0 = glm::max(0, static_cast<int>(glm::floor(min_y)));
+    const int y1 = glm::min(m_height - 1, static_cast<int>(glm::floor(max_y)));
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    // the first level where the rectangle spans at most 4x4 texels
+    int level_idx = 0;
+    while (level_idx + 1 < GetLevelCount() && ((x1 >> level_idx) - (x0 >> level_idx) > 3 || (y1 >> level_idx) - (y0 >> level_idx) > 3)) {
+        ++level_idx;
+    }
+
+    const Level& level = m_levels[level_idx];
+    const float box_inv_w = (1.0f + DEPTH_BIAS) / min_w;
+    for (int y = y0 >> level_idx; y <= (y1 >> level_idx); ++y) {
+        for (int x = x0 >> level_idx; x <= (x1 >> level_idx); ++x) {
+            if (box_inv_w >= level.depth[y * level.width + x]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void OcclusionCuller::SetQueryCounts(uint32_t p_tested_count, uint32_t p_culled_count) {
+    m_stats.tested_count = p_tested_count;
+    m_stats.culled_count = p_culled_count;
+}
+
+float OcclusionCuller::GetDepth(int p_level, int p_x, int p_y) const {
+    DEV_ASSERT_INDEX(p_level, m_levels.size());
+    const Level& level = m_levels[p_level];
+    DEV_ASSERT(p_x >= 0 && p_x < level.width && p_y >= 0 && p_y < level.height);
+    return level.depth[p_y * level.width + p_x];
+}
+
+}  // namespace cave
@@ -0,0 +1,85 @@
+#pragma once
+#include "engine/math/aabb.h"
+#include "engine/math/geomath.h"
+
+namespace cave {
+
+// CPU occlusion culling. A budget of large occluders is rasterized into a small depth buffer,
+// objects are then tested against a min-depth hierarchy built from it. Depth is stored as 1 / w,
+// which is linear in screen space and doesn't depend on the depth range of the backend, larger is
+// closer and 0 means nothing was drawn.
+class OcclusionCuller {
+public:
+    static constexpr int DEFAULT_WIDTH = 256;
+    static constexpr int DEFAULT_HEIGHT = 128;
+    static constexpr uint32_t DEFAULT_TRIANGLE_BUDGET = 4096;
+    // rows rasterized by one job
+    static constexpr int BAND_HEIGHT = 8;
+    // triangles are clipped against this w, the near plane is usually farther
+    static constexpr float NEAR_W = 1e-3f;
+    // an object has to be this much farther than the occluders, relative to 1 / w, to be culled
+    static constexpr float DEPTH_BIAS = 1e-3f;
+
+    struct Stats {
+        uint32_t occluder_count = 0;
+        uint32_t triangle_count = 0;
+        // objects tested against the depth buffer and the ones found hidden
+        uint32_t tested_count = 0;
+        uint32_t culled_count = 0;
+    };
+
+    OcclusionCuller(int p_width = DEFAULT_WIDTH, int p_height = DEFAULT_HEIGHT, uint32_t p_triangle_budget = DEFAULT_TRIANGLE_BUDGET);
+
+    void BeginFrame(const Matrix4x4f& p_view_projection);
+
+    // Queues the triangles of an occluder, false if they don't fit in what's left of the budget.
+    bool AddOccluder(const Matrix4x4f& p_world_matrix,
+                     const std::vector<Vector3f>& p_positions,
+                     const std::vector<uint32_t>& p_indices);
+
+    // Rasterizes the occluders in bands of rows on the job system and builds the hierarchy.
+    void Rasterize();
+
+    // true if p_aabb is behind the occluders everywhere it covers, safe to call from several
+    // threads once Rasterize() returned
+    bool IsOccluded(const AABB& p_aabb) const;
+
+    void SetQueryCounts(uint32_t p_tested_count, uint32_t p_culled_count);
+
+    const Stats& GetStats() const { return m_stats; }
+    uint32_t GetTriangleBudget() const { return m_triangleBudget; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    // 0 until the first BeginFrame()
+    int GetLevelCount() const { return static_cast<int>(m_levels.size()); }
+
+    // 1 / w of texel (p_x, p_y) of p_level, level 0 is the rasterized buffer
+    float GetDepth(int p_level, int p_x, int p_y) const;
+
+private:
+    struct Triangle {
+        Vector2f v0, v1, v2;
+        float inv_w0, inv_w1, inv_w2;
+        int min_y, max_y;
+    };
+
+    struct Level {
+        int width;
+        int height;
+        std::vector<float> depth;
+    };
+
+    void AddClippedTriangle(const Vector4f& p_a, const Vector4f& p_b, const Vector4f& p_c);
+    void RasterizeBand(int p_band);
+    void BuildHierarchy();
+
+    std::vector<Triangle> m_triangles;
+    std::vector<Level> m_levels;
+    Matrix4x4f m_viewProjection{ 1.0f };
+    const int m_width;
+    const int m_height;
+    const uint32_t m_triangleBudget;
+    Stats m_stats;
+};
+
+}  // namespace cave
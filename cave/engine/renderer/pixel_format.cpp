@@ -55,4 +55,46 @@ uint32_t ChannelCount(PixelFormat p_format) {
     }
 }
 
+uint32_t PixelSize(PixelFormat p_format) {
+    switch (p_format) {
+        case PixelFormat::R8_UINT:
+            return 1;
+        case PixelFormat::R8G8_UINT:
+        case PixelFormat::R16_FLOAT:
+            return 2;
+        case PixelFormat::R8G8B8_UINT:
+            return 3;
+        case PixelFormat::R8G8B8A8_UINT:
+        case PixelFormat::R8G8B8A8_UNORM:
+        case PixelFormat::R8G8B8A8_UNORM_SRGB:
+        case PixelFormat::R16G16_FLOAT:
+        case PixelFormat::R32_FLOAT:
+        case PixelFormat::R11G11B10_FLOAT:
+        case PixelFormat::R10G10B10A2_UINT:
+        case PixelFormat::D32_FLOAT:
+        case PixelFormat::R24G8_TYPELESS:
+        case PixelFormat::R24_UNORM_X8_TYPELESS:
+        case PixelFormat::D24_UNORM_S8_UINT:
+        case PixelFormat::X24_TYPELESS_G8_UINT:
+            return 4;
+        case PixelFormat::R16G16B16_FLOAT:
+            return 6;
+        case PixelFormat::R16G16B16A16_FLOAT:
+        case PixelFormat::R32G32_FLOAT:
+        case PixelFormat::R32G32_SINT:
+        case PixelFormat::R32G8X24_TYPELESS:
+        case PixelFormat::D32_FLOAT_S8X24_UINT:
+            return 8;
+        case PixelFormat::R32G32B32_FLOAT:
+        case PixelFormat::R32G32B32_SINT:
+            return 12;
+        case PixelFormat::R32G32B32A32_FLOAT:
+        case PixelFormat::R32G32B32A32_SINT:
+            return 16;
+        default:
+            CRASH_NOW();
+            return 0;
+    }
+}
+
 }  // namespace cave
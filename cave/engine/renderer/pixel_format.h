@@ -48,4 +48,7 @@ uint32_t ChannelSize(PixelFormat p_format);
 
 uint32_t ChannelCount(PixelFormat p_format);
 
+// bytes per texel, depth and typeless formats included
+uint32_t PixelSize(PixelFormat p_format);
+
 }  // namespace cave
@@ -0,0 +1,81 @@
+#include "render_command.h"
+
+#include <bit>
+
+#include "engine/algorithm/algorithm.h"
+
+namespace cave {
+
+template<int BITS>
+static uint64_t MaskField(uint64_t p_value) {
+    constexpr uint64_t MASK = (1ull << BITS) - 1;
+    return p_value & MASK;
+}
+
+static uint64_t MaterialField(int p_material) {
+    // -1 (no material) sorts first
+    return MaskField<DrawSortKey::MATERIAL_BITS>(static_cast<uint64_t>(p_material + 1));
+}
+
+static uint64_t MeshField(const GpuMesh* p_mesh) {
+    // only equality matters, a collision costs a redundant bind but not correctness
+    const uint64_t hash = reinterpret_cast<uintptr_t>(p_mesh) * 0x9E3779B97F4A7C15ull;
+    return hash >> (64 - DrawSortKey::MESH_BITS);
+}
+
+uint32_t DrawSortKey::DepthBucket(float p_view_depth) {
+    const float depth = std::max(p_view_depth, 0.0f);
+    return std::bit_cast<uint32_t>(depth) >> (32 - DEPTH_BITS);
+}
+
+uint64_t DrawSortKey::Opaque(uint32_t p_pass, uint32_t p_pipeline, int p_material, const GpuMesh* p_mesh, float p_view_depth) {
+    uint64_t key = MaskField<PASS_BITS>(p_pass);
+    key = (key << PIPELINE_BITS) | MaskField<PIPELINE_BITS>(p_pipeline);
+    key = (key << MATERIAL_BITS) | MaterialField(p_material);
+    key = (key << MESH_BITS) | MeshField(p_mesh);
+    key = (key << DEPTH_BITS) | DepthBucket(p_view_depth);
+    return key;
+}
+
+uint64_t DrawSortKey::Transparent(uint32_t p_pass, uint32_t p_pipeline, int p_material, const GpuMesh* p_mesh, float p_view_depth) {
+    constexpr uint32_t DEPTH_MASK = (1u << DEPTH_BITS) - 1;
+
+    uint64_t key = MaskField<PASS_BITS>(p_pass);
+    key = (key << DEPTH_BITS) | (DEPTH_MASK - DepthBucket(p_view_depth));
+    key = (key << PIPELINE_BITS) | MaskField<PIPELINE_BITS>(p_pipeline);
+    key = (key << MATERIAL_BITS) | MaterialField(p_material);
+    key = (key << MESH_BITS) | MeshField(p_mesh);
+    return key;
+}
+
+RenderCommandList::RenderCommandList(memory::LinearAllocator* p_arena)
+    : m_commands(memory::ArenaAllocator<RenderCommand>(p_arena)),
+      m_order(memory::ArenaAllocator<uint32_t>(p_arena)),
+      m_scratch(memory::ArenaAllocator<uint32_t>(p_arena)),
+      m_keys(memory::ArenaAllocator<uint64_t>(p_arena)) {
+}
+
+void RenderCommandList::Sort() {
+    m_keys.resize(m_commands.size());
+    for (size_t i = 0; i < m_commands.size(); ++i) {
+        const RenderCommand& command = m_commands[i];
+        m_keys[i] = command.type == RenderCommandType::Draw ? command.draw.sort_key : 0;
+    }
+
+    m_scratch.resize(m_order.size());
+    RadixSortIndices(m_keys.data(), m_order.data(), m_scratch.data(), m_order.size());
+}
+
+void RenderCommandList::Clear() {
+    m_commands.clear();
+    m_order.clear();
+}
+
+void RenderCommandList::Recycle(memory::LinearAllocator* p_arena) {
+    memory::RecycleArenaVector(m_commands, p_arena);
+    memory::RecycleArenaVector(m_order, p_arena);
+    memory::RecycleArenaVector(m_scratch, p_arena);
+    memory::RecycleArenaVector(m_keys, p_arena);
+}
+
+}  // namespace cave
@@ -1,4 +1,5 @@
 #pragma once
+#include "engine/memory/arena_allocator.h"
 
 // clang-format off
 namespace cave { enum StencilFlags : uint8_t; }
@@ -23,14 +24,35 @@ struct DrawCommand {
     const GpuMesh* mesh_data = nullptr;
     const GpuTexture* texture = nullptr;
 
-    int bone_idx = -1;
+    // first row of the bone constant buffer range, see BonePalette
+    int bone_offset = -1;
     int mat_idx = -1;
     int batch_idx = -1;
 
-    uint8_t sortKey = 0;
+    uint64_t sort_key = 0;
+    uint16_t bone_row_count = 0;
     StencilFlags flags{ 0 };
 };
 
+// 64-bit keys for DrawCommand::sort_key, most significant field first:
+//   opaque:      pass(4) pipeline(4) material(20) mesh(20) depth(16)
+//   transparent: pass(4) inverted depth(16) pipeline(4) material(20) mesh(20)
+// Opaque draws are grouped by state and drawn front to back inside a group to help early-z,
+// transparent draws are drawn back to front.
+struct DrawSortKey {
+    static constexpr int PASS_BITS = 4;
+    static constexpr int PIPELINE_BITS = 4;
+    static constexpr int MATERIAL_BITS = 20;
+    static constexpr int MESH_BITS = 20;
+    static constexpr int DEPTH_BITS = 16;
+
+    static uint64_t Opaque(uint32_t p_pass, uint32_t p_pipeline, int p_material, const GpuMesh* p_mesh, float p_view_depth);
+    static uint64_t Transparent(uint32_t p_pass, uint32_t p_pipeline, int p_material, const GpuMesh* p_mesh, float p_view_depth);
+
+    // positive floats order like their bit patterns, the top 16 bits give log spaced buckets
+    static uint32_t DepthBucket(float p_view_depth);
+};
+
 struct ComputeCommand {
     int dispatchSize[3];
 };
@@ -52,4 +74,41 @@ struct RenderCommand {
     }
 };
 
+// Commands recorded for one pass. Sort() orders the command indices by DrawCommand::sort_key,
+// the commands themselves are never moved. Storage comes from p_arena when there is one.
+class RenderCommandList {
+public:
+    explicit RenderCommandList(memory::LinearAllocator* p_arena = nullptr);
+
+    void Add(const RenderCommand& p_command) {
+        m_order.push_back(static_cast<uint32_t>(m_commands.size()));
+        m_commands.push_back(p_command);
+    }
+
+    void Reserve(size_t p_count) {
+        m_commands.reserve(p_count);
+        m_order.reserve(p_count);
+    }
+
+    void Sort();
+    void Clear();
+    // clears the list and moves it to p_arena, see RecycleArenaVector()
+    void Recycle(memory::LinearAllocator* p_arena);
+
+    bool IsEmpty() const { return m_commands.empty(); }
+    size_t GetSize() const { return m_commands.size(); }
+
+    const memory::ArenaVector<RenderCommand>& GetCommands() const { return m_commands; }
+    // indices into GetCommands() in execution order, recording order until Sort() is called
+    const memory::ArenaVector<uint32_t>& GetOrder() const { return m_order; }
+
+    memory::LinearAllocator* GetArena() const { return m_commands.get_allocator().GetArena(); }
+
+private:
+    memory::ArenaVector<RenderCommand> m_commands;
+    memory::ArenaVector<uint32_t> m_order;
+    memory::ArenaVector<uint32_t> m_scratch;
+    memory::ArenaVector<uint64_t> m_keys;
+};
+
 }  // namespace cave
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "render_state_cache.h"
+
+namespace cave {
+
+bool RenderStateCache::SetMesh(const GpuMesh* p_mesh) {
+    const bool changed = !m_meshValid || m_mesh != p_mesh;
+    m_mesh = p_mesh;
+    m_meshValid = true;
+    return Count(m_stats.mesh, changed);
+}
+
+bool RenderStateCache::BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) {
+    if (p_slot < 0 || p_slot >= TEXTURE_SLOT_COUNT) {
+        return Count(m_stats.texture, true);
+    }
+
+    // OpenGL binds per target, a texture of another dimension in the same slot is a different binding
+    TextureBinding& binding = m_textures[p_slot];
+    const bool changed = !binding.valid || binding.handle != p_handle || binding.dimension != p_dimension;
+    binding = { p_handle, p_dimension, true };
+    return Count(m_stats.texture, changed);
+}
+
+bool RenderStateCache::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
+    for (int i = 0; i < m_constantBufferCount; ++i) {
+        ConstantBufferBinding& binding = m_constantBuffers[i];
+        if (binding.buffer == p_buffer) {
+            const bool changed = binding.size != p_size || binding.offset != p_offset;
+            binding.size = p_size;
+            binding.offset = p_offset;
+            return Count(m_stats.constant_buffer, changed);
+        }
+    }
+
+    if (m_constantBufferCount < CONSTANT_BUFFER_COUNT) {
+        m_constantBuffers[m_constantBufferCount++] = { p_buffer, p_size, p_offset };
+    }
+    return Count(m_stats.constant_buffer, true);
+}
+
+bool RenderStateCache::SetPipelineState(PipelineStateName p_name) {
+    const bool changed = m_pipelineState != static_cast<int>(p_name);
+    if (changed) {
+        m_pipelineState = p_name;
+        InvalidateBindings();
+    }
+    return Count(m_stats.pipeline_state, changed);
+}
+
+void RenderStateCache::InvalidateMesh() {
+    m_meshValid = false;
+}
+
+void RenderStateCache::InvalidateTexture(int p_slot) {
+    if (p_slot >= 0 && p_slot < TEXTURE_SLOT_COUNT) {
+        m_textures[p_slot].valid = false;
+    }
+}
+
+void RenderStateCache::InvalidateTextures() {
+    for (TextureBinding& binding : m_textures) {
+        binding.valid = false;
+    }
+}
+
+void RenderStateCache::InvalidateConstantBuffer(const GpuConstantBuffer* p_buffer) {
+    for (int i = 0; i < m_constantBufferCount; ++i) {
+        if (m_constantBuffers[i].buffer == p_buffer) {
+            m_constantBuffers[i] = m_constantBuffers[--m_constantBufferCount];
+            return;
+        }
+    }
+}
+
+void RenderStateCache::InvalidateBindings() {
+    InvalidateTextures();
+    m_constantBufferCount = 0;
+}
+
+void RenderStateCache::Invalidate() {
+    InvalidateMesh();
+    InvalidateBindings();
+    m_pipelineState = -1;
+}
+
+void RenderStateCache::NewFrame() {
+    Invalidate();
+    m_lastFrameStats = m_stats;
+    m_stats = {};
+}
+
+}  // namespace cave
@@ -0,0 +1,85 @@
+#pragma once
+
+namespace cave {
+
+enum class Dimension : uint32_t;
+enum PipelineStateName : uint8_t;
+struct GpuConstantBuffer;
+struct GpuMesh;
+
+// Shadow copy of the bindings the graphics manager issued. Every Set/Bind function returns true
+// if the call changes the state and has to reach the backend, false if it's redundant. Anything
+// that changes bindings behind the cache's back, like creating resources or switching render
+// targets, has to invalidate it. Only used by the thread recording the frame.
+class RenderStateCache {
+public:
+    // texture slots above this are always issued
+    static constexpr int TEXTURE_SLOT_COUNT = 64;
+    static constexpr int CONSTANT_BUFFER_COUNT = 16;
+
+    struct Counter {
+        uint32_t issued = 0;
+        uint32_t filtered = 0;
+    };
+
+    struct Stats {
+        Counter mesh;
+        Counter texture;
+        Counter constant_buffer;
+        Counter pipeline_state;
+    };
+
+    bool SetMesh(const GpuMesh* p_mesh);
+    bool BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot);
+    bool BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset);
+    bool SetPipelineState(PipelineStateName p_name);
+
+    void InvalidateMesh();
+    void InvalidateTexture(int p_slot);
+    void InvalidateTextures();
+    // D3D11 copies the contents of a buffer when a range is bound, new contents need a new bind
+    void InvalidateConstantBuffer(const GpuConstantBuffer* p_buffer);
+    // textures and constant buffers, a new pipeline can come with a new binding layout
+    void InvalidateBindings();
+    void Invalidate();
+
+    // invalidates everything and starts counting a new frame
+    void NewFrame();
+
+    const Stats& GetStats() const { return m_stats; }
+    const Stats& GetLastFrameStats() const { return m_lastFrameStats; }
+
+private:
+    struct TextureBinding {
+        uint64_t handle;
+        Dimension dimension;
+        bool valid = false;
+    };
+
+    struct ConstantBufferBinding {
+        const GpuConstantBuffer* buffer;
+        uint32_t size;
+        uint32_t offset;
+    };
+
+    static bool Count(Counter& p_counter, bool p_changed) {
+        ++(p_changed ? p_counter.issued : p_counter.filtered);
+        return p_changed;
+    }
+
+    const GpuMesh* m_mesh{ nullptr };
+    bool m_meshValid{ false };
+
+    int m_pipelineState{ -1 };
+
+    std::array<TextureBinding, TEXTURE_SLOT_COUNT> m_textures{};
+
+    // a buffer is always bound to its own slot, so the buffer identifies the binding
+    std::array<ConstantBufferBinding, CONSTANT_BUFFER_COUNT> m_constantBuffers{};
+    int m_constantBufferCount{ 0 };
+
+    Stats m_stats;
+    Stats m_lastFrameStats;
+};
+
+}  // namespace cave
@@ -65,6 +65,8 @@ struct SamplerDesc {
     float border[4];
     float minLod;
     float maxLod;
+
+    bool operator==(const SamplerDesc&) const = default;
 };
 
 static constexpr inline SamplerDesc PointClampSampler() {
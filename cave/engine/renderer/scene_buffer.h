@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+
+#include "engine/ecs/entity.h"
+#include "engine/memory/arena_allocator.h"
+#include "engine/renderer/bone_palette.h"
+
+namespace cave {
+
+// Slots of the batch constant buffer. The first TRANSIENT_BATCH_COUNT are written every frame,
+// the mesh renderers own the rest through a SceneBuffer and keep them across frames.
+inline constexpr uint32_t BATCH_BUFFER_COUNT = 4096 * 16;
+inline constexpr uint32_t TRANSIENT_BATCH_COUNT = 8192;
+inline constexpr uint32_t SCENE_BATCH_COUNT = BATCH_BUFFER_COUNT - TRANSIENT_BATCH_COUNT;
+
+// Persistent constant buffer entries, one stable slot per key, an entity by default. The GPU
+// buffer keeps a slot between frames and it's only uploaded again when its value changes, changed
+// slots next to each other go in one upload. A slot outlives the frames its key isn't updated in,
+// so an object leaving and entering the view isn't uploaded again.
+template<typename T, typename KEY = ecs::Entity>
+class SceneBuffer {
+public:
+    // every frame context has its own buffer, like the bone palettes
+    static constexpr uint32_t DEFAULT_COPY_COUNT = BonePalette::DEFAULT_COPY_COUNT;
+    // the slot of a key that wasn't updated for this many frames goes back to the free list
+    static constexpr uint32_t RETIRE_FRAME_COUNT = 120;
+
+    // p_values[src_index, src_index + count) goes to the buffer at dst_index
+    struct Upload {
+        uint32_t dst_index;
+        uint32_t src_index;
+        uint32_t count;
+    };
+
+    struct Stats {
+        uint32_t entry_count = 0;
+        // keys whose value changed this frame
+        uint32_t changed_count = 0;
+        uint32_t uploaded_count = 0;
+        uint32_t range_count = 0;
+    };
+
+    SceneBuffer(uint32_t p_capacity, uint32_t p_copy_count = DEFAULT_COPY_COUNT)
+        : m_capacity(p_capacity),
+          m_copyCount(p_copy_count) {
+        DEV_ASSERT(p_copy_count > 0);
+    }
+
+    void BeginFrame() {
+        ++m_frame;
+        m_stats.changed_count = 0;
+    }
+
+    // Writes the value of p_id and returns its slot, -1 if there is no room left for it.
+    int Update(const KEY& p_id, const T& p_value) {
+        auto [it, inserted] = m_entries.try_emplace(p_id);
+        Entry& entry = it->second;
+        if (inserted) {
+            if (!m_freeSlots.empty()) {
+                entry.slot = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            } else if (m_values.size() < m_capacity) {
+                entry.slot = static_cast<uint32_t>(m_values.size());
+                m_values.emplace_back();
+                m_pending.push_back(0);
+            } else {
+                m_entries.erase(it);
+                return -1;
+            }
+        }
+
+        entry.frame = m_frame;
+        T& value = m_values[entry.slot];
+        if (inserted || memcmp(&value, &p_value, sizeof(T)) != 0) {
+            value = p_value;
+            if (!m_pending[entry.slot]) {
+                m_dirty.push_back(entry.slot);
+            }
+            m_pending[entry.slot] = m_copyCount;
+            ++m_stats.changed_count;
+        }
+        return static_cast<int>(entry.slot);
+    }
+
+    // Retires the keys that weren't updated for RETIRE_FRAME_COUNT frames and appends the
+    // values the buffers still have to receive.
+    void EndFrame(memory::ArenaVector<Upload>& p_uploads, memory::ArenaVector<T>& p_values) {
+        // the walk over every entry is only paid once in a while
+        if (m_frame % RETIRE_FRAME_COUNT == 0) {
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                const Entry& entry = it->second;
+                if (m_frame - entry.frame >= RETIRE_FRAME_COUNT && !m_pending[entry.slot]) {
+                    m_freeSlots.push_back(entry.slot);
+                    it = m_entries.erase(it);
+                    continue;
+                }
+                ++it;
+            }
+        }
+
+        std::sort(m_dirty.begin(), m_dirty.end());
+
+        m_stats.entry_count = static_cast<uint32_t>(m_entries.size());
+        m_stats.uploaded_count = static_cast<uint32_t>(m_dirty.size());
+        m_stats.range_count = 0;
+        for (size_t i = 0; i < m_dirty.size();) {
+            const uint32_t begin = m_dirty[i];
+            uint32_t end = begin + 1;
+            for (++i; i < m_dirty.size() && m_dirty[i] == end; ++i) {
+                ++end;
+            }
+
+            p_uploads.push_back(Upload{ begin, static_cast<uint32_t>(p_values.size()), end - begin });
+            p_values.insert(p_values.end(), m_values.begin() + begin, m_values.begin() + end);
+            ++m_stats.range_count;
+        }
+
+        // the slots some copies haven't received yet are uploaded again next frame
+        std::erase_if(m_dirty, [&](uint32_t p_slot) { return --m_pending[p_slot] == 0; });
+    }
+
+    // -1 if p_id has no slot
+    int Find(const KEY& p_id) const {
+        auto it = m_entries.find(p_id);
+        return it != m_entries.end() ? static_cast<int>(it->second.slot) : -1;
+    }
+
+    const T& Get(uint32_t p_slot) const { return m_values[p_slot]; }
+    // by slot, the slots of retired keys keep their last value
+    std::span<const T> GetValues() const { return m_values; }
+
+    const Stats& GetStats() const { return m_stats; }
+    uint32_t GetCapacity() const { return m_capacity; }
+
+private:
+    struct Entry {
+        uint32_t slot = 0;
+        uint32_t frame = 0;
+    };
+
+    std::unordered_map<KEY, Entry> m_entries;
+    std::vector<uint32_t> m_freeSlots;
+    // slots with uploads left, each appears once
+    std::vector<uint32_t> m_dirty;
+    // CPU copy of the buffer, compared against to detect unchanged values
+    std::vector<T> m_values;
+    // by slot, uploads left before every copy has the current value
+    std::vector<uint32_t> m_pending;
+    uint32_t m_frame = 0;
+    const uint32_t m_capacity;
+    const uint32_t m_copyCount;
+    Stats m_stats;
+};
+
+}  // namespace cave
@@ -0,0 +1,30 @@
+#pragma once
+#include "engine/renderer/bone_palette.h"
+#include "engine/renderer/light_clusters.h"
+#include "engine/renderer/material_table.h"
+#include "engine/renderer/mesh_render_scratch.h"
+#include "engine/renderer/occlusion_culler.h"
+#include "engine/renderer/scene_buffer.h"
+
+namespace cave {
+
+// Renderer state of one scene that is kept across frames. The render system owns one per scene
+// and hands it to the mesh render system, the scene itself doesn't know about it.
+struct SceneRenderState {
+    // where the skeletons live in the bone constant buffer
+    BonePalette bone_palette;
+    // batch slots of the mesh renderers
+    SceneBuffer<PerBatchConstantBuffer> batch_buffer{ SCENE_BATCH_COUNT };
+    // constants of the material components, one entry per distinct material
+    MaterialTable material_table;
+    // occluder depth of the last rendered frame
+    OcclusionCuller occlusion_culler;
+    // point lights per cluster of the last rendered frame
+    LightClusterBuilder light_clusters;
+    // levels the camera passes drew last frame
+    MeshLodStats mesh_lod_stats;
+    // buffers the mesh render system reuses every frame
+    MeshRenderScratch scratch;
+};
+
+}  // namespace cave
@@ -0,0 +1,77 @@
+#include "upload_queue.h"
+
+#include <algorithm>
+
+namespace cave {
+
+void UploadQueue::Push(Type p_type, std::shared_ptr<void> p_asset, size_t p_bytes) {
+    DEV_ASSERT(p_asset);
+    if (!m_lookup.try_emplace(p_asset.get(), static_cast<uint32_t>(m_requests.size())).second) {
+        return;
+    }
+
+    m_requests.push_back({ p_type, std::move(p_asset), p_bytes, 0.0f, m_sequence++ });
+    ++m_stats.pending_count;
+    m_stats.pending_bytes += p_bytes;
+}
+
+void UploadQueue::SetPriorities(std::span<const UploadHint> p_hints) {
+    for (Request& request : m_requests) {
+        request.priority = 0.0f;
+    }
+    for (const UploadHint& hint : p_hints) {
+        auto it = m_lookup.find(hint.asset);
+        if (it != m_lookup.end()) {
+            float& priority = m_requests[it->second].priority;
+            priority = std::max(priority, hint.priority);
+        }
+    }
+}
+
+uint32_t UploadQueue::Process(const Budget& p_budget,
+                              const std::function<void(const Request&)>& p_upload,
+                              const std::function<double()>& p_elapsed) {
+    m_order.resize(m_requests.size());
+    for (uint32_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = i;
+    }
+    std::sort(m_order.begin(), m_order.end(), [&](uint32_t p_lhs, uint32_t p_rhs) {
+        const Request& lhs = m_requests[p_lhs];
+        const Request& rhs = m_requests[p_rhs];
+        if (lhs.priority != rhs.priority) {
+            return lhs.priority > rhs.priority;
+        }
+        return lhs.sequence < rhs.sequence;
+    });
+
+    uint32_t count = 0;
+    size_t bytes = 0;
+    for (uint32_t index : m_order) {
+        Request& request = m_requests[index];
+        if (count > 0 && (bytes + request.bytes > p_budget.bytes || p_elapsed() >= p_budget.milliseconds)) {
+            break;
+        }
+
+        p_upload(request);
+        ++count;
+        bytes += request.bytes;
+        m_lookup.erase(request.asset.get());
+        request.asset.reset();
+    }
+
+    if (count) {
+        std::erase_if(m_requests, [](const Request& p_request) { return p_request.asset == nullptr; });
+        for (uint32_t i = 0; i < m_requests.size(); ++i) {
+            m_lookup[m_requests[i].asset.get()] = i;
+        }
+    }
+
+    m_stats.pending_count = static_cast<uint32_t>(m_requests.size());
+    m_stats.pending_bytes -= bytes;
+    m_stats.uploaded_count = count;
+    m_stats.uploaded_bytes = bytes;
+    m_stats.milliseconds = count ? p_elapsed() : 0.0;
+    return count;
+}
+
+}  // namespace cave
@@ -0,0 +1,72 @@
+#pragma once
+
+namespace cave {
+
+// how much a frame wants an asset that isn't on the gpu yet, the screen size of the largest
+// object using it
+struct UploadHint {
+    const void* asset;
+    float priority;
+};
+
+// Assets waiting for their gpu resource. Every frame creates the most relevant ones first, until
+// its byte or time budget is spent, so a level that loads hundreds of textures at once spreads
+// them over frames instead of stalling one. Requests without a hint keep their submission order.
+// A request holds the asset until it's uploaded, so an asset released meanwhile can't dangle.
+// Owned by the thread that creates the resources.
+class UploadQueue {
+public:
+    enum class Type : uint8_t {
+        TEXTURE,
+        MESH,
+    };
+
+    struct Request {
+        Type type;
+        std::shared_ptr<void> asset;
+        size_t bytes;
+        float priority;
+        uint64_t sequence;
+    };
+
+    struct Budget {
+        size_t bytes;
+        double milliseconds;
+    };
+
+    struct Stats {
+        uint32_t pending_count = 0;
+        size_t pending_bytes = 0;
+        // by the last Process() that had requests
+        uint32_t uploaded_count = 0;
+        size_t uploaded_bytes = 0;
+        double milliseconds = 0.0;
+    };
+
+    // an asset already waiting isn't queued twice
+    void Push(Type p_type, std::shared_ptr<void> p_asset, size_t p_bytes);
+
+    // replaces the priorities of the last frame, hints of assets that aren't waiting are ignored
+    void SetPriorities(std::span<const UploadHint> p_hints);
+
+    // Calls p_upload on the most relevant requests until the next one doesn't fit in the byte
+    // budget or p_elapsed, in milliseconds since the call, exceeds the time budget. The first
+    // request is always uploaded, one larger than the budget mustn't block the queue.
+    uint32_t Process(const Budget& p_budget,
+                     const std::function<void(const Request&)>& p_upload,
+                     const std::function<double()>& p_elapsed);
+
+    bool IsEmpty() const { return m_requests.empty(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    std::vector<Request> m_requests;
+    // asset to index in m_requests
+    std::unordered_map<const void*, uint32_t> m_lookup;
+    std::vector<uint32_t> m_order;
+    uint64_t m_sequence{ 0 };
+
+    Stats m_stats;
+};
+
+}  // namespace cave
@@ -203,6 +203,9 @@ bool Application::MainLoop() {
         return false;
     }
 
+    // resources created while rendering the previous frames become visible to this one
+    m_graphics_manager->PublishCreatedResources();
+
     m_render_system->BeginFrame();
     m_input_manager->BeginFrame();
 
@@ -266,10 +269,14 @@ bool Application::MainLoop() {
         m_physics_manager->Update(*scene, timestep);
     }
 
-    m_render_system->RenderFrame(scene.get());
+    m_render_system->RenderFrame(scene);
 
     // === Rendering Phase ===
-    m_graphics_manager->Update(scene.get());
+    if (m_render_system->IsPipelined()) {
+        m_render_system->SubmitFrame();
+    } else {
+        m_graphics_manager->Update(scene.get());
+    }
 
     // === End Frame ===
     m_input_manager->EndFrame();
@@ -0,0 +1,108 @@
+#include "frame_pipeline.h"
+
+#include "engine/debugger/profiler.h"
+
+namespace cave {
+
+FramePipeline::~FramePipeline() {
+    Stop();
+}
+
+void FramePipeline::Start(int p_buffer_count, RenderFunc p_render_func) {
+    DEV_ASSERT(!IsRunning());
+    DEV_ASSERT(p_render_func);
+
+    const int buffer_count = glm::clamp(p_buffer_count, MIN_BUFFER_COUNT, MAX_BUFFER_COUNT);
+    if (static_cast<int>(m_frames.size()) != buffer_count) {
+        m_frames.clear();
+        for (int i = 0; i < buffer_count; ++i) {
+            m_frames.emplace_back(std::make_unique<FrameData>(RenderOptions{}));
+        }
+    }
+
+    m_renderFunc = std::move(p_render_func);
+    m_acquired = 0;
+    m_submitted = 0;
+    m_rendered = 0;
+    m_stopRequested = false;
+    m_waitTime = 0.0;
+
+    m_thread = std::thread([this]() { RenderThreadMain(); });
+}
+
+void FramePipeline::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        DEV_ASSERT(m_acquired == m_submitted);
+        m_stopRequested = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+FrameData& FramePipeline::AcquireFrame(const RenderOptions& p_options) {
+    DEV_ASSERT(IsRunning());
+
+    const uint64_t frame = m_acquired;
+    const uint64_t buffer_count = m_frames.size();
+    {
+        std::unique_lock lock(m_mutex);
+        DEV_ASSERT(m_acquired == m_submitted);
+
+        const auto begin = std::chrono::steady_clock::now();
+        m_cv.wait(lock, [&]() { return frame < m_rendered + buffer_count; });
+        m_waitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        ++m_acquired;
+    }
+
+    FrameData& framedata = *m_frames[frame % buffer_count];
+    framedata.Reset(p_options);
+    return framedata;
+}
+
+void FramePipeline::SubmitFrame() {
+    {
+        std::lock_guard lock(m_mutex);
+        DEV_ASSERT(m_submitted + 1 == m_acquired);
+        ++m_submitted;
+    }
+    m_cv.notify_all();
+}
+
+void FramePipeline::WaitIdle() {
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [&]() { return m_rendered == m_submitted; });
+}
+
+void FramePipeline::RenderThreadMain() {
+    for (;;) {
+        uint64_t frame = 0;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [&]() { return m_rendered < m_submitted || m_stopRequested; });
+            if (m_rendered == m_submitted) {
+                DEV_ASSERT(m_stopRequested);
+                return;
+            }
+            frame = m_rendered;
+        }
+
+        {
+            CAVE_PROFILE_EVENT("RenderThread");
+            m_renderFunc(*m_frames[frame % m_frames.size()]);
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            ++m_rendered;
+        }
+        m_cv.notify_all();
+    }
+}
+
+}  // namespace cave
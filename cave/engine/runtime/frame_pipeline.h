@@ -0,0 +1,60 @@
+#pragma once
+#include <condition_variable>
+
+#include "engine/renderer/frame_data.h"
+
+namespace cave {
+
+// Hands frame data from the main thread to a render thread. The frames live in a ring, the main
+// thread fills frame N + 1 while the render thread consumes frame N. A submitted frame is never
+// written by the main thread again until the render thread is done with it, so the render thread
+// sees an immutable snapshot.
+class FramePipeline {
+public:
+    using RenderFunc = std::function<void(const FrameData&)>;
+
+    static constexpr int MIN_BUFFER_COUNT = 2;
+    static constexpr int MAX_BUFFER_COUNT = 3;
+
+    ~FramePipeline();
+
+    // p_buffer_count frames in the ring, the main thread runs at most p_buffer_count - 1 frames ahead
+    void Start(int p_buffer_count, RenderFunc p_render_func);
+
+    // renders the frames already submitted, then joins the render thread
+    void Stop();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Blocks until the render thread released the oldest frame of the ring, then recycles it.
+    FrameData& AcquireFrame(const RenderOptions& p_options);
+
+    void SubmitFrame();
+
+    // blocks until every submitted frame is rendered
+    void WaitIdle();
+
+    int GetBufferCount() const { return static_cast<int>(m_frames.size()); }
+
+    // time the main thread spent blocked in AcquireFrame() since the pipeline started
+    double GetWaitTime() const { return m_waitTime; }
+
+private:
+    void RenderThreadMain();
+
+    std::vector<std::unique_ptr<FrameData>> m_frames;
+    RenderFunc m_renderFunc;
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    // frame counters, frame i lives in m_frames[i % m_frames.size()]
+    uint64_t m_acquired{ 0 };
+    uint64_t m_submitted{ 0 };
+    uint64_t m_rendered{ 0 };
+    bool m_stopRequested{ false };
+
+    double m_waitTime{ 0.0 };
+};
+
+}  // namespace cave
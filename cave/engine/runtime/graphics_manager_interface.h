@@ -23,6 +23,7 @@ struct BlendDesc;
 struct Framebuffer;
 struct FramebufferDesc;
 struct FrameContext;
+struct FrameData;
 struct GpuBuffer;
 struct GpuBufferDesc;
 struct GpuConstantBuffer;
@@ -51,6 +52,12 @@ public:
     virtual auto InitializeImpl() -> Result<void> = 0;
     virtual void Update(Scene* p_scene) = 0;
 
+    // Creates the requested resources and renders a frame built by the render system, runs on the
+    // render thread in pipelined mode. p_framedata can be null when there's nothing to draw.
+    virtual void RenderFrame(const FrameData* p_framedata) = 0;
+    // hands the resources created by RenderFrame() over to their assets, main thread only
+    virtual void PublishCreatedResources() = 0;
+
     // resource
     virtual auto CreateConstantBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuConstantBuffer>> = 0;
     virtual auto CreateStructuredBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuStructuredBuffer>> = 0;
@@ -97,8 +104,10 @@ public:
     virtual void UnbindStructuredBufferSRV(int p_slot) = 0;
 
     virtual void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) = 0;
-    template<typename T>
-    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const std::vector<T>& p_vector) {
+    // writes p_size bytes at p_offset, the rest of the buffer keeps its content
+    virtual void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) = 0;
+    template<typename T, typename ALLOCATOR>
+    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const std::vector<T, ALLOCATOR>& p_vector) {
         UpdateConstantBuffer(p_buffer, p_vector.data(), sizeof(T) * (uint32_t)p_vector.size());
     }
     template<typename T, int N>
@@ -125,8 +134,8 @@ public:
     virtual void BeginEvent(std::string_view p_event) = 0;
     virtual void EndEvent() = 0;
 
-    virtual void RequestTexture(ImageAsset* p_image) = 0;
-    virtual void RequestMesh(MeshAsset* p_mesh) = 0;
+    virtual void RequestTexture(std::shared_ptr<ImageAsset> p_image) = 0;
+    virtual void RequestMesh(std::shared_ptr<MeshAsset> p_mesh) = 0;
 
     // @TODO: move to renderer
     virtual uint64_t GetFinalImage() const = 0;
@@ -144,6 +153,12 @@ public:
 
     virtual FrameContext& GetCurrentFrame() = 0;
 
+    // Contexts the render graph records the passes of a level on concurrently, one per job. A
+    // context starts with the bindings of the graphics manager. Backends without any record every
+    // pass on the graphics manager.
+    virtual int GetRecordingContextCount() const = 0;
+    virtual IGraphicsManager& BeginRecording(int p_index) = 0;
+
     virtual void DrawSkybox() = 0;
 
 protected:
@@ -8,6 +8,10 @@
 #include "engine/renderer/graphics_dvars.h"
 #include "engine/scripting/lua/lua_script_manager.h"
 
+#if !USING(PLATFORM_WASM)
+#include "modules/sw/sw_renderer.h"
+#endif
+
 #if USING(PLATFORM_WINDOWS)
 #include "modules/d3d11/d3d11_graphics_manager.h"
 #include "modules/d3d12/d3d12_graphics_manager.h"
@@ -104,6 +108,14 @@ static IGraphicsManager* SelectGraphicsManager(const std::string& p_backend) {
         return nullptr;
     }
 
+    if (p_backend == "software") {
+#if USING(PLATFORM_WASM)
+        return nullptr;
+#else
+        return new SwGraphicsManager;
+#endif
+    }
+
     return new EmptyGraphicsManager;
 }
 
@@ -14,7 +14,7 @@
 namespace cave {
 
 // render systems
-extern void RunMeshRenderSystem(Scene* p_scene, FrameData& p_framedata);
+extern void RunMeshRenderSystem(Scene* p_scene, SceneRenderState* p_state, FrameData& p_framedata);
 extern void RunTileMapRenderSystem(Scene* p_scene, FrameData& p_framedata);
 
 extern void RunSpriteRenderSystem(const Scene* p_scene, FrameData& p_framedata);
@@ -25,6 +25,58 @@ auto RenderSystem::InitializeImpl() -> Result<void> {
 }
 
 void RenderSystem::FinalizeImpl() {
+    m_pipeline.Stop();
+    m_frameData = nullptr;
+    m_sceneStates.clear();
+}
+
+const SceneRenderState* RenderSystem::FindSceneRenderState(const std::shared_ptr<const Scene>& p_scene) const {
+    auto it = m_sceneStates.find(p_scene);
+    return it != m_sceneStates.end() ? it->second.get() : nullptr;
+}
+
+void RenderSystem::UpdatePipelineMode() {
+    IGraphicsManager* graphics_manager = m_app->GetGraphicsManager();
+    const int buffer_count = DVAR_GET_INT(gfx_frame_buffering);
+    bool pipelined = DVAR_GET_BOOL(gfx_pipelined_render);
+    if (pipelined) {
+        // ImGui draw data and OpenGL contexts are bound to the main thread
+        bool supported = !m_app->GetSpecification().enableImgui;
+        switch (graphics_manager->GetBackend()) {
+            case Backend::D3D11:
+            case Backend::D3D12:
+            case Backend::EMPTY:
+            case Backend::SOFTWARE:
+                break;
+            default:
+                supported = false;
+                break;
+        }
+
+        if (!supported) {
+            LOG_WARN("pipelined rendering is not supported with ImGui or the current backend, rendering in serial mode");
+            DVAR_SET_BOOL(gfx_pipelined_render, false);
+            pipelined = false;
+        }
+    }
+
+    if (pipelined == m_pipeline.IsRunning() &&
+        (!pipelined || buffer_count == m_pipeline.GetBufferCount())) {
+        return;
+    }
+
+    m_pipeline.Stop();
+    if (pipelined) {
+        m_pipeline.Start(buffer_count, [graphics_manager](const FrameData& p_framedata) {
+            graphics_manager->RenderFrame(&p_framedata);
+        });
+    }
+    LOG_VERBOSE("rendering in {} mode", pipelined ? "pipelined" : "serial");
+}
+
+void RenderSystem::SubmitFrame() {
+    DEV_ASSERT(m_pipeline.IsRunning());
+    m_pipeline.SubmitFrame();
 }
 
 #if 0
@@ -155,37 +207,49 @@ static void FillEnvConstants(FrameData& p_out_data) {
 }
 
 void RenderSystem::BeginFrame() {
-    if (m_frameData) {
-        delete m_frameData;
-        m_frameData = nullptr;
-    }
-
     RenderOptions options = {
         .isOpengl = m_app->GetGraphicsManager()->GetBackend() == Backend::OPENGL,
         .ssaoEnabled = DVAR_GET_BOOL(gfx_ssao_enabled),
         .vxgiEnabled = false,
         .bloomEnabled = DVAR_GET_BOOL(gfx_enable_bloom),
         .iblEnabled = DVAR_GET_BOOL(gfx_enable_ibl),
+        .occlusionCullingEnabled = DVAR_GET_BOOL(gfx_occlusion_culling),
+        // only the OpenGL 4 lighting shader reads the cluster buffers
+        .clusteredLightingEnabled = DVAR_GET_BOOL(gfx_clustered_lighting) && !USING(PLATFORM_WASM) &&
+                                    m_app->GetGraphicsManager()->GetBackend() == Backend::OPENGL,
+        .meshLodEnabled = DVAR_GET_BOOL(gfx_mesh_lod),
         .debugVoxelId = DVAR_GET_INT(gfx_debug_vxgi_voxel),
         .debugBvhDepth = DVAR_GET_INT(gfx_bvh_debug),
         .voxelTextureSize = DVAR_GET_INT(gfx_voxel_size),
         .ssaoKernelRadius = DVAR_GET_FLOAT(gfx_ssao_radius),
+        .meshLodPixelError = DVAR_GET_FLOAT(gfx_mesh_lod_pixel_error),
+        .shadowLodBias = DVAR_GET_FLOAT(gfx_shadow_lod_bias),
     };
 
-    // @HACK
-    m_frameData = new FrameData(options);
+    // the frame data is recycled so its buffers and caches keep their memory across frames
+    UpdatePipelineMode();
+    if (m_pipeline.IsRunning()) {
+        m_frameData = &m_pipeline.AcquireFrame(options);
+    } else if (m_serialFrameData) {
+        m_serialFrameData->Reset(options);
+        m_frameData = m_serialFrameData.get();
+    } else {
+        m_serialFrameData = std::make_unique<FrameData>(options);
+        m_frameData = m_serialFrameData.get();
+    }
     static bool s_firstFrame = true;
     m_frameData->bakeIbl = s_firstFrame;
     s_firstFrame = false;
 }
 
-void RenderSystem::RenderFrame(Scene* p_scene) {
+void RenderSystem::RenderFrame(const std::shared_ptr<Scene>& p_scene) {
     // HACK
     auto backend = m_app->GetGraphicsManager()->GetBackend();
     switch (backend) {
         case cave::Backend::OPENGL:
         case cave::Backend::D3D11:
         case cave::Backend::D3D12:
+        case cave::Backend::SOFTWARE:
             break;
         default:
             return;
@@ -205,14 +269,25 @@ void RenderSystem::RenderFrame(Scene* p_scene) {
         return;
     }
     FillCameraData(*camera, framedata);
-    FillConstantBuffer(p_scene, framedata);
+    FillConstantBuffer(p_scene.get(), framedata);
+
+    // keyed by owner, a new scene never picks up the slots of a destroyed one at the same address
+    std::erase_if(m_sceneStates, [](const auto& p_entry) { return p_entry.first.expired(); });
+    SceneRenderState* scene_state = nullptr;
+    if (p_scene) {
+        auto& state = m_sceneStates[p_scene];
+        if (!state) {
+            state = std::make_unique<SceneRenderState>();
+        }
+        scene_state = state.get();
+    }
 
-    RunMeshRenderSystem(p_scene, framedata);
+    RunMeshRenderSystem(p_scene.get(), scene_state, framedata);
 
-    RunTileMapRenderSystem(p_scene, framedata);
-    RunSpriteRenderSystem(p_scene, framedata);
+    RunTileMapRenderSystem(p_scene.get(), framedata);
+    RunSpriteRenderSystem(p_scene.get(), framedata);
 
-    RunDebugRenderSystem(p_scene, framedata);
+    RunDebugRenderSystem(p_scene.get(), framedata);
 
     // @TODO: RunSprite
     // @TODO: RunTileMap
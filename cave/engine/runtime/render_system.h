@@ -1,4 +1,6 @@
 #pragma once
+#include "engine/renderer/scene_render_state.h"
+#include "engine/runtime/frame_pipeline.h"
 #include "engine/runtime/module.h"
 
 namespace cave {
@@ -14,17 +16,35 @@ public:
 
     void BeginFrame();
 
-    void RenderFrame(Scene* p_scene);
+    void RenderFrame(const std::shared_ptr<Scene>& p_scene);
 
+    // Pipelined mode only, hands the frame over to the render thread. In serial mode the main loop
+    // calls IGraphicsManager::Update() instead.
+    void SubmitFrame();
+
+    bool IsPipelined() const { return m_pipeline.IsRunning(); }
+
+    // the frame being built on the main thread
     const FrameData* GetFrameData() const { return m_frameData; }
 
+    // the renderer state kept for p_scene, nullptr if it wasn't rendered yet
+    const SceneRenderState* FindSceneRenderState(const std::shared_ptr<const Scene>& p_scene) const;
+
 protected:
     auto InitializeImpl() -> Result<void> override;
     void FinalizeImpl() override;
 
     void FillCameraData(const CameraComponent& p_camera, FrameData& p_framedata);
 
+    // switches between serial and pipelined rendering, the render thread is drained first
+    void UpdatePipelineMode();
+
     FrameData* m_frameData{ nullptr };
+    // serial mode recycles this one
+    std::unique_ptr<FrameData> m_serialFrameData;
+    FramePipeline m_pipeline;
+    // renderer state of the scenes that were rendered, dropped once their scene is destroyed
+    std::map<std::weak_ptr<const Scene>, std::unique_ptr<SceneRenderState>, std::owner_less<>> m_sceneStates;
 };
 
 }  // namespace cave
@@ -0,0 +1,64 @@
+#include "animation_lod.h"
+
+namespace cave {
+
+uint32_t SelectAnimationLodInterval(const AnimationLodSettings& p_settings, bool p_visible, float p_screen_size) {
+    if (!p_settings.enabled) {
+        return 1;
+    }
+    if (!p_visible) {
+        DEV_ASSERT(std::has_single_bit(p_settings.offscreen_interval));
+        return p_settings.offscreen_interval;
+    }
+
+    uint32_t interval = 1;
+    for (int i = 0; i < AnimationLodSettings::THRESHOLD_COUNT; ++i) {
+        if (p_screen_size >= p_settings.screen_size_thresholds[i]) {
+            break;
+        }
+        interval <<= 1;
+    }
+    return interval;
+}
+
+void AnimationLodState::Schedule(const AnimationLodSettings& p_settings, uint32_t p_frame, bool p_has_visibility) {
+    const bool visible = !p_has_visibility || IsVisible(p_frame);
+    const float size = p_has_visibility ? screen_size : std::numeric_limits<float>::max();
+    interval = SelectAnimationLodInterval(p_settings, visible, size);
+
+    const uint32_t offset = (p_frame + phase) & (interval - 1);
+    // the second check bounds the gap when the interval grows between two updates
+    evaluate = !has_evaluated || offset == 0 || frames_since_update + 1 >= span;
+
+    if (evaluate) {
+        has_evaluated = true;
+        frames_since_update = 0;
+        span = interval - offset;
+    } else {
+        ++frames_since_update;
+    }
+}
+
+void AnimationLodState::MarkVisible(uint32_t p_frame, float p_screen_size) {
+    if (visible_frame != p_frame) {
+        visible_frame = p_frame;
+        screen_size = p_screen_size;
+    } else {
+        screen_size = glm::max(screen_size, p_screen_size);
+    }
+}
+
+void InterpolateBonePalette(const std::vector<Matrix4x4f>& p_from,
+                            const std::vector<Matrix4x4f>& p_to,
+                            float p_t,
+                            std::vector<Matrix4x4f>& p_out) {
+    DEV_ASSERT(p_from.size() == p_to.size());
+    p_out.resize(p_to.size());
+
+    const float s = 1.0f - p_t;
+    for (size_t i = 0; i < p_to.size(); ++i) {
+        p_out[i] = p_from[i] * s + p_to[i] * p_t;
+    }
+}
+
+}  // namespace cave
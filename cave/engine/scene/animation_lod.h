@@ -0,0 +1,74 @@
+#pragma once
+#include "engine/ecs/entity.h"
+#include "engine/math/geomath.h"
+
+namespace cave {
+
+struct AnimationLodSettings {
+    bool enabled = true;
+
+    // Screen size is the projected bounding radius over half the viewport height. A visible skeleton
+    // at least screen_size_thresholds[0] big is evaluated every frame, every threshold it falls
+    // below doubles its update interval.
+    static constexpr int THRESHOLD_COUNT = 3;
+    float screen_size_thresholds[THRESHOLD_COUNT] = { 0.2f, 0.08f, 0.03f };
+
+    // interval of skeletons that were culled last frame, must be a power of two
+    uint32_t offscreen_interval = 16;
+};
+
+struct AnimationLodStats {
+    uint32_t skeleton_count = 0;
+    // skeletons whose clips were sampled and blended this frame
+    uint32_t evaluated_count = 0;
+    // skeletons driven by a clip whose palette was interpolated between two evaluations
+    uint32_t interpolated_count = 0;
+    uint32_t offscreen_count = 0;
+};
+
+// Skeletons drawn by the renderer in one frame. The renderer only fills the report, the
+// animation update applies it to the LOD state of the skeletons before scheduling.
+struct SkeletonVisibilityReport {
+    uint32_t frame = 0;
+    // false until the renderer wrote the report once, an empty report of frame 0 means nothing
+    bool written = false;
+    // a skeleton shared by several meshes is listed once per mesh
+    std::vector<std::pair<ecs::Entity, float>> skeletons;
+};
+
+// Per skeleton scheduling state. The visibility of the previous frame comes from the renderer's
+// report, the scheduler decides whether the skeleton is evaluated this frame.
+struct AnimationLodState {
+    // frame in which the renderer last saw the skeleton, and its largest screen size in that frame
+    uint32_t visible_frame = 0;
+    float screen_size = 0.0f;
+
+    // offsets the update frame so skeletons sharing an interval don't all update together
+    uint32_t phase = 0;
+    uint32_t interval = 1;
+    // frames between the last evaluation and the next scheduled one
+    uint32_t span = 1;
+    uint32_t frames_since_update = 0;
+    bool evaluate = true;
+    bool has_evaluated = false;
+
+    // Visibility is only trusted if the renderer reported it for the previous frame, so scenes that
+    // are never rendered keep evaluating every skeleton each frame.
+    void Schedule(const AnimationLodSettings& p_settings, uint32_t p_frame, bool p_has_visibility);
+
+    // keeps the largest screen size reported for p_frame
+    void MarkVisible(uint32_t p_frame, float p_screen_size);
+
+    bool IsVisible(uint32_t p_frame) const { return visible_frame + 1 >= p_frame; }
+};
+
+uint32_t SelectAnimationLodInterval(const AnimationLodSettings& p_settings, bool p_visible, float p_screen_size);
+
+// p_out = lerp(p_from, p_to, p_t) per matrix element, the bones of a distant skeleton move little
+// between two evaluations so this is close enough to interpolating the decomposed transforms
+void InterpolateBonePalette(const std::vector<Matrix4x4f>& p_from,
+                            const std::vector<Matrix4x4f>& p_to,
+                            float p_t,
+                            std::vector<Matrix4x4f>& p_out);
+
+}  // namespace cave
@@ -0,0 +1,418 @@
+#include "compressed_animation_clip.h"
+
+#include "engine/scene/skeletal_animation_component.h"
+
+#if USING(MATH_ENABLE_SIMD_SSE)
+#include <emmintrin.h>
+#endif
+
+namespace cave {
+
+static constexpr float QUANTIZE_MAX = 65535.0f;
+
+static int ComponentCount(AnimationChannelPath p_path) {
+    return p_path == AnimationChannelPath::Rotation ? 4 : 3;
+}
+
+static Vector4f ReadKey(const SkeletalAnimationSampler& p_sampler, AnimationChannelPath p_path, int p_key) {
+    const int count = ComponentCount(p_path);
+    const float* data = p_sampler.keyframe_data.data() + p_key * count;
+    return Vector4f(data[0], data[1], data[2], count == 4 ? data[3] : 0.0f);
+}
+
+static Vector4f Interpolate(AnimationChannelPath p_path, const Vector4f& p_a, const Vector4f& p_b, float p_t) {
+    if (p_path != AnimationChannelPath::Rotation) {
+        return lerp(p_a, p_b, p_t);
+    }
+
+    // nlerp along the shortest arc
+    const Vector4f b = dot(p_a, p_b) < 0.0f ? -p_b : p_b;
+    return normalize(lerp(p_a, b, p_t));
+}
+
+static float KeyError(AnimationChannelPath p_path, const Vector4f& p_a, const Vector4f& p_b) {
+    switch (p_path) {
+        case AnimationChannelPath::Translation: {
+            const Vector4f diff = p_a - p_b;
+            return glm::sqrt(diff.x * diff.x + diff.y * diff.y + diff.z * diff.z);
+        }
+        case AnimationChannelPath::Rotation: {
+            // q and -q are the same rotation
+            const Vector4f b = dot(p_a, p_b) < 0.0f ? -p_b : p_b;
+            const Vector4f diff = abs(p_a - b);
+            return glm::max(glm::max(diff.x, diff.y), glm::max(diff.z, diff.w));
+        }
+        default: {
+            const Vector4f diff = abs(p_a - p_b);
+            return glm::max(glm::max(diff.x, diff.y), diff.z);
+        }
+    }
+}
+
+static float ErrorThreshold(AnimationChannelPath p_path, const AnimationCompressionSettings& p_settings) {
+    switch (p_path) {
+        case AnimationChannelPath::Translation:
+            return p_settings.translation_error;
+        case AnimationChannelPath::Rotation:
+            return p_settings.rotation_error;
+        default:
+            return p_settings.scale_error;
+    }
+}
+
+// Smallest-three: drop the largest component, the sign is flipped so it's always positive and
+// can be reconstructed from the other three.
+static int EncodeQuaternion(Vector4f p_quat, float* p_out) {
+    p_quat = normalize(p_quat);
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (glm::abs(p_quat[i]) > glm::abs(p_quat[largest])) {
+            largest = i;
+        }
+    }
+
+    const float sign = p_quat[largest] < 0.0f ? -1.0f : 1.0f;
+    for (int i = 0, j = 0; i < 4; ++i) {
+        if (i != largest) {
+            p_out[j++] = sign * p_quat[i];
+        }
+    }
+    return largest;
+}
+
+static Vector4f DecodeQuaternion(int p_largest, const float* p_values) {
+    const float a = p_values[0];
+    const float b = p_values[1];
+    const float c = p_values[2];
+    const float largest = glm::sqrt(glm::max(0.0f, 1.0f - a * a - b * b - c * c));
+
+    Vector4f quat;
+    for (int i = 0, j = 0; i < 4; ++i) {
+        quat[i] = i == p_largest ? largest : p_values[j++];
+    }
+    return normalize(quat);
+}
+
+bool CompressedAnimationClip::Compress(const std::vector<SkeletalAnimationSampler>& p_samplers,
+                                       const std::vector<SkeletalAnimationChannel>& p_channels,
+                                       const AnimationCompressionSettings& p_settings) {
+    Clear();
+
+    if (p_samplers.empty() || p_settings.segment_key_count <= 0) {
+        return false;
+    }
+
+    // all samplers must share the same time array, so keys can be removed clip-wide
+    const std::vector<float>& source_times = p_samplers.front().keyframe_times;
+    const int source_key_count = static_cast<int>(source_times.size());
+    if (source_key_count == 0) {
+        return false;
+    }
+    for (const SkeletalAnimationSampler& sampler : p_samplers) {
+        if (sampler.keyframe_times != source_times) {
+            return false;
+        }
+    }
+
+    const int track_count = static_cast<int>(p_samplers.size());
+    m_tracks.resize(track_count);
+    for (Track& track : m_tracks) {
+        track.path = AnimationChannelPath::Count;
+    }
+    for (const SkeletalAnimationChannel& channel : p_channels) {
+        if (channel.sampler_index >= 0 && channel.sampler_index < track_count) {
+            m_tracks[channel.sampler_index].path = channel.path;
+        }
+    }
+
+    // decode the source once
+    std::vector<std::vector<Vector4f>> values(track_count);
+    for (int track_index = 0; track_index < track_count; ++track_index) {
+        const Track& track = m_tracks[track_index];
+        const SkeletalAnimationSampler& sampler = p_samplers[track_index];
+        if (track.path == AnimationChannelPath::Count) {
+            continue;
+        }
+        if (sampler.keyframe_data.size() != source_times.size() * ComponentCount(track.path)) {
+            Clear();
+            return false;
+        }
+
+        auto& track_values = values[track_index];
+        track_values.resize(source_key_count);
+        for (int key = 0; key < source_key_count; ++key) {
+            track_values[key] = ReadKey(sampler, track.path, key);
+        }
+    }
+
+    // constant tracks
+    std::vector<int> animated_tracks;
+    for (int track_index = 0; track_index < track_count; ++track_index) {
+        Track& track = m_tracks[track_index];
+        if (track.path == AnimationChannelPath::Count) {
+            continue;
+        }
+
+        const auto& track_values = values[track_index];
+        const float threshold = ErrorThreshold(track.path, p_settings);
+        bool constant = true;
+        for (int key = 1; key < source_key_count && constant; ++key) {
+            constant = KeyError(track.path, track_values[0], track_values[key]) <= threshold;
+        }
+
+        track.constant = track_values[0];
+        if (!constant) {
+            animated_tracks.push_back(track_index);
+        }
+    }
+
+    // samplers no channel refers to are kept as zero constants, so every track has a valid path
+    for (Track& track : m_tracks) {
+        if (track.path == AnimationChannelPath::Count) {
+            track.path = AnimationChannelPath::Translation;
+        }
+    }
+
+    // re-encode with tighter key reduction until the quantized clip fits the thresholds
+    AnimationCompressionSettings reduction = p_settings;
+    for (int attempt = 0; attempt < MAX_ENCODE_ATTEMPTS; ++attempt) {
+        Encode(source_times, values, animated_tracks, reduction, p_settings.segment_key_count);
+        if (IsWithinError(source_times, values, p_settings)) {
+            return true;
+        }
+
+        reduction.translation_error *= 0.5f;
+        reduction.rotation_error *= 0.5f;
+        reduction.scale_error *= 0.5f;
+    }
+
+    // quantization alone exceeds the thresholds (e.g. a large translation range)
+    Clear();
+    return false;
+}
+
+void CompressedAnimationClip::Encode(const std::vector<float>& p_source_times,
+                                     const std::vector<std::vector<Vector4f>>& p_values,
+                                     const std::vector<int>& p_animated_tracks,
+                                     const AnimationCompressionSettings& p_reduction,
+                                     int p_segment_key_count) {
+    const int source_key_count = static_cast<int>(p_source_times.size());
+
+    // key reduction, a key is dropped only if every animated track can interpolate over it
+    auto can_interpolate = [&](int p_from, int p_to) {
+        const float duration = p_source_times[p_to] - p_source_times[p_from];
+        for (int track_index : p_animated_tracks) {
+            const Track& track = m_tracks[track_index];
+            const auto& track_values = p_values[track_index];
+            const float threshold = ErrorThreshold(track.path, p_reduction);
+            for (int key = p_from + 1; key < p_to; ++key) {
+                const float t = duration > 0.0f ? (p_source_times[key] - p_source_times[p_from]) / duration : 0.0f;
+                const Vector4f approx = Interpolate(track.path, track_values[p_from], track_values[p_to], t);
+                if (KeyError(track.path, approx, track_values[key]) > threshold) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    std::vector<int> kept_keys = { 0 };
+    for (int anchor = 0, end = 2; end < source_key_count; ++end) {
+        if (end - anchor > MAX_KEY_SPAN || !can_interpolate(anchor, end)) {
+            anchor = end - 1;
+            kept_keys.push_back(anchor);
+        }
+    }
+    if (source_key_count > 1) {
+        kept_keys.push_back(source_key_count - 1);
+    }
+
+    const int key_count = static_cast<int>(kept_keys.size());
+    m_times.clear();
+    m_times.reserve(key_count);
+    for (int key : kept_keys) {
+        m_times.push_back(p_source_times[key]);
+    }
+
+    // assign lanes, every animated track takes 3 lanes (xyz or smallest-three)
+    int lane_count = 0;
+    m_rotation_stride = 0;
+    for (int track_index : p_animated_tracks) {
+        Track& track = m_tracks[track_index];
+        track.lane = lane_count;
+        lane_count += 3;
+        if (track.path == AnimationChannelPath::Rotation) {
+            track.rotation_slot = m_rotation_stride++;
+        }
+    }
+
+    m_row_stride = (lane_count + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+    m_segment_key_count = p_segment_key_count;
+
+    // lane values before quantization
+    std::vector<float> lanes(static_cast<size_t>(key_count) * m_row_stride, 0.0f);
+    m_rotation_index.assign(static_cast<size_t>(key_count) * m_rotation_stride, 0);
+    for (int key = 0; key < key_count; ++key) {
+        float* row = lanes.data() + static_cast<size_t>(key) * m_row_stride;
+        for (int track_index : p_animated_tracks) {
+            const Track& track = m_tracks[track_index];
+            const Vector4f& value = p_values[track_index][kept_keys[key]];
+            if (track.path == AnimationChannelPath::Rotation) {
+                const int largest = EncodeQuaternion(value, row + track.lane);
+                m_rotation_index[static_cast<size_t>(key) * m_rotation_stride + track.rotation_slot] = static_cast<uint8_t>(largest);
+            } else {
+                row[track.lane + 0] = value.x;
+                row[track.lane + 1] = value.y;
+                row[track.lane + 2] = value.z;
+            }
+        }
+    }
+
+    // range reduction and quantization per segment
+    const int segment_count = (key_count + m_segment_key_count - 1) / m_segment_key_count;
+    m_segment_ranges.assign(static_cast<size_t>(segment_count) * 2 * m_row_stride, 0.0f);
+    m_key_data.assign(lanes.size(), 0);
+    for (int segment = 0; segment < segment_count; ++segment) {
+        const int first_key = segment * m_segment_key_count;
+        const int last_key = glm::min(first_key + m_segment_key_count, key_count);
+        float* range_min = m_segment_ranges.data() + static_cast<size_t>(segment) * 2 * m_row_stride;
+        float* range_scale = range_min + m_row_stride;
+
+        for (int lane = 0; lane < lane_count; ++lane) {
+            float lane_min = std::numeric_limits<float>::max();
+            float lane_max = -std::numeric_limits<float>::max();
+            for (int key = first_key; key < last_key; ++key) {
+                const float value = lanes[static_cast<size_t>(key) * m_row_stride + lane];
+                lane_min = glm::min(lane_min, value);
+                lane_max = glm::max(lane_max, value);
+            }
+
+            const float extent = lane_max - lane_min;
+            range_min[lane] = lane_min;
+            range_scale[lane] = extent / QUANTIZE_MAX;
+
+            for (int key = first_key; key < last_key; ++key) {
+                const size_t index = static_cast<size_t>(key) * m_row_stride + lane;
+                const float normalized = extent > 0.0f ? (lanes[index] - lane_min) / extent : 0.0f;
+                m_key_data[index] = static_cast<uint16_t>(glm::round(Saturate(normalized) * QUANTIZE_MAX));
+            }
+        }
+    }
+}
+
+bool CompressedAnimationClip::IsWithinError(const std::vector<float>& p_source_times,
+                                            const std::vector<std::vector<Vector4f>>& p_values,
+                                            const AnimationCompressionSettings& p_settings) const {
+    KeyframeCursor cursor;
+    std::vector<float> scratch(GetScratchSize());
+    std::vector<Vector4f> sampled(m_tracks.size());
+    for (int key = 0; key < static_cast<int>(p_source_times.size()); ++key) {
+        Sample(p_source_times[key], cursor, scratch.data(), sampled.data());
+        for (size_t track_index = 0; track_index < m_tracks.size(); ++track_index) {
+            const auto& track_values = p_values[track_index];
+            if (track_values.empty()) {
+                continue;
+            }
+
+            const AnimationChannelPath path = m_tracks[track_index].path;
+            if (KeyError(path, sampled[track_index], track_values[key]) > ErrorThreshold(path, p_settings)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void CompressedAnimationClip::Clear() {
+    m_times.clear();
+    m_tracks.clear();
+    m_key_data.clear();
+    m_rotation_index.clear();
+    m_segment_ranges.clear();
+    m_row_stride = 0;
+    m_rotation_stride = 0;
+    m_segment_key_count = 0;
+}
+
+size_t CompressedAnimationClip::GetMemoryUsage() const {
+    size_t bytes = sizeof(*this);
+    bytes += m_times.size() * sizeof(float);
+    bytes += m_tracks.size() * sizeof(Track);
+    bytes += m_key_data.size() * sizeof(uint16_t);
+    bytes += m_rotation_index.size() * sizeof(uint8_t);
+    bytes += m_segment_ranges.size() * sizeof(float);
+    return bytes;
+}
+
+void CompressedAnimationClip::DecompressRow(int p_key, float* p_out) const {
+    const uint16_t* row = m_key_data.data() + static_cast<size_t>(p_key) * m_row_stride;
+    const float* range_min = m_segment_ranges.data() + static_cast<size_t>(p_key / m_segment_key_count) * 2 * m_row_stride;
+    const float* range_scale = range_min + m_row_stride;
+
+#if USING(MATH_ENABLE_SIMD_SSE)
+    static_assert(ROW_ALIGNMENT == 8, "a row is processed 8 lanes at a time");
+    const __m128i zero = _mm_setzero_si128();
+    for (int lane = 0; lane < m_row_stride; lane += 8) {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + lane));
+        const __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero));
+        const __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(packed, zero));
+        const __m128 result_lo = _mm_add_ps(_mm_loadu_ps(range_min + lane), _mm_mul_ps(lo, _mm_loadu_ps(range_scale + lane)));
+        const __m128 result_hi = _mm_add_ps(_mm_loadu_ps(range_min + lane + 4), _mm_mul_ps(hi, _mm_loadu_ps(range_scale + lane + 4)));
+        _mm_storeu_ps(p_out + lane, result_lo);
+        _mm_storeu_ps(p_out + lane + 4, result_hi);
+    }
+#else
+    for (int lane = 0; lane < m_row_stride; ++lane) {
+        p_out[lane] = range_min[lane] + static_cast<float>(row[lane]) * range_scale[lane];
+    }
+#endif
+}
+
+Vector4f CompressedAnimationClip::DecodeTrack(const Track& p_track, int p_key, const float* p_row) const {
+    if (p_track.lane < 0) {
+        return p_track.constant;
+    }
+
+    const float* values = p_row + p_track.lane;
+    if (p_track.path == AnimationChannelPath::Rotation) {
+        const int largest = m_rotation_index[static_cast<size_t>(p_key) * m_rotation_stride + p_track.rotation_slot];
+        return DecodeQuaternion(largest, values);
+    }
+
+    return Vector4f(values[0], values[1], values[2], 0.0f);
+}
+
+void CompressedAnimationClip::Sample(float p_time, KeyframeCursor& p_cursor, float* p_scratch, Vector4f* p_out) const {
+    DEV_ASSERT(IsValid());
+
+    const int key_count = GetKeyCount();
+    const int key_left = glm::max(p_cursor.Seek(m_times, p_time), 0);
+    const int key_right = glm::min(key_left + 1, key_count - 1);
+
+    float t = 0.0f;
+    if (key_left != key_right) {
+        t = Saturate((p_time - m_times[key_left]) / (m_times[key_right] - m_times[key_left]));
+    }
+
+    float* row_left = p_scratch;
+    float* row_right = p_scratch + m_row_stride;
+    DecompressRow(key_left, row_left);
+    DecompressRow(key_right, row_right);
+
+    for (size_t track_index = 0; track_index < m_tracks.size(); ++track_index) {
+        const Track& track = m_tracks[track_index];
+        if (track.path == AnimationChannelPath::Count) {
+            continue;
+        }
+        if (track.lane < 0) {
+            p_out[track_index] = track.constant;
+            continue;
+        }
+
+        const Vector4f left = DecodeTrack(track, key_left, row_left);
+        const Vector4f right = DecodeTrack(track, key_right, row_right);
+        p_out[track_index] = Interpolate(track.path, left, right, t);
+    }
+}
+
+}  // namespace cave
@@ -0,0 +1,128 @@
+#pragma once
+#include "engine/math/geomath.h"
+#include "engine/reflection/reflection.h"
+
+namespace cave {
+
+enum class AnimationChannelPath {
+    Translation,
+    Rotation,
+    Scale,
+    Count,
+};
+
+DECLARE_ENUM_TRAITS(AnimationChannelPath, "translation", "rotation", "scale");
+
+struct KeyframeCursor;
+struct SkeletalAnimationChannel;
+struct SkeletalAnimationSampler;
+
+struct AnimationCompressionSettings {
+    // max error of the decoded clip against the source keys, in model units for translation,
+    // quaternion component for rotation
+    float translation_error = 0.0005f;
+    float rotation_error = 0.0005f;
+    float scale_error = 0.0005f;
+
+    // keys in a segment are quantized against the same range
+    int segment_key_count = 16;
+};
+
+struct CompressedAnimationTrack {
+    CAVE_META(CompressedAnimationTrack)
+
+    CAVE_PROP()
+    AnimationChannelPath path = AnimationChannelPath::Count;
+
+    // first uint16 lane in a row, -1 if the track is constant
+    CAVE_PROP()
+    int lane = -1;
+
+    // index into the per-key rotation index row, -1 if not an animated rotation
+    CAVE_PROP()
+    int rotation_slot = -1;
+
+    CAVE_PROP()
+    Vector4f constant = Vector4f::Zero;
+};
+
+// Lossy, import-time representation of a skeletal clip whose samplers share one time array.
+//
+// * keys that can be linearly interpolated within the error thresholds are removed clip-wide,
+//   so all tracks keep sharing a single time array
+// * tracks that never change are stored as a single constant
+// * animated tracks are quantized to 16 bits per component against a per-segment range,
+//   rotations use the smallest-three encoding
+// * the quantized values of all tracks at one key are stored in one row, so sampling touches
+//   two adjacent rows and dequantizes them with SIMD
+// * key reduction and quantization errors add up, so the clip is re-encoded with tighter key
+//   reduction until every source key decodes within the thresholds
+class CompressedAnimationClip {
+    CAVE_META(CompressedAnimationClip)
+
+public:
+    static constexpr int ROW_ALIGNMENT = 8;
+    static constexpr int MAX_KEY_SPAN = 64;
+    static constexpr int MAX_ENCODE_ATTEMPTS = 4;
+
+    using Track = CompressedAnimationTrack;
+
+    bool Compress(const std::vector<SkeletalAnimationSampler>& p_samplers,
+                  const std::vector<SkeletalAnimationChannel>& p_channels,
+                  const AnimationCompressionSettings& p_settings);
+
+    // Samples every track at p_time into p_out (indexed by sampler index). p_scratch must hold
+    // at least GetScratchSize() floats.
+    void Sample(float p_time, KeyframeCursor& p_cursor, float* p_scratch, Vector4f* p_out) const;
+
+    bool IsValid() const { return !m_times.empty(); }
+    void Clear();
+
+    int GetTrackCount() const { return static_cast<int>(m_tracks.size()); }
+    int GetKeyCount() const { return static_cast<int>(m_times.size()); }
+    int GetRowStride() const { return m_row_stride; }
+    size_t GetScratchSize() const { return 2 * m_row_stride; }
+    size_t GetMemoryUsage() const;
+
+    const std::vector<Track>& GetTracks() const { return m_tracks; }
+
+private:
+    void Encode(const std::vector<float>& p_source_times,
+                const std::vector<std::vector<Vector4f>>& p_values,
+                const std::vector<int>& p_animated_tracks,
+                const AnimationCompressionSettings& p_reduction,
+                int p_segment_key_count);
+    bool IsWithinError(const std::vector<float>& p_source_times,
+                       const std::vector<std::vector<Vector4f>>& p_values,
+                       const AnimationCompressionSettings& p_settings) const;
+
+    void DecompressRow(int p_key, float* p_out) const;
+    Vector4f DecodeTrack(const Track& p_track, int p_key, const float* p_row) const;
+
+    CAVE_PROP()
+    std::vector<float> m_times;
+
+    CAVE_PROP()
+    std::vector<Track> m_tracks;
+
+    CAVE_PROP()
+    int m_row_stride = 0;
+
+    CAVE_PROP()
+    int m_rotation_stride = 0;
+
+    CAVE_PROP()
+    int m_segment_key_count = 0;
+
+    CAVE_PROP()
+    std::vector<uint16_t> m_key_data;
+
+    CAVE_PROP()
+    std::vector<uint8_t> m_rotation_index;
+
+    // per segment, m_row_stride floats of range min followed by m_row_stride floats of scale
+    CAVE_PROP()
+    std::vector<float> m_segment_ranges;
+};
+
+}  // namespace cave
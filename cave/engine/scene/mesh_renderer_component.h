@@ -29,6 +29,8 @@ private:
 
     // Non-serialized
     Handle<MeshAsset> m_mesh_handle{};
+    // leaf in Scene::m_meshTree, only trusted if the leaf points back at this entity
+    int m_proxy_id = -1;
 
 public:
     MeshRendererComponent();
@@ -55,6 +57,9 @@ public:
     void SetTransparency(bool p_value = true) { m_transparency = p_value; }
     bool Transparency() const { return m_transparency; }
 
+    int GetProxyId() const { return m_proxy_id; }
+    void SetProxyId(int p_proxy_id) { m_proxy_id = p_proxy_id; }
+
     void OnDeserialized();
 };
 
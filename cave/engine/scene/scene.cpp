@@ -31,6 +31,7 @@ void Scene::Update(float p_timestep) {
     CAVE_PROFILE_EVENT();
 
     m_dirtyFlags.store(0);
+    ++m_frameIndex;
 
     jobsystem::Context ctx;
     // animation
@@ -97,6 +98,7 @@ void Scene::Copy(const Scene& p_other) {
     m_root = p_other.m_root;
     m_bound = p_other.m_bound;
     m_physicsMode = p_other.m_physicsMode;
+    m_animationLod = p_other.m_animationLod;
 }
 
 std::vector<Entity> Scene::GetSortedEntityArray() const {
@@ -211,6 +213,12 @@ void Scene::RemoveEntity(ecs::Entity p_entity) {
         RemoveEntity(child);
     }
 
+    if (const MeshRendererComponent* renderer = GetComponent<MeshRendererComponent>(p_entity); renderer) {
+        if (const int proxy = FindMeshProxy(p_entity, *renderer); proxy != DynamicAabbTree::NULL_NODE) {
+            m_meshTree.DestroyProxy(proxy);
+        }
+    }
+
     for (auto&& [_, component_manager] : m_component_lib.m_entries) {
         component_manager.manager->Remove(p_entity);
     }
@@ -254,15 +262,46 @@ bool Scene::RayObjectIntersect(ecs::Entity p_id, Ray& p_ray) {
 Scene::RayIntersectionResult Scene::Intersects(Ray& p_ray) {
     RayIntersectionResult result;
 
-    for (auto [entity, _] : View<MeshRendererComponent>()) {
-        if (RayObjectIntersect(entity, p_ray)) {
+    // nearest boxes first, boxes behind the closest hit are skipped
+    m_meshTree.RayCast(p_ray.GetStart(), p_ray.GetEnd(), [&](int p_proxy, float p_max_fraction) {
+        const Entity entity(m_meshTree.GetUserData(p_proxy));
+        if (Contains<MeshRendererComponent>(entity) && RayObjectIntersect(entity, p_ray)) {
             result.entity = entity;
+            return p_ray.GetDist();
         }
-    }
+        return p_max_fraction;
+    });
 
     return result;
 }
 
+void Scene::QueryMeshes(const Frustum& p_frustum, std::vector<ecs::Entity>& p_out) const {
+    m_meshTree.QueryFrustum(p_frustum, [&](int p_proxy) {
+        p_out.emplace_back(m_meshTree.GetUserData(p_proxy));
+    });
+}
+
+void Scene::QueryMeshes(const AABB& p_aabb, std::vector<ecs::Entity>& p_out) const {
+    m_meshTree.QueryAabb(p_aabb, [&](int p_proxy) {
+        p_out.emplace_back(m_meshTree.GetUserData(p_proxy));
+    });
+}
+
+void Scene::QueryMeshes(const Vector3f& p_center, float p_radius, std::vector<ecs::Entity>& p_out) const {
+    m_meshTree.QuerySphere(p_center, p_radius, [&](int p_proxy) {
+        p_out.emplace_back(m_meshTree.GetUserData(p_proxy));
+    });
+}
+
+int Scene::FindMeshProxy(ecs::Entity p_id, const MeshRendererComponent& p_renderer) const {
+    // components copied from another scene carry proxies of its tree
+    const int proxy = p_renderer.GetProxyId();
+    if (m_meshTree.IsProxy(proxy) && m_meshTree.GetUserData(proxy) == p_id.GetId()) {
+        return proxy;
+    }
+    return DynamicAabbTree::NULL_NODE;
+}
+
 std::vector<Guid> Scene::GetDependencies() const {
     std::vector<Guid> dependencies;
     for (const auto& [id, material] : View<MaterialComponent>()) {
@@ -1,8 +1,10 @@
 #pragma once
 #include "engine/assets/asset_interface.h"
+#include "engine/assets/mesh_asset.h"
 #include "engine/core/base/noncopyable.h"
 #include "engine/ecs/component_manager.h"
 #include "engine/ecs/view.h"
+#include "engine/math/dynamic_aabb_tree.h"
 #include "engine/math/ray.h"
 
 // components
@@ -183,6 +185,15 @@ public:
     RayIntersectionResult Intersects(Ray& p_ray);
     bool RayObjectIntersect(ecs::Entity p_object_id, Ray& p_ray);
 
+    // Mesh renderers whose bounds, as of the last Update(), touch the volume. The tree keeps fat
+    // boxes, so meshes just outside of it may be returned too.
+    void QueryMeshes(const Frustum& p_frustum, std::vector<ecs::Entity>& p_out) const;
+    void QueryMeshes(const AABB& p_aabb, std::vector<ecs::Entity>& p_out) const;
+    void QueryMeshes(const Vector3f& p_center, float p_radius, std::vector<ecs::Entity>& p_out) const;
+
+    // the leaf of p_renderer in m_meshTree, NULL_NODE if it has none yet
+    int FindMeshProxy(ecs::Entity p_id, const MeshRendererComponent& p_renderer) const;
+
     const AABB& GetBound() const { return m_bound; }
 
     ecs::Entity m_root;
@@ -194,6 +205,16 @@ public:
     AABB m_bound;
 
     PhysicsMode m_physicsMode{ PhysicsMode::NONE };
+
+    // incremented by every Update
+    uint32_t m_frameIndex{ 0 };
+    // skeletons drawn in the last rendered frame, applied by the animation update
+    SkeletonVisibilityReport m_skeletonVisibility;
+    AnimationLodSettings m_animationLod;
+    AnimationLodStats m_animationLodStats;
+    // world bounds of the mesh renderers, refreshed by RunMeshAABBUpdateSystem
+    DynamicAabbTree m_meshTree;
+
     mutable PhysicsWorldContext* m_physicsWorld{ nullptr };
 
     const auto& GetLibraryEntries() const { return m_component_lib.m_entries; }
@@ -3,6 +3,71 @@
 #include "engine/serialization/yaml_include.h"
 
 namespace cave {
+
+int KeyframeCursor::Seek(const std::vector<float>& p_times, float p_time) {
+    const int count = static_cast<int>(p_times.size());
+    if (count == 0) {
+        key = -1;
+        return key;
+    }
+
+    if (key >= 0 && key < count && p_times[key] <= p_time) {
+        for (int step = 0; step < MAX_LINEAR_STEPS; ++step) {
+            if (key + 1 >= count || p_times[key + 1] > p_time) {
+                return key;
+            }
+            ++key;
+        }
+    }
+
+    auto it = std::upper_bound(p_times.begin(), p_times.end(), p_time);
+    key = static_cast<int>(it - p_times.begin()) - 1;
+    return key;
+}
+
+void SkeletalAnimationComponent::BuildTimelines() {
+    m_timelines.clear();
+    m_sampler_timelines.resize(m_samplers.size());
+
+    // glTF exporters usually write one input accessor per clip, bucket by key count first so
+    // the full comparison only runs on likely matches
+    std::unordered_map<size_t, std::vector<int>> buckets;
+    for (int sampler_index = 0; sampler_index < (int)m_samplers.size(); ++sampler_index) {
+        const auto& times = m_samplers[sampler_index].keyframe_times;
+        auto& bucket = buckets[times.size()];
+
+        int timeline_index = -1;
+        for (int candidate : bucket) {
+            if (m_samplers[m_timelines[candidate].sampler_index].keyframe_times == times) {
+                timeline_index = candidate;
+                break;
+            }
+        }
+
+        if (timeline_index == -1) {
+            timeline_index = static_cast<int>(m_timelines.size());
+            Timeline& timeline = m_timelines.emplace_back();
+            timeline.sampler_index = sampler_index;
+            bucket.push_back(timeline_index);
+        }
+
+        m_sampler_timelines[sampler_index] = timeline_index;
+    }
+}
+
+bool SkeletalAnimationComponent::Compress(const AnimationCompressionSettings& p_settings) {
+    if (!m_compressed_clip.Compress(m_samplers, m_channels, p_settings)) {
+        return false;
+    }
+
+    m_samplers.clear();
+    m_samplers.shrink_to_fit();
+    m_sampler_timelines.clear();
+    m_timelines.clear();
+    m_compressed_cursor = KeyframeCursor();
+    return true;
+}
+
 //
 // ISerializer& WriteObject(ISerializer& s, const SkeletalAnimationComponent::SkeletalAnimationChannel& p_channel) {
 //    unused(p_channel);
@@ -2,6 +2,9 @@
 #include "engine/ecs/entity.h"
 #include "engine/math/geomath.h"
 #include "engine/reflection/reflection.h"
+#include "engine/scene/animation_lod.h"
+#include "engine/scene/compressed_animation_clip.h"
+#include "engine/scene/skeletal_pose.h"
 
 namespace cave {
 
@@ -16,16 +19,22 @@ struct SkeletonComponent {
 
     // Non-Serialized
     std::vector<Matrix4x4f> bone_transforms;
-};
 
-enum class AnimationChannelPath {
-    Translation,
-    Rotation,
-    Scale,
-    Count,
-};
+    // local bone transforms before any clip is applied, captured on the first evaluation.
+    // Channels with a total weight below 1 blend against it rather than the previous frame.
+    SkeletalPose rest_pose;
 
-DECLARE_ENUM_TRAITS(AnimationChannelPath, "translation", "rotation", "scale");
+    // scratch for blending the clips that drive this skeleton, sized once per bone count
+    SkeletalPose blended_pose;
+    SkeletalPose clip_pose;
+    std::vector<uint32_t> active_clips;
+
+    // skeletons evaluated at a reduced rate interpolate bone_transforms between the last two
+    // evaluated palettes
+    AnimationLodState lod;
+    std::vector<Matrix4x4f> previous_bone_transforms;
+    std::vector<Matrix4x4f> target_bone_transforms;
+};
 
 struct SkeletalAnimationChannel {
     CAVE_META(SkeletalAnimationChannel)
@@ -40,6 +49,18 @@ struct SkeletalAnimationChannel {
     int sampler_index = -1;
 };
 
+// Remembers the key found by the previous lookup. Playback moves forward by a few keys per frame,
+// so stepping from the cached key is O(1); seeking backwards (loop, SetTimer) or far ahead falls
+// back to a binary search.
+struct KeyframeCursor {
+    static constexpr int MAX_LINEAR_STEPS = 4;
+
+    // index of the last key with time <= the sampled time, -1 if the time is before the first key
+    int key = -1;
+
+    int Seek(const std::vector<float>& p_times, float p_time);
+};
+
 struct SkeletalAnimationSampler {
     CAVE_META(SkeletalAnimationSampler)
 
@@ -72,15 +93,54 @@ private:
     CAVE_PROP()
     float m_timer = 0;
 
-    CAVE_PROP()
+    CAVE_PROP(editor = DragFloat, min = 0, max = 1)
     float m_blend_amount = 1;
 
+    // additive clips store deltas, they are applied after the regular clips are blended
+    CAVE_PROP(editor = Toggle)
+    bool m_additive = false;
+
     CAVE_PROP()
     std::vector<SkeletalAnimationChannel> m_channels;
 
+    // released once the clip is compressed
     CAVE_PROP()
     std::vector<SkeletalAnimationSampler> m_samplers;
 
+    // imported clips are sampled from m_compressed_clip instead of the samplers when valid
+    CAVE_PROP()
+    CompressedAnimationClip m_compressed_clip;
+
+    // Non-Serialized
+    // Samplers with identical keyframe_times share one timeline, so the bracketing keys are
+    // looked up once per clip update instead of once per channel.
+    struct Timeline {
+        int sampler_index = -1;
+        KeyframeCursor cursor;
+        int key_left = -1;
+        int key_right = -1;
+        float t = 0.0f;
+    };
+
+    std::vector<int> m_sampler_timelines;
+    std::vector<Timeline> m_timelines;
+
+    KeyframeCursor m_compressed_cursor;
+    std::vector<float> m_decompress_scratch;
+    std::vector<Vector4f> m_sampled_tracks;
+
+    // Sampled channel values, blended into the pose of m_skeleton. Channels that don't target a
+    // bone of m_skeleton (or every channel, if no skeleton) are written to transforms directly.
+    ecs::Entity m_skeleton;
+    bool m_skeleton_resolved = false;
+    // some channels target transforms outside m_skeleton
+    bool m_has_direct_channels = false;
+    std::vector<int> m_channel_bones;
+    std::vector<Vector4f> m_channel_values;
+    std::vector<uint8_t> m_channel_sampled;
+
+    void BuildTimelines();
+
     friend class SkeletalAnimationSystem;
 
 public:
@@ -106,6 +166,22 @@ public:
 
     float GetTimer() const { return m_timer; }
     void SetTimer(float p_timer) { m_timer = p_timer; }
+
+    float GetBlendAmount() const { return m_blend_amount; }
+    void SetBlendAmount(float p_amount) { m_blend_amount = p_amount; }
+
+    bool IsAdditive() const { return m_additive; }
+    void SetAdditive(bool p_value = true) { m_additive = p_value; }
+
+    // call after changing channels or skeletons at runtime
+    void InvalidateSkeleton() { m_skeleton_resolved = false; }
+
+    // Builds the compressed representation from the samplers and releases them. Fails if the
+    // samplers don't share one time array or can't be encoded within the thresholds, in which
+    // case the raw samplers keep being used.
+    bool Compress(const AnimationCompressionSettings& p_settings = {});
+
+    const CompressedAnimationClip& GetCompressedClip() const { return m_compressed_clip; }
 };
 
 }  // namespace cave
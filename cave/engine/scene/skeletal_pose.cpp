@@ -0,0 +1,114 @@
+#include "skeletal_pose.h"
+
+namespace cave {
+
+static Vector4f QuaternionMultiply(const Vector4f& p_lhs, const Vector4f& p_rhs) {
+    return Vector4f(p_lhs.w * p_rhs.x + p_lhs.x * p_rhs.w + p_lhs.y * p_rhs.z - p_lhs.z * p_rhs.y,
+                    p_lhs.w * p_rhs.y - p_lhs.x * p_rhs.z + p_lhs.y * p_rhs.w + p_lhs.z * p_rhs.x,
+                    p_lhs.w * p_rhs.z + p_lhs.x * p_rhs.y - p_lhs.y * p_rhs.x + p_lhs.z * p_rhs.w,
+                    p_lhs.w * p_rhs.w - p_lhs.x * p_rhs.x - p_lhs.y * p_rhs.y - p_lhs.z * p_rhs.z);
+}
+
+void SkeletalPose::Resize(size_t p_bone_count) {
+    if (translations.size() == p_bone_count) {
+        return;
+    }
+
+    translations.resize(p_bone_count, Vector4f(0.0f));
+    rotations.resize(p_bone_count, Vector4f(0.0f, 0.0f, 0.0f, 1.0f));
+    scales.resize(p_bone_count, Vector4f(1.0f));
+    weights.resize(p_bone_count, Vector4f(0.0f));
+}
+
+void SkeletalPose::Clear() {
+    const Vector4f zero(0.0f);
+    std::fill(translations.begin(), translations.end(), zero);
+    std::fill(rotations.begin(), rotations.end(), zero);
+    std::fill(scales.begin(), scales.end(), zero);
+    std::fill(weights.begin(), weights.end(), zero);
+}
+
+void BlendPose(SkeletalPose& p_accumulated, const SkeletalPose& p_pose, float p_weight) {
+    const size_t count = p_pose.GetBoneCount();
+    DEV_ASSERT(p_accumulated.GetBoneCount() == count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Vector4f weight = p_pose.weights[i] * p_weight;
+        if (weight.x > 0.0f) {
+            p_accumulated.translations[i] += weight.x * p_pose.translations[i];
+        }
+        if (weight.y > 0.0f) {
+            const Vector4f& rotation = p_pose.rotations[i];
+            const float sign = dot(p_accumulated.rotations[i], rotation) < 0.0f ? -1.0f : 1.0f;
+            p_accumulated.rotations[i] += (sign * weight.y) * rotation;
+        }
+        if (weight.z > 0.0f) {
+            p_accumulated.scales[i] += weight.z * p_pose.scales[i];
+        }
+        p_accumulated.weights[i] += weight;
+    }
+}
+
+void NormalizePose(SkeletalPose& p_accumulated, const SkeletalPose& p_base) {
+    const size_t count = p_accumulated.GetBoneCount();
+    DEV_ASSERT(p_base.GetBoneCount() == count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Vector4f& weight = p_accumulated.weights[i];
+
+        if (weight.x > 0.0f) {
+            const Vector4f translation = p_accumulated.translations[i] * (1.0f / weight.x);
+            p_accumulated.translations[i] = lerp(p_base.translations[i], translation, Saturate(weight.x));
+        } else {
+            p_accumulated.translations[i] = p_base.translations[i];
+        }
+
+        if (weight.y > 0.0f) {
+            Vector4f rotation = normalize(p_accumulated.rotations[i]);
+            const Vector4f& base = p_base.rotations[i];
+            if (weight.y < 1.0f) {
+                if (dot(base, rotation) < 0.0f) {
+                    rotation = -rotation;
+                }
+                rotation = normalize(lerp(base, rotation, weight.y));
+            }
+            p_accumulated.rotations[i] = rotation;
+        } else {
+            p_accumulated.rotations[i] = p_base.rotations[i];
+        }
+
+        if (weight.z > 0.0f) {
+            const Vector4f scale = p_accumulated.scales[i] * (1.0f / weight.z);
+            p_accumulated.scales[i] = lerp(p_base.scales[i], scale, Saturate(weight.z));
+        } else {
+            p_accumulated.scales[i] = p_base.scales[i];
+        }
+    }
+}
+
+void AddPose(SkeletalPose& p_pose, const SkeletalPose& p_additive, float p_weight) {
+    const size_t count = p_pose.GetBoneCount();
+    DEV_ASSERT(p_additive.GetBoneCount() == count);
+
+    const Vector4f identity_rotation(0.0f, 0.0f, 0.0f, 1.0f);
+    const Vector4f identity_scale(1.0f);
+    for (size_t i = 0; i < count; ++i) {
+        const Vector4f weight = p_additive.weights[i] * p_weight;
+        if (weight.x > 0.0f) {
+            p_pose.translations[i] += weight.x * p_additive.translations[i];
+        }
+        if (weight.y > 0.0f) {
+            Vector4f delta = p_additive.rotations[i];
+            if (delta.w < 0.0f) {
+                delta = -delta;
+            }
+            delta = normalize(lerp(identity_rotation, delta, Saturate(weight.y)));
+            p_pose.rotations[i] = normalize(QuaternionMultiply(p_pose.rotations[i], delta));
+        }
+        if (weight.z > 0.0f) {
+            p_pose.scales[i] *= lerp(identity_scale, p_additive.scales[i], Saturate(weight.z));
+        }
+    }
+}
+
+}  // namespace cave
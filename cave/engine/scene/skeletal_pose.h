@@ -0,0 +1,36 @@
+#pragma once
+#include "engine/math/geomath.h"
+
+namespace cave {
+
+// Local space pose of a skeleton, stored as one array per channel so blending runs over
+// contiguous Vector4f (SSE registers). Rotations are quaternions (x, y, z, w), translations
+// and scales only use xyz.
+struct SkeletalPose {
+    std::vector<Vector4f> translations;
+    std::vector<Vector4f> rotations;
+    std::vector<Vector4f> scales;
+    // x: translation, y: rotation, z: scale
+    std::vector<Vector4f> weights;
+
+    size_t GetBoneCount() const { return translations.size(); }
+
+    // only reallocates when the bone count changes
+    void Resize(size_t p_bone_count);
+
+    // zeros every channel, used before accumulating or sampling into the pose
+    void Clear();
+};
+
+// p_accumulated += p_weight * p_pose, rotations are flipped into the same hemisphere first
+void BlendPose(SkeletalPose& p_accumulated, const SkeletalPose& p_pose, float p_weight);
+
+// Divides the accumulated channels by their weights. Channels with a total weight below 1
+// are mixed with p_base, channels nothing wrote to take the base value.
+void NormalizePose(SkeletalPose& p_accumulated, const SkeletalPose& p_base);
+
+// Applies a delta pose on top of p_pose: translations add, rotations multiply and scales
+// multiply, each faded in by p_weight.
+void AddPose(SkeletalPose& p_pose, const SkeletalPose& p_additive, float p_weight);
+
+}  // namespace cave
@@ -30,7 +30,22 @@ namespace cave {
 
 class SkeletalAnimationSystem {
 public:
+    // picks the skeletons evaluated this frame from the visibility the renderer reported last frame
+    static void Schedule(Scene& p_scene);
+
+    // samples a clip, clips that don't drive a skeleton write to transforms directly
     static void Update(Scene& p_scene, size_t p_index, float p_timestep);
+
+    static void GatherClips(Scene& p_scene);
+
+    // blends every clip gathered for a skeleton and writes the result back to the bones
+    static void EvaluatePose(Scene& p_scene, size_t p_index);
+
+private:
+    static void ResolveSkeleton(Scene& p_scene, SkeletalAnimationComponent& p_animation);
+    static void SampleSamplers(SkeletalAnimationComponent& p_animation);
+    static void SampleCompressed(SkeletalAnimationComponent& p_animation);
+    static void WriteChannels(Scene& p_scene, const SkeletalAnimationComponent& p_animation);
 };
 
 void SkeletalAnimationSystem::Update(Scene& p_scene, size_t p_index, float p_timestep) {
@@ -40,99 +55,326 @@ void SkeletalAnimationSystem::Update(Scene& p_scene, size_t p_index, float p_tim
         return;
     }
 
-    for (const SkeletalAnimationChannel& channel : animation.m_channels) {
-        if (channel.path == AnimationChannelPath::Count) {
-            continue;
+    if (!animation.m_skeleton_resolved) {
+        ResolveSkeleton(p_scene, animation);
+    }
+
+    const size_t channel_count = animation.m_channels.size();
+    if (animation.m_channel_values.size() != channel_count) {
+        animation.m_channel_values.resize(channel_count);
+        animation.m_channel_sampled.resize(channel_count);
+    }
+
+    // the LOD scheduler only skips the bones, channels that drive other transforms are still
+    // sampled every frame
+    bool evaluate = true;
+    if (animation.m_skeleton.IsValid() && !animation.m_has_direct_channels) {
+        const SkeletonComponent* skeleton = p_scene.GetComponent<SkeletonComponent>(animation.m_skeleton);
+        evaluate = !skeleton || skeleton->lod.evaluate;
+    }
+
+    if (evaluate) {
+        if (animation.m_compressed_clip.IsValid()) {
+            SampleCompressed(animation);
+        } else {
+            SampleSamplers(animation);
         }
-        DEV_ASSERT(channel.sampler_index < (int)animation.m_samplers.size());
-        const SkeletalAnimationSampler& sampler = animation.m_samplers[channel.sampler_index];
 
-        int key_left = 0;
-        int key_right = 0;
-        float time_first = std::numeric_limits<float>::min();
-        float time_last = std::numeric_limits<float>::min();
-        float time_left = std::numeric_limits<float>::min();
-        float time_right = std::numeric_limits<float>::max();
+        WriteChannels(p_scene, animation);
+    }
 
-        for (int k = 0; k < (int)sampler.keyframe_times.size(); ++k) {
-            const float time = sampler.keyframe_times[k];
-            if (time < time_first) {
-                time_first = time;
-            }
-            if (time > time_last) {
-                time_last = time;
-            }
-            if (time <= animation.m_timer && time > time_left) {
-                time_left = time;
-                key_left = k;
-            }
-            if (time >= animation.m_timer && time < time_right) {
-                time_right = time;
-                key_right = k;
+    if (animation.IsLooped() && animation.m_timer > animation.m_end) {
+        animation.m_timer = animation.m_start;
+    }
+
+    if (animation.IsPlaying()) {
+        animation.m_timer += p_timestep * animation.m_speed;
+    }
+}
+
+void SkeletalAnimationSystem::Schedule(Scene& p_scene) {
+    const uint32_t frame = p_scene.m_frameIndex;
+    const SkeletonVisibilityReport& visibility = p_scene.m_skeletonVisibility;
+    const bool has_visibility = visibility.written && visibility.frame + 1 >= frame;
+    const AnimationLodSettings& settings = p_scene.m_animationLod;
+
+    if (has_visibility) {
+        for (const auto& [id, screen_size] : visibility.skeletons) {
+            if (SkeletonComponent* skeleton = p_scene.GetComponent<SkeletonComponent>(id); skeleton) {
+                skeleton->lod.MarkVisible(visibility.frame, screen_size);
             }
         }
+    }
 
-        if (animation.m_timer < time_first) {
-            continue;
+    AnimationLodStats& stats = p_scene.m_animationLodStats;
+    stats = {};
+    for (auto [id, skeleton] : p_scene.View<SkeletonComponent>()) {
+        AnimationLodState& lod = skeleton.lod;
+        lod.phase = id.GetId();
+        lod.Schedule(settings, frame, has_visibility);
+
+        ++stats.skeleton_count;
+        stats.offscreen_count += has_visibility && !lod.IsVisible(frame);
+    }
+}
+
+void SkeletalAnimationSystem::ResolveSkeleton(Scene& p_scene, SkeletalAnimationComponent& p_animation) {
+    p_animation.m_skeleton_resolved = true;
+    p_animation.m_skeleton = ecs::Entity::Null();
+    p_animation.m_has_direct_channels = false;
+    p_animation.m_channel_bones.assign(p_animation.m_channels.size(), -1);
+
+    for (auto [id, skeleton] : p_scene.View<SkeletonComponent>()) {
+        const auto& bones = skeleton.bone_collection;
+        bool found = false;
+        for (size_t channel_index = 0; channel_index < p_animation.m_channels.size(); ++channel_index) {
+            auto it = std::find(bones.begin(), bones.end(), p_animation.m_channels[channel_index].target_id);
+            if (it != bones.end()) {
+                p_animation.m_channel_bones[channel_index] = static_cast<int>(it - bones.begin());
+                found = true;
+            }
         }
 
-        const float left = sampler.keyframe_times[key_left];
-        const float right = sampler.keyframe_times[key_right];
+        if (found) {
+            p_animation.m_skeleton = id;
+            p_animation.m_has_direct_channels = std::ranges::any_of(p_animation.m_channel_bones, [](int p_bone) { return p_bone < 0; });
+            return;
+        }
+    }
+}
 
-        float t = 0;
-        if (key_left != key_right) {
-            t = (animation.m_timer - left) / (right - left);
+void SkeletalAnimationSystem::WriteChannels(Scene& p_scene, const SkeletalAnimationComponent& p_animation) {
+    const bool has_skeleton = p_animation.m_skeleton.IsValid();
+    for (size_t channel_index = 0; channel_index < p_animation.m_channels.size(); ++channel_index) {
+        if (!p_animation.m_channel_sampled[channel_index]) {
+            continue;
         }
-        t = Saturate(t);
+        if (has_skeleton && p_animation.m_channel_bones[channel_index] >= 0) {
+            continue;
+        }
+
+        const SkeletalAnimationChannel& channel = p_animation.m_channels[channel_index];
+        const Vector4f& value = p_animation.m_channel_values[channel_index];
 
         TransformComponent* targetTransform = p_scene.GetComponent<TransformComponent>(channel.target_id);
         DEV_ASSERT(targetTransform);
-        auto dummy_mix = [](const Vector3f& a, const Vector3f& b, float t) {
-            glm::vec3 tmp = glm::mix(glm::vec3(a.x, a.y, a.z), glm::vec3(b.x, b.y, b.z), t);
-            return Vector3f(tmp.x, tmp.y, tmp.z);
-        };
-        auto dummy_mix_4 = [](const Vector4f& a, const Vector4f& b, float t) {
-            glm::vec4 tmp = glm::mix(glm::vec4(a.x, a.y, a.z, a.w), glm::vec4(b.x, b.y, b.z, b.w), t);
-            return Vector4f(tmp.x, tmp.y, tmp.z, tmp.w);
-        };
         switch (channel.path) {
-            case AnimationChannelPath::Scale: {
-                DEV_ASSERT(sampler.keyframe_data.size() == sampler.keyframe_times.size() * 3);
-                const Vector3f* data = (const Vector3f*)sampler.keyframe_data.data();
-                const Vector3f& vLeft = data[key_left];
-                const Vector3f& vRight = data[key_right];
-                targetTransform->SetScale(dummy_mix(vLeft, vRight, t));
+            case AnimationChannelPath::Scale:
+                targetTransform->SetScale(value.xyz);
                 break;
-            }
+            case AnimationChannelPath::Translation:
+                targetTransform->SetTranslation(value.xyz);
+                break;
+            case AnimationChannelPath::Rotation:
+                targetTransform->SetRotation(value);
+                break;
+            default:
+                CRASH_NOW();
+                break;
+        }
+        targetTransform->SetDirty();
+    }
+}
+
+void SkeletalAnimationSystem::SampleCompressed(SkeletalAnimationComponent& p_animation) {
+    const CompressedAnimationClip& clip = p_animation.m_compressed_clip;
+    // a deserialized clip has no scratch yet
+    if (p_animation.m_sampled_tracks.size() != static_cast<size_t>(clip.GetTrackCount())) {
+        p_animation.m_decompress_scratch.resize(clip.GetScratchSize());
+        p_animation.m_sampled_tracks.resize(clip.GetTrackCount());
+    }
+
+    clip.Sample(p_animation.m_timer,
+                p_animation.m_compressed_cursor,
+                p_animation.m_decompress_scratch.data(),
+                p_animation.m_sampled_tracks.data());
+
+    for (size_t channel_index = 0; channel_index < p_animation.m_channels.size(); ++channel_index) {
+        const SkeletalAnimationChannel& channel = p_animation.m_channels[channel_index];
+        const bool sampled = channel.path != AnimationChannelPath::Count;
+        p_animation.m_channel_sampled[channel_index] = sampled;
+        if (sampled) {
+            DEV_ASSERT(channel.sampler_index < clip.GetTrackCount());
+            p_animation.m_channel_values[channel_index] = p_animation.m_sampled_tracks[channel.sampler_index];
+        }
+    }
+}
+
+void SkeletalAnimationSystem::SampleSamplers(SkeletalAnimationComponent& p_animation) {
+    if (p_animation.m_sampler_timelines.size() != p_animation.m_samplers.size()) {
+        p_animation.BuildTimelines();
+    }
+
+    const float timer = p_animation.m_timer;
+    for (SkeletalAnimationComponent::Timeline& timeline : p_animation.m_timelines) {
+        const std::vector<float>& times = p_animation.m_samplers[timeline.sampler_index].keyframe_times;
+        const int key = timeline.cursor.Seek(times, timer);
+        timeline.key_left = key;
+        if (key < 0) {
+            continue;
+        }
+
+        timeline.key_right = glm::min(key + 1, (int)times.size() - 1);
+
+        const float left = times[timeline.key_left];
+        const float right = times[timeline.key_right];
+
+        float t = 0;
+        if (timeline.key_left != timeline.key_right) {
+            t = (timer - left) / (right - left);
+        }
+        timeline.t = Saturate(t);
+    }
+
+    for (size_t channel_index = 0; channel_index < p_animation.m_channels.size(); ++channel_index) {
+        const SkeletalAnimationChannel& channel = p_animation.m_channels[channel_index];
+        p_animation.m_channel_sampled[channel_index] = false;
+        if (channel.path == AnimationChannelPath::Count) {
+            continue;
+        }
+        DEV_ASSERT(channel.sampler_index < (int)p_animation.m_samplers.size());
+        const SkeletalAnimationSampler& sampler = p_animation.m_samplers[channel.sampler_index];
+        const SkeletalAnimationComponent::Timeline& timeline = p_animation.m_timelines[p_animation.m_sampler_timelines[channel.sampler_index]];
+
+        // timer is before the first key
+        if (timeline.key_left < 0) {
+            continue;
+        }
+
+        const int key_left = timeline.key_left;
+        const int key_right = timeline.key_right;
+        const float t = timeline.t;
+
+        Vector4f& value = p_animation.m_channel_values[channel_index];
+        switch (channel.path) {
+            case AnimationChannelPath::Scale:
             case AnimationChannelPath::Translation: {
                 DEV_ASSERT(sampler.keyframe_data.size() == sampler.keyframe_times.size() * 3);
                 const Vector3f* data = (const Vector3f*)sampler.keyframe_data.data();
-                const Vector3f& vLeft = data[key_left];
-                const Vector3f& vRight = data[key_right];
-                targetTransform->SetTranslation(dummy_mix(vLeft, vRight, t));
+                value = Vector4f(lerp(data[key_left], data[key_right], t), 0.0f);
                 break;
             }
             case AnimationChannelPath::Rotation: {
                 DEV_ASSERT(sampler.keyframe_data.size() == sampler.keyframe_times.size() * 4);
                 const Vector4f* data = (const Vector4f*)sampler.keyframe_data.data();
-                const Vector4f& vLeft = data[key_left];
-                const Vector4f& vRight = data[key_right];
-                targetTransform->SetRotation(dummy_mix_4(vLeft, vRight, t));
+                value = lerp(data[key_left], data[key_right], t);
                 break;
             }
             default:
                 CRASH_NOW();
                 break;
         }
-        targetTransform->SetDirty();
+        p_animation.m_channel_sampled[channel_index] = true;
     }
+}
 
-    if (animation.IsLooped() && animation.m_timer > animation.m_end) {
-        animation.m_timer = animation.m_start;
+void SkeletalAnimationSystem::GatherClips(Scene& p_scene) {
+    for (auto [id, skeleton] : p_scene.View<SkeletonComponent>()) {
+        skeleton.active_clips.clear();
     }
 
-    if (animation.IsPlaying()) {
-        animation.m_timer += p_timestep * animation.m_speed;
+    const size_t count = p_scene.GetCount<SkeletalAnimationComponent>();
+    for (size_t index = 0; index < count; ++index) {
+        const SkeletalAnimationComponent& animation = p_scene.GetComponentByIndex<SkeletalAnimationComponent>(index);
+        if (!animation.IsPlaying() || !animation.m_skeleton.IsValid()) {
+            continue;
+        }
+
+        if (SkeletonComponent* skeleton = p_scene.GetComponent<SkeletonComponent>(animation.m_skeleton); DEV_VERIFY(skeleton)) {
+            skeleton->active_clips.push_back(static_cast<uint32_t>(index));
+        }
+    }
+
+    // skeletons without a clip aren't throttled, their palette follows the bones every frame
+    AnimationLodStats& stats = p_scene.m_animationLodStats;
+    for (auto [id, skeleton] : p_scene.View<SkeletonComponent>()) {
+        if (!skeleton.active_clips.empty()) {
+            stats.evaluated_count += skeleton.lod.evaluate;
+            stats.interpolated_count += !skeleton.lod.evaluate;
+        }
+    }
+}
+
+void SkeletalAnimationSystem::EvaluatePose(Scene& p_scene, size_t p_index) {
+    SkeletonComponent& skeleton = p_scene.GetComponentByIndex<SkeletonComponent>(p_index);
+    if (skeleton.active_clips.empty() || !skeleton.lod.evaluate) {
+        return;
+    }
+
+    const size_t bone_count = skeleton.bone_collection.size();
+    skeleton.blended_pose.Resize(bone_count);
+    skeleton.clip_pose.Resize(bone_count);
+
+    // bone transforms are only written below, so on the first evaluation they still hold the
+    // rest pose
+    if (skeleton.rest_pose.GetBoneCount() != bone_count) {
+        skeleton.rest_pose.Resize(bone_count);
+        for (size_t bone = 0; bone < bone_count; ++bone) {
+            const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(skeleton.bone_collection[bone]);
+            DEV_ASSERT(transform);
+            skeleton.rest_pose.translations[bone] = Vector4f(transform->GetTranslation(), 0.0f);
+            skeleton.rest_pose.rotations[bone] = transform->GetRotation();
+            skeleton.rest_pose.scales[bone] = Vector4f(transform->GetScale(), 0.0f);
+        }
+    }
+
+    auto sample_clip = [&](const SkeletalAnimationComponent& p_animation) {
+        SkeletalPose& pose = skeleton.clip_pose;
+        pose.Clear();
+        for (size_t channel_index = 0; channel_index < p_animation.m_channels.size(); ++channel_index) {
+            const int bone = p_animation.m_channel_bones[channel_index];
+            if (bone < 0 || !p_animation.m_channel_sampled[channel_index]) {
+                continue;
+            }
+
+            const Vector4f& value = p_animation.m_channel_values[channel_index];
+            switch (p_animation.m_channels[channel_index].path) {
+                case AnimationChannelPath::Translation:
+                    pose.translations[bone] = value;
+                    pose.weights[bone].x = 1.0f;
+                    break;
+                case AnimationChannelPath::Rotation:
+                    pose.rotations[bone] = value;
+                    pose.weights[bone].y = 1.0f;
+                    break;
+                case AnimationChannelPath::Scale:
+                    pose.scales[bone] = value;
+                    pose.weights[bone].z = 1.0f;
+                    break;
+                default:
+                    break;
+            }
+        }
+    };
+
+    skeleton.blended_pose.Clear();
+    for (uint32_t clip_index : skeleton.active_clips) {
+        const SkeletalAnimationComponent& animation = p_scene.GetComponentByIndex<SkeletalAnimationComponent>(clip_index);
+        if (animation.IsAdditive()) {
+            continue;
+        }
+        sample_clip(animation);
+        BlendPose(skeleton.blended_pose, skeleton.clip_pose, animation.GetBlendAmount());
+    }
+    NormalizePose(skeleton.blended_pose, skeleton.rest_pose);
+
+    for (uint32_t clip_index : skeleton.active_clips) {
+        const SkeletalAnimationComponent& animation = p_scene.GetComponentByIndex<SkeletalAnimationComponent>(clip_index);
+        if (!animation.IsAdditive()) {
+            continue;
+        }
+        sample_clip(animation);
+        AddPose(skeleton.blended_pose, skeleton.clip_pose, animation.GetBlendAmount());
+    }
+
+    // write back
+    const SkeletalPose& pose = skeleton.blended_pose;
+    for (size_t bone = 0; bone < bone_count; ++bone) {
+        TransformComponent* transform = p_scene.GetComponent<TransformComponent>(skeleton.bone_collection[bone]);
+        transform->SetTranslation(pose.translations[bone].xyz);
+        transform->SetRotation(pose.rotations[bone]);
+        transform->SetScale(pose.scales[bone].xyz);
+        transform->SetDirty();
     }
 }
 
@@ -186,12 +428,36 @@ static void UpdateSkeleton(Scene& p_scene, size_t p_index, float) {
     // the hierarchy system. 	But this will correct them too.
 
     SkeletonComponent& skeleton = p_scene.GetComponentByIndex<SkeletonComponent>(p_index);
-    const Matrix4x4f R = glm::inverse(transform->GetWorldMatrix());
+    const AnimationLodState& lod = skeleton.lod;
     const size_t numBones = skeleton.bone_collection.size();
-    if (skeleton.bone_transforms.size() != numBones) {
-        skeleton.bone_transforms.resize(numBones);
+
+    // only clips are throttled, bones posed by physics, IK, the editor or a paused clip are
+    // followed every frame
+    const bool throttled = !skeleton.active_clips.empty();
+    if (throttled && !lod.evaluate) {
+        // move towards the palette evaluated last, reaching it the frame before the next evaluation
+        if (skeleton.target_bone_transforms.size() == numBones && skeleton.previous_bone_transforms.size() == numBones) {
+            const float t = glm::min(1.0f, float(lod.frames_since_update + 1) / float(lod.span));
+            InterpolateBonePalette(skeleton.previous_bone_transforms, skeleton.target_bone_transforms, t, skeleton.bone_transforms);
+        }
+        return;
     }
 
+    // evaluated every frame, no need to keep the palettes around
+    const bool interpolate = throttled && lod.span > 1;
+    if (interpolate) {
+        if (skeleton.bone_transforms.size() == numBones) {
+            skeleton.previous_bone_transforms = skeleton.bone_transforms;
+        }
+        skeleton.target_bone_transforms.resize(numBones);
+    }
+
+    std::vector<Matrix4x4f>& palette = interpolate ? skeleton.target_bone_transforms : skeleton.bone_transforms;
+    if (palette.size() != numBones) {
+        palette.resize(numBones);
+    }
+
+    const Matrix4x4f R = glm::inverse(transform->GetWorldMatrix());
     int idx = 0;
     for (ecs::Entity boneID : skeleton.bone_collection) {
         const TransformComponent* boneTransform = p_scene.GetComponent<TransformComponent>(boneID);
@@ -200,10 +466,15 @@ static void UpdateSkeleton(Scene& p_scene, size_t p_index, float) {
         const Matrix4x4f& B = skeleton.inverse_bind_matrices[idx];
         const Matrix4x4f& W = boneTransform->GetWorldMatrix();
         const Matrix4x4f M = R * W * B;
-        skeleton.bone_transforms[idx] = M;
+        palette[idx] = M;
         ++idx;
+    }
 
-        // @TODO: skeleton animation
+    if (interpolate) {
+        if (skeleton.previous_bone_transforms.size() != numBones) {
+            skeleton.previous_bone_transforms = skeleton.target_bone_transforms;
+        }
+        InterpolateBonePalette(skeleton.previous_bone_transforms, skeleton.target_bone_transforms, 1.0f / float(lod.span), skeleton.bone_transforms);
     }
 };
 
@@ -295,7 +566,14 @@ void RunTransformationUpdateSystem(Scene& p_scene, jobsystem::Context& p_context
 
 void RunAnimationUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float p_timestep) {
     CAVE_PROFILE_EVENT();
+    SkeletalAnimationSystem::Schedule(p_scene);
+
     JS_PARALLEL_FOR(SkeletalAnimationComponent, p_context, index, 1, SkeletalAnimationSystem::Update(p_scene, index, p_timestep));
+    p_context.Wait();
+
+    SkeletalAnimationSystem::GatherClips(p_scene);
+
+    JS_PARALLEL_FOR(SkeletonComponent, p_context, index, 1, SkeletalAnimationSystem::EvaluatePose(p_scene, index));
 }
 
 void RunSkeletonUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float p_timestep) {
@@ -308,26 +586,53 @@ void RunHierarchyUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, flo
     JS_PARALLEL_FOR(HierarchyComponent, p_context, index, SMALL_SUBTASK_GROUP_SIZE, UpdateHierarchy(p_scene, index, p_timestep));
 }
 
+// Drops the leaves of renderers that were removed, or lost their mesh or transform.
+static void RemoveStaleMeshProxies(Scene& p_scene) {
+    DynamicAabbTree& tree = p_scene.m_meshTree;
+    for (int proxy = 0; proxy < tree.GetCapacity(); ++proxy) {
+        if (!tree.IsProxy(proxy)) {
+            continue;
+        }
+
+        const ecs::Entity id(tree.GetUserData(proxy));
+        const MeshRendererComponent* renderer = p_scene.GetComponent<MeshRendererComponent>(id);
+        if (!renderer || renderer->GetProxyId() != proxy) {
+            tree.DestroyProxy(proxy);
+        }
+    }
+}
+
 void RunMeshAABBUpdateSystem(Scene& p_scene, jobsystem::Context&, float) {
     CAVE_PROFILE_EVENT();
 
     AABB bound;
+    DynamicAabbTree& tree = p_scene.m_meshTree;
+    int proxy_count = 0;
 
     for (auto [id, mesh_renderer] : p_scene.View<MeshRendererComponent>()) {
-        if (!p_scene.Contains<TransformComponent>(id)) {
-            continue;
-        }
-
-        const TransformComponent& transform = *p_scene.GetComponent<TransformComponent>(id);
+        const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(id);
         const MeshAsset* mesh = mesh_renderer.GetMeshHandle().Get();
-        if (!mesh) {
+        if (!transform || !mesh) {
+            mesh_renderer.SetProxyId(DynamicAabbTree::NULL_NODE);
             continue;
         }
 
-        Matrix4x4f M = transform.GetWorldMatrix();
+        Matrix4x4f M = transform->GetWorldMatrix();
         AABB aabb = mesh->localBound;
         aabb.ApplyMatrix(M);
         bound.UnionBox(aabb);
+
+        // only boxes that left their fat box touch the tree
+        if (const int proxy = p_scene.FindMeshProxy(id, mesh_renderer); proxy != DynamicAabbTree::NULL_NODE) {
+            tree.MoveProxy(proxy, aabb);
+        } else {
+            mesh_renderer.SetProxyId(tree.CreateProxy(aabb, id.GetId()));
+        }
+        ++proxy_count;
+    }
+
+    if (tree.GetProxyCount() != proxy_count) {
+        RemoveStaleMeshProxies(p_scene);
     }
 
     p_scene.m_bound = bound;
@@ -1,16 +1,51 @@
 #include "engine/assets/image_asset.h"
 #include "engine/assets/material_asset.h"
+#include "engine/debugger/profiler.h"
 #include "engine/math/frustum.h"
 #include "engine/math/geometry.h"
 #include "engine/math/matrix_transform.h"
+#include "engine/render_graph/draw_commands.h"
 #include "engine/renderer/frame_data.h"
+#include "engine/renderer/scene_render_state.h"
 #include "engine/runtime/asset_registry.h"
 #include "engine/scene/scene.h"
+#include "engine/systems/job_system/job_system.h"
 
 namespace cave {
 
-using FilterObjectFunc1 = std::function<bool(const MeshRendererComponent& p_object)>;
-using FilterObjectFunc2 = std::function<bool(const AABB& p_object_aabb)>;
+// mesh renderers processed by one job when generating draw commands
+static constexpr uint32_t MESH_COMMAND_GROUP_SIZE = 512;
+// occluders are simple meshes that cover a good part of the screen
+static constexpr uint32_t MAX_OCCLUDER_TRIANGLE_COUNT = 256;
+static constexpr float MIN_OCCLUDER_SCREEN_SIZE = 0.1f;
+
+// volumes a mesh tree leaf was found in, candidates still get the exact test
+enum MeshCullFlag : uint8_t {
+    MESH_CULL_VIEW = 1 << 0,
+    MESH_CULL_SHADOW = 1 << 1,
+    MESH_CULL_VOXEL = 1 << 2,
+    MESH_CULL_ALL = MESH_CULL_VIEW | MESH_CULL_SHADOW | MESH_CULL_VOXEL,
+};
+
+// Culling volumes and shared buffer indices, read only while the jobs run.
+struct MeshPassContext {
+    Frustum camera_frustum;
+    Frustum shadow_frustum;
+    bool has_shadow = false;
+    bool has_voxel = false;
+    int null_material_idx = -1;
+    const MaterialTable* material_table = nullptr;
+    const BonePalette* bone_palette = nullptr;
+    // MeshCullFlag per leaf of Scene::m_meshTree
+    std::span<const uint8_t> cull_flags;
+    // camera view occlusion, nullptr when disabled
+    const OcclusionCuller* occlusion = nullptr;
+    // mesh LOD error allowed per screen size, 0 draws every mesh at full detail
+    float lod_error_scale = 0.0f;
+    float shadow_lod_error_scale = 0.0f;
+    // some material has images that aren't on the gpu yet
+    bool has_pending_images = false;
+};
 
 // @TODO: fix this function OMG
 static void FillMaterialConstantBuffer(bool p_is_opengl,
@@ -71,80 +106,42 @@ static void FillMaterialConstantBuffer(bool p_is_opengl,
     cb.c_hasMaterialMap = set_texture(TextureSlot::MetallicRoughness, cb.c_materialMapHandle);
 };
 
-// @TODO: refactor this
-static void FillPass(const Scene& p_scene,
-                     FilterObjectFunc1 p_filter1,
-                     FilterObjectFunc2 p_filter2,
-                     std::vector<RenderCommand>& p_commands,
-                     FrameData& p_framedata) {
-
-    auto view = p_scene.View<MeshRendererComponent, TransformComponent>();
-    for (auto [entity, renderer, transform] : view) {
-        const MeshAsset* _mesh = renderer.GetMeshHandle().Get();
-        if (!_mesh) continue;
-
-        if (!p_filter1(renderer)) continue;
-
-        const MeshAsset& mesh = *_mesh;
-        const Matrix4x4f& world_matrix = transform.GetWorldMatrix();
-        AABB aabb = mesh.localBound;
-        aabb.ApplyMatrix(world_matrix);
-        if (!p_filter2(aabb)) {
-            continue;
-        }
-
-        ecs::Entity skeleton_id = renderer.GetSkeletonId();
-        PerBatchConstantBuffer batch_buffer;
-        batch_buffer.c_worldMatrix = world_matrix;
-        batch_buffer.c_meshFlag = skeleton_id.IsValid();
-
-        DrawCommand draw;
-        if (entity == p_scene.m_selected) {
-            draw.flags = STENCIL_FLAG_SELECTED;
-        }
-
-        draw.batch_idx = p_framedata.batchCache.FindOrAdd(entity, batch_buffer);
-        if (skeleton_id.IsValid()) {
-            auto& skeleton = *p_scene.GetComponent<SkeletonComponent>(skeleton_id);
-            DEV_ASSERT(skeleton.bone_transforms.size() <= MAX_BONE_COUNT);
-
-            BoneConstantBuffer bone;
-            memcpy(bone.c_bones, skeleton.bone_transforms.data(), sizeof(Matrix4x4f) * skeleton.bone_transforms.size());
-
-            // @TODO: better memory usage
-            draw.bone_idx = p_framedata.boneCache.FindOrAdd(skeleton_id, bone);
-        } else {
-            draw.bone_idx = -1;
-        }
-
-        draw.mesh_data = mesh.gpuResource.get();
-        if (draw.mesh_data) {
-            draw.mat_idx = -1;
-            draw.index_count = static_cast<uint32_t>(mesh.indices.size());
-            p_commands.emplace_back(RenderCommand::From(draw));
-        }
-    }
-}
-
-static void FillLightBuffer(const Scene& p_scene, FrameData& p_framedata) {
-    const uint32_t light_count = glm::min<uint32_t>((uint32_t)p_scene.GetCount<LightComponent>(), MAX_LIGHT_COUNT);
-
+static void FillLightBuffer(const Scene& p_scene, FrameData& p_framedata, MeshPassContext& p_context) {
     auto& cache = p_framedata.perFrameCache;
-    cache.c_lightCount = light_count;
 
     [[maybe_unused]] auto& point_shadow_cache = p_framedata.pointShadowCache;
 
+    const bool clustered = p_framedata.options.clusteredLightingEnabled;
+
     int idx = 0;
     for (auto [light_entity, light_component] : p_scene.View<LightComponent>()) {
         const TransformComponent* light_transform = p_scene.GetComponent<TransformComponent>(light_entity);
         DEV_ASSERT(light_transform);
 
-        // SHOULD BE THIS INDEX
+        const MaterialComponent& material = *p_scene.GetComponent<MaterialComponent>(light_entity);
+
+        // point lights without shadows go through the clusters, the constant buffer keeps the rest
+        if (clustered && light_component.GetType() == LightType::Point && !light_component.CastShadow()) {
+            if (p_framedata.pointLights.size() < MAX_CLUSTERED_LIGHT_COUNT) {
+                GpuPointLight& point_light = p_framedata.pointLights.emplace_back();
+                point_light.position = light_component.GetPosition();
+                point_light.max_distance = light_component.GetMaxDistance();
+                point_light.color = material.base_color.xyz * material.emissive;
+                point_light.atten_constant = light_component.GetAttenConstant();
+                point_light.atten_linear = light_component.GetAttenLinear();
+                point_light.atten_quadratic = light_component.GetAttenQuadratic();
+            }
+            continue;
+        }
+
+        if (idx >= MAX_LIGHT_COUNT) {
+            continue;
+        }
+
         Light& light = cache.c_lights[idx];
         bool cast_shadow = light_component.CastShadow();
         light.cast_shadow = cast_shadow;
         light.type = static_cast<int>(light_component.GetType());
-        const MaterialComponent& material = *p_scene.GetComponent<MaterialComponent>(light_entity);
         // @TODO: [SCRUM-210] fix material
         light.color = material.base_color.xyz;
         light.color *= material.emissive;
@@ -184,18 +181,9 @@ static void FillLightBuffer(const Scene& p_scene, FrameData& p_framedata) {
                 p_framedata.shadowPasses[0].pass_idx = static_cast<int>(p_framedata.passCache.size());
                 p_framedata.passCache.emplace_back(pass_constant);
 
-                // @TODO: fix
-                Frustum light_frustum(light.projection_matrix * light.view_matrix);
-                FillPass(
-                    p_scene,
-                    [](const MeshRendererComponent& p_object) {
-                        return p_object.CastShadow();
-                    },
-                    [&](const AABB& p_aabb) {
-                        return light_frustum.Intersects(p_aabb);
-                    },
-                    p_framedata.shadow_pass_commands,
-                    p_framedata);
+                // shadow casters are gathered with the other passes in FillMeshPasses
+                p_context.shadow_frustum = Frustum(light.projection_matrix * light.view_matrix);
+                p_context.has_shadow = true;
             } break;
             case LIGHT_TYPE_POINT: {
                 // @TODO: there's a bug in shadow map allocation
@@ -255,6 +243,26 @@ static void FillLightBuffer(const Scene& p_scene, FrameData& p_framedata) {
         }
         ++idx;
     }
+
+    cache.c_lightCount = idx;
+}
+
+static void FillLightClusters(SceneRenderState& p_state, FrameData& p_framedata) {
+    const auto& camera = p_framedata.mainCamera;
+    LightClusterBuilder& builder = p_state.light_clusters;
+    builder.Build(camera.viewMatrix,
+                  camera.projectionMatrixFrustum,
+                  camera.zNear,
+                  camera.zFar,
+                  p_framedata.pointLights,
+                  p_framedata.lightClusters,
+                  p_framedata.lightIndices);
+
+    auto& cache = p_framedata.perFrameCache;
+    cache.c_clusterSliceScale = builder.GetSliceScale();
+    cache.c_clusterSliceBias = builder.GetSliceBias();
+    cache.c_clusteredLighting = 1;
+    cache.c_pointLightCount = static_cast<int>(p_framedata.pointLights.size());
 }
 
 static void FillVoxelPass(const Scene& p_scene, FrameData& p_framedata) {
@@ -304,9 +312,73 @@ static void FillVoxelPass(const Scene& p_scene, FrameData& p_framedata) {
     cache.c_voxelSize = voxel_size;
 }
 
-static void FillMainPass(const Scene* p_scene, FrameData& p_framedata) {
+// Projected bounding radius over half the viewport height, feeds the animation LOD of the next
+// Scene::Update.
+static float ComputeScreenSize(const AABB& p_aabb, const FrameData::Camera& p_camera) {
+    const Vector3f extent = 0.5f * p_aabb.Size();
+    const Vector3f offset = p_aabb.Center() - p_camera.position;
+    const float radius = glm::sqrt(extent.x * extent.x + extent.y * extent.y + extent.z * extent.z);
+    const float distance = glm::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+
+    // projectionMatrixFrustum[1][1] is cot(fovy / 2)
+    return distance > radius
+               ? radius * p_camera.projectionMatrixFrustum[1][1] / distance
+               : std::numeric_limits<float>::max();
+}
+
+// Rasterizes the largest simple opaque meshes in the view, up to the triangle budget of the culler.
+static void FillOcclusionBuffer(Scene& p_scene, SceneRenderState& p_state, const FrameData& p_framedata, MeshPassContext& p_context) {
+    CAVE_PROFILE_EVENT();
+
+    using Occluder = MeshRenderScratch::Occluder;
+    std::vector<Occluder>& occluders = p_state.scratch.occluders;
+    std::vector<ecs::Entity>& candidates = p_state.scratch.occluder_candidates;
+
+    const auto& camera = p_framedata.mainCamera;
+    OcclusionCuller& culler = p_state.occlusion_culler;
+    culler.BeginFrame(camera.projectionMatrixFrustum * camera.viewMatrix);
+
+    candidates.clear();
+    p_scene.QueryMeshes(p_context.camera_frustum, candidates);
+
+    occluders.clear();
+    for (ecs::Entity id : candidates) {
+        const MeshRendererComponent* renderer = p_scene.GetComponent<MeshRendererComponent>(id);
+        if (!renderer || !renderer->IsVisible() || renderer->Transparency() || renderer->GetSkeletonId().IsValid()) {
+            continue;
+        }
+        const MeshAsset* mesh = renderer->GetMeshHandle().Get();
+        if (!mesh || mesh->positions.empty() || mesh->indices.size() / 3 > MAX_OCCLUDER_TRIANGLE_COUNT) {
+            continue;
+        }
+        const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(id);
+        if (!transform) {
+            continue;
+        }
+
+        AABB aabb = mesh->localBound;
+        aabb.ApplyMatrix(transform->GetWorldMatrix());
+        const float screen_size = ComputeScreenSize(aabb, camera);
+        if (screen_size >= MIN_OCCLUDER_SCREEN_SIZE) {
+            occluders.push_back({ screen_size, mesh, &transform->GetWorldMatrix() });
+        }
+    }
+
+    std::sort(occluders.begin(), occluders.end(), [](const Occluder& p_lhs, const Occluder& p_rhs) {
+        return p_lhs.screen_size > p_rhs.screen_size;
+    });
+    for (const Occluder& occluder : occluders) {
+        // smaller occluders may still fit
+        culler.AddOccluder(*occluder.world_matrix, occluder.mesh->positions, occluder.mesh->indices);
+    }
+
+    culler.Rasterize();
+    p_context.occlusion = &culler;
+}
+
+static void FillMainPass(FrameData& p_framedata, MeshPassContext& p_context) {
     const auto& camera = p_framedata.mainCamera;
-    Frustum camera_frustum(camera.projectionMatrixFrustum * camera.viewMatrix);
+    p_context.camera_frustum = Frustum(camera.projectionMatrixFrustum * camera.viewMatrix);
 
     // main pass
     PerPassConstantBuffer pass_constant;
@@ -316,128 +388,473 @@ static void FillMainPass(const Scene* p_scene, FrameData& p_framedata) {
     p_framedata.mainPass.pass_idx = static_cast<int>(p_framedata.passCache.size());
     p_framedata.passCache.emplace_back(pass_constant);
 
-    if (!p_scene) {
-        return;
+    // The error of a level is relative to the bounding radius, which covers screen_size times half
+    // the viewport height. Shadow texels are larger than pixels, the bias allows coarser levels.
+    const auto& options = p_framedata.options;
+    if (options.meshLodEnabled && options.meshLodPixelError > 0.0f && camera.sceenHeight > 0.0f) {
+        p_context.lod_error_scale = options.meshLodPixelError / (0.5f * camera.sceenHeight);
+        p_context.shadow_lod_error_scale = p_context.lod_error_scale * glm::max(options.shadowLodBias, 1.0f);
     }
-    const Scene& scene = *p_scene;
+}
 
-    using FilterFunc = std::function<bool(const AABB&)>;
-    FilterFunc filter_main = [&](const AABB& p_aabb) -> bool { return camera_frustum.Intersects(p_aabb); };
+// Materials and bone palettes are shared between objects, so they are written once up front and
+// the jobs only read the lookups. Only the ones of renderers that passed the tree culling are
+// written, the materials of the others retire from the table and their skeletons give their range
+// back to the palette.
+static void FillSharedBuffers(Scene& p_scene, SceneRenderState& p_state, FrameData& p_framedata, MeshPassContext& p_context) {
+    CAVE_PROFILE_EVENT();
 
     const bool is_opengl = p_framedata.options.isOpengl;
-    for (auto [entity, renderer] : scene.View<MeshRendererComponent>()) {
+
+    // materials with the same constants share an entry, only new entries are uploaded
+    MaterialTable& material_table = p_state.material_table;
+    material_table.BeginFrame();
+    p_context.material_table = &material_table;
+
+    // the table compares whole buffers, the padding must not hold garbage
+    MaterialConstantBuffer material_buffer{};
+    FillMaterialConstantBuffer(is_opengl, nullptr, material_buffer);
+    p_context.null_material_idx = material_table.Update(ecs::Entity::Null(), material_buffer);
+    DEV_ASSERT(p_context.null_material_idx >= 0);
+
+    std::vector<ecs::Entity>& skeletons = p_state.scratch.skeletons;
+    skeletons.clear();
+
+    const uint32_t renderer_count = static_cast<uint32_t>(p_scene.GetCount<MeshRendererComponent>());
+    for (uint32_t index = 0; index < renderer_count; ++index) {
+        const MeshRendererComponent& renderer = p_scene.GetComponentByIndex<MeshRendererComponent>(index);
+        const ecs::Entity entity = p_scene.GetEntityByIndex<MeshRendererComponent>(index);
+        const int proxy = p_scene.FindMeshProxy(entity, renderer);
+        if (proxy != DynamicAabbTree::NULL_NODE && !p_context.cull_flags[proxy]) {
+            continue;
+        }
+
+        for (const ecs::Entity material_id : renderer.GetMaterialInstances()) {
+            // written by an earlier renderer
+            if (material_table.Find(material_id) >= 0) {
+                continue;
+            }
+            const MaterialComponent* material = p_scene.GetComponent<MaterialComponent>(material_id);
+            if (!material) {
+                continue;
+            }
+
+            FillMaterialConstantBuffer(is_opengl, material, material_buffer);
+            material_table.Update(material_id, material_buffer);
+
+            // the constants hold texture handles
+            for (const auto& handle : material->m_images) {
+                const ImageAsset* image = handle.Get();
+                if (image && image->gpu_texture) {
+                    p_framedata.retainedResources.push_back(image->gpu_texture);
+                }
+                p_context.has_pending_images |= image && !image->gpu_texture;
+            }
+        }
+
+        if (const ecs::Entity skeleton_id = renderer.GetSkeletonId(); skeleton_id.IsValid()) {
+            skeletons.push_back(skeleton_id);
+        }
+    }
+    material_table.EndFrame(p_framedata.materialUploads, p_framedata.materialUploadValues, p_framedata.materials);
+
+    // palettes stay in the bone buffer across frames, only the ones that changed are uploaded
+    std::sort(skeletons.begin(), skeletons.end());
+    skeletons.erase(std::unique(skeletons.begin(), skeletons.end()), skeletons.end());
+
+    BonePalette& palette = p_state.bone_palette;
+    palette.BeginFrame();
+    for (const ecs::Entity skeleton_id : skeletons) {
+        const SkeletonComponent* skeleton = p_scene.GetComponent<SkeletonComponent>(skeleton_id);
+        if (!skeleton) {
+            continue;
+        }
+        DEV_ASSERT(skeleton->bone_transforms.size() <= MAX_BONE_COUNT);
+
+        // a skeleton that doesn't fit in the palette has no range, its meshes aren't skinned
+        const uint32_t bone_count = glm::min<uint32_t>((uint32_t)skeleton->bone_transforms.size(), MAX_BONE_COUNT);
+        palette.Update(skeleton_id, skeleton->bone_transforms.data(), bone_count);
+    }
+    palette.EndFrame(p_framedata.boneUploads, p_framedata.boneUploadRows);
+    p_framedata.instanceRowOffset = palette.GetTop();
+    p_context.bone_palette = &palette;
+}
+
+// the images of a visible renderer that are still waiting for their texture
+static void AddMaterialUploadHints(const Scene& p_scene,
+                                   const MeshRendererComponent& p_renderer,
+                                   float p_screen_size,
+                                   std::vector<UploadHint>& p_hints) {
+    for (const ecs::Entity material_id : p_renderer.GetMaterialInstances()) {
+        const MaterialComponent* material = p_scene.GetComponent<MaterialComponent>(material_id);
+        if (!material) {
+            continue;
+        }
+        for (const auto& handle : material->m_images) {
+            const ImageAsset* image = handle.Get();
+            if (image && !image->gpu_texture) {
+                p_hints.push_back({ image, p_screen_size });
+            }
+        }
+    }
+}
+
+template<typename FILTER>
+static void AddSubsetDraws(const MeshPassContext& p_context,
+                           const MeshRendererComponent& p_renderer,
+                           const MeshAsset& p_mesh,
+                           int p_lod,
+                           const Matrix4x4f& p_world_matrix,
+                           const DrawCommand& p_draw,
+                           bool p_is_transparent,
+                           float p_view_depth,
+                           const FILTER& p_filter,
+                           std::vector<RenderCommand>& p_commands) {
+    const auto& materials = p_renderer.GetMaterialInstances();
+    const uint32_t pipeline = p_draw.bone_offset >= 0;
+
+    for (size_t idx = 0; idx < p_mesh.subsets.size(); ++idx) {
+        const auto& subset = p_mesh.GetSubset(p_lod, idx);
+        AABB aabb = subset.local_bound;
+        aabb.ApplyMatrix(p_world_matrix);
+        if (!p_filter(aabb)) {
+            continue;
+        }
+
+        // @TODO: [SCRUM-210] fix material
+        const ecs::Entity material_id = idx < materials.size() ? materials[idx] : ecs::Entity::Null();
+
+        DrawCommand draw = p_draw;
+        draw.index_count = subset.index_count;
+        draw.index_offset = subset.index_offset;
+        const int mat_idx = p_context.material_table->Find(material_id);
+        draw.mat_idx = mat_idx >= 0 ? mat_idx : p_context.null_material_idx;
+        draw.sort_key = p_is_transparent
+                            ? DrawSortKey::Transparent(0, pipeline, draw.mat_idx, draw.mesh_data, p_view_depth)
+                            : DrawSortKey::Opaque(0, pipeline, draw.mat_idx, draw.mesh_data, p_view_depth);
+
+        p_commands.push_back(RenderCommand::From(draw));
+    }
+}
+
+static void GenerateMeshCommands(Scene& p_scene,
+                                 const FrameData& p_framedata,
+                                 const MeshPassContext& p_context,
+                                 uint32_t p_begin,
+                                 uint32_t p_end,
+                                 MeshCommandChunk& p_chunk) {
+    const auto& camera = p_framedata.mainCamera;
+    const AABB& voxel_bound = p_framedata.voxel_gi_bound;
+
+    for (uint32_t index = p_begin; index < p_end; ++index) {
+        const MeshRendererComponent& renderer = p_scene.GetComponentByIndex<MeshRendererComponent>(index);
         const MeshAsset* _mesh = renderer.GetMeshHandle().Get();
-        if (_mesh == nullptr) continue;
+        if (!_mesh) continue;
         const MeshAsset& mesh = *_mesh;
 
-        const bool is_renderable = renderer.IsVisible();
-        const bool is_transparent = renderer.Transparency();
-        const bool is_opaque = is_renderable && !is_transparent;
-
-        // @TODO: cast shadow
+        const ecs::Entity entity = p_scene.GetEntityByIndex<MeshRendererComponent>(index);
+        // renderers the tree hasn't seen yet are tested against every volume
+        const int proxy = p_scene.FindMeshProxy(entity, renderer);
+        const uint8_t cull_flags = proxy != DynamicAabbTree::NULL_NODE ? p_context.cull_flags[proxy] : MESH_CULL_ALL;
+        if (!cull_flags) continue;
 
-        const TransformComponent& transform = *scene.GetComponent<TransformComponent>(entity);
-        DEV_ASSERT(scene.Contains<TransformComponent>(entity));
+        const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(entity);
+        if (!DEV_VERIFY(transform)) continue;
 
-        const Matrix4x4f& world_matrix = transform.GetWorldMatrix();
+        const Matrix4x4f& world_matrix = transform->GetWorldMatrix();
         AABB aabb = mesh.localBound;
         aabb.ApplyMatrix(world_matrix);
 
-        ecs::Entity skeleton_id = renderer.GetSkeletonId();
-        PerBatchConstantBuffer batch_buffer;
-        batch_buffer.c_worldMatrix = world_matrix;
-        batch_buffer.c_meshFlag = skeleton_id.IsValid();
+        const bool is_renderable = renderer.IsVisible();
+        const bool is_transparent = renderer.Transparency();
+        const bool is_opaque = is_renderable && !is_transparent;
 
+        const bool in_shadow = (cull_flags & MESH_CULL_SHADOW) && p_context.has_shadow && renderer.CastShadow() && p_context.shadow_frustum.Intersects(aabb);
+        bool in_view = (cull_flags & MESH_CULL_VIEW) && (is_opaque || is_transparent) && p_context.camera_frustum.Intersects(aabb);
+        // shadow casters and voxels aren't seen from the camera, only the view passes are culled
+        if (in_view && p_context.occlusion) {
+            ++p_chunk.occlusion_tested_count;
+            if (p_context.occlusion->IsOccluded(aabb)) {
+                ++p_chunk.occlusion_culled_count;
+                in_view = false;
+            }
+        }
+        const bool in_voxel = (cull_flags & MESH_CULL_VOXEL) && p_context.has_voxel && voxel_bound.Intersects(aabb);
+        if (!in_shadow && !in_view && !in_voxel) {
+            continue;
+        }
+
+        // still uploading, the larger it is on screen the sooner it's created
+        if (!mesh.gpuResource) {
+            p_chunk.upload_hints.push_back({ &mesh, in_view ? ComputeScreenSize(aabb, camera) : 0.0f });
+            continue;
+        }
+        if (in_view && p_context.has_pending_images) {
+            AddMaterialUploadHints(p_scene, renderer, ComputeScreenSize(aabb, camera), p_chunk.upload_hints);
+        }
+
+        const ecs::Entity skeleton_id = renderer.GetSkeletonId();
         DrawCommand draw;
         // @TODO: refactor the stencil part
-        if (entity == scene.m_selected) {
+        if (entity == p_scene.m_selected) {
             draw.flags = STENCIL_FLAG_SELECTED;
         }
 
         if (skeleton_id.IsValid()) {
-            const SkeletonComponent* skeleton = scene.GetComponent<SkeletonComponent>(skeleton_id);
-            if (skeleton) {
-                DEV_ASSERT(skeleton->bone_transforms.size() <= MAX_BONE_COUNT);
+            if (const BonePalette::Range* range = p_context.bone_palette->Find(skeleton_id); range) {
+                draw.bone_offset = static_cast<int>(range->offset);
+                draw.bone_row_count = static_cast<uint16_t>(range->row_count);
+            }
+            if (is_renderable && in_view) {
+                p_chunk.visible_skeletons.emplace_back(skeleton_id, ComputeScreenSize(aabb, camera));
+            }
+        }
 
-                BoneConstantBuffer bone;
-                memcpy(bone.c_bones, skeleton->bone_transforms.data(), sizeof(Matrix4x4f) * skeleton->bone_transforms.size());
+        int view_lod = 0;
+        int shadow_lod = 0;
+        if (p_context.lod_error_scale > 0.0f && !mesh.lods.empty()) {
+            const float screen_size = ComputeScreenSize(aabb, camera);
+            view_lod = mesh.SelectLod(p_context.lod_error_scale / screen_size);
+            shadow_lod = mesh.SelectLod(p_context.shadow_lod_error_scale / screen_size);
+        }
+        if (in_view) {
+            MeshLodStats& stats = p_chunk.lod_stats;
+            ++stats.mesh_count;
+            ++stats.level_counts[view_lod];
+            stats.full_triangle_count += mesh.GetIndexCount(0) / 3;
+            stats.drawn_triangle_count += mesh.GetIndexCount(view_lod) / 3;
+        }
 
-                // @TODO: better memory usage
-                draw.bone_idx = p_framedata.boneCache.FindOrAdd(skeleton_id, bone);
-            }
+        if (p_chunk.meshes.empty() || p_chunk.meshes.back() != &mesh) {
+            p_chunk.meshes.push_back(&mesh);
         }
 
+        PerBatchConstantBuffer& batch_buffer = p_chunk.batches.emplace_back();
+        batch_buffer.c_worldMatrix = world_matrix;
+        batch_buffer.c_meshFlag = draw.bone_offset >= 0;
+        p_chunk.batch_ids.push_back(entity);
+
         draw.mat_idx = -1;
-        draw.batch_idx = p_framedata.batchCache.FindOrAdd(entity, batch_buffer);
-        draw.index_count = static_cast<uint32_t>(mesh.indices.size());
-        draw.mesh_data = (GpuMesh*)mesh.gpuResource.get();
-        if (!draw.mesh_data) {
-            continue;
+        draw.batch_idx = static_cast<int>(p_chunk.batches.size() - 1);
+        draw.index_count = mesh.GetIndexCount(view_lod);
+        draw.index_offset = mesh.GetIndexOffset(view_lod);
+        draw.mesh_data = mesh.gpuResource.get();
+
+        const Vector3f to_center = aabb.Center() - camera.position;
+        const float view_depth = dot(to_center, camera.front);
+        const uint32_t pipeline = draw.bone_offset >= 0;
+
+        // depth only, group by mesh
+        if (in_shadow) {
+            DrawCommand& shadow_draw = p_chunk.commands[MESH_PASS_SHADOW].emplace_back(RenderCommand::From(draw)).draw;
+            shadow_draw.index_count = mesh.GetIndexCount(shadow_lod);
+            shadow_draw.index_offset = mesh.GetIndexOffset(shadow_lod);
+            shadow_draw.sort_key = DrawSortKey::Opaque(0, pipeline, -1, draw.mesh_data, 0.0f);
         }
 
-        auto add_to_pass = [&](std::vector<RenderCommand>& p_commands, FilterFunc& p_filter, bool p_model_only) {
-            if (!p_filter(aabb)) {
-                return;
-            }
+        auto in_frustum = [&](const AABB& p_aabb) { return p_context.camera_frustum.Intersects(p_aabb); };
+        if (in_view && is_opaque) {
+            DrawCommand& depth_draw = p_chunk.commands[MESH_PASS_PREPASS].emplace_back(RenderCommand::From(draw)).draw;
+            depth_draw.sort_key = DrawSortKey::Opaque(0, pipeline, -1, draw.mesh_data, view_depth);
 
-            DrawCommand draw_cmd = draw;
-            if (p_model_only) {
-                p_commands.emplace_back(RenderCommand::From(draw_cmd));
-                return;
-            }
+            AddSubsetDraws(p_context, renderer, mesh, view_lod, world_matrix, draw, false, view_depth, in_frustum, p_chunk.commands[MESH_PASS_GBUFFER]);
+        }
 
-            const auto& materials = renderer.GetMaterialInstances();
+        if (in_view && is_transparent) {
+            AddSubsetDraws(p_context, renderer, mesh, view_lod, world_matrix, draw, true, view_depth, in_frustum, p_chunk.commands[MESH_PASS_TRANSPARENT]);
+        }
 
-            for (size_t idx = 0; idx < mesh.subsets.size(); ++idx) {
-                const auto& subset = mesh.subsets[idx];
-                AABB aabb2 = subset.local_bound;
-                aabb2.ApplyMatrix(world_matrix);
-                if (!p_filter(aabb2)) {
-                    continue;
-                }
+        if (in_voxel) {
+            auto in_voxel_bound = [&](const AABB& p_aabb) { return voxel_bound.Intersects(p_aabb); };
+            AddSubsetDraws(p_context, renderer, mesh, shadow_lod, world_matrix, draw, is_transparent, view_depth, in_voxel_bound, p_chunk.commands[MESH_PASS_VOXELIZATION]);
+        }
+    }
+}
 
-                // @TODO: [SCRUM-210] fix material
-                MaterialConstantBuffer material_buffer;
-                ecs::Entity material_id =
-                    idx < materials.size() ? materials[idx] : ecs::Entity::Null();
+// Flags the tree leaves in each culling volume, so the walk skips the renderers outside all of
+// them without looking up their transform.
+static void CullMeshTree(Scene& p_scene, SceneRenderState& p_state, const FrameData& p_framedata, MeshPassContext& p_context) {
+    CAVE_PROFILE_EVENT();
 
-                const MaterialComponent* material = p_scene->GetComponent<MaterialComponent>(material_id);
+    std::vector<uint8_t>& cull_flags = p_state.scratch.cull_flags;
 
-                FillMaterialConstantBuffer(is_opengl, material, material_buffer);
+    const DynamicAabbTree& tree = p_scene.m_meshTree;
+    cull_flags.assign(tree.GetCapacity(), 0);
+    tree.QueryFrustum(p_context.camera_frustum, [&](int p_proxy) { cull_flags[p_proxy] |= MESH_CULL_VIEW; });
+    if (p_context.has_shadow) {
+        tree.QueryFrustum(p_context.shadow_frustum, [&](int p_proxy) { cull_flags[p_proxy] |= MESH_CULL_SHADOW; });
+    }
+    if (p_context.has_voxel) {
+        tree.QueryAabb(p_framedata.voxel_gi_bound, [&](int p_proxy) { cull_flags[p_proxy] |= MESH_CULL_VOXEL; });
+    }
+
+    p_context.cull_flags = cull_flags;
+}
 
-                draw_cmd.index_count = subset.index_count;
-                draw_cmd.index_offset = subset.index_offset;
-                draw_cmd.mat_idx = p_framedata.materialCache.FindOrAdd(material_id, material_buffer);
+// Every pass is filled in a single walk over the mesh renderers. The walk is split into groups that
+// run on the job system, each writing to its own chunk, then the chunks are appended in order.
+static void FillMeshPasses(Scene& p_scene, SceneRenderState& p_state, FrameData& p_framedata, const MeshPassContext& p_context) {
+    CAVE_PROFILE_EVENT();
 
-                p_commands.emplace_back(RenderCommand::From(draw_cmd));
-            }
-        };
+    std::vector<MeshCommandChunk>& chunks = p_state.scratch.chunks;
+
+    SkeletonVisibilityReport& visibility = p_scene.m_skeletonVisibility;
+    visibility.frame = p_scene.m_frameIndex;
+    visibility.written = true;
+    visibility.skeletons.clear();
 
-        if (is_opaque) {
-            add_to_pass(p_framedata.prepass_commands, filter_main, true);
+    const uint32_t renderer_count = static_cast<uint32_t>(p_scene.GetCount<MeshRendererComponent>());
+    const uint32_t chunk_count = (renderer_count + MESH_COMMAND_GROUP_SIZE - 1) / MESH_COMMAND_GROUP_SIZE;
+    if (chunks.size() < chunk_count) {
+        chunks.resize(chunk_count);
+    }
+
+    auto generate = [&](uint32_t p_chunk_idx) {
+        MeshCommandChunk& chunk = chunks[p_chunk_idx];
+        chunk.Clear();
+
+        const uint32_t begin = p_chunk_idx * MESH_COMMAND_GROUP_SIZE;
+        const uint32_t end = glm::min(begin + MESH_COMMAND_GROUP_SIZE, renderer_count);
+        GenerateMeshCommands(p_scene, p_framedata, p_context, begin, end, chunk);
+    };
+
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(chunk_count, 1, [&](jobsystem::JobArgs p_args) { generate(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    for (uint32_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+        generate(chunk_idx);
+    }
+#endif
+
+    RenderCommandList* lists[MESH_PASS_COUNT] = {
+        &p_framedata.shadow_pass_commands,
+        &p_framedata.prepass_commands,
+        &p_framedata.gbuffer_commands,
+        &p_framedata.transparent_commands,
+        &p_framedata.voxelization_commands,
+    };
+
+    size_t command_counts[MESH_PASS_COUNT] = {};
+    for (uint32_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+        const MeshCommandChunk& chunk = chunks[chunk_idx];
+        for (uint32_t pass = 0; pass < MESH_PASS_COUNT; ++pass) {
+            command_counts[pass] += chunk.commands[pass].size();
         }
+    }
 
-        if (is_opaque) {
-            add_to_pass(p_framedata.gbuffer_commands, filter_main, false);
+    for (uint32_t pass = 0; pass < MESH_PASS_COUNT; ++pass) {
+        lists[pass]->Reserve(lists[pass]->GetSize() + command_counts[pass]);
+    }
+
+    // the batches keep their slot across frames, only the ones that changed are uploaded
+    std::vector<int>& batch_slots = p_state.scratch.batch_slots;
+    auto& scene_batches = p_state.batch_buffer;
+    scene_batches.BeginFrame();
+
+    std::vector<const MeshAsset*>& meshes = p_state.scratch.meshes;
+    meshes.clear();
+
+    uint32_t occlusion_tested_count = 0;
+    uint32_t occlusion_culled_count = 0;
+    MeshLodStats lod_stats;
+    for (uint32_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+        MeshCommandChunk& chunk = chunks[chunk_idx];
+        batch_slots.resize(chunk.batches.size());
+        for (size_t i = 0; i < chunk.batches.size(); ++i) {
+            const int slot = scene_batches.Update(chunk.batch_ids[i], chunk.batches[i]);
+            if (slot >= 0) {
+                batch_slots[i] = static_cast<int>(TRANSIENT_BATCH_COUNT) + slot;
+            } else {
+                // the scene buffer is full, written this frame only, -1 if that is full too
+                batch_slots[i] = p_framedata.AddTransientBatch(chunk.batches[i]);
+            }
         }
 
-        if (is_transparent) {
-            add_to_pass(p_framedata.transparent_commands, filter_main, false);
+        for (uint32_t pass = 0; pass < MESH_PASS_COUNT; ++pass) {
+            for (RenderCommand& command : chunk.commands[pass]) {
+                command.draw.batch_idx = batch_slots[command.draw.batch_idx];
+                if (command.draw.batch_idx >= 0) {
+                    lists[pass]->Add(command);
+                }
+            }
         }
 
-        if (p_framedata.voxel_gi_bound.IsValid()) {
-            FilterFunc gi_filter = [&](const AABB& p_aabb) -> bool { return p_framedata.voxel_gi_bound.Intersects(p_aabb); };
-            add_to_pass(p_framedata.voxelization_commands, gi_filter, false);
+        meshes.insert(meshes.end(), chunk.meshes.begin(), chunk.meshes.end());
+        p_framedata.uploadHints.insert(p_framedata.uploadHints.end(), chunk.upload_hints.begin(), chunk.upload_hints.end());
+
+        visibility.skeletons.insert(visibility.skeletons.end(), chunk.visible_skeletons.begin(), chunk.visible_skeletons.end());
+
+        occlusion_tested_count += chunk.occlusion_tested_count;
+        occlusion_culled_count += chunk.occlusion_culled_count;
+
+        lod_stats.mesh_count += chunk.lod_stats.mesh_count;
+        lod_stats.full_triangle_count += chunk.lod_stats.full_triangle_count;
+        lod_stats.drawn_triangle_count += chunk.lod_stats.drawn_triangle_count;
+        for (int level = 0; level <= MeshAsset::MAX_LOD_COUNT; ++level) {
+            lod_stats.level_counts[level] += chunk.lod_stats.level_counts[level];
         }
     }
+    p_state.mesh_lod_stats = lod_stats;
+
+    std::sort(meshes.begin(), meshes.end());
+    meshes.erase(std::unique(meshes.begin(), meshes.end()), meshes.end());
+    for (const MeshAsset* mesh : meshes) {
+        p_framedata.retainedResources.push_back(mesh->gpuResource);
+    }
+
+    scene_batches.EndFrame(p_framedata.batchUploads, p_framedata.batchUploadValues);
+
+    if (p_context.occlusion) {
+        p_state.occlusion_culler.SetQueryCounts(occlusion_tested_count, occlusion_culled_count);
+    }
 }
 
-void RunMeshRenderSystem(Scene* p_scene, FrameData& p_framedata) {
+// p_state is the renderer state of p_scene, it may only be null without a scene
+void RunMeshRenderSystem(Scene* p_scene, SceneRenderState* p_state, FrameData& p_framedata) {
+    DEV_ASSERT(!p_scene || p_state);
+
+    MeshPassContext context;
     if (p_scene) {
-        FillLightBuffer(*p_scene, p_framedata);
+        FillLightBuffer(*p_scene, p_framedata, context);
         FillVoxelPass(*p_scene, p_framedata);
     }
-    FillMainPass(p_scene, p_framedata);
+    FillMainPass(p_framedata, context);
+
+    if (p_scene) {
+        context.has_voxel = p_framedata.voxel_gi_bound.IsValid();
+        CullMeshTree(*p_scene, *p_state, p_framedata, context);
+        FillSharedBuffers(*p_scene, *p_state, p_framedata, context);
+        if (p_framedata.options.occlusionCullingEnabled) {
+            FillOcclusionBuffer(*p_scene, *p_state, p_framedata, context);
+        }
+        FillMeshPasses(*p_scene, *p_state, p_framedata, context);
+        if (p_framedata.options.clusteredLightingEnabled) {
+            FillLightClusters(*p_state, p_framedata);
+        }
+    }
+
+    p_framedata.shadow_pass_commands.Sort();
+    p_framedata.prepass_commands.Sort();
+    p_framedata.gbuffer_commands.Sort();
+    p_framedata.transparent_commands.Sort();
+    p_framedata.voxelization_commands.Sort();
+
+    // transparent draws are sorted by depth first and rarely share state with their neighbours
+    const SceneBuffer<PerBatchConstantBuffer>* scene_batches = p_scene ? &p_state->batch_buffer : nullptr;
+    MergeInstancedDraws(p_framedata.shadow_pass_commands, p_framedata, scene_batches);
+    MergeInstancedDraws(p_framedata.prepass_commands, p_framedata, scene_batches);
+    MergeInstancedDraws(p_framedata.gbuffer_commands, p_framedata, scene_batches);
+    MergeInstancedDraws(p_framedata.voxelization_commands, p_framedata, scene_batches);
+
+    // the bone buffer is sized to what the palettes and the instanced draws use
+    if (p_scene) {
+        BonePalette& palette = p_state->bone_palette;
+        const uint32_t used_row_count = p_framedata.instanceRowOffset + static_cast<uint32_t>(p_framedata.instanceRows.size());
+        palette.ReserveBuffer(used_row_count + BONE_BLOCK_ROW_COUNT, p_framedata.boneUploads, p_framedata.boneUploadRows);
+        p_framedata.boneBufferRowCount = palette.GetBufferRowCount();
+    }
 }
 
 // @TODO: fix emitter
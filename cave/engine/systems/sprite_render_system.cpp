@@ -18,14 +18,21 @@ void RunSpriteRenderSystem(const Scene* p_scene, FrameData& p_framedata) {
         batch_buffer.c_tint_color = sprite_renderer.GetTintColor();
         const auto& rect = sprite_renderer.GetRect();
         batch_buffer.c_uv_rect = Vector4f(rect.GetMin(), rect.GetMax());
+        const int batch_idx = p_framedata.FindOrAddTransientBatch(id, batch_buffer);
+        if (batch_idx < 0) {
+            continue;
+        }
 
         DrawCommand draw;
         draw.index_count = 6;
-        draw.batch_idx = p_framedata.batchCache.FindOrAdd(id, batch_buffer);
+        draw.batch_idx = batch_idx;
 
         ImageAsset* image = sprite_renderer.GetHandle().Get();
         if (image) {
             draw.texture = image->gpu_texture.get();
+            if (image->gpu_texture) {
+                p_framedata.retainedResources.push_back(image->gpu_texture);
+            }
         } else {
             // @TODO: dummy sprite?
         }
@@ -29,15 +29,23 @@ void RunTileMapRenderSystem(Scene* p_scene, FrameData& p_framedata) {
         PerBatchConstantBuffer batch_buffer;
         batch_buffer.c_worldMatrix = world_matrix;
         batch_buffer.c_tint_color = tile_map_renderer.GetTintColor();
+        const int batch_idx = p_framedata.FindOrAddTransientBatch(id, batch_buffer);
+        if (batch_idx < 0) {
+            continue;
+        }
 
         DrawCommand draw;
         draw.index_count = cache.mesh->desc.drawCount;
         draw.mesh_data = cache.mesh.get();
-        draw.batch_idx = p_framedata.batchCache.FindOrAdd(id, batch_buffer);
+        p_framedata.retainedResources.push_back(cache.mesh);
+        draw.batch_idx = batch_idx;
 
         ImageAsset* image = cache.image.Get();
         if (image) {
             draw.texture = image->gpu_texture.get();
+            if (image->gpu_texture) {
+                p_framedata.retainedResources.push_back(image->gpu_texture);
+            }
         } else {
             // @TODO: dummy sprite?
         }
@@ -60,7 +60,7 @@ static void RegisterPersistentImages(Application* p_app) {
         asset_registry.RegisterPersistentAsset("textures/checkerboard",
                                                TO_GUID(GUID3),
                                                texture);
-        graphics_manager.RequestTexture(texture.get());
+        graphics_manager.RequestTexture(texture);
     }
 }
 
@@ -75,42 +75,42 @@ static void RegisterPersistentMeshes(Application* p_app) {
         asset_registry.RegisterPersistentAsset("meshes/plane",
                                                TO_GUID(GUID4),
                                                mesh);
-        graphics_manager.RequestMesh(mesh.get());
+        graphics_manager.RequestMesh(mesh);
     }
     {
         auto mesh = CreateCubeMesh(Vector3f(0.5f));
         asset_registry.RegisterPersistentAsset("meshes/cube",
                                                TO_GUID(GUID5),
                                                mesh);
-        graphics_manager.RequestMesh(mesh.get());
+        graphics_manager.RequestMesh(mesh);
     }
     {
         auto mesh = CreateSphereMesh(0.5f);
         asset_registry.RegisterPersistentAsset("meshes/sphere",
                                                TO_GUID(GUID6),
                                                mesh);
-        graphics_manager.RequestMesh(mesh.get());
+        graphics_manager.RequestMesh(mesh);
     }
     {
         auto mesh = CreateCylinderMesh(0.5f, 1.0f);
         asset_registry.RegisterPersistentAsset("meshes/cylinder",
                                                TO_GUID(GUID7),
                                                mesh);
-        graphics_manager.RequestMesh(mesh.get());
+        graphics_manager.RequestMesh(mesh);
     }
     {
         auto mesh = CreateConeMesh(0.5f, 1.0f);
         asset_registry.RegisterPersistentAsset("meshes/cone",
                                                TO_GUID(GUID8),
                                                mesh);
-        graphics_manager.RequestMesh(mesh.get());
+        graphics_manager.RequestMesh(mesh);
     }
     {
         auto mesh = CreateTorusMesh(0.5f);
         asset_registry.RegisterPersistentAsset("meshes/torus",
                                                TO_GUID(GUID9),
                                                mesh);
-        graphics_manager.RequestMesh(mesh.get());
+        graphics_manager.RequestMesh(mesh);
     }
 }
 
@@ -24,7 +24,7 @@ namespace cave {
 enum { A = 0, B = 1, C = 2, D = 3, E = 4, F = 5, G = 6, H = 7 };
 // clang-format on
 
-static std::shared_ptr<MeshAsset> CreatePlaneMesh(const Vector3f& p_point_0,
+inline std::shared_ptr<MeshAsset> CreatePlaneMesh(const Vector3f& p_point_0,
                                                   const Vector3f& p_point_1,
                                                   const Vector3f& p_point_2,
                                                   const Vector3f& p_point_3) {
@@ -74,7 +74,7 @@ static std::shared_ptr<MeshAsset> CreatePlaneMesh(const Vector3f& p_point_0,
     return mesh;
 }
 
-static std::shared_ptr<MeshAsset> CreatePlaneMesh(const Vector3f& p_scale) {
+inline std::shared_ptr<MeshAsset> CreatePlaneMesh(const Vector3f& p_scale) {
     const float x = p_scale.x;
     const float y = p_scale.y;
     Vector3f a(-x, +y, 0.0f);  // A
@@ -84,7 +84,7 @@ static std::shared_ptr<MeshAsset> CreatePlaneMesh(const Vector3f& p_scale) {
     return CreatePlaneMesh(a, b, c, d);
 }
 
-static std::shared_ptr<MeshAsset> CreateCubeMesh(const Vector3f& p_scale) {
+inline std::shared_ptr<MeshAsset> CreateCubeMesh(const Vector3f& p_scale) {
     auto mesh = std::make_shared<MeshAsset>();
     // clang-format off
     constexpr uint32_t indices[] = {
@@ -215,7 +215,7 @@ static std::shared_ptr<MeshAsset> CreateCubeMesh(const Vector3f& p_scale) {
     return mesh;
 }
 
-static std::shared_ptr<MeshAsset> CreateSphereMesh(float p_radius,
+inline std::shared_ptr<MeshAsset> CreateSphereMesh(float p_radius,
                                                    int p_rings = 60,
                                                    int p_sectors = 60) {
     auto mesh = std::make_shared<MeshAsset>();
@@ -272,7 +272,7 @@ static std::shared_ptr<MeshAsset> CreateSphereMesh(float p_radius,
     return mesh;
 }
 
-static std::shared_ptr<MeshAsset> CreateCylinderMesh(float p_radius,
+inline std::shared_ptr<MeshAsset> CreateCylinderMesh(float p_radius,
                                                      float p_height,
                                                      int p_sectors = 60,
                                                      int p_height_sector = 1) {
@@ -387,7 +387,7 @@ static std::shared_ptr<MeshAsset> CreateCylinderMesh(float p_radius,
     return mesh;
 }
 
-static std::shared_ptr<MeshAsset> CreateConeMesh(float p_radius,
+inline std::shared_ptr<MeshAsset> CreateConeMesh(float p_radius,
                                                  float p_height,
                                                  int p_sectors = 60) {
     auto mesh = std::make_shared<MeshAsset>();
@@ -494,7 +494,7 @@ static std::shared_ptr<MeshAsset> CreateConeMesh(float p_radius,
     return mesh;
 }
 
-static std::shared_ptr<MeshAsset> CreateTorusMesh(float p_radius,
+inline std::shared_ptr<MeshAsset> CreateTorusMesh(float p_radius,
                                                   float p_tube_radius = 0.2f,
                                                   int p_sectors = 60,
                                                   int p_tube_sectors = 60) {
@@ -0,0 +1,142 @@
+#include "engine/scene/compressed_animation_clip.h"
+#include "engine/scene/skeletal_animation_component.h"
+
+namespace cave {
+
+static constexpr int BENCH_BONE_COUNT = 60;
+static constexpr int BENCH_KEY_COUNT = 2000;
+static constexpr float BENCH_KEY_INTERVAL = 1.0f / 30.0f;
+static constexpr float BENCH_FRAME_TIME = 1.0f / 60.0f;
+
+struct BenchClip {
+    std::vector<SkeletalAnimationSampler> samplers;
+    std::vector<SkeletalAnimationChannel> channels;
+
+    size_t GetMemoryUsage() const {
+        size_t bytes = 0;
+        for (const auto& sampler : samplers) {
+            bytes += (sampler.keyframe_times.size() + sampler.keyframe_data.size()) * sizeof(float);
+        }
+        return bytes;
+    }
+};
+
+// Mocap-like clip: every bone rotates with a few overlapping frequencies, the root and a few
+// bones translate, scale never changes.
+static BenchClip CreateBenchClip() {
+    BenchClip clip;
+    std::mt19937 engine(0xA11);
+    std::uniform_real_distribution<float> dist(0.2f, 3.0f);
+
+    for (int bone = 0; bone < BENCH_BONE_COUNT; ++bone) {
+        const float f0 = dist(engine);
+        const float f1 = dist(engine);
+        const float f2 = dist(engine);
+        const bool translates = bone % 8 == 0;
+
+        for (int path_index = 0; path_index < 3; ++path_index) {
+            const AnimationChannelPath path = static_cast<AnimationChannelPath>(path_index);
+            SkeletalAnimationChannel& channel = clip.channels.emplace_back();
+            channel.path = path;
+            channel.sampler_index = static_cast<int>(clip.samplers.size());
+
+            SkeletalAnimationSampler& sampler = clip.samplers.emplace_back();
+            for (int key = 0; key < BENCH_KEY_COUNT; ++key) {
+                const float t = key * BENCH_KEY_INTERVAL;
+                sampler.keyframe_times.push_back(t);
+                switch (path) {
+                    case AnimationChannelPath::Translation: {
+                        const float amount = translates ? 1.0f : 0.0f;
+                        sampler.keyframe_data.push_back(amount * glm::sin(f0 * t));
+                        sampler.keyframe_data.push_back(1.0f + amount * 0.1f * glm::sin(f1 * t));
+                        sampler.keyframe_data.push_back(amount * 0.5f * t);
+                    } break;
+                    case AnimationChannelPath::Rotation: {
+                        const glm::quat q = glm::quat(glm::vec3(0.5f * glm::sin(f0 * t), 0.3f * glm::sin(f1 * t), 0.2f * glm::sin(f2 * t)));
+                        sampler.keyframe_data.push_back(q.x);
+                        sampler.keyframe_data.push_back(q.y);
+                        sampler.keyframe_data.push_back(q.z);
+                        sampler.keyframe_data.push_back(q.w);
+                    } break;
+                    default: {
+                        sampler.keyframe_data.push_back(1.0f);
+                        sampler.keyframe_data.push_back(1.0f);
+                        sampler.keyframe_data.push_back(1.0f);
+                    } break;
+                }
+            }
+        }
+    }
+    return clip;
+}
+
+static const BenchClip& GetBenchClip() {
+    static const BenchClip s_clip = CreateBenchClip();
+    return s_clip;
+}
+
+// Raw per-character sampling with a cursor, matching what the animation system does without compression.
+static void BM_AnimationSample_Raw(benchmark::State& p_state) {
+    const BenchClip& clip = GetBenchClip();
+    const auto& times = clip.samplers.front().keyframe_times;
+    KeyframeCursor cursor;
+    std::vector<Vector4f> result(clip.samplers.size());
+    float timer = 0.0f;
+
+    for (auto _ : p_state) {
+        timer = timer + BENCH_FRAME_TIME > times.back() ? 0.0f : timer + BENCH_FRAME_TIME;
+        const int left = glm::max(cursor.Seek(times, timer), 0);
+        const int right = glm::min(left + 1, (int)times.size() - 1);
+        const float t = left == right ? 0.0f : (timer - times[left]) / (times[right] - times[left]);
+
+        for (size_t i = 0; i < clip.samplers.size(); ++i) {
+            const float* data = clip.samplers[i].keyframe_data.data();
+            const int count = clip.channels[i].path == AnimationChannelPath::Rotation ? 4 : 3;
+            for (int c = 0; c < count; ++c) {
+                result[i][c] = glm::mix(data[left * count + c], data[right * count + c], t);
+            }
+        }
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    p_state.counters["bytes"] = static_cast<double>(clip.GetMemoryUsage());
+    p_state.SetItemsProcessed(p_state.iterations() * clip.samplers.size());
+}
+BENCHMARK(BM_AnimationSample_Raw);
+
+static void BM_AnimationSample_Compressed(benchmark::State& p_state) {
+    const BenchClip& clip = GetBenchClip();
+    CompressedAnimationClip compressed;
+    if (!compressed.Compress(clip.samplers, clip.channels, {})) {
+        p_state.SkipWithError("failed to compress clip");
+        return;
+    }
+
+    KeyframeCursor cursor;
+    std::vector<float> scratch(compressed.GetScratchSize());
+    std::vector<Vector4f> result(compressed.GetTrackCount());
+    const float length = clip.samplers.front().keyframe_times.back();
+    float timer = 0.0f;
+
+    for (auto _ : p_state) {
+        timer = timer + BENCH_FRAME_TIME > length ? 0.0f : timer + BENCH_FRAME_TIME;
+        compressed.Sample(timer, cursor, scratch.data(), result.data());
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    p_state.counters["bytes"] = static_cast<double>(compressed.GetMemoryUsage());
+    p_state.counters["keys"] = static_cast<double>(compressed.GetKeyCount());
+    p_state.SetItemsProcessed(p_state.iterations() * compressed.GetTrackCount());
+}
+BENCHMARK(BM_AnimationSample_Compressed);
+
+static void BM_AnimationCompress(benchmark::State& p_state) {
+    const BenchClip& clip = GetBenchClip();
+    for (auto _ : p_state) {
+        CompressedAnimationClip compressed;
+        benchmark::DoNotOptimize(compressed.Compress(clip.samplers, clip.channels, {}));
+    }
+}
+BENCHMARK(BM_AnimationCompress)->Unit(benchmark::kMillisecond);
+
+}  // namespace cave
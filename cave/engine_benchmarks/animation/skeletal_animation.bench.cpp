@@ -0,0 +1,136 @@
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace cave {
+
+static constexpr int BENCH_CHARACTER_COUNT = 500;
+static constexpr int BENCH_BONE_COUNT = 60;
+static constexpr int BENCH_KEY_COUNT = 2000;
+static constexpr int BENCH_CHANNELS_PER_BONE = 3;
+static constexpr float BENCH_FRAME_TIME = 1.0f / 60.0f;
+static constexpr float BENCH_KEY_INTERVAL = 1.0f / 30.0f;
+
+static std::vector<float> BenchKeyframeTimes() {
+    std::vector<float> times(BENCH_KEY_COUNT);
+    for (int i = 0; i < BENCH_KEY_COUNT; ++i) {
+        times[i] = i * BENCH_KEY_INTERVAL;
+    }
+    return times;
+}
+
+// the lookup the animation system did before cursors, kept as a reference
+static int LinearScanKeyframe(const std::vector<float>& p_times, float p_time) {
+    int key = -1;
+    float time_left = -std::numeric_limits<float>::max();
+    for (int k = 0; k < (int)p_times.size(); ++k) {
+        const float time = p_times[k];
+        if (time <= p_time && time > time_left) {
+            time_left = time;
+            key = k;
+        }
+    }
+    return key;
+}
+
+// Every character plays the same clip at a different phase, every channel looks up its keys,
+// which is what the animation system did per frame before timelines were shared.
+template<typename FUNC>
+static void RunKeyframeLookupBenchmark(benchmark::State& p_state, FUNC&& p_lookup) {
+    const std::vector<float> times = BenchKeyframeTimes();
+    const float length = times.back();
+    constexpr int lookup_count = BENCH_CHARACTER_COUNT * BENCH_BONE_COUNT * BENCH_CHANNELS_PER_BONE;
+
+    std::vector<float> timers(BENCH_CHARACTER_COUNT);
+    for (int i = 0; i < BENCH_CHARACTER_COUNT; ++i) {
+        timers[i] = length * i / BENCH_CHARACTER_COUNT;
+    }
+
+    std::vector<KeyframeCursor> cursors(lookup_count);
+    int64_t sum = 0;
+    for (auto _ : p_state) {
+        for (int character = 0; character < BENCH_CHARACTER_COUNT; ++character) {
+            float& timer = timers[character];
+            timer += BENCH_FRAME_TIME;
+            if (timer > length) {
+                timer = 0.0f;
+            }
+
+            constexpr int channel_count = BENCH_BONE_COUNT * BENCH_CHANNELS_PER_BONE;
+            for (int channel = 0; channel < channel_count; ++channel) {
+                sum += p_lookup(cursors[character * channel_count + channel], times, timer);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    p_state.SetItemsProcessed(p_state.iterations() * lookup_count);
+}
+
+static void BM_KeyframeLookup_LinearScan(benchmark::State& p_state) {
+    RunKeyframeLookupBenchmark(p_state, [](KeyframeCursor&, const std::vector<float>& p_times, float p_time) {
+        return LinearScanKeyframe(p_times, p_time);
+    });
+}
+BENCHMARK(BM_KeyframeLookup_LinearScan)->Unit(benchmark::kMillisecond);
+
+static void BM_KeyframeLookup_BinarySearch(benchmark::State& p_state) {
+    RunKeyframeLookupBenchmark(p_state, [](KeyframeCursor&, const std::vector<float>& p_times, float p_time) {
+        auto it = std::upper_bound(p_times.begin(), p_times.end(), p_time);
+        return static_cast<int>(it - p_times.begin()) - 1;
+    });
+}
+BENCHMARK(BM_KeyframeLookup_BinarySearch)->Unit(benchmark::kMillisecond);
+
+static void BM_KeyframeLookup_Cursor(benchmark::State& p_state) {
+    RunKeyframeLookupBenchmark(p_state, [](KeyframeCursor& p_cursor, const std::vector<float>& p_times, float p_time) {
+        return p_cursor.Seek(p_times, p_time);
+    });
+}
+BENCHMARK(BM_KeyframeLookup_Cursor)->Unit(benchmark::kMillisecond);
+
+// Runs the real animation system. Every component owns its own copy of the clip (~6MB with
+// 60 bones and 2000 keys), so the character count is kept lower than the lookup benchmarks.
+static void BM_SkeletalAnimationSystem(benchmark::State& p_state) {
+    const int character_count = static_cast<int>(p_state.range(0));
+    const std::vector<float> times = BenchKeyframeTimes();
+
+    Scene scene;
+    for (int character = 0; character < character_count; ++character) {
+        auto animation_id = scene.CreateEntity();
+        SkeletalAnimationComponent& animation = scene.Create<SkeletalAnimationComponent>(animation_id);
+        animation.SetEnd(times.back());
+        animation.SetTimer(times.back() * character / character_count);
+        animation.SetPlaying();
+
+        auto& samplers = animation.GetSamplers();
+        auto& channels = animation.GetChannels();
+        for (int bone = 0; bone < BENCH_BONE_COUNT; ++bone) {
+            auto bone_id = scene.CreateEntity();
+            scene.Create<TransformComponent>(bone_id);
+
+            for (int i = 0; i < BENCH_CHANNELS_PER_BONE; ++i) {
+                const AnimationChannelPath path = static_cast<AnimationChannelPath>(i);
+                const size_t components = path == AnimationChannelPath::Rotation ? 4 : 3;
+
+                SkeletalAnimationChannel& channel = channels.emplace_back();
+                channel.path = path;
+                channel.target_id = bone_id;
+                channel.sampler_index = static_cast<int>(samplers.size());
+
+                SkeletalAnimationSampler& sampler = samplers.emplace_back();
+                sampler.keyframe_times = times;
+                sampler.keyframe_data.resize(times.size() * components, 1.0f);
+            }
+        }
+    }
+
+    for (auto _ : p_state) {
+        jobsystem::Context ctx;
+        RunAnimationUpdateSystem(scene, ctx, BENCH_FRAME_TIME);
+        ctx.Wait();
+    }
+    p_state.SetItemsProcessed(p_state.iterations() * character_count * BENCH_BONE_COUNT);
+}
+BENCHMARK(BM_SkeletalAnimationSystem)->Arg(8)->Arg(32)->Unit(benchmark::kMillisecond);
+
+}  // namespace cave
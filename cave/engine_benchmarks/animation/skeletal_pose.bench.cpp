@@ -0,0 +1,50 @@
+#include "engine/scene/skeletal_pose.h"
+
+namespace cave {
+
+static constexpr int BENCH_SKELETON_COUNT = 500;
+static constexpr int BENCH_BONE_COUNT = 60;
+
+static SkeletalPose CreateBenchPose(std::mt19937& p_engine) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    SkeletalPose pose;
+    pose.Resize(BENCH_BONE_COUNT);
+    for (int i = 0; i < BENCH_BONE_COUNT; ++i) {
+        pose.translations[i] = Vector4f(dist(p_engine), dist(p_engine), dist(p_engine), 0.0f);
+        pose.rotations[i] = normalize(Vector4f(dist(p_engine), dist(p_engine), dist(p_engine), dist(p_engine)));
+        pose.scales[i] = Vector4f(1.0f);
+        pose.weights[i] = Vector4f(1.0f, 1.0f, 1.0f, 0.0f);
+    }
+    return pose;
+}
+
+// Crossfade two clips and apply an additive layer for every skeleton, no allocation inside the loop.
+static void BM_PoseBlendCrossfadeAdditive(benchmark::State& p_state) {
+    std::mt19937 engine(0xB1E4D);
+    const SkeletalPose clip_a = CreateBenchPose(engine);
+    const SkeletalPose clip_b = CreateBenchPose(engine);
+    const SkeletalPose additive = CreateBenchPose(engine);
+    const SkeletalPose base = CreateBenchPose(engine);
+
+    std::vector<SkeletalPose> results(BENCH_SKELETON_COUNT);
+    for (SkeletalPose& pose : results) {
+        pose.Resize(BENCH_BONE_COUNT);
+    }
+
+    float fade = 0.0f;
+    for (auto _ : p_state) {
+        fade = fade >= 1.0f ? 0.0f : fade + 0.01f;
+        for (SkeletalPose& pose : results) {
+            pose.Clear();
+            BlendPose(pose, clip_a, 1.0f - fade);
+            BlendPose(pose, clip_b, fade);
+            NormalizePose(pose, base);
+            AddPose(pose, additive, 0.3f);
+        }
+        benchmark::DoNotOptimize(results.data());
+    }
+    p_state.SetItemsProcessed(p_state.iterations() * BENCH_SKELETON_COUNT * BENCH_BONE_COUNT);
+}
+BENCHMARK(BM_PoseBlendCrossfadeAdditive)->Unit(benchmark::kMicrosecond);
+
+}  // namespace cave
@@ -0,0 +1,115 @@
+#include "engine/math/aabb.h"
+#include "math.bench.h"
+
+namespace cave {
+
+static AABB BenchRandomAABB() {
+    const Vector3f center = BenchRandomVector3f();
+    const Vector3f size = BenchRandomVector3f(0.1f, 10.0f);
+    return AABB::FromCenterSize(center, size);
+}
+
+struct GlmBox {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+static GlmBox ToGlmBox(const AABB& p_box) {
+    return { ToGlm(p_box.GetMin()), ToGlm(p_box.GetMax()) };
+}
+
+static void BM_AabbApplyMatrix_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto boxes = BenchGenerate<AABB>(BenchRandomAABB);
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<AABB> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = boxes[i];
+        out[i].ApplyMatrix(m[i]);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_AabbApplyMatrix_Engine);
+
+static void BM_AabbApplyMatrix_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    std::vector<GlmBox> boxes;
+    for (const AABB& box : BenchGenerate<AABB>(BenchRandomAABB)) {
+        boxes.emplace_back(ToGlmBox(box));
+    }
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<GlmBox> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        const GlmBox& box = boxes[i];
+        GlmBox result{ glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec4 point((corner & 4) ? box.max.x : box.min.x,
+                                  (corner & 2) ? box.max.y : box.min.y,
+                                  (corner & 1) ? box.max.z : box.min.z,
+                                  1.0f);
+            const glm::vec3 transformed = glm::vec3(m[i] * point);
+            result.min = glm::min(result.min, transformed);
+            result.max = glm::max(result.max, transformed);
+        }
+        out[i] = result;
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_AabbApplyMatrix_Glm);
+
+static void BM_AabbUnion_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto boxes = BenchGenerate<AABB>(BenchRandomAABB);
+    AABB result;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        result.UnionBox(boxes[i]);
+    });
+    benchmark::DoNotOptimize(result);
+}
+BENCHMARK(BM_AabbUnion_Engine);
+
+static void BM_AabbUnion_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    std::vector<GlmBox> boxes;
+    for (const AABB& box : BenchGenerate<AABB>(BenchRandomAABB)) {
+        boxes.emplace_back(ToGlmBox(box));
+    }
+    GlmBox result{ glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        result.min = glm::min(result.min, boxes[i].min);
+        result.max = glm::max(result.max, boxes[i].max);
+    });
+    benchmark::DoNotOptimize(result);
+}
+BENCHMARK(BM_AabbUnion_Glm);
+
+static void BM_AabbIntersects_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto a = BenchGenerate<AABB>(BenchRandomAABB);
+    const auto b = BenchGenerate<AABB>(BenchRandomAABB);
+    int hits = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        hits += a[i].Intersects(b[i]);
+    });
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(BM_AabbIntersects_Engine);
+
+static void BM_AabbIntersects_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    std::vector<GlmBox> a, b;
+    for (const AABB& box : BenchGenerate<AABB>(BenchRandomAABB)) {
+        a.emplace_back(ToGlmBox(box));
+    }
+    for (const AABB& box : BenchGenerate<AABB>(BenchRandomAABB)) {
+        b.emplace_back(ToGlmBox(box));
+    }
+    int hits = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        hits += glm::all(glm::lessThan(glm::max(a[i].min, b[i].min), glm::min(a[i].max, b[i].max)));
+    });
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(BM_AabbIntersects_Glm);
+
+}  // namespace cave
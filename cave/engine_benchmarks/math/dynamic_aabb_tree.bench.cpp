@@ -0,0 +1,193 @@
+#include "engine/math/dynamic_aabb_tree.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/math/ray.h"
+#include "math.bench.h"
+
+namespace cave {
+
+static constexpr int TREE_OBJECT_COUNT = 100000;
+// objects moved every frame, in percent
+static constexpr int TREE_MOVING_PERCENT = 5;
+static constexpr float TREE_WORLD_SIZE = 2000.0f;
+
+// Boxes of 1 to 8 units spread over a 2km square, a few stories high, like the props of an open
+// world. The first 5% move a little every frame.
+struct BenchTreeScene {
+    std::vector<AABB> boxes;
+    std::vector<Vector3f> velocities;
+    std::vector<int> proxies;
+    DynamicAabbTree tree;
+
+    BenchTreeScene() {
+        const float half = 0.5f * TREE_WORLD_SIZE;
+        for (int i = 0; i < TREE_OBJECT_COUNT; ++i) {
+            const Vector3f center(BenchRandomFloat(-half, half), BenchRandomFloat(0.0f, 50.0f), BenchRandomFloat(-half, half));
+            boxes.push_back(AABB::FromCenterSize(center, BenchRandomVector3f(1.0f, 8.0f)));
+            velocities.push_back(BenchRandomVector3f(-0.2f, 0.2f));
+            proxies.push_back(tree.CreateProxy(boxes.back(), static_cast<uint32_t>(i)));
+        }
+    }
+
+    // returns the number of leaves reinserted
+    int Step() {
+        int reinserted = 0;
+        for (int i = 0; i < TREE_OBJECT_COUNT * TREE_MOVING_PERCENT / 100; ++i) {
+            boxes[i] = AABB(boxes[i].GetMin() + velocities[i], boxes[i].GetMax() + velocities[i]);
+            reinserted += tree.MoveProxy(proxies[i], boxes[i]);
+        }
+        return reinserted;
+    }
+
+    static BenchTreeScene& Get() {
+        static BenchTreeScene s_scene;
+        return s_scene;
+    }
+};
+
+static Frustum BenchTreeFrustum() {
+    const Matrix4x4f view = LookAtRh(Vector3f(0.0f, 20.0f, 0.0f), Vector3f(100.0f, 0.0f, -100.0f), Vector3f::UnitY);
+    const Matrix4x4f projection = BuildPerspectiveRH(Degree(60.0f).GetRadians(), 16.0f / 9.0f, 0.1f, 500.0f);
+    return Frustum(projection * view);
+}
+
+static void BM_DynamicAabbTree_Build(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto& boxes = BenchTreeScene::Get().boxes;
+    for (auto _ : p_state) {
+        DynamicAabbTree tree;
+        for (int i = 0; i < TREE_OBJECT_COUNT; ++i) {
+            tree.CreateProxy(boxes[i], static_cast<uint32_t>(i));
+        }
+        benchmark::DoNotOptimize(tree.GetHeight());
+    }
+    p_state.SetItemsProcessed(p_state.iterations() * TREE_OBJECT_COUNT);
+}
+BENCHMARK(BM_DynamicAabbTree_Build)->Unit(benchmark::kMillisecond);
+
+// one frame of 5% of the objects moving
+static void BM_DynamicAabbTree_Update(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    BenchTreeScene& scene = BenchTreeScene::Get();
+    int64_t reinserted = 0;
+    for (auto _ : p_state) {
+        reinserted += scene.Step();
+    }
+    p_state.counters["reinserted"] = static_cast<double>(reinserted) / p_state.iterations();
+    p_state.counters["height"] = scene.tree.GetHeight();
+    p_state.counters["area_ratio"] = scene.tree.GetAreaRatio();
+}
+BENCHMARK(BM_DynamicAabbTree_Update)->Unit(benchmark::kMicrosecond);
+
+static void BM_DynamicAabbTree_QueryFrustum(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    const Frustum frustum = BenchTreeFrustum();
+    int visible = 0;
+    for (auto _ : p_state) {
+        visible = 0;
+        scene.tree.QueryFrustum(frustum, [&](int) { ++visible; });
+        benchmark::DoNotOptimize(visible);
+    }
+    p_state.counters["visible"] = visible;
+}
+BENCHMARK(BM_DynamicAabbTree_QueryFrustum)->Unit(benchmark::kMicrosecond);
+
+static void BM_LinearScan_QueryFrustum(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    const Frustum frustum = BenchTreeFrustum();
+    int visible = 0;
+    for (auto _ : p_state) {
+        visible = 0;
+        for (const AABB& box : scene.boxes) {
+            visible += frustum.Intersects(box);
+        }
+        benchmark::DoNotOptimize(visible);
+    }
+    p_state.counters["visible"] = visible;
+}
+BENCHMARK(BM_LinearScan_QueryFrustum)->Unit(benchmark::kMicrosecond);
+
+static void BM_DynamicAabbTree_QueryAabb(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    const AABB region = AABB::FromCenterSize(Vector3f(0.0f, 25.0f, 0.0f), Vector3f(64.0f));
+    int count = 0;
+    for (auto _ : p_state) {
+        count = 0;
+        scene.tree.QueryAabb(region, [&](int) { ++count; });
+        benchmark::DoNotOptimize(count);
+    }
+    p_state.counters["found"] = count;
+}
+BENCHMARK(BM_DynamicAabbTree_QueryAabb)->Unit(benchmark::kMicrosecond);
+
+static void BM_LinearScan_QueryAabb(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    const AABB region = AABB::FromCenterSize(Vector3f(0.0f, 25.0f, 0.0f), Vector3f(64.0f));
+    int count = 0;
+    for (auto _ : p_state) {
+        count = 0;
+        for (const AABB& box : scene.boxes) {
+            count += region.Intersects(box);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    p_state.counters["found"] = count;
+}
+BENCHMARK(BM_LinearScan_QueryAabb)->Unit(benchmark::kMicrosecond);
+
+static void BM_DynamicAabbTree_QuerySphere(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    int count = 0;
+    for (auto _ : p_state) {
+        count = 0;
+        scene.tree.QuerySphere(Vector3f(0.0f, 10.0f, 0.0f), 30.0f, [&](int) { ++count; });
+        benchmark::DoNotOptimize(count);
+    }
+    p_state.counters["found"] = count;
+}
+BENCHMARK(BM_DynamicAabbTree_QuerySphere)->Unit(benchmark::kMicrosecond);
+
+// picking, the nearest box along a segment crossing the world
+static void BM_DynamicAabbTree_RayCast(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    const Vector3f start(-1000.0f, 10.0f, -3.0f);
+    const Vector3f end(1000.0f, 20.0f, 5.0f);
+    for (auto _ : p_state) {
+        int nearest = DynamicAabbTree::NULL_NODE;
+        scene.tree.RayCast(start, end, [&](int p_proxy, float p_max_fraction) {
+            Ray ray(start, end);
+            if (ray.Intersects(scene.tree.GetFatAABB(p_proxy)) && ray.GetDist() < p_max_fraction) {
+                nearest = p_proxy;
+                return ray.GetDist();
+            }
+            return p_max_fraction;
+        });
+        benchmark::DoNotOptimize(nearest);
+    }
+}
+BENCHMARK(BM_DynamicAabbTree_RayCast)->Unit(benchmark::kMicrosecond);
+
+static void BM_LinearScan_RayCast(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchTreeScene& scene = BenchTreeScene::Get();
+    const Vector3f start(-1000.0f, 10.0f, -3.0f);
+    const Vector3f end(1000.0f, 20.0f, 5.0f);
+    for (auto _ : p_state) {
+        Ray ray(start, end);
+        int nearest = -1;
+        for (int i = 0; i < TREE_OBJECT_COUNT; ++i) {
+            if (ray.Intersects(scene.boxes[i])) {
+                nearest = i;
+            }
+        }
+        benchmark::DoNotOptimize(nearest);
+    }
+}
+BENCHMARK(BM_LinearScan_RayCast)->Unit(benchmark::kMicrosecond);
+
+}  // namespace cave
@@ -0,0 +1,69 @@
+#include "engine/math/aabb.h"
+#include "engine/math/frustum.h"
+#include "engine/math/matrix_transform.h"
+#include "math.bench.h"
+
+namespace cave {
+
+static Matrix4x4f BenchCameraMatrix() {
+    const Matrix4x4f view = LookAtRh(Vector3f(0.0f, 10.0f, 50.0f), Vector3f(0.0f), Vector3f(0.0f, 1.0f, 0.0f));
+    const Matrix4x4f projection = BuildPerspectiveRH(Degree(60.0f).GetRadians(), 16.0f / 9.0f, 0.1f, 200.0f);
+    return projection * view;
+}
+
+static void BM_FrustumConstruct(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<Frustum> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = Frustum(m[i]);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_FrustumConstruct);
+
+static void BM_FrustumCullAabb_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const Frustum frustum(BenchCameraMatrix());
+    const auto boxes = BenchGenerate<AABB>([]() {
+        return AABB::FromCenterSize(BenchRandomVector3f(), BenchRandomVector3f(0.5f, 5.0f));
+    });
+    int visible = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        visible += frustum.Intersects(boxes[i]);
+    });
+    benchmark::DoNotOptimize(visible);
+}
+BENCHMARK(BM_FrustumCullAabb_Engine);
+
+static void BM_FrustumCullAabb_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const Frustum frustum(BenchCameraMatrix());
+    glm::vec4 planes[6];
+    for (int i = 0; i < 6; ++i) {
+        planes[i] = glm::vec4(ToGlm(frustum[i].normal), frustum[i].dist);
+    }
+
+    std::vector<glm::vec3> box_min, box_max;
+    for (const AABB& box : BenchGenerate<AABB>([]() {
+             return AABB::FromCenterSize(BenchRandomVector3f(), BenchRandomVector3f(0.5f, 5.0f));
+         })) {
+        box_min.emplace_back(ToGlm(box.GetMin()));
+        box_max.emplace_back(ToGlm(box.GetMax()));
+    }
+
+    int visible = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        bool inside = true;
+        for (int j = 0; j < 6 && inside; ++j) {
+            const glm::vec3 normal(planes[j]);
+            const glm::vec3 p = glm::mix(box_min[i], box_max[i], glm::greaterThan(normal, glm::vec3(0.0f)));
+            inside = glm::dot(normal, p) + planes[j].w >= 0.0f;
+        }
+        visible += inside;
+    });
+    benchmark::DoNotOptimize(visible);
+}
+BENCHMARK(BM_FrustumCullAabb_Glm);
+
+}  // namespace cave
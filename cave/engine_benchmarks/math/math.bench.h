@@ -0,0 +1,112 @@
+#pragma once
+#include "engine/math/geomath.h"
+#include "engine/math/vector.h"
+
+namespace cave {
+
+// Number of elements processed per benchmark iteration. Large enough to amortize the loop
+// overhead, small enough to keep the working set in L1/L2.
+constexpr int MATH_BENCH_COUNT = 4096;
+
+// Every benchmark declares one first, the random data is drawn from a fresh engine with a fixed
+// seed so the engine and glm variants of a benchmark see exactly the same data, whatever ran
+// before them.
+class BenchRandomScope {
+public:
+    BenchRandomScope()
+        : m_engine(0xCAFE), m_previous(s_current) {
+        s_current = this;
+    }
+
+    ~BenchRandomScope() { s_current = m_previous; }
+
+    BenchRandomScope(const BenchRandomScope&) = delete;
+    BenchRandomScope& operator=(const BenchRandomScope&) = delete;
+
+    static std::mt19937& Engine() {
+        DEV_ASSERT(s_current);
+        return s_current->m_engine;
+    }
+
+private:
+    std::mt19937 m_engine;
+    BenchRandomScope* m_previous;
+
+    static inline thread_local BenchRandomScope* s_current = nullptr;
+};
+
+inline std::mt19937& BenchRandomEngine() {
+    return BenchRandomScope::Engine();
+}
+
+inline float BenchRandomFloat(float p_min = -100.0f, float p_max = 100.0f) {
+    std::uniform_real_distribution<float> dist(p_min, p_max);
+    return dist(BenchRandomEngine());
+}
+
+inline Vector3f BenchRandomVector3f(float p_min = -100.0f, float p_max = 100.0f) {
+    return Vector3f(BenchRandomFloat(p_min, p_max),
+                    BenchRandomFloat(p_min, p_max),
+                    BenchRandomFloat(p_min, p_max));
+}
+
+inline Vector4f BenchRandomVector4f(float p_min = -100.0f, float p_max = 100.0f) {
+    return Vector4f(BenchRandomFloat(p_min, p_max),
+                    BenchRandomFloat(p_min, p_max),
+                    BenchRandomFloat(p_min, p_max),
+                    BenchRandomFloat(p_min, p_max));
+}
+
+inline Matrix4x4f BenchRandomMatrix() {
+    const glm::vec3 translation(BenchRandomFloat(), BenchRandomFloat(), BenchRandomFloat());
+    const glm::vec3 axis = glm::normalize(glm::vec3(BenchRandomFloat(0.1f, 1.0f),
+                                                    BenchRandomFloat(0.1f, 1.0f),
+                                                    BenchRandomFloat(0.1f, 1.0f)));
+    const float angle = BenchRandomFloat(0.0f, glm::two_pi<float>());
+    const glm::vec3 scale(BenchRandomFloat(0.5f, 2.0f));
+    const glm::mat4 identity(1.0f);
+    return glm::translate(identity, translation) * glm::rotate(identity, angle, axis) * glm::scale(identity, scale);
+}
+
+template<typename T, typename FUNC>
+inline std::vector<T> BenchGenerate(FUNC&& p_func, int p_count = MATH_BENCH_COUNT) {
+    std::vector<T> result;
+    result.reserve(p_count);
+    for (int i = 0; i < p_count; ++i) {
+        result.emplace_back(p_func());
+    }
+    return result;
+}
+
+inline glm::vec3 ToGlm(const Vector3f& p_vec) {
+    return glm::vec3(p_vec.x, p_vec.y, p_vec.z);
+}
+
+inline glm::vec4 ToGlm(const Vector4f& p_vec) {
+    return glm::vec4(p_vec.x, p_vec.y, p_vec.z, p_vec.w);
+}
+
+template<typename SRC>
+inline auto ToGlm(const std::vector<SRC>& p_vector) {
+    using DST = decltype(ToGlm(p_vector[0]));
+    std::vector<DST> result;
+    result.reserve(p_vector.size());
+    for (const auto& value : p_vector) {
+        result.emplace_back(ToGlm(value));
+    }
+    return result;
+}
+
+// Runs p_func(i) for every element each iteration and reports element throughput.
+template<typename FUNC>
+inline void RunElementBenchmark(benchmark::State& p_state, int p_count, FUNC&& p_func) {
+    for (auto _ : p_state) {
+        for (int i = 0; i < p_count; ++i) {
+            p_func(i);
+        }
+        benchmark::ClobberMemory();
+    }
+    p_state.SetItemsProcessed(p_state.iterations() * p_count);
+}
+
+}  // namespace cave
@@ -0,0 +1,135 @@
+#include "engine/math/matrix_transform.h"
+#include "math.bench.h"
+
+namespace cave {
+
+static void BM_MatrixMulVector4_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    const auto v = BenchGenerate<Vector4f>([]() { return BenchRandomVector4f(); });
+    std::vector<Vector4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = m[i] * v[i];
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixMulVector4_Engine);
+
+static void BM_MatrixMulVector4_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    const auto v = ToGlm(BenchGenerate<Vector4f>([]() { return BenchRandomVector4f(); }));
+    std::vector<glm::vec4> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = m[i] * v[i];
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixMulVector4_Glm);
+
+static void BM_MatrixMulMatrix(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto a = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    const auto b = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<Matrix4x4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = a[i] * b[i];
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixMulMatrix);
+
+static void BM_MatrixInverse(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<Matrix4x4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = glm::inverse(m[i]);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixInverse);
+
+static void BM_MatrixLookAt_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto eye = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); });
+    const auto center = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); });
+    const Vector3f up(0.0f, 1.0f, 0.0f);
+    std::vector<Matrix4x4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = LookAtRh(eye[i], center[i], up);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixLookAt_Engine);
+
+static void BM_MatrixLookAt_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto eye = ToGlm(BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); }));
+    const auto center = ToGlm(BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); }));
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+    std::vector<Matrix4x4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = glm::lookAtRH(eye[i], center[i], up);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixLookAt_Glm);
+
+static void BM_MatrixCompose_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto t = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); });
+    const auto s = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(0.5f, 2.0f); });
+    const Vector3f axis = normalize(Vector3f(1.0f, 2.0f, 3.0f));
+    std::vector<Matrix4x4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = Translate(t[i]) * Rotate(Radian(static_cast<float>(i)), axis) * Scale(s[i]);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixCompose_Engine);
+
+static void BM_MatrixCompose_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto t = ToGlm(BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); }));
+    const auto s = ToGlm(BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(0.5f, 2.0f); }));
+    const glm::vec3 axis = glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f));
+    const glm::mat4 identity(1.0f);
+    std::vector<Matrix4x4f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        out[i] = glm::translate(identity, t[i]) * glm::rotate(identity, static_cast<float>(i), axis) * glm::scale(identity, s[i]);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixCompose_Glm);
+
+static void BM_MatrixDecompose_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<Vector3f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        Vector3f scale, translation;
+        Vector4f rotation;
+        Decompose(m[i], scale, rotation, translation);
+        out[i] = translation;
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixDecompose_Engine);
+
+static void BM_MatrixDecompose_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto m = BenchGenerate<Matrix4x4f>([]() { return BenchRandomMatrix(); });
+    std::vector<glm::vec3> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        glm::vec3 scale, translation, skew;
+        glm::vec4 perspective;
+        glm::quat rotation;
+        glm::decompose(m[i], scale, rotation, translation, skew, perspective);
+        out[i] = translation;
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_MatrixDecompose_Glm);
+
+}  // namespace cave
@@ -0,0 +1,101 @@
+#include "engine/math/aabb.h"
+#include "engine/math/ray.h"
+#include "math.bench.h"
+
+WARNING_PUSH()
+WARNING_DISABLE(4201, "-Wunused-parameter")
+#include <glm/gtx/intersect.hpp>
+WARNING_POP()
+
+namespace cave {
+
+struct BenchRayData {
+    std::vector<Vector3f> start;
+    std::vector<Vector3f> end;
+    std::vector<Vector3f> a;
+    std::vector<Vector3f> b;
+    std::vector<Vector3f> c;
+    std::vector<AABB> boxes;
+
+    BenchRayData() {
+        start = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); });
+        end = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); });
+        a = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(-10.0f, 10.0f); });
+        b = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(-10.0f, 10.0f); });
+        c = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(-10.0f, 10.0f); });
+        boxes = BenchGenerate<AABB>([]() {
+            return AABB::FromCenterSize(BenchRandomVector3f(-20.0f, 20.0f), BenchRandomVector3f(1.0f, 20.0f));
+        });
+    }
+};
+
+static void BM_RayAabb_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchRayData data;
+    int hits = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        Ray ray(data.start[i], data.end[i]);
+        hits += ray.Intersects(data.boxes[i]);
+    });
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(BM_RayAabb_Engine);
+
+static void BM_RayAabb_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchRayData data;
+    const auto start = ToGlm(data.start);
+    const auto end = ToGlm(data.end);
+    std::vector<glm::vec3> box_min, box_max;
+    for (const AABB& box : data.boxes) {
+        box_min.emplace_back(ToGlm(box.GetMin()));
+        box_max.emplace_back(ToGlm(box.GetMax()));
+    }
+
+    int hits = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        const glm::vec3 inv_d = 1.0f / (end[i] - start[i]);
+        const glm::vec3 t0 = (box_min[i] - start[i]) * inv_d;
+        const glm::vec3 t1 = (box_max[i] - start[i]) * inv_d;
+        const glm::vec3 t_small = glm::min(t0, t1);
+        const glm::vec3 t_big = glm::max(t0, t1);
+        const float t_min = glm::max(t_small.x, glm::max(t_small.y, t_small.z));
+        const float t_max = glm::min(t_big.x, glm::min(t_big.y, t_big.z));
+        hits += t_min < t_max && t_min > 0.0f && t_min < 1.0f;
+    });
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(BM_RayAabb_Glm);
+
+static void BM_RayTriangle_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchRayData data;
+    int hits = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        Ray ray(data.start[i], data.end[i]);
+        hits += ray.Intersects(data.a[i], data.b[i], data.c[i]);
+    });
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(BM_RayTriangle_Engine);
+
+static void BM_RayTriangle_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const BenchRayData data;
+    const auto start = ToGlm(data.start);
+    const auto end = ToGlm(data.end);
+    const auto a = ToGlm(data.a);
+    const auto b = ToGlm(data.b);
+    const auto c = ToGlm(data.c);
+    int hits = 0;
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        glm::vec2 barycentric;
+        float distance;
+        const glm::vec3 direction = end[i] - start[i];
+        hits += glm::intersectRayTriangle(start[i], direction, a[i], b[i], c[i], barycentric, distance) && distance < 1.0f;
+    });
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(BM_RayTriangle_Glm);
+
+}  // namespace cave
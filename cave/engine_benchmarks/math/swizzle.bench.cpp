@@ -0,0 +1,55 @@
+#include "math.bench.h"
+
+namespace cave {
+
+static void BM_SwizzleRead_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    auto a = BenchGenerate<Vector4f>([]() { return BenchRandomVector4f(); });
+    std::vector<Vector3f> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        Vector3f zyx = a[i].zyx;
+        Vector2f xy = a[i].xy;
+        out[i] = zyx + Vector3f(xy, 0.0f);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_SwizzleRead_Engine);
+
+static void BM_SwizzleRead_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    const auto a = ToGlm(BenchGenerate<Vector4f>([]() { return BenchRandomVector4f(); }));
+    std::vector<glm::vec3> out(MATH_BENCH_COUNT);
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        glm::vec3 zyx(a[i].z, a[i].y, a[i].x);
+        glm::vec2 xy(a[i].x, a[i].y);
+        out[i] = zyx + glm::vec3(xy, 0.0f);
+    });
+    benchmark::DoNotOptimize(out.data());
+}
+BENCHMARK(BM_SwizzleRead_Glm);
+
+static void BM_SwizzleWrite_Engine(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    auto a = BenchGenerate<Vector4f>([]() { return BenchRandomVector4f(); });
+    const auto b = BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); });
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        a[i].zyx = b[i];
+    });
+    benchmark::DoNotOptimize(a.data());
+}
+BENCHMARK(BM_SwizzleWrite_Engine);
+
+static void BM_SwizzleWrite_Glm(benchmark::State& p_state) {
+    const BenchRandomScope random_scope;
+    auto a = ToGlm(BenchGenerate<Vector4f>([]() { return BenchRandomVector4f(); }));
+    const auto b = ToGlm(BenchGenerate<Vector3f>([]() { return BenchRandomVector3f(); }));
+    RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {
+        a[i].z = b[i].x;
+        a[i].y = b[i].y;
+        a[i].x = b[i].z;
+    });
+    benchmark::DoNotOptimize(a.data());
+}
+BENCHMARK(BM_SwizzleWrite_Glm);
+
+}  // namespace cave
@@ -0,0 +1,98 @@
+#include "math.bench.h"
+
+namespace cave {
+
+#define DEFINE_VECTOR_BINARY_BENCH(NAME, VEC, OP)                                      \
+    static void BM_##NAME##_Engine(benchmark::State& p_state) {                        \
+        const BenchRandomScope random_scope;                                           \
+        const auto a = BenchGenerate<VEC>([]() { return BenchRandom##VEC(); });        \
+        const auto b = BenchGenerate<VEC>([]() { return BenchRandom##VEC(1.0f); });    \
+        std::vector<VEC> out(MATH_BENCH_COUNT);                                        \
+        RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {                    \
+            out[i] = OP(a[i], b[i]);                                                   \
+        });                                                                            \
+        benchmark::DoNotOptimize(out.data());                                          \
+    }                                                                                  \
+    BENCHMARK(BM_##NAME##_Engine);                                                     \
+    static void BM_##NAME##_Glm(benchmark::State& p_state) {                           \
+        const BenchRandomScope random_scope;                                           \
+        const auto a = ToGlm(BenchGenerate<VEC>([]() { return BenchRandom##VEC(); }));     \
+        const auto b = ToGlm(BenchGenerate<VEC>([]() { return BenchRandom##VEC(1.0f); })); \
+        std::remove_cvref_t<decltype(a)> out(MATH_BENCH_COUNT);                     \
+        RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {                    \
+            out[i] = OP(a[i], b[i]);                                                   \
+        });                                                                            \
+        benchmark::DoNotOptimize(out.data());                                          \
+    }                                                                                  \
+    BENCHMARK(BM_##NAME##_Glm)
+
+#define BENCH_ADD(A, B) ((A) + (B))
+#define BENCH_MUL(A, B) ((A) * (B))
+#define BENCH_DIV(A, B) ((A) / (B))
+#define BENCH_MADD(A, B) ((A) * (B) + (A))
+
+DEFINE_VECTOR_BINARY_BENCH(Vector3Add, Vector3f, BENCH_ADD);
+DEFINE_VECTOR_BINARY_BENCH(Vector3Mul, Vector3f, BENCH_MUL);
+DEFINE_VECTOR_BINARY_BENCH(Vector3Div, Vector3f, BENCH_DIV);
+DEFINE_VECTOR_BINARY_BENCH(Vector3Madd, Vector3f, BENCH_MADD);
+DEFINE_VECTOR_BINARY_BENCH(Vector4Add, Vector4f, BENCH_ADD);
+DEFINE_VECTOR_BINARY_BENCH(Vector4Mul, Vector4f, BENCH_MUL);
+DEFINE_VECTOR_BINARY_BENCH(Vector4Div, Vector4f, BENCH_DIV);
+DEFINE_VECTOR_BINARY_BENCH(Vector4Madd, Vector4f, BENCH_MADD);
+
+// engine and glm expose the same free function names, so the call site is shared and ADL picks
+// the implementation
+#define BENCH_MIN(A, B) min(A, B)
+#define BENCH_MAX(A, B) max(A, B)
+#define BENCH_CROSS(A, B) cross(A, B)
+
+using glm::cross;
+using glm::max;
+using glm::min;
+
+DEFINE_VECTOR_BINARY_BENCH(Vector3Min, Vector3f, BENCH_MIN);
+DEFINE_VECTOR_BINARY_BENCH(Vector3Max, Vector3f, BENCH_MAX);
+DEFINE_VECTOR_BINARY_BENCH(Vector3Cross, Vector3f, BENCH_CROSS);
+DEFINE_VECTOR_BINARY_BENCH(Vector4Min, Vector4f, BENCH_MIN);
+DEFINE_VECTOR_BINARY_BENCH(Vector4Max, Vector4f, BENCH_MAX);
+
+#define DEFINE_VECTOR_REDUCE_BENCH(NAME, VEC, EXPR)                                    \
+    static void BM_##NAME##_Engine(benchmark::State& p_state) {                        \
+        const BenchRandomScope random_scope;                                           \
+        const auto a = BenchGenerate<VEC>([]() { return BenchRandom##VEC(); });        \
+        const auto b = BenchGenerate<VEC>([]() { return BenchRandom##VEC(); });        \
+        float sum = 0.0f;                                                              \
+        RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {                    \
+            sum += EXPR(a[i], b[i]);                                                   \
+        });                                                                            \
+        benchmark::DoNotOptimize(sum);                                                 \
+    }                                                                                  \
+    BENCHMARK(BM_##NAME##_Engine);                                                     \
+    static void BM_##NAME##_Glm(benchmark::State& p_state) {                           \
+        const BenchRandomScope random_scope;                                           \
+        const auto a = ToGlm(BenchGenerate<VEC>([]() { return BenchRandom##VEC(); })); \
+        const auto b = ToGlm(BenchGenerate<VEC>([]() { return BenchRandom##VEC(); })); \
+        float sum = 0.0f;                                                              \
+        RunElementBenchmark(p_state, MATH_BENCH_COUNT, [&](int i) {                    \
+            sum += EXPR(a[i], b[i]);                                                   \
+        });                                                                            \
+        benchmark::DoNotOptimize(sum);                                                 \
+    }                                                                                  \
+    BENCHMARK(BM_##NAME##_Glm)
+
+#define BENCH_DOT(A, B)       dot(A, B)
+#define BENCH_LENGTH(A, B)    length((A) + (B))
+#define BENCH_NORMALIZE(A, B) normalize(A).x
+
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+DEFINE_VECTOR_REDUCE_BENCH(Vector3Dot, Vector3f, BENCH_DOT);
+DEFINE_VECTOR_REDUCE_BENCH(Vector3Length, Vector3f, BENCH_LENGTH);
+DEFINE_VECTOR_REDUCE_BENCH(Vector3Normalize, Vector3f, BENCH_NORMALIZE);
+DEFINE_VECTOR_REDUCE_BENCH(Vector4Dot, Vector4f, BENCH_DOT);
+DEFINE_VECTOR_REDUCE_BENCH(Vector4Length, Vector4f, BENCH_LENGTH);
+DEFINE_VECTOR_REDUCE_BENCH(Vector4Normalize, Vector4f, BENCH_NORMALIZE);
+
+}  // namespace cave
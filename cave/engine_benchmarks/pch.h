@@ -0,0 +1,5 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "engine/pch.h"
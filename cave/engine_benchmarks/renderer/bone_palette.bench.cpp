@@ -0,0 +1,49 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/bone_palette.h"
+
+namespace cave {
+
+static constexpr uint32_t CROWD_CHARACTER_COUNT = 200;
+static constexpr uint32_t CROWD_BONE_COUNT = 64;
+
+// 200 characters, range(0) percent of them animated every frame. Reports the bytes written to the
+// bone buffer per frame next to what uploading a full palette per character costs.
+static void BM_BonePalette_Crowd(benchmark::State& p_state) {
+    const uint32_t animated_count = CROWD_CHARACTER_COUNT * static_cast<uint32_t>(p_state.range(0)) / 100;
+
+    std::vector<std::vector<Matrix4x4f>> skeletons(CROWD_CHARACTER_COUNT);
+    for (auto& skeleton : skeletons) {
+        for (uint32_t bone = 0; bone < CROWD_BONE_COUNT; ++bone) {
+            skeleton.push_back(Translate(Vector3f(static_cast<float>(bone), 0.0f, 0.0f)));
+        }
+    }
+
+    BonePalette palette;
+    memory::ArenaVector<BonePalette::Upload> uploads;
+    memory::ArenaVector<Vector4f> rows;
+    float time = 0.0f;
+    size_t uploaded_bytes = 0;
+    for (auto _ : p_state) {
+        time += 1.0f;
+        for (uint32_t i = 0; i < animated_count; ++i) {
+            for (Matrix4x4f& bone : skeletons[i]) {
+                bone[3][1] = time;
+            }
+        }
+
+        uploads.clear();
+        rows.clear();
+        palette.BeginFrame();
+        for (uint32_t i = 0; i < CROWD_CHARACTER_COUNT; ++i) {
+            palette.Update(ecs::Entity(i + 1), skeletons[i].data(), CROWD_BONE_COUNT);
+        }
+        palette.EndFrame(uploads, rows);
+        uploaded_bytes += rows.size() * sizeof(Vector4f);
+    }
+
+    p_state.counters["upload_kb"] = uploaded_bytes / 1024.0 / p_state.iterations();
+    p_state.counters["full_kb"] = CROWD_CHARACTER_COUNT * MAX_BONE_COUNT * sizeof(Matrix4x4f) / 1024.0;
+}
+BENCHMARK(BM_BonePalette_Crowd)->Arg(0)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+}  // namespace cave
@@ -0,0 +1,75 @@
+#include "engine/renderer/frame_data.h"
+
+namespace cave {
+
+static constexpr int BENCH_ENTITY_COUNT = 100000;
+
+// the cache the renderer used before the sparse pages, kept as a reference
+struct HashBufferCache {
+    std::vector<PerBatchConstantBuffer> buffer;
+    std::unordered_map<ecs::Entity, uint32_t> lookup;
+
+    uint32_t FindOrAdd(ecs::Entity p_entity, const PerBatchConstantBuffer& p_buffer) {
+        auto it = lookup.find(p_entity);
+        if (it != lookup.end()) {
+            return it->second;
+        }
+
+        uint32_t index = static_cast<uint32_t>(buffer.size());
+        lookup[p_entity] = index;
+        buffer.emplace_back(p_buffer);
+        return index;
+    }
+
+    void Clear() {
+        buffer.clear();
+        lookup.clear();
+    }
+};
+
+// One frame: every entity is added once, then looked up again by a second pass, like the shadow
+// and main passes sharing batches. The caches live across frames like the recycled frame data.
+template<typename CACHE>
+static void RunBufferCacheBenchmark(benchmark::State& p_state, bool p_new_cache_each_frame) {
+    std::vector<ecs::Entity> entities;
+    for (int i = 0; i < BENCH_ENTITY_COUNT; ++i) {
+        entities.emplace_back(static_cast<uint32_t>(i + 1));
+    }
+
+    PerBatchConstantBuffer batch{};
+    auto cache = std::make_unique<CACHE>();
+    uint64_t sum = 0;
+    for (auto _ : p_state) {
+        if (p_new_cache_each_frame) {
+            cache = std::make_unique<CACHE>();
+        } else {
+            cache->Clear();
+        }
+
+        for (ecs::Entity entity : entities) {
+            sum += cache->FindOrAdd(entity, batch);
+        }
+        for (ecs::Entity entity : entities) {
+            sum += cache->FindOrAdd(entity, batch);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    p_state.SetItemsProcessed(p_state.iterations() * BENCH_ENTITY_COUNT * 2);
+}
+
+static void BM_BufferCache_HashMap_NewFrame(benchmark::State& p_state) {
+    RunBufferCacheBenchmark<HashBufferCache>(p_state, true);
+}
+BENCHMARK(BM_BufferCache_HashMap_NewFrame)->Unit(benchmark::kMillisecond);
+
+static void BM_BufferCache_HashMap(benchmark::State& p_state) {
+    RunBufferCacheBenchmark<HashBufferCache>(p_state, false);
+}
+BENCHMARK(BM_BufferCache_HashMap)->Unit(benchmark::kMillisecond);
+
+static void BM_BufferCache_Sparse(benchmark::State& p_state) {
+    RunBufferCacheBenchmark<BufferCache<PerBatchConstantBuffer>>(p_state, false);
+}
+BENCHMARK(BM_BufferCache_Sparse)->Unit(benchmark::kMillisecond);
+
+}  // namespace cave
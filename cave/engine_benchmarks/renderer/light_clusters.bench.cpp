@@ -0,0 +1,80 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/light_clusters.h"
+
+namespace cave {
+
+static constexpr float BENCH_CLUSTER_NEAR = 0.1f;
+static constexpr float BENCH_CLUSTER_FAR = 500.0f;
+
+// Lights of 1 to 10 units scattered over a 400 x 400 yard the camera looks into.
+struct BenchLightScene {
+    std::vector<GpuPointLight> lights;
+    Matrix4x4f view;
+    Matrix4x4f projection;
+
+    BenchLightScene() {
+        std::mt19937 engine(0xC1u);
+        auto random = [&](float p_min, float p_max) { return std::uniform_real_distribution<float>(p_min, p_max)(engine); };
+
+        for (int i = 0; i < MAX_CLUSTERED_LIGHT_COUNT; ++i) {
+            GpuPointLight light{};
+            light.position = Vector3f(random(-200.0f, 200.0f), random(0.0f, 10.0f), random(-400.0f, 0.0f));
+            light.max_distance = random(1.0f, 10.0f);
+            lights.push_back(light);
+        }
+
+        view = LookAtRh(Vector3f(0.0f, 5.0f, 10.0f), Vector3f(0.0f, 2.0f, -100.0f), Vector3f::UnitY);
+        projection = BuildPerspectiveRH(Degree(60.0f).GetRadians(), 16.0f / 9.0f, BENCH_CLUSTER_NEAR, BENCH_CLUSTER_FAR);
+    }
+
+    static const BenchLightScene& Get() {
+        static BenchLightScene s_scene;
+        return s_scene;
+    }
+};
+
+static void BM_LightClusters_Build(benchmark::State& p_state) {
+    const BenchLightScene& scene = BenchLightScene::Get();
+    const auto lights = std::span<const GpuPointLight>(scene.lights).first(p_state.range(0));
+
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    for (auto _ : p_state) {
+        builder.Build(scene.view, scene.projection, BENCH_CLUSTER_NEAR, BENCH_CLUSTER_FAR, lights, clusters, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    p_state.counters["visible"] = builder.GetStats().visible_light_count;
+    p_state.counters["indices"] = builder.GetStats().index_count;
+}
+BENCHMARK(BM_LightClusters_Build)->Arg(256)->Arg(1024)->Arg(MAX_CLUSTERED_LIGHT_COUNT)->Unit(benchmark::kMicrosecond);
+
+// every light against every cluster, what the builder replaces
+static void BM_LightClusters_BruteForce(benchmark::State& p_state) {
+    const BenchLightScene& scene = BenchLightScene::Get();
+    const auto lights = std::span<const GpuPointLight>(scene.lights).first(p_state.range(0));
+
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    builder.Build(scene.view, scene.projection, BENCH_CLUSTER_NEAR, BENCH_CLUSTER_FAR, {}, clusters, indices);
+
+    std::vector<Vector3f> centers;
+    for (const GpuPointLight& light : lights) {
+        centers.push_back((scene.view * Vector4f(light.position, 1.0f)).xyz);
+    }
+
+    for (auto _ : p_state) {
+        indices.clear();
+        for (int cluster = 0; cluster < LIGHT_CLUSTER_COUNT; ++cluster) {
+            for (uint32_t light_idx = 0; light_idx < lights.size(); ++light_idx) {
+                if (builder.Intersects(cluster, centers[light_idx], lights[light_idx].max_distance)) {
+                    indices.push_back(light_idx);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(indices.data());
+    }
+    p_state.counters["indices"] = static_cast<double>(indices.size());
+}
+BENCHMARK(BM_LightClusters_BruteForce)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+}  // namespace cave
@@ -0,0 +1,25 @@
+#include "mesh_scene.bench.h"
+
+namespace cave {
+
+static void BM_MeshRenderSystem(benchmark::State& p_state) {
+    const int object_count = static_cast<int>(p_state.range(0));
+    BenchMeshScene bench(object_count);
+
+    // recycled each frame, like the render system does
+    FrameData framedata(RenderOptions{});
+    size_t command_count = 0;
+    for (auto _ : p_state) {
+        framedata.Reset(RenderOptions{});
+        framedata.mainCamera = bench.camera;
+        RunMeshRenderSystem(&bench.scene, &bench.scene_state, framedata);
+        command_count = framedata.gbuffer_commands.GetSize();
+        benchmark::DoNotOptimize(command_count);
+    }
+
+    p_state.counters["gbuffer_commands"] = static_cast<double>(command_count);
+    p_state.SetItemsProcessed(p_state.iterations() * object_count);
+}
+BENCHMARK(BM_MeshRenderSystem)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+}  // namespace cave
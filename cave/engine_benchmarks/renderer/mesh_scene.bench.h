@@ -0,0 +1,79 @@
+#pragma once
+#include "engine/assets/mesh_asset.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/scene_render_state.h"
+#include "engine/runtime/asset_registry.h"
+#include "engine/scene/scene.h"
+
+namespace cave {
+
+extern void RunMeshRenderSystem(Scene* p_scene, SceneRenderState* p_state, FrameData& p_framedata);
+
+// Meshes on a grid in front of the camera, all of them inside the view and the shadow frustum.
+struct BenchMeshScene {
+    static constexpr int MESH_ASSET_COUNT = 16;
+    static constexpr int MATERIAL_COUNT = 64;
+
+    // declared first, the mesh renderers resolve their assets through it
+    AssetRegistry registry;
+    Scene scene;
+    SceneRenderState scene_state;
+    FrameData::Camera camera{};
+
+    explicit BenchMeshScene(int p_object_count) {
+        std::vector<Guid> mesh_guids;
+        for (int i = 0; i < MESH_ASSET_COUNT; ++i) {
+            auto mesh = std::make_shared<MeshAsset>();
+            mesh->localBound = AABB::FromCenterSize(Vector3f(0.0f), Vector3f(1.0f));
+            mesh->indices.resize(36);
+            mesh->gpuResource = std::make_shared<GpuMesh>();
+            for (uint32_t subset_idx = 0; subset_idx < 2; ++subset_idx) {
+                auto& subset = mesh->subsets.emplace_back();
+                subset.index_offset = subset_idx * 18;
+                subset.index_count = 18;
+                subset.local_bound = mesh->localBound;
+            }
+
+            AssetMetaData meta;
+            meta.type = AssetType::Mesh;
+            meta.guid = Guid::Create();
+            meta.import_path = std::format("@bench/mesh_{}", i);
+            mesh_guids.push_back(meta.guid);
+            registry.RegisterAsset(std::move(meta), mesh);
+        }
+
+        std::vector<ecs::Entity> materials;
+        for (int i = 0; i < MATERIAL_COUNT; ++i) {
+            auto id = scene.CreateEntity();
+            scene.Create<MaterialComponent>(id);
+            materials.push_back(id);
+        }
+
+        const int row = static_cast<int>(glm::ceil(glm::sqrt(static_cast<float>(p_object_count))));
+        for (int i = 0; i < p_object_count; ++i) {
+            auto id = scene.CreateEntity();
+            TransformComponent& transform = scene.Create<TransformComponent>(id);
+            transform.SetWorldMatrix(Translate(Vector3f(2.0f * (i % row - row / 2), 0.0f, -2.0f * (i / row))));
+
+            MeshRendererComponent& renderer = scene.Create<MeshRendererComponent>(id);
+            renderer.SetResourceGuid(mesh_guids[i % MESH_ASSET_COUNT]);
+            renderer.AddMaterial(materials[i % MATERIAL_COUNT]);
+            renderer.AddMaterial(materials[(i + 1) % MATERIAL_COUNT]);
+        }
+        scene.m_bound = AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -static_cast<float>(row)), Vector3f(2.0f * row));
+
+        auto light_id = scene.CreateEntity();
+        scene.Create<TransformComponent>(light_id);
+        scene.Create<MaterialComponent>(light_id);
+        scene.Create<LightComponent>(light_id).SetCastShadow();
+
+        camera.position = Vector3f(0.0f, 2.0f * row, 2.0f);
+        camera.front = normalize(Vector3f(0.0f, -1.0f, -1.0f));
+        camera.viewMatrix = LookAtRh(camera.position, camera.position + camera.front, Vector3f::UnitY);
+        camera.projectionMatrixFrustum = BuildPerspectiveRH(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 8.0f * row);
+        camera.projectionMatrixRendering = camera.projectionMatrixFrustum;
+    }
+};
+
+}  // namespace cave
@@ -0,0 +1,87 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/occlusion_culler.h"
+
+namespace cave {
+
+static constexpr int OCCLUSION_BUILDING_COUNT = 300;
+static constexpr int OCCLUSION_OBJECT_COUNT = 100000;
+
+// Buildings of 12 triangles lining a street the camera looks down, props of 1 to 3 units spread
+// around and behind them.
+struct BenchOcclusionScene {
+    std::vector<Vector3f> positions;
+    std::vector<uint32_t> indices;
+    std::vector<Matrix4x4f> buildings;
+    std::vector<AABB> objects;
+    Matrix4x4f view_projection;
+
+    BenchOcclusionScene() {
+        std::mt19937 engine(0xCAFE);
+        auto random = [&](float p_min, float p_max) { return std::uniform_real_distribution<float>(p_min, p_max)(engine); };
+
+        for (int i = 0; i < 8; ++i) {
+            positions.emplace_back((i & 1) ? 0.5f : -0.5f, (i & 2) ? 1.0f : 0.0f, (i & 4) ? 0.5f : -0.5f);
+        }
+        indices = { 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+                    2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3 };
+
+        for (int i = 0; i < OCCLUSION_BUILDING_COUNT; ++i) {
+            const float side = (i & 1) ? 1.0f : -1.0f;
+            const Vector3f size(random(8.0f, 20.0f), random(10.0f, 60.0f), random(8.0f, 20.0f));
+            const Vector3f center(side * (12.0f + 0.5f * size.x), 0.0f, -10.0f - 3.0f * i);
+            buildings.push_back(Translate(center) * Scale(size));
+        }
+
+        for (int i = 0; i < OCCLUSION_OBJECT_COUNT; ++i) {
+            const Vector3f center(random(-200.0f, 200.0f), random(0.0f, 20.0f), random(-1000.0f, 0.0f));
+            objects.push_back(AABB::FromCenterSize(center, Vector3f(random(1.0f, 3.0f), random(1.0f, 3.0f), random(1.0f, 3.0f))));
+        }
+
+        const Matrix4x4f view = LookAtRh(Vector3f(0.0f, 2.0f, 0.0f), Vector3f(0.0f, 2.0f, -1.0f), Vector3f::UnitY);
+        view_projection = BuildPerspectiveRH(Degree(60.0f).GetRadians(), 16.0f / 9.0f, 0.1f, 1000.0f) * view;
+    }
+
+    void Rasterize(OcclusionCuller& p_culler) const {
+        p_culler.BeginFrame(view_projection);
+        for (const Matrix4x4f& building : buildings) {
+            p_culler.AddOccluder(building, positions, indices);
+        }
+        p_culler.Rasterize();
+    }
+
+    static const BenchOcclusionScene& Get() {
+        static BenchOcclusionScene s_scene;
+        return s_scene;
+    }
+};
+
+static void BM_OcclusionCuller_Rasterize(benchmark::State& p_state) {
+    const BenchOcclusionScene& scene = BenchOcclusionScene::Get();
+    OcclusionCuller culler;
+    for (auto _ : p_state) {
+        scene.Rasterize(culler);
+        benchmark::DoNotOptimize(culler.GetDepth(0, 0, 0));
+    }
+    p_state.counters["triangles"] = culler.GetStats().triangle_count;
+}
+BENCHMARK(BM_OcclusionCuller_Rasterize)->Unit(benchmark::kMicrosecond);
+
+static void BM_OcclusionCuller_IsOccluded(benchmark::State& p_state) {
+    const BenchOcclusionScene& scene = BenchOcclusionScene::Get();
+    OcclusionCuller culler;
+    scene.Rasterize(culler);
+
+    int culled = 0;
+    for (auto _ : p_state) {
+        culled = 0;
+        for (const AABB& object : scene.objects) {
+            culled += culler.IsOccluded(object);
+        }
+        benchmark::DoNotOptimize(culled);
+    }
+    p_state.counters["culled"] = culled;
+    p_state.SetItemsProcessed(p_state.iterations() * OCCLUSION_OBJECT_COUNT);
+}
+BENCHMARK(BM_OcclusionCuller_IsOccluded)->Unit(benchmark::kMicrosecond);
+
+}  // namespace cave
@@ -0,0 +1,107 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/render_graph/render_graph_defines.h"
+#include "engine/renderer/sampler.h"
+#include "engine_assets/primitive_meshes.h"
+#include "modules/sw/sw_renderer.h"
+
+namespace cave {
+
+static constexpr uint32_t SW_FRAME_WIDTH = 1920;
+static constexpr uint32_t SW_FRAME_HEIGHT = 1080;
+
+// The gbuffer pass of the 3D render graph at 1080p, the camera looks at a sphere of radius 0.5
+// that covers most of the screen.
+struct BenchSwGbuffer {
+    SwGraphicsManager manager;
+    std::shared_ptr<Framebuffer> framebuffer;
+    std::vector<std::shared_ptr<GpuConstantBuffer>> constants;
+    std::shared_ptr<GpuMesh> mesh;
+    uint32_t indexCount;
+
+    explicit BenchSwGbuffer(const MeshAsset& p_mesh)
+        : indexCount(static_cast<uint32_t>(p_mesh.indices.size())) {
+        auto create_target = [&](const char* p_name, AttachmentType p_type, PixelFormat p_format) {
+            GpuTextureDesc desc{};
+            desc.type = p_type;
+            desc.dimension = Dimension::TEXTURE_2D;
+            desc.width = SW_FRAME_WIDTH;
+            desc.height = SW_FRAME_HEIGHT;
+            desc.mipLevels = 1;
+            desc.arraySize = 1;
+            desc.format = p_format;
+            desc.name = p_name;
+            return manager.CreateTexture(desc, SamplerDesc());
+        };
+        framebuffer = manager.CreateFramebuffer(FramebufferDesc{
+            .colorAttachments = {
+                create_target(RG_RES_GBUFFER_COLOR0, AttachmentType::COLOR_2D, RT_FMT_GBUFFER_BASE_COLOR),
+                create_target(RG_RES_GBUFFER_COLOR1, AttachmentType::COLOR_2D, RT_FMT_GBUFFER_NORMAL),
+                create_target(RG_RES_GBUFFER_COLOR2, AttachmentType::COLOR_2D, RT_FMT_GBUFFER_MATERIAL),
+            },
+            .depthAttachment = create_target(RG_RES_DEPTH_STENCIL, AttachmentType::DEPTH_STENCIL_2D, RT_FMT_GBUFFER_DEPTH),
+        });
+
+        PerBatchConstantBuffer batch{};
+        batch.c_worldMatrix = Matrix4x4f(1.0f);
+        PerPassConstantBuffer pass{};
+        pass.c_viewMatrix = LookAtRh(Vector3f(0.0f, 0.0f, 1.5f), Vector3f::Zero, Vector3f::UnitY);
+        // near and far are swapped for reverse z
+        pass.c_projectionMatrix = BuildPerspectiveRH(Degree(45.0f).GetRadians(), 16.0f / 9.0f, 100.0f, 0.1f);
+        MaterialConstantBuffer material{};
+        material.c_baseColor = Vector4f(0.5f, 0.5f, 0.5f, 1.0f);
+        material.c_metallic = 0.2f;
+        material.c_roughness = 0.8f;
+        BindConstants(batch);
+        BindConstants(pass);
+        BindConstants(material);
+
+        mesh = *manager.CreateMesh(p_mesh);
+    }
+
+    template<typename BUFFER>
+    void BindConstants(const BUFFER& p_data) {
+        auto buffer = *manager.CreateConstantBuffer(GpuBufferDesc{
+            .type = GpuBufferType::CONSTANT,
+            .slot = BUFFER::GetUniformBufferSlot(),
+            .element_size = sizeof(BUFFER),
+            .element_count = 1,
+        });
+        manager.UpdateConstantBuffer(buffer.get(), &p_data, sizeof(BUFFER));
+        manager.BindConstantBufferRange(buffer.get(), sizeof(BUFFER), 0);
+        constants.push_back(buffer);
+    }
+
+    void Draw() {
+        manager.SetRenderTarget(framebuffer.get());
+        manager.Clear(framebuffer.get(), static_cast<ClearFlags>(CLEAR_COLOR_BIT | CLEAR_DEPTH_BIT), IGraphicsManager::DEFAULT_CLEAR_COLOR, 0.0f);
+        manager.SetPipelineState(PSO_GBUFFER);
+        manager.SetMesh(mesh.get());
+        manager.DrawElements(indexCount);
+    }
+};
+
+static void RunSwGbuffer(benchmark::State& p_state, const MeshAsset& p_mesh) {
+    BenchSwGbuffer bench(p_mesh);
+    for (auto _ : p_state) {
+        bench.Draw();
+        benchmark::ClobberMemory();
+    }
+    p_state.counters["triangles"] = static_cast<double>(bench.indexCount / 3);
+    p_state.SetItemsProcessed(p_state.iterations() * (bench.indexCount / 3));
+}
+
+// the sphere registered as the persistent asset "meshes/sphere"
+static void BM_SwRenderer_Sphere(benchmark::State& p_state) {
+    auto sphere = CreateSphereMesh(0.5f);
+    RunSwGbuffer(p_state, *sphere);
+}
+BENCHMARK(BM_SwRenderer_Sphere)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 500 rings of 1000 sectors, 1M triangles
+static void BM_SwRenderer_DenseSphere(benchmark::State& p_state) {
+    auto sphere = CreateSphereMesh(0.5f, 500, 1000);
+    RunSwGbuffer(p_state, *sphere);
+}
+BENCHMARK(BM_SwRenderer_DenseSphere)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace cave
@@ -0,0 +1,64 @@
+#include "engine/empty/empty_graphics_manager.h"
+#include "engine/render_graph/draw_commands.h"
+#include "engine/runtime/frame_pipeline.h"
+
+#include "../renderer/mesh_scene.bench.h"
+
+namespace cave {
+
+static constexpr int FRAME_BENCH_OBJECT_COUNT = 20000;
+static constexpr float FRAME_BENCH_TIMESTEP = 1.0f / 60.0f;
+
+static void SimulateFrame(BenchMeshScene& p_bench, FrameData& p_framedata) {
+    p_bench.scene.Update(FRAME_BENCH_TIMESTEP);
+    p_framedata.mainCamera = p_bench.camera;
+    RunMeshRenderSystem(&p_bench.scene, &p_bench.scene_state, p_framedata);
+}
+
+// the empty backend executes nothing, this measures the command submission the render thread takes over
+static void ExecuteFrameCommands(EmptyGraphicsManager& p_gm, const FrameData& p_framedata) {
+    ExecuteDrawCommands(p_gm, p_framedata, p_framedata.shadow_pass_commands);
+    ExecuteDrawCommands(p_gm, p_framedata, p_framedata.prepass_commands, true);
+    ExecuteDrawCommands(p_gm, p_framedata, p_framedata.gbuffer_commands);
+    ExecuteDrawCommands(p_gm, p_framedata, p_framedata.transparent_commands);
+    ExecuteDrawCommands(p_gm, p_framedata, p_framedata.voxelization_commands);
+}
+
+static void BM_FrameLoop_Serial(benchmark::State& p_state) {
+    BenchMeshScene bench(FRAME_BENCH_OBJECT_COUNT);
+    EmptyGraphicsManager gm;
+
+    FrameData framedata(RenderOptions{});
+    for (auto _ : p_state) {
+        framedata.Reset(RenderOptions{});
+        SimulateFrame(bench, framedata);
+        ExecuteFrameCommands(gm, framedata);
+    }
+
+    p_state.counters["draws"] = static_cast<double>(gm.GetStateChangeCounters().draw) / p_state.iterations();
+}
+BENCHMARK(BM_FrameLoop_Serial)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_FrameLoop_Pipelined(benchmark::State& p_state) {
+    BenchMeshScene bench(FRAME_BENCH_OBJECT_COUNT);
+    EmptyGraphicsManager gm;
+
+    FramePipeline pipeline;
+    pipeline.Start(static_cast<int>(p_state.range(0)), [&](const FrameData& p_framedata) {
+        ExecuteFrameCommands(gm, p_framedata);
+    });
+
+    for (auto _ : p_state) {
+        FrameData& framedata = pipeline.AcquireFrame(RenderOptions{});
+        SimulateFrame(bench, framedata);
+        pipeline.SubmitFrame();
+    }
+    pipeline.WaitIdle();
+    pipeline.Stop();
+
+    p_state.counters["draws"] = static_cast<double>(gm.GetStateChangeCounters().draw) / p_state.iterations();
+    p_state.counters["main_wait_ms"] = 1000.0 * pipeline.GetWaitTime() / p_state.iterations();
+}
+BENCHMARK(BM_FrameLoop_Pipelined)->Arg(2)->Arg(3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace cave
@@ -1,5 +1,8 @@
 #include <engine/algorithm/algorithm.h>
 
+#include <numeric>
+#include <random>
+
 namespace cave {
 
 TEST(topological_sort, test1) {
@@ -27,4 +30,43 @@ TEST(topological_sort, test2) {
     EXPECT_EQ(sorted[3], 3);
 }
 
+TEST(radix_sort_indices, matches_stable_sort) {
+    std::mt19937_64 engine(42);
+    std::vector<uint64_t> keys(5000);
+    for (uint64_t& key : keys) {
+        // few distinct values so stability matters
+        key = (engine() % 64) << 40 | (engine() % 4);
+    }
+
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<uint32_t> expected = order;
+    std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    std::vector<uint32_t> scratch;
+    RadixSortIndices(keys.data(), order, scratch);
+    EXPECT_EQ(order, expected);
+}
+
+TEST(radix_sort_indices, full_range_keys) {
+    std::vector<uint64_t> keys = { 0xFFFFFFFFFFFFFFFFull, 0, 0x8000000000000000ull, 1, 0x00FF00FF00FF00FFull };
+    std::vector<uint32_t> order = { 0, 1, 2, 3, 4 };
+    std::vector<uint32_t> scratch;
+    RadixSortIndices(keys.data(), order, scratch);
+
+    const std::vector<uint32_t> expected = { 1, 3, 4, 2, 0 };
+    EXPECT_EQ(order, expected);
+}
+
+TEST(radix_sort_indices, same_keys) {
+    std::vector<uint64_t> keys(16, 7);
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    const std::vector<uint32_t> expected = order;
+
+    std::vector<uint32_t> scratch;
+    RadixSortIndices(keys.data(), order, scratch);
+    EXPECT_EQ(order, expected);
+}
+
 }  // namespace cave
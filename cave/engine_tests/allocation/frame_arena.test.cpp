@@ -0,0 +1,115 @@
+#include "engine/assets/mesh_asset.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/scene_render_state.h"
+#include "engine/runtime/asset_registry.h"
+#include "engine/scene/scene.h"
+
+// counts heap allocations while enabled, replaces the global operator new of this executable only
+static std::atomic_bool s_countAllocations = false;
+static std::atomic_int s_allocationCount = 0;
+
+void* operator new(size_t p_size) {
+    if (s_countAllocations) {
+        ++s_allocationCount;
+    }
+    if (void* ptr = std::malloc(p_size ? p_size : 1); ptr) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p_ptr) noexcept {
+    std::free(p_ptr);
+}
+
+void operator delete(void* p_ptr, size_t) noexcept {
+    std::free(p_ptr);
+}
+
+namespace cave {
+
+extern void RunMeshRenderSystem(Scene* p_scene, SceneRenderState* p_state, FrameData& p_framedata);
+
+TEST(frame_arena, steady_state_has_no_heap_allocation) {
+    constexpr int OBJECT_COUNT = 2000;
+    constexpr int MATERIAL_COUNT = 8;
+
+    AssetRegistry registry;
+    auto mesh = std::make_shared<MeshAsset>();
+    mesh->localBound = AABB::FromCenterSize(Vector3f(0.0f), Vector3f(1.0f));
+    mesh->indices.resize(36);
+    mesh->gpuResource = std::make_shared<GpuMesh>();
+    auto& subset = mesh->subsets.emplace_back();
+    subset.index_count = 36;
+    subset.local_bound = mesh->localBound;
+
+    AssetMetaData meta;
+    meta.type = AssetType::Mesh;
+    meta.guid = Guid::Create();
+    meta.import_path = "@test/mesh";
+    const Guid mesh_guid = meta.guid;
+    registry.RegisterAsset(std::move(meta), mesh);
+
+    Scene scene;
+    SceneRenderState scene_state;
+    std::vector<ecs::Entity> materials;
+    for (int i = 0; i < MATERIAL_COUNT; ++i) {
+        auto id = scene.CreateEntity();
+        scene.Create<MaterialComponent>(id);
+        materials.push_back(id);
+    }
+
+    for (int i = 0; i < OBJECT_COUNT; ++i) {
+        auto id = scene.CreateEntity();
+        TransformComponent& transform = scene.Create<TransformComponent>(id);
+        transform.SetWorldMatrix(Translate(Vector3f(2.0f * (i % 50 - 25), 0.0f, -2.0f * (i / 50))));
+
+        MeshRendererComponent& renderer = scene.Create<MeshRendererComponent>(id);
+        renderer.SetResourceGuid(mesh_guid);
+        renderer.AddMaterial(materials[i % MATERIAL_COUNT]);
+    }
+    scene.m_bound = AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -40.0f), Vector3f(100.0f));
+
+    auto light_id = scene.CreateEntity();
+    scene.Create<TransformComponent>(light_id);
+    scene.Create<MaterialComponent>(light_id);
+    scene.Create<LightComponent>(light_id).SetCastShadow();
+
+    FrameData::Camera camera{};
+    camera.position = Vector3f(0.0f, 50.0f, 2.0f);
+    camera.front = normalize(Vector3f(0.0f, -1.0f, -1.0f));
+    camera.viewMatrix = LookAtRh(camera.position, camera.position + camera.front, Vector3f::UnitY);
+    camera.projectionMatrixFrustum = BuildPerspectiveRH(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    camera.projectionMatrixRendering = camera.projectionMatrixFrustum;
+
+    FrameData framedata(RenderOptions{});
+    auto run_frame = [&]() {
+        framedata.Reset(RenderOptions{});
+        framedata.mainCamera = camera;
+        RunMeshRenderSystem(&scene, &scene_state, framedata);
+        framedata.GetDebugDraw().AddBox2(Vector2f(0.0f), Vector2f(1.0f), Vector4f(1.0f));
+    };
+
+    // the first frames grow the containers and the persistent caches
+    for (int i = 0; i < 4; ++i) {
+        run_frame();
+    }
+    ASSERT_GT(framedata.gbuffer_commands.GetSize(), 0u);
+
+    s_allocationCount = 0;
+    s_countAllocations = true;
+    for (int i = 0; i < 16; ++i) {
+        run_frame();
+    }
+    s_countAllocations = false;
+
+    EXPECT_EQ(s_allocationCount.load(), 0);
+
+    const FrameData::ArenaStats stats = framedata.GetArenaStats();
+    EXPECT_EQ(stats.overflowCount, 0u);
+    EXPECT_GT(stats.lastFrameUsed, 0u);
+    EXPECT_LE(stats.lastFrameUsed, stats.highWaterMark);
+}
+
+}  // namespace cave
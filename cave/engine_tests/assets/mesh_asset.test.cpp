@@ -0,0 +1,67 @@
+#include "engine/assets/mesh_asset.h"
+
+#include "engine/core/io/archive.h"
+#include "engine/core/io/file_access_unix.h"
+
+namespace cave {
+
+static void FillLodMesh(MeshAsset& p_mesh) {
+    p_mesh.indices = { 0, 1, 2, 2, 3, 0 };
+    p_mesh.positions = { Vector3f(0.0f), Vector3f(1.0f, 0.0f, 0.0f), Vector3f(1.0f), Vector3f(0.0f, 1.0f, 0.0f) };
+    auto& subset = p_mesh.subsets.emplace_back();
+    subset.index_count = 6;
+    p_mesh.lods.push_back(MeshAsset::MeshLod{ 0, 3, 0.5f });
+    p_mesh.lod_subsets.emplace_back().index_count = 3;
+    p_mesh.lod_indices = { 0, 1, 2 };
+}
+
+TEST(mesh_asset, load_archive_with_lods) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const char* test_file = "mesh_asset_test_lods";
+
+    MeshAsset source;
+    FillLodMesh(source);
+    Archive writer;
+    ASSERT_TRUE(writer.OpenWrite(test_file));
+    writer.Write(MeshAsset::ARCHIVE_MAGIC);
+    writer.Write(static_cast<uint32_t>(MeshAsset::VERSION));
+    source.SerializeBinary(writer, MeshAsset::VERSION);
+    writer.Close();
+
+    AssetMetaData meta;
+    meta.import_path = test_file;
+    MeshAsset mesh;
+    ASSERT_TRUE(mesh.LoadFromDisk(meta));
+    EXPECT_EQ(mesh.indices, source.indices);
+    ASSERT_EQ(mesh.lods.size(), 1u);
+    EXPECT_EQ(mesh.lods[0].index_count, 3u);
+    EXPECT_EQ(mesh.lod_indices, source.lod_indices);
+
+    EXPECT_TRUE(std::filesystem::remove(test_file));
+}
+
+// archives written before the header have no levels
+TEST(mesh_asset, load_version_0_archive) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const char* test_file = "mesh_asset_test_version_0";
+
+    MeshAsset source;
+    FillLodMesh(source);
+    Archive writer;
+    ASSERT_TRUE(writer.OpenWrite(test_file));
+    source.SerializeBinary(writer, 0);
+    writer.Close();
+
+    AssetMetaData meta;
+    meta.import_path = test_file;
+    MeshAsset mesh;
+    ASSERT_TRUE(mesh.LoadFromDisk(meta));
+    EXPECT_EQ(mesh.indices, source.indices);
+    EXPECT_EQ(mesh.positions.size(), source.positions.size());
+    EXPECT_TRUE(mesh.lods.empty());
+    EXPECT_TRUE(mesh.lod_indices.empty());
+
+    EXPECT_TRUE(std::filesystem::remove(test_file));
+}
+
+}  // namespace cave
@@ -0,0 +1,220 @@
+#include "engine/assets/mesh_asset.h"
+#include "engine/assets/mesh_simplifier.h"
+
+namespace cave {
+
+// n x n quads on the unit square, y = 0
+static void BuildGrid(int p_n, std::vector<Vector3f>& p_positions, std::vector<uint32_t>& p_indices) {
+    for (int z = 0; z <= p_n; ++z) {
+        for (int x = 0; x <= p_n; ++x) {
+            p_positions.emplace_back(float(x) / p_n, 0.0f, float(z) / p_n);
+        }
+    }
+    for (int z = 0; z < p_n; ++z) {
+        for (int x = 0; x < p_n; ++x) {
+            const uint32_t a = z * (p_n + 1) + x;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + p_n + 1;
+            const uint32_t d = c + 1;
+            p_indices.insert(p_indices.end(), { a, c, b, b, c, d });
+        }
+    }
+}
+
+// subdivided icosahedron of radius 1, closed and welded
+static void BuildSphere(int p_subdivisions, std::vector<Vector3f>& p_positions, std::vector<uint32_t>& p_indices) {
+    const float t = 0.5f * (1.0f + glm::sqrt(5.0f));
+    const Vector3f corners[12] = {
+        { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+        { 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+        { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 },
+    };
+    for (const Vector3f& corner : corners) {
+        p_positions.push_back(normalize(corner));
+    }
+    p_indices = {
+        0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,
+        1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+        3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,
+        4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1
+    };
+
+    for (int level = 0; level < p_subdivisions; ++level) {
+        std::unordered_map<uint64_t, uint32_t> midpoints;
+        auto midpoint = [&](uint32_t p_a, uint32_t p_b) {
+            const uint64_t key = (uint64_t(glm::min(p_a, p_b)) << 32) | glm::max(p_a, p_b);
+            auto [it, inserted] = midpoints.try_emplace(key, static_cast<uint32_t>(p_positions.size()));
+            if (inserted) {
+                p_positions.push_back(normalize(p_positions[p_a] + p_positions[p_b]));
+            }
+            return it->second;
+        };
+
+        std::vector<uint32_t> indices;
+        for (size_t i = 0; i < p_indices.size(); i += 3) {
+            const uint32_t a = p_indices[i], b = p_indices[i + 1], c = p_indices[i + 2];
+            const uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            indices.insert(indices.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+        }
+        p_indices = std::move(indices);
+    }
+}
+
+static void ExpectValidTriangles(const std::vector<Vector3f>& p_positions, const std::vector<uint32_t>& p_indices) {
+    ASSERT_EQ(p_indices.size() % 3, 0u);
+    for (size_t i = 0; i < p_indices.size(); i += 3) {
+        ASSERT_LT(p_indices[i], p_positions.size());
+        ASSERT_LT(p_indices[i + 1], p_positions.size());
+        ASSERT_LT(p_indices[i + 2], p_positions.size());
+        EXPECT_NE(p_indices[i], p_indices[i + 1]);
+        EXPECT_NE(p_indices[i + 1], p_indices[i + 2]);
+        EXPECT_NE(p_indices[i], p_indices[i + 2]);
+    }
+}
+
+TEST(mesh_simplifier, flat_grid_keeps_its_border) {
+    std::vector<Vector3f> positions;
+    std::vector<uint32_t> indices;
+    BuildGrid(32, positions, indices);
+
+    const MeshSimplifier::Result result = MeshSimplifier::Simplify(positions, indices, 0, 0.01f);
+    ExpectValidTriangles(positions, result.indices);
+    EXPECT_LT(result.indices.size(), indices.size() / 8);
+    EXPECT_NEAR(result.error, 0.0f, 1e-4f);
+
+    // every triangle still faces up and together they cover the square
+    float area = 0.0f;
+    std::vector<bool> used(positions.size(), false);
+    for (size_t i = 0; i < result.indices.size(); i += 3) {
+        const Vector3f& a = positions[result.indices[i]];
+        const Vector3f normal = cross(positions[result.indices[i + 1]] - a, positions[result.indices[i + 2]] - a);
+        EXPECT_GT(normal.y, 0.0f);
+        area += 0.5f * normal.y;
+        used[result.indices[i]] = used[result.indices[i + 1]] = used[result.indices[i + 2]] = true;
+    }
+    EXPECT_NEAR(area, 1.0f, 1e-4f);
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const Vector3f& p = positions[i];
+        if (p.x == 0.0f || p.x == 1.0f || p.z == 0.0f || p.z == 1.0f) {
+            EXPECT_TRUE(used[i]);
+        }
+    }
+}
+
+TEST(mesh_simplifier, sphere_stays_closed) {
+    std::vector<Vector3f> positions;
+    std::vector<uint32_t> indices;
+    BuildSphere(4, positions, indices);
+
+    const uint32_t target = static_cast<uint32_t>(indices.size() / 4) / 3 * 3;
+    const MeshSimplifier::Result result = MeshSimplifier::Simplify(positions, indices, target, 0.1f);
+    ExpectValidTriangles(positions, result.indices);
+    EXPECT_LE(result.indices.size(), target);
+    EXPECT_GT(result.error, 0.0f);
+    EXPECT_LE(result.error, 0.1f);
+
+    // every edge is still shared by two triangles and the triangles face outwards
+    std::unordered_map<uint64_t, int> edge_counts;
+    for (size_t i = 0; i < result.indices.size(); i += 3) {
+        const Vector3f& a = positions[result.indices[i]];
+        const Vector3f& b = positions[result.indices[i + 1]];
+        const Vector3f& c = positions[result.indices[i + 2]];
+        EXPECT_GT(dot(cross(b - a, c - a), a + b + c), 0.0f);
+        for (int corner = 0; corner < 3; ++corner) {
+            const uint32_t from = result.indices[i + corner];
+            const uint32_t to = result.indices[i + (corner + 1) % 3];
+            ++edge_counts[(uint64_t(glm::min(from, to)) << 32) | glm::max(from, to)];
+        }
+    }
+    for (auto [edge, count] : edge_counts) {
+        EXPECT_EQ(count, 2);
+    }
+}
+
+TEST(mesh_simplifier, stops_at_the_error_limit) {
+    std::vector<Vector3f> positions;
+    std::vector<uint32_t> indices;
+    BuildSphere(3, positions, indices);
+
+    const MeshSimplifier::Result result = MeshSimplifier::Simplify(positions, indices, 0, 1e-4f);
+    EXPECT_EQ(result.indices.size(), indices.size());
+    EXPECT_EQ(result.error, 0.0f);
+}
+
+static void BuildSphereMesh(MeshAsset& p_mesh) {
+    BuildSphere(4, p_mesh.positions, p_mesh.indices);
+    MeshAsset::MeshSubset& subset = p_mesh.subsets.emplace_back();
+    subset.index_count = static_cast<uint32_t>(p_mesh.indices.size());
+    for (const Vector3f& position : p_mesh.positions) {
+        subset.local_bound.ExpandPoint(position);
+    }
+    p_mesh.localBound = subset.local_bound;
+}
+
+TEST(mesh_asset, lod_chain) {
+    MeshAsset mesh;
+    BuildSphereMesh(mesh);
+    mesh.GenerateLods();
+
+    ASSERT_FALSE(mesh.lods.empty());
+    ASSERT_EQ(mesh.lod_subsets.size(), mesh.lods.size());
+
+    uint32_t expected_offset = static_cast<uint32_t>(mesh.indices.size());
+    for (int lod = 1; lod <= static_cast<int>(mesh.lods.size()); ++lod) {
+        EXPECT_EQ(mesh.GetIndexOffset(lod), expected_offset);
+        EXPECT_EQ(mesh.GetSubset(lod, 0).index_offset, expected_offset);
+        EXPECT_EQ(mesh.GetSubset(lod, 0).index_count, mesh.GetIndexCount(lod));
+        EXPECT_LT(mesh.GetIndexCount(lod), mesh.GetIndexCount(lod - 1));
+        EXPECT_GE(mesh.lods[lod - 1].error, lod > 1 ? mesh.lods[lod - 2].error : 0.0f);
+        expected_offset += mesh.GetIndexCount(lod);
+
+        const uint32_t begin = mesh.GetIndexOffset(lod) - static_cast<uint32_t>(mesh.indices.size());
+        ExpectValidTriangles(mesh.positions, std::vector<uint32_t>(mesh.lod_indices.begin() + begin, mesh.lod_indices.begin() + begin + mesh.GetIndexCount(lod)));
+    }
+    EXPECT_EQ(expected_offset, mesh.indices.size() + mesh.lod_indices.size());
+
+    EXPECT_EQ(mesh.SelectLod(0.0f), 0);
+    EXPECT_EQ(mesh.SelectLod(1.0f), static_cast<int>(mesh.lods.size()));
+}
+
+TEST(mesh_asset, no_lods_for_small_meshes) {
+    MeshAsset mesh;
+    BuildSphere(1, mesh.positions, mesh.indices);
+    mesh.subsets.push_back({ 0, static_cast<uint32_t>(mesh.indices.size()), AABB() });
+    mesh.GenerateLods();
+
+    EXPECT_TRUE(mesh.lods.empty());
+    EXPECT_EQ(mesh.SelectLod(1.0f), 0);
+    EXPECT_EQ(mesh.GetIndexCount(0), mesh.indices.size());
+}
+
+// A field of spheres from 2 to 200 units away, with the selection of the mesh render system at
+// one pixel of error on a 1080p screen with a 60 degree field of view.
+TEST(mesh_asset, lod_scene_triangle_count) {
+    MeshAsset mesh;
+    BuildSphereMesh(mesh);
+    mesh.GenerateLods();
+
+    const float cot_half_fovy = 1.0f / glm::tan(glm::radians(30.0f));
+    const float lod_error_scale = 1.0f / (0.5f * 1080.0f);
+
+    uint32_t full_triangle_count = 0;
+    uint32_t drawn_triangle_count = 0;
+    int level_counts[MeshAsset::MAX_LOD_COUNT + 1] = {};
+    for (int i = 0; i < 100; ++i) {
+        const float distance = 2.0f + 198.0f * i / 99.0f;
+        const float screen_size = cot_half_fovy / distance;
+        const int lod = mesh.SelectLod(lod_error_scale / screen_size);
+        ++level_counts[lod];
+        full_triangle_count += mesh.GetIndexCount(0) / 3;
+        drawn_triangle_count += mesh.GetIndexCount(lod) / 3;
+    }
+
+    // close spheres keep every triangle, most of the field is far enough for the coarsest level
+    EXPECT_GT(level_counts[0], 0);
+    EXPECT_GT(level_counts[mesh.lods.size()], 50);
+    EXPECT_LT(drawn_triangle_count, full_triangle_count / 4);
+}
+
+}  // namespace cave
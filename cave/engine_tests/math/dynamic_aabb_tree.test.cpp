@@ -0,0 +1,169 @@
+#include "engine/math/dynamic_aabb_tree.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/math/ray.h"
+
+namespace cave {
+
+struct TreeObject {
+    AABB aabb;
+    int proxy;
+};
+
+static AABB RandomBox(std::mt19937& p_engine) {
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    return AABB::FromCenterSize(Vector3f(position(p_engine), position(p_engine), position(p_engine)),
+                                Vector3f(size(p_engine), size(p_engine), size(p_engine)));
+}
+
+static std::vector<TreeObject> FillTree(DynamicAabbTree& p_tree, std::mt19937& p_engine, int p_count) {
+    std::vector<TreeObject> objects;
+    for (int i = 0; i < p_count; ++i) {
+        const AABB aabb = RandomBox(p_engine);
+        objects.push_back({ aabb, p_tree.CreateProxy(aabb, static_cast<uint32_t>(i)) });
+    }
+    return objects;
+}
+
+// every object the exact test accepts is reported, fat boxes may add a few more
+template<typename QUERY, typename TEST>
+static void ExpectSuperset(const std::vector<TreeObject>& p_objects, QUERY&& p_query, TEST&& p_test) {
+    std::vector<int> found;
+    p_query([&](int p_proxy) { found.push_back(p_proxy); });
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(std::unique(found.begin(), found.end()), found.end());
+
+    for (const TreeObject& object : p_objects) {
+        if (p_test(object.aabb)) {
+            EXPECT_TRUE(std::binary_search(found.begin(), found.end(), object.proxy));
+        }
+    }
+}
+
+TEST(dynamic_aabb_tree, create_and_destroy) {
+    DynamicAabbTree tree;
+    std::mt19937 engine(1);
+    auto objects = FillTree(tree, engine, 500);
+    EXPECT_TRUE(tree.Validate());
+    EXPECT_EQ(tree.GetProxyCount(), 500);
+
+    for (size_t i = 0; i < objects.size(); i += 2) {
+        tree.DestroyProxy(objects[i].proxy);
+    }
+    EXPECT_TRUE(tree.Validate());
+    EXPECT_EQ(tree.GetProxyCount(), 250);
+    EXPECT_TRUE(tree.IsProxy(objects[1].proxy));
+    EXPECT_FALSE(tree.IsProxy(objects[0].proxy));
+    EXPECT_EQ(tree.GetUserData(objects[1].proxy), 1u);
+
+    // freed nodes are reused before the pool grows
+    const int capacity = tree.GetCapacity();
+    FillTree(tree, engine, 100);
+    EXPECT_EQ(tree.GetCapacity(), capacity);
+    EXPECT_TRUE(tree.Validate());
+}
+
+TEST(dynamic_aabb_tree, stays_balanced) {
+    DynamicAabbTree tree;
+    // sorted insertion is the worst case without rotations
+    for (int i = 0; i < 4096; ++i) {
+        tree.CreateProxy(AABB::FromCenterSize(Vector3f(static_cast<float>(i), 0.0f, 0.0f), Vector3f(0.5f)), i);
+    }
+    EXPECT_TRUE(tree.Validate());
+    EXPECT_LE(tree.GetHeight(), 24);
+}
+
+TEST(dynamic_aabb_tree, small_moves_keep_the_leaf) {
+    DynamicAabbTree tree(0.5f);
+    const AABB aabb = AABB::FromCenterSize(Vector3f(0.0f), Vector3f(1.0f));
+    const int proxy = tree.CreateProxy(aabb, 7);
+
+    EXPECT_FALSE(tree.MoveProxy(proxy, AABB::FromCenterSize(Vector3f(0.25f, 0.0f, 0.0f), Vector3f(1.0f))));
+    EXPECT_TRUE(tree.MoveProxy(proxy, AABB::FromCenterSize(Vector3f(2.0f, 0.0f, 0.0f), Vector3f(1.0f))));
+    EXPECT_EQ(tree.GetUserData(proxy), 7u);
+
+    // the new fat box is stretched along the move, by at most the box size
+    const AABB& fat_aabb = tree.GetFatAABB(proxy);
+    EXPECT_FLOAT_EQ(fat_aabb.GetMin().x, 1.0f);
+    EXPECT_FLOAT_EQ(fat_aabb.GetMax().x, 4.0f);
+    EXPECT_FLOAT_EQ(fat_aabb.GetMin().y, -1.0f);
+    EXPECT_FLOAT_EQ(fat_aabb.GetMax().y, 1.0f);
+
+    // moving on in the same direction stays in the stretched box
+    EXPECT_FALSE(tree.MoveProxy(proxy, AABB::FromCenterSize(Vector3f(2.8f, 0.0f, 0.0f), Vector3f(1.0f))));
+}
+
+TEST(dynamic_aabb_tree, queries_match_brute_force) {
+    DynamicAabbTree tree;
+    std::mt19937 engine(2);
+    auto objects = FillTree(tree, engine, 2000);
+
+    // move a few objects around, the tree is queried with the boxes it was last given
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+    for (int frame = 0; frame < 10; ++frame) {
+        for (size_t i = frame; i < objects.size(); i += 20) {
+            const Vector3f delta(offset(engine), offset(engine), offset(engine));
+            objects[i].aabb = AABB(objects[i].aabb.GetMin() + delta, objects[i].aabb.GetMax() + delta);
+            tree.MoveProxy(objects[i].proxy, objects[i].aabb);
+        }
+    }
+    ASSERT_TRUE(tree.Validate());
+
+    const AABB box = AABB::FromCenterSize(Vector3f(5.0f, -3.0f, 10.0f), Vector3f(30.0f));
+    ExpectSuperset(
+        objects,
+        [&](auto p_callback) { tree.QueryAabb(box, p_callback); },
+        [&](const AABB& p_aabb) { return box.Intersects(p_aabb); });
+
+    const Vector3f center(-10.0f, 5.0f, 0.0f);
+    const float radius = 15.0f;
+    ExpectSuperset(
+        objects,
+        [&](auto p_callback) { tree.QuerySphere(center, radius, p_callback); },
+        [&](const AABB& p_aabb) {
+            const Vector3f closest = min(max(center, p_aabb.GetMin()), p_aabb.GetMax());
+            return length(closest - center) <= radius;
+        });
+
+    const Matrix4x4f view = LookAtRh(Vector3f(0.0f, 10.0f, 80.0f), Vector3f(0.0f), Vector3f::UnitY);
+    const Frustum frustum(BuildPerspectiveRH(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) * view);
+    ExpectSuperset(
+        objects,
+        [&](auto p_callback) { tree.QueryFrustum(frustum, p_callback); },
+        [&](const AABB& p_aabb) { return frustum.Intersects(p_aabb); });
+}
+
+TEST(dynamic_aabb_tree, ray_cast_finds_nearest) {
+    DynamicAabbTree tree;
+    std::mt19937 engine(3);
+    const auto objects = FillTree(tree, engine, 2000);
+
+    const Vector3f start(-60.0f, 1.0f, 2.0f);
+    const Vector3f end(60.0f, -1.0f, -2.0f);
+
+    // nearest fat box along the segment, clipping the cast at every hit
+    int nearest = DynamicAabbTree::NULL_NODE;
+    float nearest_fraction = 1.0f;
+    tree.RayCast(start, end, [&](int p_proxy, float p_max_fraction) {
+        Ray ray(start, end);
+        if (ray.Intersects(tree.GetFatAABB(p_proxy)) && ray.GetDist() < p_max_fraction) {
+            nearest = p_proxy;
+            nearest_fraction = ray.GetDist();
+            return ray.GetDist();
+        }
+        return p_max_fraction;
+    });
+
+    float expected_fraction = 1.0f;
+    for (const TreeObject& object : objects) {
+        Ray ray(start, end);
+        if (ray.Intersects(tree.GetFatAABB(object.proxy))) {
+            expected_fraction = glm::min(expected_fraction, ray.GetDist());
+        }
+    }
+
+    ASSERT_NE(nearest, DynamicAabbTree::NULL_NODE);
+    EXPECT_FLOAT_EQ(nearest_fraction, expected_fraction);
+}
+
+}  // namespace cave
@@ -0,0 +1,33 @@
+#include "engine/memory/arena_allocator.h"
+
+namespace cave::memory {
+
+TEST(arena_allocator, allocates_from_arena) {
+    LinearAllocator arena(1024);
+    ArenaVector<int> vector{ ArenaAllocator<int>(&arena) };
+    vector.reserve(16);
+    EXPECT_TRUE(arena.Owns(vector.data()));
+    EXPECT_GE(arena.Used(), 16 * sizeof(int));
+
+    // too large for the arena, falls back to the heap
+    vector.reserve(1024);
+    EXPECT_FALSE(arena.Owns(vector.data()));
+    EXPECT_EQ(arena.OverflowCount(), 1u);
+}
+
+TEST(arena_allocator, recycle_reserves_previous_size) {
+    LinearAllocator arena_a(4096);
+    LinearAllocator arena_b(4096);
+    ArenaVector<int> vector{ ArenaAllocator<int>(&arena_a) };
+    for (int i = 0; i < 100; ++i) {
+        vector.push_back(i);
+    }
+
+    RecycleArenaVector(vector, &arena_b);
+    EXPECT_TRUE(vector.empty());
+    EXPECT_GE(vector.capacity(), 100u);
+    EXPECT_TRUE(arena_b.Owns(vector.data()));
+    EXPECT_EQ(vector.get_allocator().GetArena(), &arena_b);
+}
+
+}  // namespace cave::memory
@@ -79,6 +79,34 @@ TEST(linear_allocator, boundary_no_overflow) {
     EXPECT_EQ(p3, nullptr);
 }
 
+TEST(linear_allocator, mixed_alignment) {
+    LinearAllocator alloc(1024);
+
+    void* p1 = alloc.Allocate(3, 1);
+    void* p2 = alloc.Allocate(8, 8);
+    void* p3 = alloc.Allocate(1, 1);
+    void* p4 = alloc.Allocate(32, 64);
+    EXPECT_TRUE(IsAligned(p2, 8));
+    EXPECT_TRUE(IsAligned(p4, 64));
+    EXPECT_TRUE(p1 < p2 && p2 < p3 && p3 < p4);
+    EXPECT_TRUE(alloc.Owns(p4));
+    EXPECT_FALSE(alloc.Owns(&alloc));
+}
+
+TEST(linear_allocator, high_water_mark) {
+    LinearAllocator alloc(1024);
+
+    alloc.Allocate(512);
+    alloc.Reset();
+    alloc.Allocate(128);
+    EXPECT_EQ(alloc.HighWaterMark(), 512u);
+    EXPECT_EQ(alloc.OverflowCount(), 0u);
+
+    EXPECT_EQ(alloc.Allocate(1024), nullptr);
+    EXPECT_EQ(alloc.OverflowCount(), 1u);
+    EXPECT_EQ(alloc.HighWaterMark(), 512u);
+}
+
 TEST(linear_allocator, debug_patterns) {
     if constexpr (LinearAllocator::kDebug) {
         const size_t cap = 1024;
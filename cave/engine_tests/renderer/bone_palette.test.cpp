@@ -0,0 +1,183 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/bone_palette.h"
+
+namespace cave {
+
+using UploadList = memory::ArenaVector<BonePalette::Upload>;
+using RowList = memory::ArenaVector<Vector4f>;
+
+static std::vector<Matrix4x4f> MakePalette(uint32_t p_bone_count, float p_time) {
+    std::vector<Matrix4x4f> palette;
+    for (uint32_t i = 0; i < p_bone_count; ++i) {
+        palette.push_back(Translate(Vector3f(static_cast<float>(i), p_time, 0.0f)));
+    }
+    return palette;
+}
+
+static uint32_t RunFrame(BonePalette& p_palette, const std::vector<std::vector<Matrix4x4f>>& p_skeletons) {
+    UploadList uploads;
+    RowList rows;
+    p_palette.BeginFrame();
+    for (size_t i = 0; i < p_skeletons.size(); ++i) {
+        EXPECT_TRUE(p_palette.Update(ecs::Entity(static_cast<uint32_t>(i + 1)), p_skeletons[i].data(), (uint32_t)p_skeletons[i].size()));
+    }
+    p_palette.EndFrame(uploads, rows);
+
+    uint32_t row_count = 0;
+    for (const BonePalette::Upload& upload : uploads) {
+        EXPECT_EQ(upload.dst_row % BonePalette::ROW_ALIGNMENT, 0u);
+        EXPECT_LE(upload.src_row + upload.row_count, rows.size());
+        row_count += upload.row_count;
+    }
+    EXPECT_EQ(row_count, rows.size());
+    return row_count;
+}
+
+TEST(bone_palette, store_matrix) {
+    const Matrix4x4f matrix = Translate(Vector3f(1.0f, 2.0f, 3.0f)) * Scale(Vector3f(2.0f));
+    Vector4f rows[BonePalette::ROWS_PER_BONE];
+    BonePalette::StoreMatrix(matrix, rows);
+
+    const Vector4f point(4.0f, 5.0f, 6.0f, 1.0f);
+    const Vector4f expected = matrix * point;
+    for (int row = 0; row < 3; ++row) {
+        EXPECT_FLOAT_EQ(dot(rows[row], point), expected[row]);
+    }
+}
+
+TEST(bone_palette, ranges_fit_bone_counts) {
+    BonePalette palette(1024);
+    const uint32_t bone_counts[] = { 1, 20, 64, MAX_BONE_COUNT };
+
+    palette.BeginFrame();
+    for (uint32_t i = 0; i < 4; ++i) {
+        const auto transforms = MakePalette(bone_counts[i], 0.0f);
+        ASSERT_TRUE(palette.Update(ecs::Entity(i + 1), transforms.data(), bone_counts[i]));
+    }
+
+    uint32_t end = 0;
+    for (uint32_t i = 0; i < 4; ++i) {
+        const BonePalette::Range* range = palette.Find(ecs::Entity(i + 1));
+        ASSERT_TRUE(range);
+        EXPECT_EQ(range->row_count, bone_counts[i] * BonePalette::ROWS_PER_BONE);
+        EXPECT_EQ(range->offset % BonePalette::ROW_ALIGNMENT, 0u);
+        EXPECT_GE(range->offset, end);
+        end = range->offset + range->row_count;
+    }
+    EXPECT_EQ(palette.Find(ecs::Entity(5)), nullptr);
+
+    // no room left for another full skeleton
+    palette.BeginFrame();
+    const auto transforms = MakePalette(MAX_BONE_COUNT, 0.0f);
+    for (uint32_t i = 0; i < 4; ++i) {
+        palette.Update(ecs::Entity(i + 1), transforms.data(), bone_counts[i]);
+    }
+    EXPECT_FALSE(palette.Update(ecs::Entity(10), transforms.data(), MAX_BONE_COUNT));
+    EXPECT_FALSE(palette.Update(ecs::Entity(11), transforms.data(), MAX_BONE_COUNT));
+    EXPECT_EQ(palette.Find(ecs::Entity(10)), nullptr);
+}
+
+TEST(bone_palette, unchanged_skeletons_are_not_uploaded) {
+    constexpr uint32_t BONE_COUNT = 30;
+    constexpr uint32_t ROW_COUNT = BONE_COUNT * BonePalette::ROWS_PER_BONE;
+    BonePalette palette(4096, 2);
+    std::vector<std::vector<Matrix4x4f>> skeletons(4, MakePalette(BONE_COUNT, 0.0f));
+
+    // a new range is uploaded to both copies of the buffer
+    EXPECT_GE(RunFrame(palette, skeletons), 4 * ROW_COUNT);
+    EXPECT_GE(RunFrame(palette, skeletons), 4 * ROW_COUNT);
+    EXPECT_EQ(RunFrame(palette, skeletons), 0u);
+    EXPECT_EQ(palette.GetStats().changed_count, 0u);
+
+    skeletons[2] = MakePalette(BONE_COUNT, 1.0f);
+    EXPECT_EQ(RunFrame(palette, skeletons), ROW_COUNT);
+    EXPECT_EQ(palette.GetStats().changed_count, 1u);
+    EXPECT_EQ(RunFrame(palette, skeletons), ROW_COUNT);
+    EXPECT_EQ(RunFrame(palette, skeletons), 0u);
+}
+
+TEST(bone_palette, released_ranges_are_reused) {
+    BonePalette palette(BONE_BLOCK_ROW_COUNT * 2);
+    const auto transforms = MakePalette(MAX_BONE_COUNT, 0.0f);
+
+    palette.BeginFrame();
+    ASSERT_TRUE(palette.Update(ecs::Entity(1), transforms.data(), MAX_BONE_COUNT));
+    ASSERT_TRUE(palette.Update(ecs::Entity(2), transforms.data(), MAX_BONE_COUNT));
+    UploadList uploads;
+    RowList rows;
+    palette.EndFrame(uploads, rows);
+    // adjacent ranges go in a single upload
+    EXPECT_EQ(uploads.size(), 1u);
+    const uint32_t offset = palette.Find(ecs::Entity(1))->offset;
+
+    // skeleton 1 is gone, its range is free for a new one
+    palette.BeginFrame();
+    ASSERT_TRUE(palette.Update(ecs::Entity(2), transforms.data(), MAX_BONE_COUNT));
+    palette.EndFrame(uploads, rows);
+    EXPECT_EQ(palette.Find(ecs::Entity(1)), nullptr);
+    EXPECT_EQ(palette.GetStats().used_row_count, BONE_BLOCK_ROW_COUNT);
+
+    palette.BeginFrame();
+    ASSERT_TRUE(palette.Update(ecs::Entity(2), transforms.data(), MAX_BONE_COUNT));
+    ASSERT_TRUE(palette.Update(ecs::Entity(3), transforms.data(), MAX_BONE_COUNT));
+    EXPECT_EQ(palette.Find(ecs::Entity(3))->offset, offset);
+}
+
+TEST(bone_palette, growing_buffer_uploads_every_copy) {
+    BonePalette palette(BONE_BLOCK_ROW_COUNT * 4);
+    const std::vector<std::vector<Matrix4x4f>> skeletons(2, MakePalette(MAX_BONE_COUNT, 0.0f));
+    RunFrame(palette, skeletons);
+    RunFrame(palette, skeletons);
+    EXPECT_EQ(RunFrame(palette, skeletons), 0u);
+
+    // a buffer that grows loses the rows, each copy receives all of them once
+    const uint32_t used_row_count = palette.GetTop();
+    for (uint32_t copy = 0; copy < BonePalette::DEFAULT_COPY_COUNT; ++copy) {
+        UploadList uploads;
+        RowList rows;
+        palette.BeginFrame();
+        for (size_t i = 0; i < skeletons.size(); ++i) {
+            ASSERT_TRUE(palette.Update(ecs::Entity(static_cast<uint32_t>(i + 1)), skeletons[i].data(), MAX_BONE_COUNT));
+        }
+        palette.EndFrame(uploads, rows);
+        if (copy == 0) {
+            palette.ReserveBuffer(BONE_BUFFER_MIN_ROW_COUNT + 1, uploads, rows);
+            EXPECT_EQ(palette.GetBufferRowCount() % BONE_BLOCK_ROW_COUNT, 0u);
+            EXPECT_GT(palette.GetBufferRowCount(), BONE_BUFFER_MIN_ROW_COUNT);
+        }
+        EXPECT_EQ(rows.size(), used_row_count);
+    }
+    EXPECT_EQ(RunFrame(palette, skeletons), 0u);
+
+    // a smaller request keeps the buffer
+    UploadList uploads;
+    RowList rows;
+    const uint32_t buffer_row_count = palette.GetBufferRowCount();
+    palette.ReserveBuffer(BONE_BLOCK_ROW_COUNT, uploads, rows);
+    EXPECT_EQ(palette.GetBufferRowCount(), buffer_row_count);
+    EXPECT_TRUE(rows.empty());
+}
+
+// 200 characters, a tenth of them animated in a frame, the rest idle or off-screen with a frozen pose
+TEST(bone_palette, crowd_upload_bytes) {
+    constexpr uint32_t CHARACTER_COUNT = 200;
+    constexpr uint32_t BONE_COUNT = 64;
+    constexpr uint32_t ANIMATED_COUNT = 20;
+
+    BonePalette palette;
+    std::vector<std::vector<Matrix4x4f>> skeletons(CHARACTER_COUNT, MakePalette(BONE_COUNT, 0.0f));
+    RunFrame(palette, skeletons);
+    RunFrame(palette, skeletons);
+
+    for (uint32_t i = 0; i < ANIMATED_COUNT; ++i) {
+        skeletons[i * (CHARACTER_COUNT / ANIMATED_COUNT)] = MakePalette(BONE_COUNT, 1.0f);
+    }
+    const size_t bytes = RunFrame(palette, skeletons) * sizeof(Vector4f);
+
+    // a full 4x4 palette of MAX_BONE_COUNT bones per character every frame
+    const size_t full_bytes = CHARACTER_COUNT * MAX_BONE_COUNT * sizeof(Matrix4x4f);
+    EXPECT_EQ(bytes, ANIMATED_COUNT * BONE_COUNT * 3 * sizeof(Vector4f));
+    EXPECT_LT(bytes * 20, full_bytes);
+}
+
+}  // namespace cave
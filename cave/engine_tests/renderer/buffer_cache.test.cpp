@@ -0,0 +1,68 @@
+#include "engine/renderer/frame_data.h"
+
+namespace cave {
+
+struct TestBuffer {
+    int value = 0;
+};
+
+TEST(buffer_cache, find_or_add) {
+    BufferCache<TestBuffer> cache;
+    const ecs::Entity a(3);
+    const ecs::Entity b(5000);
+
+    EXPECT_EQ(cache.Find(a), -1);
+    EXPECT_EQ(cache.FindOrAdd(a, { 1 }), 0u);
+    EXPECT_EQ(cache.FindOrAdd(b, { 2 }), 1u);
+    // already added, the new value is ignored
+    EXPECT_EQ(cache.FindOrAdd(a, { 3 }), 0u);
+
+    EXPECT_EQ(cache.Find(a), 0);
+    EXPECT_EQ(cache.Find(b), 1);
+    EXPECT_EQ(cache.Find(ecs::Entity(4)), -1);
+    ASSERT_EQ(cache.buffer.size(), 2u);
+    EXPECT_EQ(cache.buffer[0].value, 1);
+    EXPECT_EQ(cache.buffer[1].value, 2);
+}
+
+TEST(buffer_cache, clear_forgets_previous_frame) {
+    BufferCache<TestBuffer> cache;
+    for (uint32_t id = 1; id <= 100; ++id) {
+        cache.FindOrAdd(ecs::Entity(id), { static_cast<int>(id) });
+    }
+
+    cache.Clear();
+    EXPECT_TRUE(cache.buffer.empty());
+    EXPECT_EQ(cache.Find(ecs::Entity(1)), -1);
+
+    // ids get dense indices in the order they are added
+    EXPECT_EQ(cache.FindOrAdd(ecs::Entity(50)), 0u);
+    EXPECT_EQ(cache.FindOrAdd(ecs::Entity(7), { 7 }), 1u);
+    EXPECT_EQ(cache.Find(ecs::Entity(50)), 0);
+    EXPECT_EQ(cache.Find(ecs::Entity(8)), -1);
+    EXPECT_EQ(cache.buffer[1].value, 7);
+}
+
+// the slots past TRANSIENT_BATCH_COUNT are the scene batches, a full frame drops draws instead
+TEST(buffer_cache, transient_batches_are_bounded) {
+    FrameData framedata(RenderOptions{});
+    framedata.Reset(RenderOptions{});
+    const ecs::Entity sprite(3);
+    EXPECT_EQ(framedata.FindOrAddTransientBatch(sprite, {}), 0);
+    for (uint32_t i = 1; i < TRANSIENT_BATCH_COUNT; ++i) {
+        EXPECT_EQ(framedata.AddTransientBatch({}), static_cast<int>(i));
+    }
+
+    EXPECT_EQ(framedata.AddTransientBatch({}), -1);
+    EXPECT_EQ(framedata.FindOrAddTransientBatch(ecs::Entity(4), {}), -1);
+    // a slot the id got before the buffer filled up is still found
+    EXPECT_EQ(framedata.FindOrAddTransientBatch(sprite, {}), 0);
+    EXPECT_EQ(framedata.batchCache.buffer.size(), size_t(TRANSIENT_BATCH_COUNT));
+    EXPECT_EQ(framedata.droppedBatchCount, 2u);
+
+    framedata.Reset(RenderOptions{});
+    EXPECT_EQ(framedata.droppedBatchCount, 0u);
+    EXPECT_EQ(framedata.AddTransientBatch({}), 0);
+}
+
+}  // namespace cave
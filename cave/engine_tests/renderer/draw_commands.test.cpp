@@ -0,0 +1,179 @@
+#include "engine/empty/empty_graphics_manager.h"
+#include "engine/render_graph/draw_commands.h"
+#include "engine/renderer/frame_data.h"
+#include "filtered_graphics_manager.h"
+
+#include <random>
+
+namespace cave {
+
+TEST(draw_sort_key, opaque_front_to_back) {
+    GpuMesh mesh;
+    const uint64_t near_key = DrawSortKey::Opaque(0, 0, 3, &mesh, 1.0f);
+    const uint64_t far_key = DrawSortKey::Opaque(0, 0, 3, &mesh, 100.0f);
+    EXPECT_LT(near_key, far_key);
+
+    // state takes priority over depth
+    const uint64_t other_material = DrawSortKey::Opaque(0, 0, 4, &mesh, 0.5f);
+    EXPECT_LT(far_key, other_material);
+}
+
+TEST(draw_sort_key, transparent_back_to_front) {
+    GpuMesh mesh_a;
+    GpuMesh mesh_b;
+    const uint64_t near_key = DrawSortKey::Transparent(0, 0, 0, &mesh_a, 1.0f);
+    const uint64_t far_key = DrawSortKey::Transparent(0, 0, 5, &mesh_b, 100.0f);
+    EXPECT_GT(near_key, far_key);
+}
+
+TEST(draw_sort_key, depth_bucket_monotonic) {
+    uint32_t prev = DrawSortKey::DepthBucket(-1.0f);
+    EXPECT_EQ(prev, 0u);
+    for (float depth = 0.01f; depth < 10000.0f; depth *= 1.5f) {
+        const uint32_t bucket = DrawSortKey::DepthBucket(depth);
+        EXPECT_GE(bucket, prev);
+        prev = bucket;
+    }
+}
+
+TEST(draw_commands, sorted_order_reduces_state_changes) {
+    constexpr int MESH_COUNT = 4;
+    constexpr int MATERIAL_COUNT = 8;
+    constexpr int DRAW_COUNT = 2000;
+
+    GpuMesh meshes[MESH_COUNT];
+    FrameData framedata(RenderOptions{});
+    framedata.materials.resize(MATERIAL_COUNT);
+    for (int i = 0; i < MATERIAL_COUNT; ++i) {
+        MaterialConstantBuffer& material = framedata.materials[i];
+        material.c_baseColorMapHandle = 1 + 3 * i;
+        material.c_normalMapHandle = 2 + 3 * i;
+        material.c_materialMapHandle = 3 + 3 * i;
+    }
+
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<float> depth(0.1f, 500.0f);
+    RenderCommandList list;
+    for (int i = 0; i < DRAW_COUNT; ++i) {
+        DrawCommand draw;
+        draw.mesh_data = &meshes[engine() % MESH_COUNT];
+        draw.mat_idx = engine() % MATERIAL_COUNT;
+        draw.batch_idx = i;
+        draw.index_count = 36;
+        draw.sort_key = DrawSortKey::Opaque(0, 0, draw.mat_idx, draw.mesh_data, depth(engine));
+        list.Add(RenderCommand::From(draw));
+    }
+
+    FilteredGraphicsManager unsorted_gm;
+    ExecuteDrawCommands(unsorted_gm, framedata, list);
+    const auto unsorted = unsorted_gm.GetStateChangeCounters();
+
+    list.Sort();
+    FilteredGraphicsManager sorted_gm;
+    ExecuteDrawCommands(sorted_gm, framedata, list);
+    const auto sorted = sorted_gm.GetStateChangeCounters();
+
+    EXPECT_EQ(unsorted.draw, uint32_t(DRAW_COUNT));
+    EXPECT_EQ(sorted.draw, uint32_t(DRAW_COUNT));
+
+    // one bind per material and at most one mesh bind per (material, mesh) pair
+    EXPECT_EQ(sorted.bindTexture, uint32_t(3 * MATERIAL_COUNT));
+    EXPECT_LE(sorted.setMesh, uint32_t(MESH_COUNT * MATERIAL_COUNT));
+
+    EXPECT_GT(unsorted.bindTexture, 10 * sorted.bindTexture);
+    EXPECT_GT(unsorted.setMesh, 10 * sorted.setMesh);
+
+    // within a state group draws are front to back
+    const auto& commands = list.GetCommands();
+    const auto& order = list.GetOrder();
+    for (size_t i = 1; i < order.size(); ++i) {
+        EXPECT_LE(commands[order[i - 1]].draw.sort_key, commands[order[i]].draw.sort_key);
+    }
+}
+
+TEST(draw_commands, instance_forest) {
+    constexpr int TREE_COUNT = 20000;
+    constexpr int TREE_VARIANT_COUNT = 3;
+    // trunk and leaves
+    constexpr int SUBSET_COUNT = 2;
+
+    GpuMesh tree_meshes[TREE_VARIANT_COUNT];
+    GpuMesh character_mesh;
+    FrameData framedata(RenderOptions{});
+    framedata.materials.resize(SUBSET_COUNT);
+
+    std::mt19937 engine(3);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    RenderCommandList list;
+    double translation_sum = 0.0;
+    for (int tree = 0; tree < TREE_COUNT; ++tree) {
+        PerBatchConstantBuffer batch;
+        batch.c_worldMatrix = Matrix4x4f(1.0f);
+        batch.c_worldMatrix[3][0] = position(engine);
+        batch.c_meshFlag = 0;
+        translation_sum += batch.c_worldMatrix[3][0];
+
+        DrawCommand draw;
+        draw.batch_idx = static_cast<int>(framedata.batchCache.buffer.size());
+        draw.mesh_data = &tree_meshes[engine() % TREE_VARIANT_COUNT];
+        framedata.batchCache.buffer.emplace_back(batch);
+
+        for (int subset = 0; subset < SUBSET_COUNT; ++subset) {
+            draw.mat_idx = subset;
+            draw.index_offset = subset * 300;
+            draw.index_count = 300;
+            draw.sort_key = DrawSortKey::Opaque(0, 0, draw.mat_idx, draw.mesh_data, glm::abs(batch.c_worldMatrix[3][0]));
+            list.Add(RenderCommand::From(draw));
+        }
+    }
+
+    // skinned draws read their palette from the bone slot and are never instanced
+    for (int i = 0; i < 2; ++i) {
+        DrawCommand draw;
+        draw.batch_idx = 0;
+        draw.bone_offset = 0;
+        draw.bone_row_count = 64 * BonePalette::ROWS_PER_BONE;
+        draw.mat_idx = 0;
+        draw.mesh_data = &character_mesh;
+        draw.index_count = 900;
+        draw.sort_key = DrawSortKey::Opaque(0, 1, draw.mat_idx, draw.mesh_data, 1.0f);
+        list.Add(RenderCommand::From(draw));
+    }
+
+    list.Sort();
+    MergeInstancedDraws(list, framedata);
+
+    EmptyGraphicsManager gm;
+    ExecuteDrawCommands(gm, framedata, list);
+    const auto& counters = gm.GetStateChangeCounters();
+
+    // a run that leaves a single tree for its last chunk draws it without instancing
+    const uint32_t single_tree_draws = counters.draw - 2;
+    EXPECT_LE(single_tree_draws, uint32_t(TREE_VARIANT_COUNT * SUBSET_COUNT));
+    EXPECT_EQ(counters.instance + single_tree_draws, uint32_t(TREE_COUNT * SUBSET_COUNT));
+
+    const uint32_t max_instanced_draws = TREE_VARIANT_COUNT * SUBSET_COUNT * (TREE_COUNT / MAX_BONE_COUNT + 1);
+    EXPECT_LE(counters.drawInstanced, max_instanced_draws);
+    EXPECT_LE(framedata.instanceRows.size(), BONE_INSTANCE_ROW_COUNT);
+
+    // every tree is drawn once per subset
+    double drawn_sum = 0.0;
+    for (const RenderCommand& command : list.GetCommands()) {
+        const DrawCommand& draw = command.draw;
+        if (draw.instance_count > 1) {
+            EXPECT_EQ(draw.batch_idx, framedata.instanceBatchIdx);
+            // instances start on a bindable offset, the translation is the last column of the 3x4 rows
+            EXPECT_EQ(draw.bone_offset % BonePalette::ROW_ALIGNMENT, 0);
+            EXPECT_EQ(draw.bone_row_count, draw.instance_count * BonePalette::ROWS_PER_BONE);
+            const uint32_t first_row = draw.bone_offset - framedata.instanceRowOffset;
+            for (uint32_t i = 0; i < draw.instance_count; ++i) {
+                drawn_sum += framedata.instanceRows[first_row + i * BonePalette::ROWS_PER_BONE].w;
+            }
+        } else if (draw.bone_offset < 0) {
+            drawn_sum += framedata.batchCache.buffer[draw.batch_idx].c_worldMatrix[3][0];
+        }
+    }
+    EXPECT_NEAR(drawn_sum, SUBSET_COUNT * translation_sum, 1e-3);
+}
+
+}  // namespace cave
@@ -0,0 +1,34 @@
+#pragma once
+#include "engine/empty/empty_graphics_manager.h"
+#include "engine/renderer/render_state_cache.h"
+
+namespace cave {
+
+// forwards through a cache the way GraphicsManager does, the empty counters see what the backend gets
+class FilteredGraphicsManager : public EmptyGraphicsManager {
+public:
+    FilteredGraphicsManager() {
+        m_frameContext.batchCb = std::make_shared<GpuConstantBuffer>(GpuBufferDesc{ .type = GpuBufferType::CONSTANT, .slot = 1 });
+        m_frameContext.materialCb = std::make_shared<GpuConstantBuffer>(GpuBufferDesc{ .type = GpuBufferType::CONSTANT, .slot = 2 });
+    }
+
+    void SetMesh(const GpuMesh* p_mesh) override {
+        if (m_cache.SetMesh(p_mesh)) {
+            EmptyGraphicsManager::SetMesh(p_mesh);
+        }
+    }
+    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) override {
+        if (m_cache.BindTexture(p_dimension, p_handle, p_slot)) {
+            EmptyGraphicsManager::BindTexture(p_dimension, p_handle, p_slot);
+        }
+    }
+    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override {
+        if (m_cache.BindConstantBufferRange(p_buffer, p_size, p_offset)) {
+            EmptyGraphicsManager::BindConstantBufferRange(p_buffer, p_size, p_offset);
+        }
+    }
+
+    RenderStateCache m_cache;
+};
+
+}  // namespace cave
@@ -0,0 +1,164 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/light_clusters.h"
+
+#include <random>
+
+namespace cave {
+
+static constexpr float CLUSTER_NEAR = 0.1f;
+static constexpr float CLUSTER_FAR = 200.0f;
+
+struct ClusterTestCamera {
+    Matrix4x4f view;
+    Matrix4x4f projection;
+
+    ClusterTestCamera() {
+        view = LookAtRh(Vector3f(1.0f, 2.0f, 3.0f), Vector3f(4.0f, 1.0f, -10.0f), Vector3f::UnitY);
+        projection = BuildPerspectiveRH(glm::radians(60.0f), 16.0f / 9.0f, CLUSTER_NEAR, CLUSTER_FAR);
+    }
+
+    Vector3f ToView(const Vector3f& p_position) const {
+        const Vector4f position = view * Vector4f(p_position, 1.0f);
+        return position.xyz;
+    }
+};
+
+static GpuPointLight ClusterTestLight(const Vector3f& p_position, float p_radius) {
+    GpuPointLight light{};
+    light.position = p_position;
+    light.max_distance = p_radius;
+    return light;
+}
+
+static std::vector<GpuPointLight> RandomClusterTestLights(int p_count, uint32_t p_seed) {
+    std::mt19937 engine(p_seed);
+    auto random = [&](float p_min, float p_max) { return std::uniform_real_distribution<float>(p_min, p_max)(engine); };
+
+    std::vector<GpuPointLight> lights;
+    for (int i = 0; i < p_count; ++i) {
+        lights.push_back(ClusterTestLight(Vector3f(random(-60.0f, 60.0f), random(-10.0f, 20.0f), random(-150.0f, 20.0f)), random(0.5f, 12.0f)));
+    }
+    return lights;
+}
+
+static std::span<const uint32_t> ClusterLights(const memory::ArenaVector<uint32_t>& p_clusters, const memory::ArenaVector<uint32_t>& p_indices, int p_cluster) {
+    const uint32_t packed = p_clusters[p_cluster];
+    return std::span<const uint32_t>(p_indices).subspan(packed & LIGHT_CLUSTER_OFFSET_MASK, packed >> LIGHT_CLUSTER_OFFSET_BITS);
+}
+
+TEST(light_clusters, empty_without_lights) {
+    const ClusterTestCamera camera;
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    builder.Build(camera.view, camera.projection, CLUSTER_NEAR, CLUSTER_FAR, {}, clusters, indices);
+
+    ASSERT_EQ(clusters.size(), size_t(LIGHT_CLUSTER_COUNT));
+    EXPECT_TRUE(indices.empty());
+    for (uint32_t cluster : clusters) {
+        EXPECT_EQ(cluster, 0u);
+    }
+}
+
+TEST(light_clusters, skips_lights_outside_the_frustum) {
+    const ClusterTestCamera camera;
+    const Vector3f forward(3.0f, -1.0f, -13.0f);
+    const std::vector<GpuPointLight> lights = {
+        // behind the camera
+        ClusterTestLight(Vector3f(1.0f, 2.0f, 3.0f) - 0.5f * forward, 1.0f),
+        // past the far plane
+        ClusterTestLight(Vector3f(1.0f, 2.0f, 3.0f) + 20.0f * forward, 5.0f),
+        // far to the side
+        ClusterTestLight(Vector3f(400.0f, 2.0f, -10.0f), 5.0f),
+    };
+
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    builder.Build(camera.view, camera.projection, CLUSTER_NEAR, CLUSTER_FAR, lights, clusters, indices);
+
+    EXPECT_EQ(builder.GetStats().light_count, 3u);
+    EXPECT_EQ(builder.GetStats().visible_light_count, 0u);
+    EXPECT_TRUE(indices.empty());
+}
+
+TEST(light_clusters, light_around_the_camera) {
+    const ClusterTestCamera camera;
+    const std::vector<GpuPointLight> lights = { ClusterTestLight(Vector3f(1.0f, 2.0f, 3.0f), 1.0f) };
+
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    builder.Build(camera.view, camera.projection, CLUSTER_NEAR, CLUSTER_FAR, lights, clusters, indices);
+
+    // every tile of the first slice is lit
+    for (int y = 0; y < LIGHT_CLUSTER_Y; ++y) {
+        for (int x = 0; x < LIGHT_CLUSTER_X; ++x) {
+            EXPECT_EQ(ClusterLights(clusters, indices, LightClusterBuilder::ClusterIndex(x, y, 0)).size(), 1u);
+        }
+    }
+    EXPECT_TRUE(ClusterLights(clusters, indices, LightClusterBuilder::ClusterIndex(0, 0, LIGHT_CLUSTER_Z - 1)).empty());
+}
+
+// every listed light touches its cluster and is listed once
+TEST(light_clusters, lists_match_brute_force) {
+    const ClusterTestCamera camera;
+    const std::vector<GpuPointLight> lights = RandomClusterTestLights(500, 7);
+
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    builder.Build(camera.view, camera.projection, CLUSTER_NEAR, CLUSTER_FAR, lights, clusters, indices);
+    ASSERT_EQ(builder.GetStats().overflow_count, 0u);
+
+    uint32_t brute_force_count = 0;
+    for (int cluster = 0; cluster < LIGHT_CLUSTER_COUNT; ++cluster) {
+        const std::span<const uint32_t> list = ClusterLights(clusters, indices, cluster);
+        EXPECT_TRUE(std::is_sorted(list.begin(), list.end()));
+        EXPECT_EQ(std::adjacent_find(list.begin(), list.end()), list.end());
+        for (uint32_t light_idx : list) {
+            ASSERT_LT(light_idx, lights.size());
+            EXPECT_TRUE(builder.Intersects(cluster, camera.ToView(lights[light_idx].position), lights[light_idx].max_distance));
+        }
+
+        for (const GpuPointLight& light : lights) {
+            brute_force_count += builder.Intersects(cluster, camera.ToView(light.position), light.max_distance);
+        }
+    }
+
+    // the screen rectangle of a light only drops clusters the sphere misses
+    EXPECT_LE(builder.GetStats().index_count, brute_force_count);
+    EXPECT_GT(builder.GetStats().index_count, brute_force_count * 9 / 10);
+}
+
+// a point in view is lit by every light in range through the list of its cluster
+TEST(light_clusters, points_find_their_lights) {
+    const ClusterTestCamera camera;
+    const std::vector<GpuPointLight> lights = RandomClusterTestLights(500, 11);
+
+    LightClusterBuilder builder;
+    memory::ArenaVector<uint32_t> clusters, indices;
+    builder.Build(camera.view, camera.projection, CLUSTER_NEAR, CLUSTER_FAR, lights, clusters, indices);
+
+    std::mt19937 engine(3);
+    auto random = [&](float p_min, float p_max) { return std::uniform_real_distribution<float>(p_min, p_max)(engine); };
+
+    int tested = 0;
+    for (int i = 0; i < 2000; ++i) {
+        const Vector3f position(random(-60.0f, 60.0f), random(-10.0f, 20.0f), random(-150.0f, 3.0f));
+        const Vector3f view_position = camera.ToView(position);
+        const int cluster = builder.FindCluster(view_position);
+        if (cluster < 0 || -view_position.z < CLUSTER_NEAR) {
+            continue;
+        }
+
+        ++tested;
+        const std::span<const uint32_t> list = ClusterLights(clusters, indices, cluster);
+        for (uint32_t light_idx = 0; light_idx < lights.size(); ++light_idx) {
+            const Vector3f delta = position - lights[light_idx].position;
+            // away from the edge of the sphere, where rounding decides
+            if (length(delta) < lights[light_idx].max_distance - 0.001f) {
+                EXPECT_TRUE(std::binary_search(list.begin(), list.end(), light_idx));
+            }
+        }
+    }
+    EXPECT_GT(tested, 100);
+}
+
+}  // namespace cave
@@ -0,0 +1,103 @@
+#include "engine/renderer/material_table.h"
+
+namespace cave {
+
+static MaterialConstantBuffer MakeMaterial(float p_roughness, uint32_t p_base_color_map = 0) {
+    MaterialConstantBuffer material{};
+    material.c_baseColor = Vector4f(1.0f);
+    material.c_roughness = p_roughness;
+    material.c_baseColorMapHandle = p_base_color_map;
+    return material;
+}
+
+struct MaterialFrame {
+    memory::ArenaVector<MaterialTable::Upload> uploads;
+    memory::ArenaVector<MaterialConstantBuffer> values;
+    memory::ArenaVector<MaterialConstantBuffer> table;
+    std::vector<int> indices;
+};
+
+static MaterialFrame RunFrame(MaterialTable& p_table, const std::vector<MaterialConstantBuffer>& p_materials) {
+    MaterialFrame frame;
+    p_table.BeginFrame();
+    for (size_t i = 0; i < p_materials.size(); ++i) {
+        frame.indices.push_back(p_table.Update(ecs::Entity(static_cast<uint32_t>(i + 1)), p_materials[i]));
+        EXPECT_GE(frame.indices.back(), 0);
+    }
+    p_table.EndFrame(frame.uploads, frame.values, frame.table);
+
+    // every draw reads its constants back from the table
+    for (size_t i = 0; i < p_materials.size(); ++i) {
+        EXPECT_EQ(memcmp(&frame.table[frame.indices[i]], &p_materials[i], sizeof(MaterialConstantBuffer)), 0);
+    }
+    return frame;
+}
+
+TEST(material_table, instances_share_entries) {
+    constexpr uint32_t MATERIAL_COUNT = 1000;
+    constexpr uint32_t ASSET_COUNT = 4;
+    MaterialTable table(64, 2);
+    std::vector<MaterialConstantBuffer> materials;
+    for (uint32_t i = 0; i < MATERIAL_COUNT; ++i) {
+        materials.push_back(MakeMaterial(0.25f * (i % ASSET_COUNT), 1 + i % ASSET_COUNT));
+    }
+
+    // new entries go to both copies of the buffer
+    MaterialFrame frame = RunFrame(table, materials);
+    EXPECT_EQ(frame.values.size(), ASSET_COUNT);
+    EXPECT_EQ(table.GetStats().material_count, MATERIAL_COUNT);
+    EXPECT_EQ(table.GetStats().entry_count, ASSET_COUNT);
+    for (uint32_t i = ASSET_COUNT; i < MATERIAL_COUNT; ++i) {
+        EXPECT_EQ(frame.indices[i], frame.indices[i % ASSET_COUNT]);
+    }
+    const std::vector<int> indices = frame.indices;
+    EXPECT_EQ(RunFrame(table, materials).values.size(), ASSET_COUNT);
+
+    // nothing changes, nothing is uploaded and the indices stay
+    for (int i = 0; i < 10; ++i) {
+        frame = RunFrame(table, materials);
+        EXPECT_TRUE(frame.uploads.empty());
+        EXPECT_EQ(frame.indices, indices);
+    }
+}
+
+TEST(material_table, edited_material) {
+    MaterialTable table(64, 1);
+    std::vector<MaterialConstantBuffer> materials = {
+        MakeMaterial(0.5f),
+        MakeMaterial(0.5f),
+        MakeMaterial(0.8f),
+    };
+    const std::vector<int> indices = RunFrame(table, materials).indices;
+    EXPECT_EQ(indices[0], indices[1]);
+
+    // the edited material moves to a new entry, the one it shared keeps its value
+    materials[1].c_roughness = 0.1f;
+    MaterialFrame frame = RunFrame(table, materials);
+    ASSERT_EQ(frame.values.size(), 1u);
+    EXPECT_EQ(frame.values[0].c_roughness, 0.1f);
+    EXPECT_EQ(frame.indices[0], indices[0]);
+    EXPECT_NE(frame.indices[1], indices[1]);
+    EXPECT_EQ(frame.indices[2], indices[2]);
+
+    // back to the values of another entry, it joins it without an upload
+    materials[1].c_roughness = 0.8f;
+    frame = RunFrame(table, materials);
+    EXPECT_TRUE(frame.uploads.empty());
+    EXPECT_EQ(frame.indices[1], indices[2]);
+}
+
+TEST(material_table, find) {
+    MaterialTable table(64, 1);
+    RunFrame(table, { MakeMaterial(0.5f), MakeMaterial(0.6f) });
+    EXPECT_GE(table.Find(ecs::Entity(1)), 0);
+    EXPECT_GE(table.Find(ecs::Entity(2)), 0);
+    EXPECT_EQ(table.Find(ecs::Entity(3)), -1);
+
+    // a material that wasn't updated this frame has no index
+    RunFrame(table, { MakeMaterial(0.5f) });
+    EXPECT_GE(table.Find(ecs::Entity(1)), 0);
+    EXPECT_EQ(table.Find(ecs::Entity(2)), -1);
+}
+
+}  // namespace cave
@@ -0,0 +1,160 @@
+#include "engine/assets/mesh_asset.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/scene_render_state.h"
+#include "engine/runtime/asset_registry.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace cave {
+
+extern void RunMeshRenderSystem(Scene* p_scene, SceneRenderState* p_state, FrameData& p_framedata);
+
+// A forest of one tree mesh, the trees are merged into instanced draws whose world matrices go to
+// the bone buffer. The buffer is sized to the rows the frame used, not to the largest scene.
+TEST(mesh_render_system, many_trees) {
+    constexpr int TREE_COUNT = 4000;
+    constexpr int ROW_LENGTH = 80;
+
+    AssetRegistry registry;
+    auto mesh = std::make_shared<MeshAsset>();
+    mesh->localBound = AABB::FromCenterSize(Vector3f(0.0f), Vector3f(1.0f));
+    mesh->indices.resize(36);
+    mesh->gpuResource = std::make_shared<GpuMesh>();
+    auto& subset = mesh->subsets.emplace_back();
+    subset.index_count = 36;
+    subset.local_bound = mesh->localBound;
+
+    AssetMetaData meta;
+    meta.type = AssetType::Mesh;
+    meta.guid = Guid::Create();
+    meta.import_path = "@test/tree";
+    const Guid mesh_guid = meta.guid;
+    registry.RegisterAsset(std::move(meta), mesh);
+
+    Scene scene;
+    SceneRenderState scene_state;
+    auto material_id = scene.CreateEntity();
+    scene.Create<MaterialComponent>(material_id);
+
+    for (int i = 0; i < TREE_COUNT; ++i) {
+        auto id = scene.CreateEntity();
+        TransformComponent& transform = scene.Create<TransformComponent>(id);
+        transform.SetWorldMatrix(Translate(Vector3f(2.0f * (i % ROW_LENGTH - ROW_LENGTH / 2), 0.0f, -2.0f * (i / ROW_LENGTH))));
+
+        MeshRendererComponent& renderer = scene.Create<MeshRendererComponent>(id);
+        renderer.SetResourceGuid(mesh_guid);
+        renderer.AddMaterial(material_id);
+    }
+    scene.m_bound = AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -50.0f), Vector3f(200.0f));
+
+    FrameData::Camera camera{};
+    camera.position = Vector3f(0.0f, 60.0f, 10.0f);
+    camera.front = normalize(Vector3f(0.0f, -1.0f, -1.0f));
+    camera.viewMatrix = LookAtRh(camera.position, camera.position + camera.front, Vector3f::UnitY);
+    camera.projectionMatrixFrustum = BuildPerspectiveRH(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    camera.projectionMatrixRendering = camera.projectionMatrixFrustum;
+
+    FrameData framedata(RenderOptions{});
+    for (int frame = 0; frame < 2; ++frame) {
+        framedata.Reset(RenderOptions{});
+        framedata.mainCamera = camera;
+        RunMeshRenderSystem(&scene, &scene_state, framedata);
+    }
+
+    uint32_t instanced_draw_count = 0;
+    uint32_t instance_count = 0;
+    for (const RenderCommand& command : framedata.gbuffer_commands.GetCommands()) {
+        const DrawCommand& draw = command.draw;
+        if (draw.instance_count <= 1) {
+            continue;
+        }
+
+        ++instanced_draw_count;
+        instance_count += draw.instance_count;
+        // a whole BoneConstantBuffer is bound at the offset, it must stay inside the buffer
+        EXPECT_GE(static_cast<uint32_t>(draw.bone_offset), framedata.instanceRowOffset);
+        EXPECT_LE(draw.bone_offset + BONE_BLOCK_ROW_COUNT, framedata.boneBufferRowCount);
+    }
+    EXPECT_GT(instanced_draw_count, 0u);
+    EXPECT_GT(instance_count, static_cast<uint32_t>(TREE_COUNT / 2));
+
+    // no skeletons, the instance rows start at the top of the buffer
+    EXPECT_EQ(framedata.instanceRowOffset, 0u);
+    EXPECT_GE(framedata.boneBufferRowCount, framedata.instanceRows.size() + BONE_BLOCK_ROW_COUNT);
+    EXPECT_LT(framedata.boneBufferRowCount, BONE_BUFFER_ROW_COUNT);
+    EXPECT_EQ(framedata.boneBufferRowCount, scene_state.bone_palette.GetBufferRowCount());
+
+    // the frame keeps the gpu mesh of its draws alive until it's reset
+    std::weak_ptr<GpuMesh> gpu_mesh = mesh->gpuResource;
+    mesh->gpuResource.reset();
+    EXPECT_FALSE(gpu_mesh.expired());
+    framedata.Reset(RenderOptions{});
+    EXPECT_TRUE(gpu_mesh.expired());
+}
+
+// The materials and palettes of renderers outside every culling volume aren't written.
+TEST(mesh_render_system, shared_buffers_only_visible) {
+    AssetRegistry registry;
+    auto mesh = std::make_shared<MeshAsset>();
+    mesh->localBound = AABB::FromCenterSize(Vector3f(0.0f), Vector3f(1.0f));
+    mesh->indices.resize(36);
+    mesh->gpuResource = std::make_shared<GpuMesh>();
+    auto& subset = mesh->subsets.emplace_back();
+    subset.index_count = 36;
+    subset.local_bound = mesh->localBound;
+
+    AssetMetaData meta;
+    meta.type = AssetType::Mesh;
+    meta.guid = Guid::Create();
+    meta.import_path = "@test/skinned";
+    const Guid mesh_guid = meta.guid;
+    registry.RegisterAsset(std::move(meta), mesh);
+
+    Scene scene;
+    SceneRenderState scene_state;
+    auto add_character = [&](const Vector3f& p_position, ecs::Entity& p_material_id, ecs::Entity& p_skeleton_id) {
+        p_material_id = scene.CreateEntity();
+        scene.Create<MaterialComponent>(p_material_id);
+
+        p_skeleton_id = scene.CreateEntity();
+        SkeletonComponent& skeleton = scene.Create<SkeletonComponent>(p_skeleton_id);
+        skeleton.bone_transforms.assign(4, Matrix4x4f(1.0f));
+
+        auto id = scene.CreateEntity();
+        scene.Create<TransformComponent>(id).SetWorldMatrix(Translate(p_position));
+        MeshRendererComponent& renderer = scene.Create<MeshRendererComponent>(id);
+        renderer.SetResourceGuid(mesh_guid);
+        renderer.AddMaterial(p_material_id);
+        renderer.SetSkeletonId(p_skeleton_id);
+    };
+
+    ecs::Entity front_material, front_skeleton;
+    ecs::Entity back_material, back_skeleton;
+    add_character(Vector3f(0.0f, 0.0f, -5.0f), front_material, front_skeleton);
+    add_character(Vector3f(0.0f, 0.0f, 5.0f), back_material, back_skeleton);
+
+    jobsystem::Context ctx;
+    RunMeshAABBUpdateSystem(scene, ctx, 0.0f);
+
+    FrameData::Camera camera{};
+    camera.position = Vector3f(0.0f);
+    camera.front = Vector3f(0.0f, 0.0f, -1.0f);
+    camera.viewMatrix = LookAtRh(camera.position, camera.position + camera.front, Vector3f::UnitY);
+    camera.projectionMatrixFrustum = BuildPerspectiveRH(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    camera.projectionMatrixRendering = camera.projectionMatrixFrustum;
+
+    FrameData framedata(RenderOptions{});
+    framedata.Reset(RenderOptions{});
+    framedata.mainCamera = camera;
+    RunMeshRenderSystem(&scene, &scene_state, framedata);
+
+    EXPECT_NE(scene_state.bone_palette.Find(front_skeleton), nullptr);
+    EXPECT_EQ(scene_state.bone_palette.Find(back_skeleton), nullptr);
+    EXPECT_GE(scene_state.material_table.Find(front_material), 0);
+    EXPECT_EQ(scene_state.material_table.Find(back_material), -1);
+    EXPECT_EQ(framedata.gbuffer_commands.GetCommands().size(), 1u);
+}
+
+}  // namespace cave
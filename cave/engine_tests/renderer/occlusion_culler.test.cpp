@@ -0,0 +1,105 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/occlusion_culler.h"
+
+namespace cave {
+
+// camera at the origin looking down -z
+static Matrix4x4f OcclusionViewProjection() {
+    const Matrix4x4f view = LookAtRh(Vector3f(0.0f), Vector3f(0.0f, 0.0f, -1.0f), Vector3f::UnitY);
+    return BuildPerspectiveRH(glm::radians(90.0f), 2.0f, 0.1f, 100.0f) * view;
+}
+
+// a 2x2 quad facing the camera, scaled and moved by the world matrix
+static const std::vector<Vector3f> s_quadPositions = {
+    Vector3f(-1.0f, -1.0f, 0.0f),
+    Vector3f(1.0f, -1.0f, 0.0f),
+    Vector3f(1.0f, 1.0f, 0.0f),
+    Vector3f(-1.0f, 1.0f, 0.0f),
+};
+static const std::vector<uint32_t> s_quadIndices = { 0, 1, 2, 0, 2, 3 };
+
+// a 4x4 wall 5 units in front of the camera
+static void AddWall(OcclusionCuller& p_culler) {
+    const Matrix4x4f world = Translate(Vector3f(0.0f, 0.0f, -5.0f)) * Scale(Vector3f(2.0f, 2.0f, 1.0f));
+    EXPECT_TRUE(p_culler.AddOccluder(world, s_quadPositions, s_quadIndices));
+}
+
+TEST(occlusion_culler, nothing_is_occluded_without_occluders) {
+    OcclusionCuller culler;
+    culler.BeginFrame(OcclusionViewProjection());
+    culler.Rasterize();
+
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -50.0f), Vector3f(1.0f))));
+    EXPECT_EQ(culler.GetStats().occluder_count, 0u);
+}
+
+TEST(occlusion_culler, boxes_behind_a_wall) {
+    OcclusionCuller culler;
+    culler.BeginFrame(OcclusionViewProjection());
+    AddWall(culler);
+    culler.Rasterize();
+
+    // behind the middle of the wall, small and large on screen
+    EXPECT_TRUE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -10.0f), Vector3f(1.0f))));
+    EXPECT_TRUE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -8.0f), Vector3f(2.0f, 2.0f, 1.0f))));
+    // in front of the wall
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -3.0f), Vector3f(1.0f))));
+    // crossing the wall
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -5.0f), Vector3f(1.0f))));
+    // beside it
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(8.0f, 0.0f, -10.0f), Vector3f(1.0f))));
+    // sticking out of its edge
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(3.5f, 0.0f, -10.0f), Vector3f(1.0f))));
+    // around the camera
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f), Vector3f(1.0f))));
+}
+
+TEST(occlusion_culler, clips_occluders_at_the_camera) {
+    OcclusionCuller culler;
+    culler.BeginFrame(OcclusionViewProjection());
+    // a floor going from behind the camera into the distance
+    const Matrix4x4f world = Translate(Vector3f(0.0f, -1.0f, -40.0f)) * Rotate(Degree(-90.0f), Vector3f::UnitX) * Scale(Vector3f(50.0f, 50.0f, 1.0f));
+    EXPECT_TRUE(culler.AddOccluder(world, s_quadPositions, s_quadIndices));
+    culler.Rasterize();
+
+    EXPECT_TRUE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, -3.0f, -10.0f), Vector3f(1.0f))));
+    EXPECT_FALSE(culler.IsOccluded(AABB::FromCenterSize(Vector3f(0.0f, 0.0f, -10.0f), Vector3f(1.0f))));
+}
+
+TEST(occlusion_culler, hierarchy_keeps_the_farthest_depth) {
+    OcclusionCuller culler(64, 32);
+    culler.BeginFrame(OcclusionViewProjection());
+    AddWall(culler);
+    culler.Rasterize();
+
+    ASSERT_EQ(culler.GetLevelCount(), 7);
+    // the wall covers the middle of the screen only
+    EXPECT_FLOAT_EQ(culler.GetDepth(0, 32, 16), 0.2f);
+    EXPECT_FLOAT_EQ(culler.GetDepth(0, 0, 0), 0.0f);
+    EXPECT_FLOAT_EQ(culler.GetDepth(6, 0, 0), 0.0f);
+    for (int level = 1; level < culler.GetLevelCount(); ++level) {
+        EXPECT_LE(culler.GetDepth(level, 0, 0), culler.GetDepth(level - 1, 0, 0));
+    }
+}
+
+TEST(occlusion_culler, respects_the_triangle_budget) {
+    OcclusionCuller culler(OcclusionCuller::DEFAULT_WIDTH, OcclusionCuller::DEFAULT_HEIGHT, 3);
+    culler.BeginFrame(OcclusionViewProjection());
+    AddWall(culler);
+    // two more triangles don't fit
+    EXPECT_FALSE(culler.AddOccluder(Translate(Vector3f(0.0f, 0.0f, -2.0f)), s_quadPositions, s_quadIndices));
+    culler.Rasterize();
+    culler.SetQueryCounts(10, 4);
+
+    const OcclusionCuller::Stats& stats = culler.GetStats();
+    EXPECT_EQ(stats.occluder_count, 1u);
+    EXPECT_EQ(stats.triangle_count, 2u);
+    EXPECT_EQ(stats.tested_count, 10u);
+    EXPECT_EQ(stats.culled_count, 4u);
+
+    // the next frame starts over
+    culler.BeginFrame(OcclusionViewProjection());
+    EXPECT_EQ(culler.GetStats().triangle_count, 0u);
+}
+
+}  // namespace cave
@@ -0,0 +1,562 @@
+#include "engine/empty/empty_graphics_manager.h"
+#include "engine/render_graph/render_graph.h"
+#include "engine/render_graph/render_graph_builder.h"
+#include "engine/renderer/frame_data.h"
+
+#include <random>
+
+namespace cave {
+
+static RenderGraphBuilderConfig AliasingTestConfig() {
+    RenderGraphBuilderConfig config;
+    config.is_runtime = false;
+    config.frameWidth = 64;
+    config.frameHeight = 32;
+    return config;
+}
+
+static const RenderGraphResourceInfo* FindResourceInfo(const RenderGraph& p_graph, std::string_view p_name) {
+    for (const auto& info : p_graph.GetResourceInfos()) {
+        if (info.name == p_name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+// every pass reads the output of the one before
+TEST(render_graph_builder, chain_reuses_textures) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+    builder.AddPass("p0").Create("t0", { desc }).Write(ResourceAccess::RTV, "t0");
+    builder.AddPass("p1").Create("t1", { desc }).Read(ResourceAccess::SRV, "t0").Write(ResourceAccess::RTV, "t1");
+    builder.AddPass("p2").Create("t2", { desc }).Read(ResourceAccess::SRV, "t1").Write(ResourceAccess::RTV, "t2");
+    builder.AddPass("p3").Create("t3", { desc }).Read(ResourceAccess::SRV, "t2").Write(ResourceAccess::RTV, "t3");
+    builder.AddPass("p4").Create("t4", { desc, PointClampSampler(), true }).Read(ResourceAccess::SRV, "t3").Write(ResourceAccess::RTV, "t4");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+
+    EXPECT_EQ(graph->FindResource("t0"), graph->FindResource("t2"));
+    EXPECT_EQ(graph->FindResource("t1"), graph->FindResource("t3"));
+    EXPECT_NE(graph->FindResource("t0"), graph->FindResource("t1"));
+    // persistent resources keep their own texture
+    EXPECT_NE(graph->FindResource("t4"), graph->FindResource("t2"));
+    EXPECT_NE(graph->FindResource("t4"), graph->FindResource("t3"));
+
+    const RenderGraphResourceInfo* t2 = FindResourceInfo(*graph, "t2");
+    ASSERT_NE(t2, nullptr);
+    EXPECT_EQ(t2->firstPass, 2);
+    EXPECT_EQ(t2->lastPass, 3);
+    EXPECT_EQ(t2->sizeInByte, 64u * 32u * 8u);
+
+    const RenderGraphMemoryStats& stats = graph->GetMemoryStats();
+    EXPECT_EQ(stats.resourceCount, 5u);
+    EXPECT_EQ(stats.textureCount, 3u);
+    EXPECT_EQ(stats.dedicatedBytes, 5u * t2->sizeInByte);
+    EXPECT_EQ(stats.allocatedBytes, 3u * t2->sizeInByte);
+    EXPECT_EQ(stats.peakLiveBytes, 3u * t2->sizeInByte);
+}
+
+// a different format, size or sampler needs its own texture
+TEST(render_graph_builder, only_matching_resources_alias) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+    const GpuTextureDesc other_format = builder.BuildDefaultTextureDesc(PixelFormat::R8G8B8A8_UNORM, AttachmentType::COLOR_2D);
+    const GpuTextureDesc half_size = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D, 32, 16);
+
+    builder.AddPass("p0").Create("t0", { desc }).Write(ResourceAccess::RTV, "t0");
+    builder.AddPass("p1").Create("t1", { desc }).Read(ResourceAccess::SRV, "t0").Write(ResourceAccess::RTV, "t1");
+    builder.AddPass("p2").Create("format", { other_format }).Read(ResourceAccess::SRV, "t1").Write(ResourceAccess::RTV, "format");
+    builder.AddPass("p3").Create("size", { half_size }).Read(ResourceAccess::SRV, "format").Write(ResourceAccess::RTV, "size");
+    builder.AddPass("p4").Create("sampler", { desc, LinearClampSampler() }).Read(ResourceAccess::SRV, "size").Write(ResourceAccess::RTV, "sampler");
+    builder.AddPass("p5").Create("t5", { desc }).Read(ResourceAccess::SRV, "sampler").Write(ResourceAccess::RTV, "t5");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+
+    const auto t0 = graph->FindResource("t0");
+    const auto t1 = graph->FindResource("t1");
+    EXPECT_NE(graph->FindResource("format"), t0);
+    EXPECT_NE(graph->FindResource("size"), t0);
+    EXPECT_NE(graph->FindResource("sampler"), t0);
+    EXPECT_NE(graph->FindResource("sampler"), t1);
+    // the last one fits the texture freed most recently
+    EXPECT_EQ(graph->FindResource("t5"), t1);
+    EXPECT_EQ(graph->GetMemoryStats().textureCount, 5u);
+}
+
+// Random graphs, every pass reads a few earlier resources. Resources sharing a texture must never
+// be alive in the same pass and the texture must take every bind flag they need.
+TEST(render_graph_builder, aliased_lifetimes_never_overlap) {
+    std::mt19937 engine(17);
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        EmptyGraphicsManager gm;
+        RenderGraphBuilder builder(AliasingTestConfig(), gm);
+        const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+        constexpr int PASS_COUNT = 24;
+        std::set<std::string> uavs;
+        for (int pass_idx = 0; pass_idx < PASS_COUNT; ++pass_idx) {
+            const std::string name = std::format("t{}", pass_idx);
+            auto& pass = builder.AddPass(std::format("p{}", pass_idx));
+            pass.Create(name, { desc });
+            if (pass_idx > 0) {
+                for (int read = 0; read < 2; ++read) {
+                    const int input = std::uniform_int_distribution<int>(glm::max(0, pass_idx - 6), pass_idx - 1)(engine);
+                    const std::string input_name = std::format("t{}", input);
+                    if (read) {
+                        pass.Read(ResourceAccess::SRV, input_name);
+                    } else {
+                        pass.Read(ResourceAccess::UAV, input_name);
+                        uavs.insert(input_name);
+                    }
+                }
+            }
+            pass.Write(ResourceAccess::RTV, name);
+        }
+
+        auto result = builder.Compile();
+        ASSERT_TRUE(result.has_value());
+        std::shared_ptr<RenderGraph> graph = *result;
+
+        const auto& infos = graph->GetResourceInfos();
+        ASSERT_EQ(infos.size(), size_t(PASS_COUNT));
+        for (const auto& lhs : infos) {
+            const auto texture = graph->FindResource(lhs.name);
+            ASSERT_NE(texture, nullptr);
+            EXPECT_TRUE(texture->desc.bindFlags & BIND_RENDER_TARGET);
+            if (uavs.contains(lhs.name)) {
+                EXPECT_TRUE(texture->desc.bindFlags & BIND_UNORDERED_ACCESS);
+            }
+            for (const auto& rhs : infos) {
+                if (&lhs == &rhs || lhs.textureIdx != rhs.textureIdx) {
+                    continue;
+                }
+                EXPECT_TRUE(lhs.lastPass < rhs.firstPass || rhs.lastPass < lhs.firstPass);
+            }
+        }
+
+        const RenderGraphMemoryStats& stats = graph->GetMemoryStats();
+        EXPECT_LT(stats.textureCount, stats.resourceCount);
+        EXPECT_LE(stats.peakLiveBytes, stats.allocatedBytes);
+        EXPECT_LT(stats.allocatedBytes, stats.dedicatedBytes);
+    }
+}
+
+static std::vector<std::string> ScheduledPasses(RenderGraph& p_graph, const RenderOptions& p_options) {
+    std::vector<std::string> names;
+    for (int idx : p_graph.GetSchedule(p_options)) {
+        names.emplace_back(p_graph.GetRenderPasses()[idx]->GetName());
+    }
+    return names;
+}
+
+static bool SsaoCondition(const RenderOptions& p_options) {
+    return p_options.ssaoEnabled;
+}
+
+static bool BloomCondition(const RenderOptions& p_options) {
+    return p_options.bloomEnabled;
+}
+
+// passes whose resources never reach the output are dropped with what they create and import
+TEST(render_graph_builder, culls_passes_without_output) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+    int import_count = 0;
+    builder.AddPass("scene").Create("color", { desc }).Write(ResourceAccess::RTV, "color");
+    builder.AddPass("debug").Create("debug", { desc }).Read(ResourceAccess::SRV, "color").Write(ResourceAccess::RTV, "debug");
+    builder.AddPass("debug_view")
+        .Import("noise", [&]() {
+            ++import_count;
+            return std::shared_ptr<GpuTexture>();
+        })
+        .Create("debug_view", { desc })
+        .Read(ResourceAccess::SRV, "debug")
+        .Read(ResourceAccess::SRV, "noise")
+        .Write(ResourceAccess::RTV, "debug_view");
+    builder.AddPass("tone").Create("final", { desc, PointClampSampler(), true }).Read(ResourceAccess::SRV, "color").Write(ResourceAccess::RTV, "final");
+    builder.AddOutput("final");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+
+    ASSERT_EQ(graph->GetRenderPasses().size(), 2u);
+    EXPECT_NE(graph->FindPass("scene"), nullptr);
+    EXPECT_NE(graph->FindPass("tone"), nullptr);
+    EXPECT_EQ(graph->FindPass("debug"), nullptr);
+    EXPECT_EQ(graph->GetCulledPasses(), std::vector<std::string>({ "debug", "debug_view" }));
+    EXPECT_EQ(graph->FindResource("debug"), nullptr);
+    EXPECT_EQ(graph->FindResource("debug_view"), nullptr);
+    EXPECT_EQ(import_count, 0);
+    EXPECT_EQ(graph->GetMemoryStats().resourceCount, 2u);
+}
+
+// writing a resource a live pass touches keeps a pass, so do manual dependencies
+TEST(render_graph_builder, keeps_writers_and_dependencies) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+    const GpuTextureDesc depth_desc = builder.BuildDefaultTextureDesc(PixelFormat::D24_UNORM_S8_UINT, AttachmentType::DEPTH_STENCIL_2D);
+
+    builder.AddPass("early_z").Create("depth", { depth_desc }).Write(ResourceAccess::DSV, "depth");
+    builder.AddPass("outline").Create("outline", { desc }).Write(ResourceAccess::RTV, "outline").Write(ResourceAccess::DSV, "depth");
+    builder.AddPass("bake").Create("cube", { desc, PointClampSampler(), true }).Write(ResourceAccess::RTV, "cube");
+    builder.AddPass("unused").Create("unused", { desc }).Write(ResourceAccess::RTV, "unused");
+    builder.AddPass("tone").Create("final", { desc, PointClampSampler(), true }).Read(ResourceAccess::SRV, "depth").Write(ResourceAccess::RTV, "final");
+    builder.AddDependency("bake", "tone");
+    builder.AddDependency("unused", "outline");
+    builder.AddOutput("final");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+
+    EXPECT_EQ(graph->GetRenderPasses().size(), 5u);
+    EXPECT_TRUE(graph->GetCulledPasses().empty());
+}
+
+TEST(render_graph_builder, output_must_be_written) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+    builder.AddPass("p0").Create("t0", { desc }).Write(ResourceAccess::RTV, "t0");
+    builder.AddOutput("missing");
+    EXPECT_FALSE(builder.Compile().has_value());
+}
+
+// Disabled conditional passes are skipped with the passes only they need. The schedule is built
+// once per combination of conditions, other options don't matter.
+TEST(render_graph_builder, conditional_pass_schedules) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+    builder.AddPass("gbuffer").Create("normal", { desc }).Write(ResourceAccess::RTV, "normal");
+    builder.AddPass("noise").Create("noise", { desc }).Write(ResourceAccess::RTV, "noise");
+    builder.AddPass("ssao").Create("ssao", { desc }).Read(ResourceAccess::SRV, "normal").Read(ResourceAccess::SRV, "noise").Write(ResourceAccess::RTV, "ssao").SetCondition(SsaoCondition);
+    builder.AddPass("lighting").Create("lighting", { desc }).Read(ResourceAccess::SRV, "normal").Read(ResourceAccess::SRV, "ssao").Write(ResourceAccess::RTV, "lighting");
+    builder.AddPass("bloom").Create("bloom", { desc }).Read(ResourceAccess::SRV, "lighting").Write(ResourceAccess::RTV, "bloom").SetCondition(BloomCondition);
+    builder.AddPass("tone").Create("final", { desc, PointClampSampler(), true }).Read(ResourceAccess::SRV, "lighting").Read(ResourceAccess::SRV, "bloom").Write(ResourceAccess::RTV, "final");
+    builder.AddOutput("final");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+    EXPECT_TRUE(graph->FindPass("ssao")->IsConditional());
+    EXPECT_FALSE(graph->FindPass("tone")->IsConditional());
+
+    RenderOptions options;
+    options.ssaoEnabled = true;
+    options.bloomEnabled = true;
+    EXPECT_EQ(ScheduledPasses(*graph, options),
+              std::vector<std::string>({ "gbuffer", "noise", "ssao", "lighting", "bloom", "tone" }));
+
+    options.ssaoEnabled = false;
+    EXPECT_EQ(ScheduledPasses(*graph, options),
+              std::vector<std::string>({ "gbuffer", "lighting", "bloom", "tone" }));
+
+    options.bloomEnabled = false;
+    EXPECT_EQ(ScheduledPasses(*graph, options),
+              std::vector<std::string>({ "gbuffer", "lighting", "tone" }));
+
+    const std::vector<int>* cached = &graph->GetSchedule(options);
+    options.ssaoKernelRadius = 2.0f;
+    options.meshLodEnabled = true;
+    EXPECT_EQ(&graph->GetSchedule(options), cached);
+
+    options.ssaoEnabled = true;
+    EXPECT_NE(&graph->GetSchedule(options), cached);
+    EXPECT_EQ(graph->GetSchedule(options).size(), 5u);
+}
+
+// Random graphs with a few outputs. A culled pass never feeds a kept one and every kept pass
+// leads to an output.
+TEST(render_graph_builder, culling_keeps_what_outputs_need) {
+    std::mt19937 engine(29);
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        EmptyGraphicsManager gm;
+        RenderGraphBuilder builder(AliasingTestConfig(), gm);
+        const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+        constexpr int PASS_COUNT = 24;
+        std::vector<std::vector<int>> reads(PASS_COUNT);
+        for (int pass_idx = 0; pass_idx < PASS_COUNT; ++pass_idx) {
+            auto& pass = builder.AddPass(std::format("p{}", pass_idx));
+            pass.Create(std::format("t{}", pass_idx), { desc });
+            const int read_count = pass_idx ? std::uniform_int_distribution<int>(0, 2)(engine) : 0;
+            for (int read = 0; read < read_count; ++read) {
+                const int input = std::uniform_int_distribution<int>(0, pass_idx - 1)(engine);
+                pass.Read(ResourceAccess::SRV, std::format("t{}", input));
+                reads[pass_idx].push_back(input);
+            }
+            pass.Write(ResourceAccess::RTV, std::format("t{}", pass_idx));
+        }
+
+        std::vector<bool> expected(PASS_COUNT, false);
+        for (int output : { PASS_COUNT - 1, PASS_COUNT / 2 }) {
+            builder.AddOutput(std::format("t{}", output));
+            expected[output] = true;
+        }
+        for (int pass_idx = PASS_COUNT - 1; pass_idx >= 0; --pass_idx) {
+            if (expected[pass_idx]) {
+                for (int input : reads[pass_idx]) {
+                    expected[input] = true;
+                }
+            }
+        }
+
+        auto result = builder.Compile();
+        ASSERT_TRUE(result.has_value());
+        std::shared_ptr<RenderGraph> graph = *result;
+
+        size_t kept = 0;
+        for (int pass_idx = 0; pass_idx < PASS_COUNT; ++pass_idx) {
+            const bool found = graph->FindPass(std::format("p{}", pass_idx)) != nullptr;
+            EXPECT_EQ(found, expected[pass_idx]);
+            EXPECT_EQ(graph->FindResource(std::format("t{}", pass_idx)) != nullptr, expected[pass_idx]);
+            kept += found;
+        }
+        EXPECT_EQ(graph->GetRenderPasses().size(), kept);
+        EXPECT_EQ(graph->GetCulledPasses().size(), PASS_COUNT - kept);
+    }
+}
+
+static std::vector<std::vector<std::string>> LevelNames(const RenderGraph& p_graph) {
+    std::vector<std::vector<std::string>> names;
+    for (const auto& level : p_graph.GetLevels()) {
+        auto& level_names = names.emplace_back();
+        for (int idx : level.passes) {
+            level_names.emplace_back(p_graph.GetRenderPasses()[idx]->GetName());
+        }
+    }
+    return names;
+}
+
+// shadows don't wait for the gbuffer, ssao and the outline only read what the gbuffer wrote
+TEST(render_graph_builder, dependency_levels) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+    const GpuTextureDesc depth_desc = builder.BuildDefaultTextureDesc(PixelFormat::D24_UNORM_S8_UINT, AttachmentType::DEPTH_STENCIL_2D);
+
+    builder.AddPass("shadow").Create("shadow", { depth_desc, LinearClampSampler() }).Write(ResourceAccess::DSV, "shadow");
+    builder.AddPass("gbuffer").Create("normal", { desc }).Create("depth", { depth_desc }).Write(ResourceAccess::RTV, "normal").Write(ResourceAccess::DSV, "depth");
+    builder.AddPass("ssao").Create("ssao", { desc }).Read(ResourceAccess::SRV, "normal").Read(ResourceAccess::SRV, "depth").Write(ResourceAccess::RTV, "ssao");
+    builder.AddPass("outline").Create("outline", { desc }).Read(ResourceAccess::SRV, "depth").Write(ResourceAccess::RTV, "outline");
+    builder.AddPass("lighting").Create("lighting", { desc }).Read(ResourceAccess::SRV, "normal").Read(ResourceAccess::SRV, "ssao").Read(ResourceAccess::SRV, "shadow").Write(ResourceAccess::RTV, "lighting");
+    builder.AddPass("bloom").Create("bloom", { desc, LinearClampSampler() }).Read(ResourceAccess::SRV, "lighting").Write(ResourceAccess::RTV, "bloom");
+    builder.AddPass("tone").Create("final", { desc, PointClampSampler(), true }).Read(ResourceAccess::SRV, "lighting").Read(ResourceAccess::SRV, "bloom").Read(ResourceAccess::SRV, "outline").Write(ResourceAccess::RTV, "final");
+    builder.AddOutput("final");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+
+    using Levels = std::vector<std::vector<std::string>>;
+    EXPECT_EQ(LevelNames(*graph), Levels({ { "shadow", "gbuffer" }, { "ssao", "outline" }, { "lighting" }, { "bloom" }, { "tone" } }));
+}
+
+// a resource moving into a texture after another one waits for its last reader
+TEST(render_graph_builder, aliasing_waits_for_last_reader) {
+    EmptyGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+    const GpuTextureDesc other_format = builder.BuildDefaultTextureDesc(PixelFormat::R8G8B8A8_UNORM, AttachmentType::COLOR_2D);
+
+    builder.AddPass("p0").Create("t0", { desc }).Write(ResourceAccess::RTV, "t0");
+    builder.AddPass("other").Create("other", { other_format }).Write(ResourceAccess::RTV, "other");
+    builder.AddPass("p1").Create("t1", { desc }).Read(ResourceAccess::SRV, "t0").Write(ResourceAccess::RTV, "t1");
+    builder.AddPass("p2").Create("t2", { desc }).Read(ResourceAccess::SRV, "other").Write(ResourceAccess::RTV, "t2");
+    builder.AddPass("p3").Create("t3", { desc, PointClampSampler(), true }).Read(ResourceAccess::SRV, "t1").Read(ResourceAccess::SRV, "t2").Write(ResourceAccess::RTV, "t3");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+    ASSERT_EQ(graph->FindResource("t0"), graph->FindResource("t2"));
+
+    // p2 only reads what the level before wrote, but can't start before p1 is done with t0
+    using Levels = std::vector<std::vector<std::string>>;
+    EXPECT_EQ(LevelNames(*graph), Levels({ { "p0", "other" }, { "p1" }, { "p2" }, { "p3" } }));
+}
+
+// Random graphs with aliasing. Passes sharing a level never touch the same texture unless both
+// read it, and every pass comes after what it reads.
+TEST(render_graph_builder, levels_have_no_hazards) {
+    std::mt19937 engine(41);
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        EmptyGraphicsManager gm;
+        RenderGraphBuilder builder(AliasingTestConfig(), gm);
+        const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+        constexpr int PASS_COUNT = 32;
+        std::vector<std::vector<int>> reads(PASS_COUNT);
+        for (int pass_idx = 0; pass_idx < PASS_COUNT; ++pass_idx) {
+            auto& pass = builder.AddPass(std::format("p{}", pass_idx));
+            pass.Create(std::format("t{}", pass_idx), { desc });
+            const int read_count = pass_idx ? std::uniform_int_distribution<int>(0, 2)(engine) : 0;
+            for (int read = 0; read < read_count; ++read) {
+                const int input = std::uniform_int_distribution<int>(glm::max(0, pass_idx - 8), pass_idx - 1)(engine);
+                const bool uav = std::uniform_int_distribution<int>(0, 3)(engine) == 0;
+                pass.Read(uav ? ResourceAccess::UAV : ResourceAccess::SRV, std::format("t{}", input));
+                reads[pass_idx].push_back(input);
+            }
+            pass.Write(ResourceAccess::RTV, std::format("t{}", pass_idx));
+        }
+
+        auto result = builder.Compile();
+        ASSERT_TRUE(result.has_value());
+        std::shared_ptr<RenderGraph> graph = *result;
+        const auto& passes = graph->GetRenderPasses();
+
+        std::vector<int> pass_levels(passes.size(), -1);
+        const auto& levels = graph->GetLevels();
+        for (int level = 0; level < (int)levels.size(); ++level) {
+            EXPECT_FALSE(levels[level].passes.empty());
+            for (int idx : levels[level].passes) {
+                EXPECT_EQ(pass_levels[idx], -1);
+                pass_levels[idx] = level;
+            }
+        }
+
+        auto written = [](const RenderPass& p_pass) {
+            std::set<const GpuTexture*> textures;
+            for (const auto* list : { &p_pass.GetRtvs(), &p_pass.GetUavs() }) {
+                for (const auto& texture : *list) {
+                    textures.insert(texture.get());
+                }
+            }
+            return textures;
+        };
+        auto touched = [&written](const RenderPass& p_pass) {
+            std::set<const GpuTexture*> textures = written(p_pass);
+            for (const auto& texture : p_pass.GetSrvs()) {
+                textures.insert(texture.get());
+            }
+            return textures;
+        };
+
+        for (int lhs = 0; lhs < (int)passes.size(); ++lhs) {
+            ASSERT_NE(pass_levels[lhs], -1);
+            for (int rhs = lhs + 1; rhs < (int)passes.size(); ++rhs) {
+                if (pass_levels[lhs] != pass_levels[rhs]) {
+                    continue;
+                }
+                const auto lhs_touched = touched(*passes[lhs]);
+                for (const GpuTexture* texture : written(*passes[rhs])) {
+                    EXPECT_FALSE(lhs_touched.contains(texture));
+                }
+                const auto rhs_touched = touched(*passes[rhs]);
+                for (const GpuTexture* texture : written(*passes[lhs])) {
+                    EXPECT_FALSE(rhs_touched.contains(texture));
+                }
+            }
+        }
+
+        std::map<std::string, int> level_by_name;
+        for (int idx = 0; idx < (int)passes.size(); ++idx) {
+            level_by_name[std::string(passes[idx]->GetName())] = pass_levels[idx];
+        }
+        for (int pass_idx = 0; pass_idx < PASS_COUNT; ++pass_idx) {
+            for (int input : reads[pass_idx]) {
+                EXPECT_GT(level_by_name[std::format("p{}", pass_idx)], level_by_name[std::format("p{}", input)]);
+            }
+        }
+        EXPECT_LT(levels.size(), passes.size());
+    }
+}
+
+struct RecordedPass {
+    std::string name;
+    const IRenderCmdContext* cmd;
+};
+
+static std::mutex s_recordedMutex;
+static std::vector<RecordedPass> s_recorded;
+
+static void RecordPassFunc(RenderPassExcutionContext& p_ctx) {
+    std::lock_guard lock(s_recordedMutex);
+    s_recorded.push_back({ std::string(p_ctx.pass.GetName()), &p_ctx.cmd });
+}
+
+// records the passes of a level on contexts of its own, like a backend recording concurrently
+class RecordingGraphicsManager : public EmptyGraphicsManager {
+public:
+    int GetRecordingContextCount() const override { return static_cast<int>(m_contexts.size()); }
+    IGraphicsManager& BeginRecording(int p_index) override { return m_contexts[p_index]; }
+
+    std::array<EmptyGraphicsManager, 3> m_contexts;
+};
+
+// every scheduled pass is recorded once, after the levels before it. The passes of a level go to
+// different contexts, a lone pass records on the graphics manager
+TEST(render_graph_builder, execute_follows_levels) {
+    RecordingGraphicsManager gm;
+    RenderGraphBuilder builder(AliasingTestConfig(), gm);
+    const GpuTextureDesc desc = builder.BuildDefaultTextureDesc(PixelFormat::R16G16B16A16_FLOAT, AttachmentType::COLOR_2D);
+
+    constexpr int WIDTH = 8;
+    for (int i = 0; i < WIDTH; ++i) {
+        builder.AddPass(std::format("a{}", i)).Create(std::format("a{}", i), { desc }).Write(ResourceAccess::RTV, std::format("a{}", i)).SetExecuteFunc(RecordPassFunc);
+    }
+    for (int i = 0; i < WIDTH; ++i) {
+        auto& pass = builder.AddPass(std::format("b{}", i));
+        // a different sampler, so the second row doesn't reuse the textures of the first
+        pass.Create(std::format("b{}", i), { desc, LinearClampSampler() })
+            .Read(ResourceAccess::SRV, std::format("a{}", i))
+            .Read(ResourceAccess::SRV, std::format("a{}", (i + 1) % WIDTH))
+            .Write(ResourceAccess::RTV, std::format("b{}", i))
+            .SetExecuteFunc(RecordPassFunc);
+        if (i % 2) {
+            pass.SetCondition(SsaoCondition);
+        }
+    }
+    auto& final_pass = builder.AddPass("final");
+    final_pass.Create("final", { desc, PointClampSampler(), true }).Write(ResourceAccess::RTV, "final").SetExecuteFunc(RecordPassFunc);
+    for (int i = 0; i < WIDTH; ++i) {
+        final_pass.Read(ResourceAccess::SRV, std::format("b{}", i));
+    }
+    builder.AddOutput("final");
+
+    auto result = builder.Compile();
+    ASSERT_TRUE(result.has_value());
+    std::shared_ptr<RenderGraph> graph = *result;
+    ASSERT_EQ(graph->GetLevels().size(), 3u);
+
+    const std::set<const IRenderCmdContext*> contexts = { &gm.m_contexts[0], &gm.m_contexts[1], &gm.m_contexts[2] };
+    for (bool ssao : { true, false }) {
+        RenderOptions options;
+        options.ssaoEnabled = ssao;
+        FrameData framedata(options);
+        s_recorded.clear();
+        graph->Execute(framedata, gm);
+
+        const size_t expected = ssao ? 2 * WIDTH + 1 : WIDTH + WIDTH / 2 + 1;
+        ASSERT_EQ(s_recorded.size(), expected);
+        std::set<std::string> names;
+        for (size_t i = 0; i < s_recorded.size(); ++i) {
+            const RecordedPass& recorded = s_recorded[i];
+            names.insert(recorded.name);
+            const char group = i < WIDTH ? 'a' : (i + 1 < expected ? 'b' : 'f');
+            EXPECT_EQ(recorded.name[0], group);
+            if (group == 'f') {
+                EXPECT_EQ(recorded.cmd, &gm);
+            } else {
+                EXPECT_TRUE(contexts.contains(recorded.cmd));
+            }
+        }
+        EXPECT_EQ(names.size(), expected);
+    }
+}
+
+}  // namespace cave
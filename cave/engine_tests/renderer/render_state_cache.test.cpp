@@ -0,0 +1,150 @@
+#include "engine/render_graph/draw_commands.h"
+#include "engine/renderer/frame_data.h"
+#include "filtered_graphics_manager.h"
+
+namespace cave {
+
+TEST(render_state_cache, drops_redundant_calls) {
+    GpuMesh mesh_a;
+    GpuMesh mesh_b;
+    GpuConstantBuffer buffer(GpuBufferDesc{ .type = GpuBufferType::CONSTANT, .slot = 1 });
+    RenderStateCache cache;
+
+    EXPECT_TRUE(cache.SetMesh(&mesh_a));
+    EXPECT_FALSE(cache.SetMesh(&mesh_a));
+    EXPECT_TRUE(cache.SetMesh(&mesh_b));
+    // the screen quad passes draw without a mesh
+    EXPECT_TRUE(cache.SetMesh(nullptr));
+    EXPECT_FALSE(cache.SetMesh(nullptr));
+
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 7, 3));
+    EXPECT_FALSE(cache.BindTexture(Dimension::TEXTURE_2D, 7, 3));
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 7, 4));
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_CUBE, 7, 3));
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 8, 3));
+
+    EXPECT_TRUE(cache.BindConstantBufferRange(&buffer, 64, 0));
+    EXPECT_FALSE(cache.BindConstantBufferRange(&buffer, 64, 0));
+    EXPECT_TRUE(cache.BindConstantBufferRange(&buffer, 64, 64));
+    EXPECT_TRUE(cache.BindConstantBufferRange(&buffer, 128, 64));
+
+    EXPECT_TRUE(cache.SetPipelineState(PSO_GBUFFER));
+    EXPECT_FALSE(cache.SetPipelineState(PSO_GBUFFER));
+
+    const RenderStateCache::Stats& stats = cache.GetStats();
+    EXPECT_EQ(stats.mesh.issued, 3u);
+    EXPECT_EQ(stats.mesh.filtered, 2u);
+    EXPECT_EQ(stats.texture.issued, 4u);
+    EXPECT_EQ(stats.texture.filtered, 1u);
+    EXPECT_EQ(stats.constant_buffer.issued, 3u);
+    EXPECT_EQ(stats.constant_buffer.filtered, 1u);
+    EXPECT_EQ(stats.pipeline_state.issued, 1u);
+    EXPECT_EQ(stats.pipeline_state.filtered, 1u);
+}
+
+TEST(render_state_cache, invalidation) {
+    GpuMesh mesh;
+    GpuConstantBuffer buffer(GpuBufferDesc{ .type = GpuBufferType::CONSTANT, .slot = 1 });
+    RenderStateCache cache;
+
+    cache.SetPipelineState(PSO_GBUFFER);
+    cache.SetMesh(&mesh);
+    cache.BindTexture(Dimension::TEXTURE_2D, 7, 3);
+    cache.BindTexture(Dimension::TEXTURE_2D, 9, 5);
+    cache.BindConstantBufferRange(&buffer, 64, 0);
+
+    cache.InvalidateTexture(3);
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 7, 3));
+    EXPECT_FALSE(cache.BindTexture(Dimension::TEXTURE_2D, 9, 5));
+
+    // a new pipeline forgets the bindings, the mesh stays
+    EXPECT_TRUE(cache.SetPipelineState(PSO_LIGHTING));
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 9, 5));
+    EXPECT_TRUE(cache.BindConstantBufferRange(&buffer, 64, 0));
+    EXPECT_FALSE(cache.SetMesh(&mesh));
+
+    cache.InvalidateMesh();
+    EXPECT_TRUE(cache.SetMesh(&mesh));
+
+    // new contents of a bound buffer are bound again, other buffers stay
+    GpuConstantBuffer other(GpuBufferDesc{ .type = GpuBufferType::CONSTANT, .slot = 2 });
+    EXPECT_TRUE(cache.BindConstantBufferRange(&other, 64, 0));
+    cache.InvalidateConstantBuffer(&buffer);
+    EXPECT_TRUE(cache.BindConstantBufferRange(&buffer, 64, 0));
+    EXPECT_FALSE(cache.BindConstantBufferRange(&other, 64, 0));
+
+    // slots the cache doesn't track always go through
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 7, RenderStateCache::TEXTURE_SLOT_COUNT));
+    EXPECT_TRUE(cache.BindTexture(Dimension::TEXTURE_2D, 7, RenderStateCache::TEXTURE_SLOT_COUNT));
+
+    const RenderStateCache::Stats stats = cache.GetStats();
+    cache.NewFrame();
+    EXPECT_EQ(cache.GetLastFrameStats().texture.issued, stats.texture.issued);
+    EXPECT_EQ(cache.GetStats().texture.issued, 0u);
+    EXPECT_TRUE(cache.SetMesh(&mesh));
+    EXPECT_TRUE(cache.SetPipelineState(PSO_LIGHTING));
+    EXPECT_TRUE(cache.BindConstantBufferRange(&buffer, 64, 0));
+}
+
+// Objects with a trunk and a leaves subset, drawn in submission order. The two materials only
+// differ in their base color, the normal and material maps are shared.
+TEST(render_state_cache, synthetic_stream) {
+    constexpr int OBJECT_COUNT = 100;
+    constexpr int SUBSET_COUNT = 2;
+    constexpr uint32_t DRAW_COUNT = OBJECT_COUNT * SUBSET_COUNT;
+
+    GpuMesh meshes[2];
+    FrameData framedata(RenderOptions{});
+    framedata.materials.resize(SUBSET_COUNT);
+    for (int subset = 0; subset < SUBSET_COUNT; ++subset) {
+        MaterialConstantBuffer& material = framedata.materials[subset];
+        material.c_baseColorMapHandle = 1 + subset;
+        material.c_normalMapHandle = 10;
+        material.c_materialMapHandle = 11;
+    }
+
+    RenderCommandList list;
+    for (int object = 0; object < OBJECT_COUNT; ++object) {
+        for (int subset = 0; subset < SUBSET_COUNT; ++subset) {
+            DrawCommand draw;
+            draw.mesh_data = &meshes[object % 2];
+            draw.batch_idx = object;
+            draw.mat_idx = subset;
+            draw.index_count = 36;
+            list.Add(RenderCommand::From(draw));
+        }
+    }
+
+    EmptyGraphicsManager unfiltered;
+    ExecuteDrawCommands(unfiltered, framedata, list);
+    const auto& requested = unfiltered.GetStateChangeCounters();
+
+    FilteredGraphicsManager gm;
+    ExecuteDrawCommands(gm, framedata, list);
+    const auto& issued = gm.GetStateChangeCounters();
+    const RenderStateCache::Stats& stats = gm.m_cache.GetStats();
+
+    EXPECT_EQ(issued.draw, DRAW_COUNT);
+
+    // what reached the backend is what the cache counted as issued
+    EXPECT_EQ(issued.setMesh, stats.mesh.issued);
+    EXPECT_EQ(issued.bindTexture, stats.texture.issued);
+    EXPECT_EQ(issued.bindConstantBuffer, stats.constant_buffer.issued);
+    EXPECT_EQ(requested.setMesh, stats.mesh.issued + stats.mesh.filtered);
+    EXPECT_EQ(requested.bindTexture, stats.texture.issued + stats.texture.filtered);
+    EXPECT_EQ(requested.bindConstantBuffer, stats.constant_buffer.issued + stats.constant_buffer.filtered);
+
+    // the mesh changes with every object, the second subset draws the same mesh
+    EXPECT_EQ(stats.mesh.issued, uint32_t(OBJECT_COUNT));
+    EXPECT_EQ(stats.mesh.filtered, uint32_t(OBJECT_COUNT));
+
+    // every draw switches material, only the base color changes after the first one
+    EXPECT_EQ(requested.bindTexture, 3 * DRAW_COUNT);
+    EXPECT_EQ(stats.texture.issued, DRAW_COUNT + 2);
+
+    // the batch of the second subset is already bound, the material slot changes every draw
+    EXPECT_EQ(stats.constant_buffer.issued, OBJECT_COUNT + DRAW_COUNT);
+    EXPECT_EQ(stats.constant_buffer.filtered, uint32_t(OBJECT_COUNT));
+}
+
+}  // namespace cave
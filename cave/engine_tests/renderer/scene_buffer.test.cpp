@@ -0,0 +1,128 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/scene_buffer.h"
+
+namespace cave {
+
+using BatchBuffer = SceneBuffer<PerBatchConstantBuffer>;
+
+static PerBatchConstantBuffer MakeBatch(float p_x) {
+    PerBatchConstantBuffer batch{};
+    batch.c_worldMatrix = Translate(Vector3f(p_x, 0.0f, 0.0f));
+    batch.c_meshFlag = 0;
+    return batch;
+}
+
+// returns the bytes the frame uploads
+static size_t RunFrame(BatchBuffer& p_buffer, const std::vector<PerBatchConstantBuffer>& p_batches, uint32_t* p_range_count = nullptr) {
+    memory::ArenaVector<BatchBuffer::Upload> uploads;
+    memory::ArenaVector<PerBatchConstantBuffer> values;
+    p_buffer.BeginFrame();
+    for (size_t i = 0; i < p_batches.size(); ++i) {
+        EXPECT_GE(p_buffer.Update(ecs::Entity(static_cast<uint32_t>(i + 1)), p_batches[i]), 0);
+    }
+    p_buffer.EndFrame(uploads, values);
+
+    uint32_t count = 0;
+    for (const BatchBuffer::Upload& upload : uploads) {
+        EXPECT_LE(upload.src_index + upload.count, values.size());
+        EXPECT_LE(upload.dst_index + upload.count, p_buffer.GetCapacity());
+        for (uint32_t i = 0; i < upload.count; ++i) {
+            EXPECT_EQ(memcmp(&values[upload.src_index + i], &p_buffer.Get(upload.dst_index + i), sizeof(PerBatchConstantBuffer)), 0);
+        }
+        count += upload.count;
+    }
+    EXPECT_EQ(count, values.size());
+    if (p_range_count) {
+        *p_range_count = static_cast<uint32_t>(uploads.size());
+    }
+    return count * sizeof(PerBatchConstantBuffer);
+}
+
+TEST(scene_buffer, static_scene_upload_bytes) {
+    constexpr uint32_t OBJECT_COUNT = 1000;
+    constexpr size_t FULL_BYTES = OBJECT_COUNT * sizeof(PerBatchConstantBuffer);
+    BatchBuffer buffer(SCENE_BATCH_COUNT, 2);
+    std::vector<PerBatchConstantBuffer> batches;
+    for (uint32_t i = 0; i < OBJECT_COUNT; ++i) {
+        batches.push_back(MakeBatch(static_cast<float>(i)));
+    }
+
+    // new slots go to both copies of the buffer, in a single range
+    uint32_t range_count = 0;
+    EXPECT_EQ(RunFrame(buffer, batches, &range_count), FULL_BYTES);
+    EXPECT_EQ(range_count, 1u);
+    EXPECT_EQ(RunFrame(buffer, batches), FULL_BYTES);
+
+    // nothing moves, nothing is uploaded
+    for (int frame = 0; frame < 10; ++frame) {
+        EXPECT_EQ(RunFrame(buffer, batches), 0u);
+        EXPECT_EQ(buffer.GetStats().changed_count, 0u);
+    }
+    EXPECT_EQ(buffer.GetStats().entry_count, OBJECT_COUNT);
+
+    // two neighbours and a lone object move
+    batches[10] = MakeBatch(-1.0f);
+    batches[11] = MakeBatch(-2.0f);
+    batches[500] = MakeBatch(-3.0f);
+    EXPECT_EQ(RunFrame(buffer, batches, &range_count), 3 * sizeof(PerBatchConstantBuffer));
+    EXPECT_EQ(range_count, 2u);
+    EXPECT_EQ(buffer.GetStats().changed_count, 3u);
+    EXPECT_EQ(RunFrame(buffer, batches, &range_count), 3 * sizeof(PerBatchConstantBuffer));
+    EXPECT_EQ(range_count, 2u);
+    EXPECT_EQ(RunFrame(buffer, batches), 0u);
+}
+
+TEST(scene_buffer, stable_slots) {
+    BatchBuffer buffer(16, 1);
+    memory::ArenaVector<BatchBuffer::Upload> uploads;
+    memory::ArenaVector<PerBatchConstantBuffer> values;
+
+    buffer.BeginFrame();
+    const int slot_a = buffer.Update(ecs::Entity(1), MakeBatch(1.0f));
+    const int slot_b = buffer.Update(ecs::Entity(2), MakeBatch(2.0f));
+    buffer.EndFrame(uploads, values);
+    EXPECT_NE(slot_a, slot_b);
+
+    // an object culled for a few frames comes back to its slot without an upload
+    for (int frame = 0; frame < 10; ++frame) {
+        buffer.BeginFrame();
+        EXPECT_EQ(buffer.Update(ecs::Entity(2), MakeBatch(2.0f)), slot_b);
+        buffer.EndFrame(uploads, values);
+    }
+    uploads.clear();
+    buffer.BeginFrame();
+    EXPECT_EQ(buffer.Update(ecs::Entity(1), MakeBatch(1.0f)), slot_a);
+    buffer.EndFrame(uploads, values);
+    EXPECT_TRUE(uploads.empty());
+
+    // gone for long enough, the slot goes to the next new object
+    for (uint32_t frame = 0; frame < BatchBuffer::RETIRE_FRAME_COUNT * 2; ++frame) {
+        buffer.BeginFrame();
+        buffer.Update(ecs::Entity(2), MakeBatch(2.0f));
+        buffer.EndFrame(uploads, values);
+    }
+    EXPECT_EQ(buffer.Find(ecs::Entity(1)), -1);
+    EXPECT_EQ(buffer.Find(ecs::Entity(2)), slot_b);
+
+    uploads.clear();
+    buffer.BeginFrame();
+    EXPECT_EQ(buffer.Update(ecs::Entity(3), MakeBatch(3.0f)), slot_a);
+    buffer.EndFrame(uploads, values);
+    ASSERT_EQ(uploads.size(), 1u);
+    EXPECT_EQ(uploads[0].dst_index, uint32_t(slot_a));
+}
+
+TEST(scene_buffer, full_buffer) {
+    BatchBuffer buffer(4, 1);
+    buffer.BeginFrame();
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(buffer.Update(ecs::Entity(i + 1), MakeBatch(0.0f)), static_cast<int>(i));
+    }
+    // the caller falls back to a transient batch
+    EXPECT_EQ(buffer.Update(ecs::Entity(5), MakeBatch(0.0f)), -1);
+    EXPECT_EQ(buffer.Find(ecs::Entity(5)), -1);
+    EXPECT_EQ(buffer.Update(ecs::Entity(2), MakeBatch(1.0f)), 1);
+}
+
+}  // namespace cave
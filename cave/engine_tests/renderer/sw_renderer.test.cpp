@@ -0,0 +1,273 @@
+#include "engine/assets/mesh_asset.h"
+#include "engine/renderer/sampler.h"
+#include "engine/systems/job_system/job_system.h"
+#include "modules/sw/sw_renderer.h"
+
+namespace cave {
+
+static std::shared_ptr<GpuTexture> CreateTarget(SwGraphicsManager& p_manager,
+                                                std::string p_name,
+                                                AttachmentType p_type,
+                                                PixelFormat p_format,
+                                                uint32_t p_width,
+                                                uint32_t p_height) {
+    GpuTextureDesc desc{};
+    desc.type = p_type;
+    desc.dimension = Dimension::TEXTURE_2D;
+    desc.width = p_width;
+    desc.height = p_height;
+    desc.mipLevels = 1;
+    desc.arraySize = 1;
+    desc.format = p_format;
+    desc.name = std::move(p_name);
+    return p_manager.CreateTexture(desc, SamplerDesc());
+}
+
+template<typename BUFFER>
+static std::shared_ptr<GpuConstantBuffer> BindConstants(SwGraphicsManager& p_manager, const BUFFER& p_data) {
+    auto buffer = p_manager.CreateConstantBuffer(GpuBufferDesc{
+        .type = GpuBufferType::CONSTANT,
+        .slot = BUFFER::GetUniformBufferSlot(),
+        .element_size = sizeof(BUFFER),
+        .element_count = 1,
+    });
+    EXPECT_TRUE(buffer);
+    p_manager.UpdateConstantBuffer(buffer->get(), &p_data, sizeof(BUFFER));
+    p_manager.BindConstantBufferRange(buffer->get(), sizeof(BUFFER), 0);
+    return *buffer;
+}
+
+static const SwGpuTexture& Pixels(const std::shared_ptr<GpuTexture>& p_texture) {
+    return *static_cast<const SwGpuTexture*>(p_texture.get());
+}
+
+static int CountCovered(const std::shared_ptr<GpuTexture>& p_texture) {
+    const SwGpuTexture& texture = Pixels(p_texture);
+    int count = 0;
+    for (int y = 0; y < texture.GetHeight(); ++y) {
+        for (int x = 0; x < texture.GetWidth(); ++x) {
+            count += texture.Load(x, y).a > 0.5f;
+        }
+    }
+    return count;
+}
+
+TEST(sw_renderer, gbuffer_writes_every_target) {
+    constexpr uint32_t SIZE = 64;
+    SwGraphicsManager manager;
+
+    auto base_color = CreateTarget(manager, "base_color", AttachmentType::COLOR_2D, PixelFormat::R8G8B8A8_UNORM, SIZE, SIZE);
+    auto normal = CreateTarget(manager, "normal", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, SIZE, SIZE);
+    auto material = CreateTarget(manager, "material", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, SIZE, SIZE);
+    auto depth = CreateTarget(manager, "depth", AttachmentType::DEPTH_2D, PixelFormat::D32_FLOAT, SIZE, SIZE);
+    auto framebuffer = manager.CreateFramebuffer(FramebufferDesc{
+        .colorAttachments = { base_color, normal, material },
+        .depthAttachment = depth,
+    });
+
+    const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    manager.SetRenderTarget(framebuffer.get());
+    manager.Clear(framebuffer.get(), static_cast<ClearFlags>(CLEAR_COLOR_BIT | CLEAR_DEPTH_BIT), clear_color, 0.0f);
+
+    PerBatchConstantBuffer batch{};
+    batch.c_worldMatrix = Matrix4x4f(1.0f);
+    PerPassConstantBuffer pass{};
+    pass.c_viewMatrix = Matrix4x4f(1.0f);
+    pass.c_projectionMatrix = Matrix4x4f(1.0f);
+    MaterialConstantBuffer material_constants{};
+    material_constants.c_baseColor = Vector4f(1.0f, 0.0f, 0.0f, 1.0f);
+    material_constants.c_metallic = 0.25f;
+    material_constants.c_roughness = 0.75f;
+    auto batch_buffer = BindConstants(manager, batch);
+    auto pass_buffer = BindConstants(manager, pass);
+    auto material_buffer = BindConstants(manager, material_constants);
+
+    // counter clockwise, covers the bottom left quarter of the target
+    MeshAsset mesh;
+    mesh.positions = { Vector3f(-1.0f, -1.0f, 0.5f), Vector3f(0.0f, -1.0f, 0.5f), Vector3f(-1.0f, 1.0f, 0.5f) };
+    mesh.normals = { Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, 1.0f) };
+    mesh.indices = { 0, 1, 2 };
+    auto gpu_mesh = manager.CreateMesh(mesh);
+    ASSERT_TRUE(gpu_mesh);
+
+    manager.SetPipelineState(PSO_GBUFFER);
+    manager.SetMesh(gpu_mesh->get());
+    manager.DrawElements(3);
+
+    EXPECT_EQ(CountCovered(base_color), SIZE * SIZE / 4);
+
+    const Vector4f inside_color = Pixels(base_color).Load(4, SIZE - 4);
+    EXPECT_FLOAT_EQ(inside_color.r, 1.0f);
+    EXPECT_FLOAT_EQ(inside_color.g, 0.0f);
+    const Vector4f inside_normal = Pixels(normal).Load(4, SIZE - 4);
+    EXPECT_FLOAT_EQ(inside_normal.b, 1.0f);
+    const Vector4f inside_material = Pixels(material).Load(4, SIZE - 4);
+    EXPECT_FLOAT_EQ(inside_material.g, 0.75f);
+    EXPECT_FLOAT_EQ(inside_material.b, 0.25f);
+    EXPECT_FLOAT_EQ(Pixels(depth).Load(4, SIZE - 4).x, 0.5f);
+
+    // the top right corner is outside of the triangle
+    EXPECT_FLOAT_EQ(Pixels(base_color).Load(SIZE - 4, 4).a, 0.0f);
+    EXPECT_FLOAT_EQ(Pixels(depth).Load(SIZE - 4, 4).x, 0.0f);
+
+    // the same triangle wound clockwise is culled
+    mesh.indices = { 0, 2, 1 };
+    auto culled_mesh = manager.CreateMesh(mesh);
+    ASSERT_TRUE(culled_mesh);
+    manager.Clear(framebuffer.get(), CLEAR_COLOR_BIT, clear_color);
+    manager.SetMesh(culled_mesh->get());
+    manager.DrawElements(3);
+    EXPECT_EQ(CountCovered(base_color), 0);
+}
+
+TEST(sw_renderer, tiles_keep_submission_order) {
+    // not a multiple of the tile size
+    constexpr uint32_t WIDTH = 100;
+    constexpr uint32_t HEIGHT = 70;
+    SwGraphicsManager manager;
+
+    auto base_color = CreateTarget(manager, "base_color", AttachmentType::COLOR_2D, PixelFormat::R8G8B8A8_UNORM, WIDTH, HEIGHT);
+    auto normal = CreateTarget(manager, "normal", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, WIDTH, HEIGHT);
+    auto material = CreateTarget(manager, "material", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, WIDTH, HEIGHT);
+    auto depth = CreateTarget(manager, "depth", AttachmentType::DEPTH_2D, PixelFormat::D32_FLOAT, WIDTH, HEIGHT);
+    auto framebuffer = manager.CreateFramebuffer(FramebufferDesc{
+        .colorAttachments = { base_color, normal, material },
+        .depthAttachment = depth,
+    });
+
+    const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    manager.SetRenderTarget(framebuffer.get());
+    manager.Clear(framebuffer.get(), static_cast<ClearFlags>(CLEAR_COLOR_BIT | CLEAR_DEPTH_BIT), clear_color, 0.0f);
+
+    PerBatchConstantBuffer batch{};
+    batch.c_worldMatrix = Matrix4x4f(1.0f);
+    PerPassConstantBuffer pass{};
+    pass.c_viewMatrix = Matrix4x4f(1.0f);
+    pass.c_projectionMatrix = Matrix4x4f(1.0f);
+    MaterialConstantBuffer material_constants{};
+    material_constants.c_baseColor = Vector4f(1.0f);
+    auto batch_buffer = BindConstants(manager, batch);
+    auto pass_buffer = BindConstants(manager, pass);
+    auto material_buffer = BindConstants(manager, material_constants);
+
+    // two triangles covering every tile at the same depth, the depth test passes on equal depth
+    // so the second one has to be on top everywhere
+    MeshAsset mesh;
+    mesh.positions = {
+        Vector3f(-1.0f, -1.0f, 0.5f), Vector3f(3.0f, -1.0f, 0.5f), Vector3f(-1.0f, 3.0f, 0.5f),
+        Vector3f(-1.0f, -1.0f, 0.5f), Vector3f(3.0f, -1.0f, 0.5f), Vector3f(-1.0f, 3.0f, 0.5f)
+    };
+    mesh.normals = {
+        Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, 1.0f),
+        Vector3f(0.0f, 1.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f)
+    };
+    mesh.indices = { 0, 1, 2, 3, 4, 5 };
+    auto gpu_mesh = manager.CreateMesh(mesh);
+    ASSERT_TRUE(gpu_mesh);
+
+    manager.SetPipelineState(PSO_GBUFFER);
+    manager.SetMesh(gpu_mesh->get());
+    manager.DrawElements(6);
+
+    EXPECT_EQ(CountCovered(base_color), WIDTH * HEIGHT);
+
+    int second_on_top = 0;
+    const SwGpuTexture& normals = Pixels(normal);
+    for (int y = 0; y < normals.GetHeight(); ++y) {
+        for (int x = 0; x < normals.GetWidth(); ++x) {
+            second_on_top += normals.Load(x, y).g == 1.0f;
+        }
+    }
+    EXPECT_EQ(second_on_top, WIDTH * HEIGHT);
+}
+
+TEST(sw_renderer, screen_quad_covers_target) {
+    constexpr uint32_t SIZE = 48;
+    SwGraphicsManager manager;
+
+    auto lighting = CreateTarget(manager, "lighting", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, SIZE, SIZE);
+    auto output = CreateTarget(manager, "output", AttachmentType::COLOR_2D, PixelFormat::R8G8B8A8_UNORM, SIZE, SIZE);
+    auto framebuffer = manager.CreateFramebuffer(FramebufferDesc{ .colorAttachments = { output } });
+
+    static_cast<SwGpuTexture*>(lighting.get())->Clear(Vector4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+    PerFrameConstantBuffer frame{};
+    auto frame_buffer = BindConstants(manager, frame);
+
+    manager.SetRenderTarget(framebuffer.get());
+    manager.SetPipelineState(PSO_POST_PROCESS);
+    manager.BindTexture(Dimension::TEXTURE_2D, lighting->GetHandle(), 0);
+    manager.SetMesh(nullptr);
+    manager.DrawArrays(6);
+
+    // every pixel is shaded exactly once, the diagonal is not drawn twice
+    EXPECT_EQ(CountCovered(output), SIZE * SIZE);
+
+    // reinhard then gamma correction
+    const float expected = std::pow(0.5f, 1.0f / 2.2f);
+    EXPECT_NEAR(Pixels(output).Load(SIZE / 2, SIZE / 2).r, expected, 1e-4f);
+}
+
+TEST(sw_renderer, dispatch_runs_every_thread) {
+    SwGraphicsManager manager;
+
+    auto input = CreateTarget(manager, "input", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, 64, 64);
+    auto output = CreateTarget(manager, "output", AttachmentType::RW_TEXTURE, PixelFormat::R16G16B16A16_FLOAT, 20, 20);
+
+    // bright enough to pass the bloom threshold
+    static_cast<SwGpuTexture*>(input.get())->Clear(Vector4f(4.0f, 4.0f, 4.0f, 1.0f));
+
+    manager.SetPipelineState(PSO_BLOOM_SETUP);
+    manager.BindTexture(Dimension::TEXTURE_2D, input->GetHandle(), 0);
+    manager.BindUnorderedAccessView(0, output.get());
+    // 16x16 groups, the threads out of the image do nothing
+    manager.Dispatch(2, 2, 1);
+
+    EXPECT_EQ(CountCovered(output), 20 * 20);
+    EXPECT_FLOAT_EQ(Pixels(output).Load(19, 19).r, 4.0f);
+}
+
+// passes of a render graph level draw on contexts of their own, with the bindings of the manager
+TEST(sw_renderer, recording_contexts_draw_concurrently) {
+    constexpr uint32_t SIZE = 32;
+    constexpr int PASS_COUNT = 2;
+    SwGraphicsManager manager;
+    ASSERT_GE(manager.GetRecordingContextCount(), PASS_COUNT);
+
+    auto lighting = CreateTarget(manager, "lighting", AttachmentType::COLOR_2D, PixelFormat::R16G16B16A16_FLOAT, SIZE, SIZE);
+    static_cast<SwGpuTexture*>(lighting.get())->Clear(Vector4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+    std::shared_ptr<GpuTexture> outputs[PASS_COUNT];
+    std::shared_ptr<Framebuffer> framebuffers[PASS_COUNT];
+    for (int i = 0; i < PASS_COUNT; ++i) {
+        outputs[i] = CreateTarget(manager, std::format("output{}", i), AttachmentType::COLOR_2D, PixelFormat::R8G8B8A8_UNORM, SIZE, SIZE);
+        framebuffers[i] = manager.CreateFramebuffer(FramebufferDesc{ .colorAttachments = { outputs[i] } });
+    }
+
+    PerFrameConstantBuffer frame{};
+    auto frame_buffer = BindConstants(manager, frame);
+    manager.BindTexture(Dimension::TEXTURE_2D, lighting->GetHandle(), 0);
+
+    jobsystem::Context ctx;
+    ctx.Dispatch(PASS_COUNT, 1, [&](jobsystem::JobArgs p_args) {
+        const int pass = static_cast<int>(p_args.jobIndex);
+        IGraphicsManager& cmd = manager.BeginRecording(pass);
+        cmd.SetRenderTarget(framebuffers[pass].get());
+        cmd.SetPipelineState(PSO_POST_PROCESS);
+        cmd.SetMesh(nullptr);
+        cmd.DrawArrays(6);
+    });
+    ctx.Wait();
+
+    const float expected = std::pow(0.5f, 1.0f / 2.2f);
+    for (int i = 0; i < PASS_COUNT; ++i) {
+        EXPECT_EQ(CountCovered(outputs[i]), SIZE * SIZE);
+        EXPECT_NEAR(Pixels(outputs[i]).Load(SIZE / 2, SIZE / 2).r, expected, 1e-4f);
+    }
+
+    // the manager keeps its own state
+    EXPECT_EQ(manager.m_state.colorCount, 0u);
+    EXPECT_EQ(manager.m_state.pipeline, nullptr);
+}
+
+}  // namespace cave
@@ -0,0 +1,194 @@
+#include <algorithm>
+
+#include "engine/empty/empty_graphics_manager.h"
+#include "engine/renderer/upload_queue.h"
+
+namespace cave {
+
+namespace {
+
+// a texture waiting for the gpu, the empty backend creates it and a fake clock charges its size
+struct FakeTexture {
+    GpuTextureDesc desc{};
+    size_t bytes = 0;
+    std::shared_ptr<GpuTexture> gpu_texture;
+};
+
+std::vector<std::shared_ptr<FakeTexture>> MakeTextures(int p_count) {
+    std::vector<std::shared_ptr<FakeTexture>> textures(p_count);
+    for (auto& texture : textures) {
+        texture = std::make_shared<FakeTexture>();
+    }
+    return textures;
+}
+
+constexpr size_t MB = 1024 * 1024;
+// what the simulated driver takes to copy a megabyte
+constexpr double MS_PER_MB = 1.0;
+
+struct SimulatedUploader {
+    EmptyGraphicsManager gm;
+    double clock = 0.0;
+    std::vector<const FakeTexture*> uploaded;
+
+    uint32_t Frame(UploadQueue& p_queue, const UploadQueue::Budget& p_budget) {
+        const double start = clock;
+        return p_queue.Process(
+            p_budget,
+            [&](const UploadQueue::Request& p_request) {
+                auto texture = static_cast<FakeTexture*>(p_request.asset.get());
+                texture->gpu_texture = gm.CreateTexture(texture->desc, {});
+                clock += MS_PER_MB * p_request.bytes / MB;
+                uploaded.push_back(texture);
+            },
+            [&]() { return clock - start; });
+    }
+};
+
+}  // namespace
+
+TEST(upload_queue, budget_spreads_uploads) {
+    constexpr int TEXTURE_COUNT = 64;
+    constexpr size_t TEXTURE_BYTES = 4 * MB;
+    const UploadQueue::Budget budget{ 16 * MB, 16.0 };
+
+    auto textures = MakeTextures(TEXTURE_COUNT);
+    UploadQueue queue;
+    for (auto& texture : textures) {
+        texture->desc.width = texture->desc.height = 1024;
+        texture->bytes = TEXTURE_BYTES;
+        queue.Push(UploadQueue::Type::TEXTURE, texture, texture->bytes);
+    }
+    EXPECT_EQ(queue.GetStats().pending_count, uint32_t(TEXTURE_COUNT));
+    EXPECT_EQ(queue.GetStats().pending_bytes, TEXTURE_COUNT * TEXTURE_BYTES);
+
+    SimulatedUploader uploader;
+    int frame_count = 0;
+    double worst_frame = 0.0;
+    while (!queue.IsEmpty()) {
+        const double start = uploader.clock;
+        const uint32_t count = uploader.Frame(queue, budget);
+        const double frame = uploader.clock - start;
+        worst_frame = std::max(worst_frame, frame);
+        ++frame_count;
+
+        // a frame stops at the first request that doesn't fit
+        ASSERT_GT(count, 0u);
+        EXPECT_LE(queue.GetStats().uploaded_bytes, budget.bytes);
+        EXPECT_LT(frame, budget.milliseconds + MS_PER_MB * TEXTURE_BYTES / MB);
+        EXPECT_EQ(queue.GetStats().milliseconds, frame);
+        ASSERT_LT(frame_count, TEXTURE_COUNT);
+    }
+
+    for (const auto& texture : textures) {
+        EXPECT_TRUE(texture->gpu_texture);
+    }
+    EXPECT_EQ(uploader.uploaded.size(), size_t(TEXTURE_COUNT));
+    EXPECT_EQ(queue.GetStats().pending_bytes, 0u);
+    EXPECT_EQ(frame_count, TEXTURE_COUNT * int(TEXTURE_BYTES) / int(budget.bytes));
+
+    // draining everything in one frame would have stalled it for the whole level
+    const double drain_all = MS_PER_MB * TEXTURE_COUNT * TEXTURE_BYTES / MB;
+    EXPECT_EQ(uploader.clock, drain_all);
+    EXPECT_LE(worst_frame * 10.0, drain_all);
+}
+
+TEST(upload_queue, time_budget) {
+    constexpr int TEXTURE_COUNT = 10;
+    auto textures = MakeTextures(TEXTURE_COUNT);
+    UploadQueue queue;
+    for (auto& texture : textures) {
+        texture->bytes = 2 * MB;
+        queue.Push(UploadQueue::Type::TEXTURE, texture, texture->bytes);
+    }
+
+    // plenty of bytes, the clock decides
+    SimulatedUploader uploader;
+    EXPECT_EQ(uploader.Frame(queue, { 1024 * MB, 5.0 }), 3u);
+    EXPECT_EQ(queue.GetStats().pending_count, uint32_t(TEXTURE_COUNT - 3));
+}
+
+TEST(upload_queue, priority_order) {
+    auto textures = MakeTextures(6);
+    UploadQueue queue;
+    for (auto& texture : textures) {
+        texture->bytes = MB;
+        queue.Push(UploadQueue::Type::TEXTURE, texture, texture->bytes);
+    }
+
+    // the largest object on screen first, an asset hinted twice keeps its best priority,
+    // hints for assets that aren't queued are ignored
+    FakeTexture unknown;
+    const UploadHint hints[] = {
+        { textures[4].get(), 0.1f },
+        { textures[2].get(), 0.5f },
+        { textures[4].get(), 0.8f },
+        { &unknown, 1.0f },
+    };
+    queue.SetPriorities(hints);
+
+    SimulatedUploader uploader;
+    EXPECT_EQ(uploader.Frame(queue, { 3 * MB, 100.0 }), 3u);
+    ASSERT_EQ(uploader.uploaded.size(), 3u);
+    EXPECT_EQ(uploader.uploaded[0], textures[4].get());
+    EXPECT_EQ(uploader.uploaded[1], textures[2].get());
+    // what nothing asked for keeps its submission order
+    EXPECT_EQ(uploader.uploaded[2], textures[0].get());
+
+    // priorities only last one frame
+    const UploadHint next_hints[] = { { textures[5].get(), 0.2f } };
+    queue.SetPriorities(next_hints);
+    EXPECT_EQ(uploader.Frame(queue, { 3 * MB, 100.0 }), 3u);
+    ASSERT_EQ(uploader.uploaded.size(), 6u);
+    EXPECT_EQ(uploader.uploaded[3], textures[5].get());
+    EXPECT_EQ(uploader.uploaded[4], textures[1].get());
+    EXPECT_EQ(uploader.uploaded[5], textures[3].get());
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(upload_queue, oversized_and_duplicate_requests) {
+    auto huge = std::make_shared<FakeTexture>();
+    auto small = std::make_shared<FakeTexture>();
+    huge->bytes = 64 * MB;
+    small->bytes = MB;
+
+    UploadQueue queue;
+    queue.Push(UploadQueue::Type::TEXTURE, huge, huge->bytes);
+    queue.Push(UploadQueue::Type::TEXTURE, huge, huge->bytes);
+    queue.Push(UploadQueue::Type::MESH, small, small->bytes);
+    EXPECT_EQ(queue.GetStats().pending_count, 2u);
+    EXPECT_EQ(queue.GetStats().pending_bytes, huge->bytes + small->bytes);
+
+    // a request larger than the whole budget still goes, alone
+    SimulatedUploader uploader;
+    EXPECT_EQ(uploader.Frame(queue, { 16 * MB, 4.0 }), 1u);
+    EXPECT_TRUE(huge->gpu_texture);
+    EXPECT_EQ(queue.GetStats().uploaded_bytes, huge->bytes);
+
+    // once uploaded, the same asset can be queued again
+    queue.Push(UploadQueue::Type::TEXTURE, huge, huge->bytes);
+    EXPECT_EQ(queue.GetStats().pending_count, 2u);
+    EXPECT_EQ(uploader.Frame(queue, { 16 * MB, 4.0 }), 1u);
+    EXPECT_EQ(uploader.uploaded.back(), small.get());
+}
+
+TEST(upload_queue, request_owns_asset) {
+    auto texture = std::make_shared<FakeTexture>();
+    texture->bytes = MB;
+    std::weak_ptr<FakeTexture> weak = texture;
+
+    UploadQueue queue;
+    queue.Push(UploadQueue::Type::TEXTURE, texture, texture->bytes);
+
+    // released by the scene before its upload, the request still points to a live asset
+    texture.reset();
+    EXPECT_FALSE(weak.expired());
+
+    SimulatedUploader uploader;
+    EXPECT_EQ(uploader.Frame(queue, { 16 * MB, 4.0 }), 1u);
+    EXPECT_EQ(uploader.uploaded.size(), 1u);
+    // nothing else owns it, the queue lets it go once uploaded
+    EXPECT_TRUE(weak.expired());
+}
+
+}  // namespace cave
@@ -0,0 +1,74 @@
+#include "engine/runtime/frame_pipeline.h"
+
+namespace cave {
+
+TEST(frame_pipeline, renders_in_order) {
+    constexpr int FRAME_COUNT = 100;
+
+    std::vector<int> rendered;
+    FramePipeline pipeline;
+    pipeline.Start(3, [&](const FrameData& p_framedata) {
+        rendered.push_back(p_framedata.perFrameCache.c_frameIndex);
+    });
+    EXPECT_EQ(pipeline.GetBufferCount(), 3);
+
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        FrameData& framedata = pipeline.AcquireFrame(RenderOptions{});
+        framedata.perFrameCache.c_frameIndex = i;
+        pipeline.SubmitFrame();
+    }
+    pipeline.Stop();
+
+    // every submitted frame is rendered before Stop() returns
+    ASSERT_EQ(rendered.size(), size_t(FRAME_COUNT));
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        EXPECT_EQ(rendered[i], i);
+    }
+}
+
+TEST(frame_pipeline, bounded_latency) {
+    for (int buffer_count = FramePipeline::MIN_BUFFER_COUNT; buffer_count <= FramePipeline::MAX_BUFFER_COUNT; ++buffer_count) {
+        std::atomic_int rendered = 0;
+        std::atomic_int submitted = 0;
+        int max_ahead = 0;
+
+        FramePipeline pipeline;
+        pipeline.Start(buffer_count, [&](const FrameData& p_framedata) {
+            // the frame is not touched by the main thread while it is rendered
+            const int frame = p_framedata.perFrameCache.c_frameIndex;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            EXPECT_EQ(p_framedata.perFrameCache.c_frameIndex, frame);
+            EXPECT_EQ(frame, rendered.load());
+            rendered.fetch_add(1);
+        });
+
+        for (int i = 0; i < 32; ++i) {
+            FrameData& framedata = pipeline.AcquireFrame(RenderOptions{});
+            max_ahead = std::max(max_ahead, i - rendered.load());
+            framedata.perFrameCache.c_frameIndex = i;
+            pipeline.SubmitFrame();
+            submitted.fetch_add(1);
+        }
+
+        pipeline.WaitIdle();
+        EXPECT_EQ(rendered.load(), submitted.load());
+        pipeline.Stop();
+
+        // a frame is acquired only once the frame buffer_count frames older is rendered
+        EXPECT_LE(max_ahead, buffer_count - 1);
+    }
+}
+
+TEST(frame_pipeline, clamps_buffer_count) {
+    FramePipeline pipeline;
+    pipeline.Start(8, [](const FrameData&) {});
+    EXPECT_EQ(pipeline.GetBufferCount(), FramePipeline::MAX_BUFFER_COUNT);
+    pipeline.Stop();
+    EXPECT_FALSE(pipeline.IsRunning());
+
+    pipeline.Start(1, [](const FrameData&) {});
+    EXPECT_EQ(pipeline.GetBufferCount(), FramePipeline::MIN_BUFFER_COUNT);
+    pipeline.Stop();
+}
+
+}  // namespace cave
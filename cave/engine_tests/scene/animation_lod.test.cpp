@@ -0,0 +1,178 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/scene/animation_lod.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace cave {
+
+TEST(animation_lod, select_interval) {
+    AnimationLodSettings settings;
+    settings.screen_size_thresholds[0] = 0.2f;
+    settings.screen_size_thresholds[1] = 0.1f;
+    settings.screen_size_thresholds[2] = 0.05f;
+    settings.offscreen_interval = 16;
+
+    EXPECT_EQ(SelectAnimationLodInterval(settings, true, 0.5f), 1u);
+    EXPECT_EQ(SelectAnimationLodInterval(settings, true, 0.15f), 2u);
+    EXPECT_EQ(SelectAnimationLodInterval(settings, true, 0.07f), 4u);
+    EXPECT_EQ(SelectAnimationLodInterval(settings, true, 0.01f), 8u);
+    EXPECT_EQ(SelectAnimationLodInterval(settings, false, 0.5f), 16u);
+
+    settings.enabled = false;
+    EXPECT_EQ(SelectAnimationLodInterval(settings, false, 0.01f), 1u);
+}
+
+TEST(animation_lod, no_visibility_evaluates_every_frame) {
+    AnimationLodSettings settings;
+    AnimationLodState lod;
+    for (uint32_t frame = 1; frame < 32; ++frame) {
+        lod.Schedule(settings, frame, false);
+        EXPECT_TRUE(lod.evaluate);
+        EXPECT_EQ(lod.interval, 1u);
+    }
+}
+
+TEST(animation_lod, staggered_offscreen) {
+    AnimationLodSettings settings;
+    settings.offscreen_interval = 16;
+
+    constexpr uint32_t SKELETON_COUNT = 64;
+    std::vector<AnimationLodState> states(SKELETON_COUNT);
+    std::vector<uint32_t> last_update(SKELETON_COUNT, 0);
+    for (uint32_t i = 0; i < SKELETON_COUNT; ++i) {
+        states[i].phase = i;
+    }
+
+    // never seen by the renderer, everything evaluates on the first frame, then the updates spread
+    // evenly over the interval
+    for (uint32_t frame = 2; frame < 200; ++frame) {
+        uint32_t evaluated = 0;
+        for (uint32_t i = 0; i < SKELETON_COUNT; ++i) {
+            AnimationLodState& lod = states[i];
+            lod.Schedule(settings, frame, true);
+            EXPECT_EQ(lod.interval, 16u);
+            if (lod.evaluate) {
+                ++evaluated;
+                if (frame >= 40) {
+                    EXPECT_EQ(frame - last_update[i], 16u);
+                }
+                last_update[i] = frame;
+            }
+        }
+        if (frame > 2) {
+            EXPECT_EQ(evaluated, SKELETON_COUNT / 16);
+        }
+    }
+}
+
+TEST(animation_lod, interval_change_bounds_gap) {
+    AnimationLodSettings settings;
+    settings.offscreen_interval = 8;
+
+    AnimationLodState lod;
+    lod.phase = 3;
+
+    // visible and large, then culled
+    uint32_t frame = 1;
+    for (; frame < 10; ++frame) {
+        lod.visible_frame = frame - 1;
+        lod.screen_size = 1.0f;
+        lod.Schedule(settings, frame, true);
+        EXPECT_TRUE(lod.evaluate);
+    }
+
+    uint32_t last_update = frame - 1;
+    for (; frame < 60; ++frame) {
+        lod.Schedule(settings, frame, true);
+        if (lod.evaluate) {
+            EXPECT_LE(frame - last_update, 8u);
+            last_update = frame;
+        }
+        EXPECT_LE(lod.frames_since_update + 1, lod.span);
+    }
+
+    // becoming visible again is picked up the next frame
+    lod.visible_frame = frame - 1;
+    lod.Schedule(settings, frame, true);
+    EXPECT_TRUE(lod.evaluate);
+    EXPECT_EQ(lod.interval, 1u);
+}
+
+TEST(animation_lod, mark_visible_keeps_largest_size) {
+    AnimationLodState lod;
+    lod.MarkVisible(5, 0.1f);
+    lod.MarkVisible(5, 0.3f);
+    lod.MarkVisible(5, 0.2f);
+    EXPECT_EQ(lod.visible_frame, 5u);
+    EXPECT_FLOAT_EQ(lod.screen_size, 0.3f);
+
+    // a new frame starts over
+    lod.MarkVisible(6, 0.05f);
+    EXPECT_EQ(lod.visible_frame, 6u);
+    EXPECT_FLOAT_EQ(lod.screen_size, 0.05f);
+}
+
+TEST(animation_lod, interpolate_palette) {
+    std::vector<Matrix4x4f> from(2, Matrix4x4f(1.0f));
+    std::vector<Matrix4x4f> to(2, Matrix4x4f(3.0f));
+    std::vector<Matrix4x4f> out;
+
+    InterpolateBonePalette(from, to, 0.25f, out);
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_FLOAT_EQ(out[0][0][0], 1.5f);
+    EXPECT_FLOAT_EQ(out[1][3][3], 1.5f);
+    EXPECT_FLOAT_EQ(out[1][0][1], 0.0f);
+
+    InterpolateBonePalette(from, to, 1.0f, out);
+    EXPECT_FLOAT_EQ(out[0][2][2], 3.0f);
+}
+
+// A skeleton without a clip, posed by something else, reported offscreen. Its palette still
+// follows the bone every frame.
+TEST(animation_lod, skeleton_without_clip_is_not_throttled) {
+    Scene scene;
+    auto bone_id = scene.CreateEntity();
+    scene.Create<TransformComponent>(bone_id);
+
+    auto skeleton_id = scene.CreateEntity();
+    scene.Create<TransformComponent>(skeleton_id);
+    SkeletonComponent& skeleton = scene.Create<SkeletonComponent>(skeleton_id);
+    skeleton.bone_collection.push_back(bone_id);
+    skeleton.inverse_bind_matrices.push_back(Matrix4x4f(1.0f));
+
+    jobsystem::Context ctx;
+    for (uint32_t frame = 1; frame < 20; ++frame) {
+        scene.m_frameIndex = frame;
+        // the renderer drew last frame without the skeleton
+        scene.m_skeletonVisibility.frame = frame - 1;
+        scene.m_skeletonVisibility.written = true;
+
+        scene.GetComponent<TransformComponent>(bone_id)->SetWorldMatrix(Translate(Vector3f(float(frame), 0.0f, 0.0f)));
+        RunAnimationUpdateSystem(scene, ctx, 0.0f);
+        RunSkeletonUpdateSystem(scene, ctx, 0.0f);
+
+        const SkeletonComponent& result = *scene.GetComponent<SkeletonComponent>(skeleton_id);
+        ASSERT_EQ(result.bone_transforms.size(), 1u);
+        EXPECT_FLOAT_EQ(result.bone_transforms[0][3][0], float(frame));
+    }
+}
+
+// before the renderer wrote a report nothing is known to be offscreen or small
+TEST(animation_lod, unwritten_report_evaluates_every_frame) {
+    Scene scene;
+    auto skeleton_id = scene.CreateEntity();
+    scene.Create<TransformComponent>(skeleton_id);
+    scene.Create<SkeletonComponent>(skeleton_id);
+
+    jobsystem::Context ctx;
+    scene.m_frameIndex = 1;
+    RunAnimationUpdateSystem(scene, ctx, 0.0f);
+
+    const SkeletonComponent& skeleton = *scene.GetComponent<SkeletonComponent>(skeleton_id);
+    EXPECT_EQ(skeleton.lod.interval, 1u);
+    EXPECT_TRUE(skeleton.lod.evaluate);
+    EXPECT_EQ(scene.m_animationLodStats.offscreen_count, 0u);
+}
+
+}  // namespace cave
@@ -0,0 +1,161 @@
+#include "engine/scene/compressed_animation_clip.h"
+#include "engine/scene/skeletal_animation_component.h"
+
+namespace cave {
+
+static constexpr int KEY_COUNT = 200;
+static constexpr float KEY_INTERVAL = 1.0f / 30.0f;
+
+struct TestClip {
+    std::vector<SkeletalAnimationSampler> samplers;
+    std::vector<SkeletalAnimationChannel> channels;
+
+    void AddTrack(AnimationChannelPath p_path, const std::function<Vector4f(float)>& p_func) {
+        SkeletalAnimationChannel& channel = channels.emplace_back();
+        channel.path = p_path;
+        channel.sampler_index = static_cast<int>(samplers.size());
+
+        SkeletalAnimationSampler& sampler = samplers.emplace_back();
+        for (int key = 0; key < KEY_COUNT; ++key) {
+            const float time = key * KEY_INTERVAL;
+            const Vector4f value = p_func(time);
+            sampler.keyframe_times.push_back(time);
+            sampler.keyframe_data.push_back(value.x);
+            sampler.keyframe_data.push_back(value.y);
+            sampler.keyframe_data.push_back(value.z);
+            if (p_path == AnimationChannelPath::Rotation) {
+                sampler.keyframe_data.push_back(value.w);
+            }
+        }
+    }
+};
+
+static Vector4f AxisAngle(const Vector3f& p_axis, float p_angle) {
+    const Vector3f axis = normalize(p_axis);
+    const float s = glm::sin(0.5f * p_angle);
+    return Vector4f(axis.x * s, axis.y * s, axis.z * s, glm::cos(0.5f * p_angle));
+}
+
+static TestClip CreateTestClip() {
+    TestClip clip;
+    clip.AddTrack(AnimationChannelPath::Translation, [](float t) {
+        return Vector4f(glm::sin(t), 2.0f * glm::cos(3.0f * t), 0.5f * t, 0.0f);
+    });
+    clip.AddTrack(AnimationChannelPath::Rotation, [](float t) {
+        return AxisAngle(Vector3f(1.0f, 2.0f, 0.5f), 4.0f * t);
+    });
+    clip.AddTrack(AnimationChannelPath::Scale, [](float) {
+        return Vector4f(1.0f, 1.0f, 1.0f, 0.0f);
+    });
+    // linear motion, every key but the first and the last can be removed
+    clip.AddTrack(AnimationChannelPath::Translation, [](float t) {
+        return Vector4f(t, -t, 2.0f * t, 0.0f);
+    });
+    return clip;
+}
+
+TEST(compressed_animation_clip, reject_mismatched_times) {
+    TestClip clip = CreateTestClip();
+    clip.samplers[1].keyframe_times.back() += 1.0f;
+
+    CompressedAnimationClip compressed;
+    EXPECT_FALSE(compressed.Compress(clip.samplers, clip.channels, {}));
+    EXPECT_FALSE(compressed.IsValid());
+}
+
+TEST(compressed_animation_clip, constant_track) {
+    const TestClip clip = CreateTestClip();
+
+    CompressedAnimationClip compressed;
+    ASSERT_TRUE(compressed.Compress(clip.samplers, clip.channels, {}));
+
+    const auto& tracks = compressed.GetTracks();
+    ASSERT_EQ(tracks.size(), 4);
+    EXPECT_GE(tracks[0].lane, 0);
+    EXPECT_GE(tracks[1].lane, 0);
+    EXPECT_EQ(tracks[2].lane, -1);
+    EXPECT_GE(tracks[3].lane, 0);
+}
+
+TEST(compressed_animation_clip, key_reduction) {
+    TestClip clip;
+    clip.AddTrack(AnimationChannelPath::Translation, [](float t) {
+        return Vector4f(t, -t, 2.0f * t, 0.0f);
+    });
+
+    CompressedAnimationClip compressed;
+    ASSERT_TRUE(compressed.Compress(clip.samplers, clip.channels, {}));
+
+    // linear track only keeps one key every MAX_KEY_SPAN
+    EXPECT_LE(compressed.GetKeyCount(), KEY_COUNT / CompressedAnimationClip::MAX_KEY_SPAN + 2);
+}
+
+TEST(compressed_animation_clip, component_releases_samplers) {
+    const TestClip clip = CreateTestClip();
+
+    SkeletalAnimationComponent animation;
+    animation.GetSamplers() = clip.samplers;
+    animation.GetChannels() = clip.channels;
+    ASSERT_TRUE(animation.Compress());
+    EXPECT_TRUE(animation.GetCompressedClip().IsValid());
+    EXPECT_TRUE(animation.GetSamplers().empty());
+}
+
+TEST(compressed_animation_clip, reject_out_of_error_budget) {
+    // 16 bit quantization of a 1000 unit range can't meet the default threshold
+    TestClip clip;
+    clip.AddTrack(AnimationChannelPath::Translation, [](float t) {
+        return Vector4f(1000.0f * glm::sin(t), 0.0f, 0.0f, 0.0f);
+    });
+
+    CompressedAnimationClip compressed;
+    EXPECT_FALSE(compressed.Compress(clip.samplers, clip.channels, {}));
+    EXPECT_FALSE(compressed.IsValid());
+}
+
+TEST(compressed_animation_clip, sample_within_error) {
+    const TestClip clip = CreateTestClip();
+
+    AnimationCompressionSettings settings;
+    CompressedAnimationClip compressed;
+    ASSERT_TRUE(compressed.Compress(clip.samplers, clip.channels, settings));
+    EXPECT_LT(compressed.GetKeyCount(), KEY_COUNT);
+
+    size_t raw_bytes = 0;
+    for (const auto& sampler : clip.samplers) {
+        raw_bytes += (sampler.keyframe_times.size() + sampler.keyframe_data.size()) * sizeof(float);
+    }
+    EXPECT_LT(compressed.GetMemoryUsage(), raw_bytes);
+
+    std::vector<float> scratch(compressed.GetScratchSize());
+    std::vector<Vector4f> result(compressed.GetTrackCount());
+    KeyframeCursor cursor;
+
+    // key reduction and quantization together stay within the thresholds
+    for (int key = 0; key < KEY_COUNT; ++key) {
+        const float time = key * KEY_INTERVAL;
+        compressed.Sample(time, cursor, scratch.data(), result.data());
+
+        for (int track = 0; track < (int)clip.samplers.size(); ++track) {
+            const auto& data = clip.samplers[track].keyframe_data;
+            if (clip.channels[track].path == AnimationChannelPath::Rotation) {
+                const float tolerance = settings.rotation_error;
+                Vector4f expected(data[4 * key + 0], data[4 * key + 1], data[4 * key + 2], data[4 * key + 3]);
+                if (dot(expected, result[track]) < 0.0f) {
+                    expected = -expected;
+                }
+                EXPECT_NEAR(result[track].x, expected.x, tolerance);
+                EXPECT_NEAR(result[track].y, expected.y, tolerance);
+                EXPECT_NEAR(result[track].z, expected.z, tolerance);
+                EXPECT_NEAR(result[track].w, expected.w, tolerance);
+            } else {
+                const float tolerance = glm::max(settings.translation_error, settings.scale_error);
+                EXPECT_NEAR(result[track].x, data[3 * key + 0], tolerance);
+                EXPECT_NEAR(result[track].y, data[3 * key + 1], tolerance);
+                EXPECT_NEAR(result[track].z, data[3 * key + 2], tolerance);
+            }
+        }
+    }
+}
+
+}  // namespace cave
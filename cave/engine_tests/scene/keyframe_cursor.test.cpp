@@ -0,0 +1,52 @@
+#include "engine/scene/skeletal_animation_component.h"
+
+namespace cave {
+
+static const std::vector<float> s_times = { 0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 2.5f, 3.0f, 3.5f, 4.0f, 4.5f, 5.0f };
+
+TEST(keyframe_cursor, empty) {
+    KeyframeCursor cursor;
+    EXPECT_EQ(cursor.Seek({}, 1.0f), -1);
+}
+
+TEST(keyframe_cursor, before_first_key) {
+    KeyframeCursor cursor;
+    EXPECT_EQ(cursor.Seek(s_times, -1.0f), -1);
+}
+
+TEST(keyframe_cursor, after_last_key) {
+    KeyframeCursor cursor;
+    EXPECT_EQ(cursor.Seek(s_times, 100.0f), 10);
+}
+
+TEST(keyframe_cursor, exact_key) {
+    KeyframeCursor cursor;
+    EXPECT_EQ(cursor.Seek(s_times, 0.0f), 0);
+    EXPECT_EQ(cursor.Seek(s_times, 2.5f), 5);
+    EXPECT_EQ(cursor.Seek(s_times, 5.0f), 10);
+}
+
+TEST(keyframe_cursor, forward_playback) {
+    KeyframeCursor cursor;
+    for (float time = 0.0f; time < 5.0f; time += 0.1f) {
+        const int expected = static_cast<int>(std::upper_bound(s_times.begin(), s_times.end(), time) - s_times.begin()) - 1;
+        EXPECT_EQ(cursor.Seek(s_times, time), expected);
+    }
+}
+
+TEST(keyframe_cursor, seek_backward) {
+    KeyframeCursor cursor;
+    EXPECT_EQ(cursor.Seek(s_times, 4.2f), 8);
+    EXPECT_EQ(cursor.Seek(s_times, 0.7f), 1);
+    EXPECT_EQ(cursor.Seek(s_times, -0.7f), -1);
+    EXPECT_EQ(cursor.Seek(s_times, 0.1f), 0);
+}
+
+TEST(keyframe_cursor, seek_far_ahead) {
+    KeyframeCursor cursor;
+    EXPECT_EQ(cursor.Seek(s_times, 0.1f), 0);
+    // more than MAX_LINEAR_STEPS keys ahead
+    EXPECT_EQ(cursor.Seek(s_times, 4.7f), 9);
+}
+
+}  // namespace cave
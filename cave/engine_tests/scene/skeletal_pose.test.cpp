@@ -0,0 +1,119 @@
+#include "engine/scene/skeletal_pose.h"
+
+namespace cave {
+
+static constexpr float EPSILON = 1e-5f;
+
+static Vector4f AxisAngleZ(float p_angle) {
+    return Vector4f(0.0f, 0.0f, glm::sin(0.5f * p_angle), glm::cos(0.5f * p_angle));
+}
+
+static SkeletalPose CreatePose(size_t p_bone_count, const Vector4f& p_translation, const Vector4f& p_rotation, const Vector4f& p_scale) {
+    SkeletalPose pose;
+    pose.Resize(p_bone_count);
+    for (size_t i = 0; i < p_bone_count; ++i) {
+        pose.translations[i] = p_translation;
+        pose.rotations[i] = p_rotation;
+        pose.scales[i] = p_scale;
+        pose.weights[i] = Vector4f(1.0f, 1.0f, 1.0f, 0.0f);
+    }
+    return pose;
+}
+
+TEST(skeletal_pose, resize_keeps_storage) {
+    SkeletalPose pose;
+    pose.Resize(60);
+    const Vector4f* translations = pose.translations.data();
+    const Vector4f* weights = pose.weights.data();
+
+    pose.Clear();
+    pose.Resize(60);
+    EXPECT_EQ(pose.translations.data(), translations);
+    EXPECT_EQ(pose.weights.data(), weights);
+}
+
+TEST(skeletal_pose, blend_two_poses) {
+    const SkeletalPose a = CreatePose(4, Vector4f(0.0f), AxisAngleZ(0.0f), Vector4f(1.0f));
+    const SkeletalPose b = CreatePose(4, Vector4f(2.0f, 4.0f, 6.0f, 0.0f), AxisAngleZ(1.0f), Vector4f(3.0f));
+    const SkeletalPose base = CreatePose(4, Vector4f(100.0f), AxisAngleZ(2.0f), Vector4f(100.0f));
+
+    SkeletalPose result;
+    result.Resize(4);
+    result.Clear();
+    BlendPose(result, a, 0.5f);
+    BlendPose(result, b, 0.5f);
+    NormalizePose(result, base);
+
+    const Vector4f expected_rotation = AxisAngleZ(0.5f);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_NEAR(result.translations[i].x, 1.0f, EPSILON);
+        EXPECT_NEAR(result.translations[i].y, 2.0f, EPSILON);
+        EXPECT_NEAR(result.translations[i].z, 3.0f, EPSILON);
+        EXPECT_NEAR(result.scales[i].x, 2.0f, EPSILON);
+        EXPECT_NEAR(result.rotations[i].z, expected_rotation.z, EPSILON);
+        EXPECT_NEAR(result.rotations[i].w, expected_rotation.w, EPSILON);
+    }
+}
+
+TEST(skeletal_pose, opposite_hemisphere) {
+    const SkeletalPose a = CreatePose(1, Vector4f(0.0f), AxisAngleZ(0.2f), Vector4f(1.0f));
+    const SkeletalPose b = CreatePose(1, Vector4f(0.0f), -AxisAngleZ(0.2f), Vector4f(1.0f));
+    const SkeletalPose base = CreatePose(1, Vector4f(0.0f), AxisAngleZ(0.0f), Vector4f(1.0f));
+
+    SkeletalPose result;
+    result.Resize(1);
+    result.Clear();
+    BlendPose(result, a, 0.5f);
+    BlendPose(result, b, 0.5f);
+    NormalizePose(result, base);
+
+    // q and -q must not cancel out
+    const Vector4f expected = AxisAngleZ(0.2f);
+    EXPECT_NEAR(glm::abs(dot(result.rotations[0], expected)), 1.0f, EPSILON);
+}
+
+TEST(skeletal_pose, partial_weight_mixes_base) {
+    const SkeletalPose a = CreatePose(1, Vector4f(4.0f), AxisAngleZ(0.0f), Vector4f(1.0f));
+    const SkeletalPose base = CreatePose(1, Vector4f(0.0f), AxisAngleZ(0.0f), Vector4f(1.0f));
+
+    SkeletalPose result;
+    result.Resize(1);
+    result.Clear();
+    BlendPose(result, a, 0.25f);
+    NormalizePose(result, base);
+
+    EXPECT_NEAR(result.translations[0].x, 1.0f, EPSILON);
+}
+
+TEST(skeletal_pose, unweighted_channels_take_base) {
+    SkeletalPose a = CreatePose(2, Vector4f(4.0f), AxisAngleZ(1.0f), Vector4f(4.0f));
+    a.weights[1] = Vector4f(0.0f);
+    const SkeletalPose base = CreatePose(2, Vector4f(-1.0f), AxisAngleZ(0.0f), Vector4f(2.0f));
+
+    SkeletalPose result;
+    result.Resize(2);
+    result.Clear();
+    BlendPose(result, a, 1.0f);
+    NormalizePose(result, base);
+
+    EXPECT_NEAR(result.translations[0].x, 4.0f, EPSILON);
+    EXPECT_NEAR(result.translations[1].x, -1.0f, EPSILON);
+    EXPECT_NEAR(result.scales[1].x, 2.0f, EPSILON);
+    EXPECT_NEAR(result.rotations[1].w, 1.0f, EPSILON);
+}
+
+TEST(skeletal_pose, additive) {
+    SkeletalPose pose = CreatePose(1, Vector4f(1.0f, 2.0f, 3.0f, 0.0f), AxisAngleZ(0.5f), Vector4f(2.0f));
+    const SkeletalPose delta = CreatePose(1, Vector4f(1.0f, 1.0f, 1.0f, 0.0f), AxisAngleZ(0.25f), Vector4f(1.5f));
+
+    AddPose(pose, delta, 1.0f);
+
+    const Vector4f expected_rotation = AxisAngleZ(0.75f);
+    EXPECT_NEAR(pose.translations[0].x, 2.0f, EPSILON);
+    EXPECT_NEAR(pose.translations[0].z, 4.0f, EPSILON);
+    EXPECT_NEAR(pose.rotations[0].z, expected_rotation.z, EPSILON);
+    EXPECT_NEAR(pose.rotations[0].w, expected_rotation.w, EPSILON);
+    EXPECT_NEAR(pose.scales[0].x, 3.0f, EPSILON);
+}
+
+}  // namespace cave
@@ -316,13 +316,24 @@ auto D3d11GraphicsManager::CreateStructuredBuffer(const GpuBufferDesc& p_desc) -
     return structured_buffer;
 }
 
-void D3d11GraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
+void D3d11GraphicsManager::UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
     auto buffer = reinterpret_cast<const D3d11UniformBuffer*>(p_buffer);
     DEV_ASSERT(p_size <= buffer->capacity);
     buffer->data = (const char*)p_data;
 }
 
-void D3d11GraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
+void D3d11GraphicsManager::UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) {
+    auto buffer = reinterpret_cast<const D3d11UniformBuffer*>(p_buffer);
+    DEV_ASSERT(p_size + p_offset <= buffer->capacity);
+    // the data is copied to the GPU when a range is bound, keep a copy that outlives the frame
+    if (buffer->storage.size() < buffer->capacity) {
+        buffer->storage.resize(buffer->capacity);
+    }
+    memcpy(buffer->storage.data() + p_offset, p_data, p_size);
+    buffer->data = buffer->storage.data();
+}
+
+void D3d11GraphicsManager::BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
     auto buffer = reinterpret_cast<const D3d11UniformBuffer*>(p_buffer);
     DEV_ASSERT(p_size + p_offset <= buffer->capacity);
     D3D11_MAPPED_SUBRESOURCE mapped;
@@ -334,7 +345,7 @@ void D3d11GraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_bu
     }
 }
 
-void D3d11GraphicsManager::BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) {
+void D3d11GraphicsManager::BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) {
     unused(p_dimension);
 
     if (p_handle) {
@@ -344,7 +355,7 @@ void D3d11GraphicsManager::BindTexture(Dimension p_dimension, uint64_t p_handle,
     }
 }
 
-void D3d11GraphicsManager::UnbindTexture(Dimension p_dimension, int p_slot) {
+void D3d11GraphicsManager::UnbindTextureImpl(Dimension p_dimension, int p_slot) {
     unused(p_dimension);
 
     ID3D11ShaderResourceView* srv = nullptr;
@@ -352,7 +363,7 @@ void D3d11GraphicsManager::UnbindTexture(Dimension p_dimension, int p_slot) {
     m_deviceContext->CSSetShaderResources(p_slot, 1, &srv);
 }
 
-void D3d11GraphicsManager::GenerateMipmap(const GpuTexture* p_texture) {
+void D3d11GraphicsManager::GenerateMipmapImpl(const GpuTexture* p_texture) {
     auto texture = reinterpret_cast<const D3d11GpuTexture*>(p_texture);
     m_deviceContext->GenerateMips(texture->srv.Get());
 }
@@ -663,7 +674,7 @@ std::shared_ptr<Framebuffer> D3d11GraphicsManager::CreateFramebuffer(const Frame
     return framebuffer;
 }
 
-void D3d11GraphicsManager::SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
+void D3d11GraphicsManager::SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
     unused(p_mip_level);
     DEV_ASSERT(p_framebuffer);
 
@@ -820,7 +831,7 @@ auto D3d11GraphicsManager::CreateMeshImpl(const GpuMeshDesc& p_desc,
     return ret;
 }
 
-void D3d11GraphicsManager::SetMesh(const GpuMesh* p_mesh) {
+void D3d11GraphicsManager::SetMeshImpl(const GpuMesh* p_mesh) {
     if (!p_mesh) {
         m_deviceContext->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
         m_deviceContext->IASetInputLayout(nullptr);
@@ -30,7 +30,7 @@ public:
     void SetStencilRef(uint32_t p_ref) final;
     void SetBlendState(const BlendDesc& p_desc, const float* p_factor, uint32_t p_mask) final;
 
-    void SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) final;
+    void SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) final;
     void UnsetRenderTarget() final;
 
     void Clear(const Framebuffer* p_framebuffer,
@@ -49,7 +49,7 @@ public:
                         const GpuBufferDesc* p_vb_descs,
                         const GpuBufferDesc* p_ib_desc) -> Result<std::shared_ptr<GpuMesh>> final;
 
-    void SetMesh(const GpuMesh* p_mesh) final;
+    void SetMeshImpl(const GpuMesh* p_mesh) final;
     void UpdateBuffer(const GpuBufferDesc& p_desc, GpuBuffer* p_buffer) final;
 
     void DrawElements(uint32_t p_count, uint32_t p_offset) final;
@@ -69,13 +69,14 @@ public:
     void BindStructuredBufferSRV(int p_slot, const GpuStructuredBuffer* p_buffer) final;
     void UnbindStructuredBufferSRV(int p_slot) final;
 
-    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) final;
-    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) final;
+    void UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) final;
+    void UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) final;
+    void BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) final;
 
-    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) final;
-    void UnbindTexture(Dimension p_dimension, int p_slot) final;
+    void BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) final;
+    void UnbindTextureImpl(Dimension p_dimension, int p_slot) final;
 
-    void GenerateMipmap(const GpuTexture* p_texture) final;
+    void GenerateMipmapImpl(const GpuTexture* p_texture) final;
 
     void BeginEvent(std::string_view p_event) final;
     void EndEvent() final;
@@ -36,6 +36,8 @@ struct D3d11UniformBuffer : public GpuConstantBuffer {
 
     Microsoft::WRL::ComPtr<ID3D11Buffer> internalBuffer;
     mutable const char* data;
+    // backs data for buffers written with UpdateConstantBufferRange()
+    mutable std::vector<char> storage;
 };
 
 struct D3d11StructuredBuffer : GpuStructuredBuffer {
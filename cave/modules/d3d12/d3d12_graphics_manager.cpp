@@ -314,7 +314,7 @@ void D3d12GraphicsManager::SetBlendState(const BlendDesc& p_desc, const float* p
     unused(p_mask);
 }
 
-void D3d12GraphicsManager::SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
+void D3d12GraphicsManager::SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
     unused(p_mip_level);
     DEV_ASSERT(p_framebuffer);
 
@@ -512,7 +512,7 @@ auto D3d12GraphicsManager::CreateMeshImpl(const GpuMeshDesc& p_desc,
     return ret;
 }
 
-void D3d12GraphicsManager::SetMesh(const GpuMesh* p_mesh) {
+void D3d12GraphicsManager::SetMeshImpl(const GpuMesh* p_mesh) {
     auto mesh = reinterpret_cast<const D3d12MeshBuffers*>(p_mesh);
 
     m_graphicsCommandList->IASetVertexBuffers(0, MESH_MAX_VERTEX_BUFFER_COUNT, mesh->vbvs);
@@ -644,14 +644,22 @@ auto D3d12GraphicsManager::CreateStructuredBuffer(const GpuBufferDesc& p_desc) -
     return result;
 }
 
-void D3d12GraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
+void D3d12GraphicsManager::UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
     if (p_size) {
         auto cb = reinterpret_cast<const D3d12ConstantBuffer*>(p_buffer);
         memcpy(cb->mappedData, p_data, p_size);
     }
 }
 
-void D3d12GraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
+void D3d12GraphicsManager::UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) {
+    auto cb = reinterpret_cast<const D3d12ConstantBuffer*>(p_buffer);
+    DEV_ASSERT(p_size + p_offset <= cb->capacity);
+    if (p_size) {
+        memcpy(cb->mappedData + p_offset, p_data, p_size);
+    }
+}
+
+void D3d12GraphicsManager::BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
     auto buffer = reinterpret_cast<const D3d12ConstantBuffer*>(p_buffer);
     DEV_ASSERT(p_size + p_offset <= buffer->capacity);
 
@@ -903,18 +911,18 @@ std::shared_ptr<GpuTexture> D3d12GraphicsManager::CreateTextureImpl(const GpuTex
     return gpu_texture;
 }
 
-void D3d12GraphicsManager::BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) {
+void D3d12GraphicsManager::BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) {
     unused(p_dimension);
     unused(p_handle);
     unused(p_slot);
 }
 
-void D3d12GraphicsManager::UnbindTexture(Dimension p_dimension, int p_slot) {
+void D3d12GraphicsManager::UnbindTextureImpl(Dimension p_dimension, int p_slot) {
     unused(p_dimension);
     unused(p_slot);
 }
 
-void D3d12GraphicsManager::GenerateMipmap(const GpuTexture* p_texture) {
+void D3d12GraphicsManager::GenerateMipmapImpl(const GpuTexture* p_texture) {
     unused(p_texture);
     CRASH_NOW();
 }
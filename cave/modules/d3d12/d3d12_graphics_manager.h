@@ -31,7 +31,7 @@ public:
     void SetStencilRef(uint32_t p_ref) final;
     void SetBlendState(const BlendDesc& p_desc, const float* p_factor, uint32_t p_mask) final;
 
-    void SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) final;
+    void SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) final;
     void UnsetRenderTarget() final;
     void BeginDrawPass(const Framebuffer* p_framebuffer) final;
     void EndDrawPass(const Framebuffer* p_framebuffer) final;
@@ -52,7 +52,7 @@ public:
                         const GpuBufferDesc* p_vb_descs,
                         const GpuBufferDesc* p_ib_desc) -> Result<std::shared_ptr<GpuMesh>> final;
 
-    void SetMesh(const GpuMesh* p_mesh) final;
+    void SetMeshImpl(const GpuMesh* p_mesh) final;
 
     void DrawElements(uint32_t p_count, uint32_t p_offset) final;
     void DrawElementsInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset) final;
@@ -70,14 +70,15 @@ public:
     void UnbindStructuredBufferSRV(int p_slot) final;
 
     auto CreateConstantBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuConstantBuffer>> final;
-    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) final;
-    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) final;
+    void UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) final;
+    void UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) final;
+    void BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) final;
 
     // @TODO: remove Dimension
-    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) final;
-    void UnbindTexture(Dimension p_dimension, int p_slot) final;
+    void BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) final;
+    void UnbindTextureImpl(Dimension p_dimension, int p_slot) final;
 
-    void GenerateMipmap(const GpuTexture* p_texture) final;
+    void GenerateMipmapImpl(const GpuTexture* p_texture) final;
 
     std::shared_ptr<Framebuffer> CreateFramebuffer(const FramebufferDesc& p_subpass_desc) final;
 
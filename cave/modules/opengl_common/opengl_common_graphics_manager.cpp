@@ -252,7 +252,7 @@ auto CommonOpenGLGraphicsManager::CreateMeshImpl(const GpuMeshDesc& p_desc,
     return ret;
 }
 
-void CommonOpenGLGraphicsManager::SetMesh(const GpuMesh* p_mesh) {
+void CommonOpenGLGraphicsManager::SetMeshImpl(const GpuMesh* p_mesh) {
     if (!p_mesh) {
         if (!m_dummy_vao) {
             glGenVertexArrays(1, &m_dummy_vao);
@@ -359,20 +359,28 @@ void CommonOpenGLGraphicsManager::UpdateBufferData(const GpuBufferDesc& p_desc,
     CRASH_NOW();
 }
 
-void CommonOpenGLGraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
+void CommonOpenGLGraphicsManager::UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
     auto buffer = reinterpret_cast<const OpenGlUniformBuffer*>(p_buffer);
     glBindBuffer(GL_UNIFORM_BUFFER, buffer->handle);
     glBufferData(GL_UNIFORM_BUFFER, p_size, p_data, GL_DYNAMIC_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
-void CommonOpenGLGraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
+void CommonOpenGLGraphicsManager::UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) {
+    auto buffer = reinterpret_cast<const OpenGlUniformBuffer*>(p_buffer);
+    DEV_ASSERT(p_size + p_offset <= buffer->capacity);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->handle);
+    glBufferSubData(GL_UNIFORM_BUFFER, p_offset, p_size, p_data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void CommonOpenGLGraphicsManager::BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
     auto buffer = reinterpret_cast<const OpenGlUniformBuffer*>(p_buffer);
     DEV_ASSERT(p_size + p_offset <= buffer->capacity);
     glBindBufferRange(GL_UNIFORM_BUFFER, p_buffer->GetSlot(), buffer->handle, p_offset, p_size);
 }
 
-void CommonOpenGLGraphicsManager::BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) {
+void CommonOpenGLGraphicsManager::BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) {
     if (p_handle == 0) {
         return;
     }
@@ -382,14 +390,14 @@ void CommonOpenGLGraphicsManager::BindTexture(Dimension p_dimension, uint64_t p_
     glBindTexture(texture_type, static_cast<GLuint>(p_handle));
 }
 
-void CommonOpenGLGraphicsManager::UnbindTexture(Dimension p_dimension, int p_slot) {
+void CommonOpenGLGraphicsManager::UnbindTextureImpl(Dimension p_dimension, int p_slot) {
     const GLuint texture_type = gl::ConvertDimension(p_dimension);
 
     glActiveTexture(GL_TEXTURE0 + p_slot);
     glBindTexture(texture_type, 0);
 }
 
-void CommonOpenGLGraphicsManager::GenerateMipmap(const GpuTexture* p_texture) {
+void CommonOpenGLGraphicsManager::GenerateMipmapImpl(const GpuTexture* p_texture) {
     auto dimension = gl::ConvertDimension(p_texture->desc.dimension);
     glBindTexture(dimension, p_texture->GetHandle32());
     glGenerateMipmap(dimension);
@@ -595,7 +603,7 @@ void CommonOpenGLGraphicsManager::SetBlendState(const BlendDesc& p_desc, const f
     glBlendFunc(src_blend, dest_blend);
 }
 
-void CommonOpenGLGraphicsManager::SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
+void CommonOpenGLGraphicsManager::SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
     DEV_ASSERT(p_framebuffer);
     if (p_framebuffer->desc.type == FramebufferDesc::SCREEN) {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
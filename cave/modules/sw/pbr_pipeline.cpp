@@ -12,15 +12,13 @@ VSOutput PbrPipeline::ProcessVertex(const VSInput& input) {
     vs_output.position = per_frame_cb.c_camProj *
                          per_frame_cb.c_camView *
                          vs_output.world_position;
+    // the camera uses an opengl projection, the rasterizer expects depth in [0, 1]
+    vs_output.position.z = 0.5f * (vs_output.position.z + vs_output.position.w);
     vs_output.normal = per_batch_cb.c_worldMatrix * input.normal;
     vs_output.uv = input.uv;
     return vs_output;
 }
 
-FORCE_INLINE float SrgbToLinear(float s) {
-    return std::pow((s + 0.055f) / 1.055f, 2.4f);
-}
-
 static Vector3f Sample(ImageAsset* p_image, Vector2f uv) {
     const int x = static_cast<int>(uv.x * p_image->width);
     const int y = static_cast<int>(uv.y * p_image->height);
@@ -42,7 +40,7 @@ static Vector3f Sample(ImageAsset* p_image, Vector2f uv) {
     return color;
 }
 
-Vector3f PbrPipeline::ProcessFragment(const VSOutput& input) {
+bool PbrPipeline::ProcessFragment(const VSOutput& input, PSOutput& output) {
     Vector3f base_color;
     if (material_cb.c_hasBaseColorMap && material_cb.c_baseColorMapHandle) {
         ImageAsset* image = (ImageAsset*)material_cb.c_baseColorMapHandle;
@@ -58,7 +56,8 @@ Vector3f PbrPipeline::ProcessFragment(const VSOutput& input) {
                                            material_cb.c_roughness,
                                            material_cb.c_emissivePower);
 
-    return final_color;
+    output.color[0] = Vector4f(final_color, 1.0f);
+    return true;
 }
 
 Vector3f PbrPipeline::ComputeLighting(Vector3f base_color,
@@ -101,4 +100,71 @@ Vector3f PbrPipeline::ComputeLighting(Vector3f base_color,
     return final_color;
 }
 
+static float ShadowTest(const SwGpuTexture& p_shadow_map, const Light& p_light, const Vector3f& p_world_position, float p_n_dot_l) {
+    Vector4f light_space_position = p_light.view_matrix * Vector4f(p_world_position, 1.0f);
+    light_space_position = p_light.projection_matrix * light_space_position;
+    light_space_position /= light_space_position.w;
+
+    const float u = 0.5f * light_space_position.x + 0.5f;
+    const float v = 0.5f * -light_space_position.y + 0.5f;
+    const float current_depth = light_space_position.z;
+
+    const Vector2f texel_size(1.0f / p_shadow_map.GetWidth(), 1.0f / p_shadow_map.GetHeight());
+
+    // @TODO: better bias
+    const float bias = max(0.005f * (1.0f - p_n_dot_l), 0.0005f);
+
+    float shadow = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        const Vector2f uv(u + (i / 2) * texel_size.x, v + (i % 2) * texel_size.y);
+        const float closest_depth = p_shadow_map.Sample(uv, AddressMode::CLAMP).x;
+        shadow += current_depth - bias > closest_depth ? 1.0f : 0.0f;
+    }
+    return shadow / 4.0f;
+}
+
+Vector3f ComputeDirectLighting(const PerFrameConstantBuffer& p_frame,
+                               const SwGpuTexture* p_shadow_map,
+                               const Vector3f& p_base_color,
+                               const Vector3f& p_world_position,
+                               const Vector3f& p_N,
+                               float p_metallic,
+                               float p_roughness) {
+    const Vector3f V = normalize(p_frame.c_cameraPosition - p_world_position);
+    const Vector3f F0 = cave::lerp(Vector3f(0.04f), p_base_color, p_metallic);
+
+    Vector3f Lo = Vector3f(0.0f);
+    const int light_count = min(p_frame.c_lightCount, MAX_LIGHT_COUNT);
+    for (int light_idx = 0; light_idx < light_count; ++light_idx) {
+        const Light& light = p_frame.c_lights[light_idx];
+        Vector3f direct_lighting = Vector3f(0.0f);
+        float shadow = 0.0f;
+        switch (light.type) {
+            case LIGHT_TYPE_INFINITE: {
+                const Vector3f L = light.position;
+                direct_lighting = lighting(p_N, L, V, light.color, F0, p_roughness, p_metallic, p_base_color);
+                if (light.cast_shadow == 1 && p_shadow_map) {
+                    const float NdotL = max(dot(p_N, L), 0.0f);
+                    shadow = ShadowTest(*p_shadow_map, light, p_world_position, NdotL);
+                    direct_lighting *= (1.0f - shadow);
+                }
+            } break;
+            case LIGHT_TYPE_POINT: {
+                const Vector3f delta = light.position - p_world_position;
+                const float dist = length(delta);
+                float atten = light.atten_constant + light.atten_linear * dist + light.atten_quadratic * (dist * dist);
+                atten = 1.0f / atten;
+                if (atten > 0.01f) {
+                    const Vector3f L = normalize(delta);
+                    direct_lighting = atten * lighting(p_N, L, V, light.color, F0, p_roughness, p_metallic, p_base_color);
+                }
+            } break;
+            default:
+                break;
+        }
+        Lo += (1.0f - shadow) * direct_lighting;
+    }
+    return Lo;
+}
+
 }  // namespace cave
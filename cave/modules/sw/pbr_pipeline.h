@@ -19,7 +19,7 @@ public:
 
     virtual VSOutput ProcessVertex(const VSInput& input) override;
 
-    virtual Vector3f ProcessFragment(const VSOutput& input) override;
+    virtual bool ProcessFragment(const VSOutput& input, PSOutput& output) override;
 
     Vector3f ComputeLighting(Vector3f base_color,
                              Vector3f world_position,
@@ -33,4 +33,14 @@ public:
     MaterialConstantBuffer material_cb;
 };
 
+// compute_lighting() of lighting.hlsl without image based lighting, p_shadow_map is the shadow
+// map of the directional lights and can be null
+Vector3f ComputeDirectLighting(const PerFrameConstantBuffer& p_frame,
+                               const SwGpuTexture* p_shadow_map,
+                               const Vector3f& p_base_color,
+                               const Vector3f& p_world_position,
+                               const Vector3f& p_N,
+                               float p_metallic,
+                               float p_roughness);
+
 }  // namespace cave
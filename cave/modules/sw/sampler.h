@@ -7,6 +7,10 @@ struct Color {
     uint8_t r, g, b, a;
 };
 
+FORCE_INLINE float SrgbToLinear(float s) {
+    return std::pow((s + 0.055f) / 1.055f, 2.4f);
+}
+
 template<class T>
 class SwTexture {
 public:
@@ -0,0 +1,331 @@
+#include "sw_pipelines.h"
+
+#include "pbr_pipeline.h"
+
+namespace cave {
+#include "shader_resource_defines.hlsl.h"
+}  // namespace cave
+
+namespace cave {
+
+static Matrix4x4f LoadBoneMatrix(const BoneConstantBuffer& p_bones, int p_index) {
+    // three rows per bone
+    Matrix4x4f matrix(1.0f);
+    for (int row = 0; row < 3; ++row) {
+        const Vector4f& value = p_bones.c_bones[p_index * 3 + row];
+        for (int col = 0; col < 4; ++col) {
+            matrix[col][row] = value[col];
+        }
+    }
+    return matrix;
+}
+
+void SwMeshPipeline::BeginDraw(const SwBindings& p_bindings, uint32_t p_instance) {
+    SwPipeline::BeginDraw(p_bindings, p_instance);
+
+    const PerBatchConstantBuffer* batch = p_bindings.Get<PerBatchConstantBuffer>();
+    const PerPassConstantBuffer* pass = p_bindings.Get<PerPassConstantBuffer>();
+    DEV_ASSERT(batch && pass);
+
+    if (batch->c_meshFlag == MESH_HAS_INSTANCE) {
+        const BoneConstantBuffer* bones = p_bindings.Get<BoneConstantBuffer>();
+        DEV_ASSERT(bones);
+        m_worldMatrix = LoadBoneMatrix(*bones, p_instance);
+    } else {
+        m_worldMatrix = batch->c_worldMatrix;
+    }
+
+    m_worldViewMatrix = pass->c_viewMatrix * m_worldMatrix;
+    m_projectionMatrix = pass->c_projectionMatrix;
+    m_material = p_bindings.Get<MaterialConstantBuffer>();
+}
+
+VSOutput SwMeshPipeline::ProcessVertex(const VSInput& p_input) {
+    const Vector4f view_position = m_worldViewMatrix * p_input.position;
+    const Vector4f normal = m_worldMatrix * p_input.normal;
+
+    VSOutput output;
+    output.position = m_projectionMatrix * view_position;
+    output.world_position = view_position;
+    output.normal = Vector4f(normalize(Vector3f(normal.xyz)), 0.0f);
+    output.uv = p_input.uv;
+    return output;
+}
+
+bool SwDepthPipeline::ProcessFragment(const VSOutput& p_input, PSOutput& p_output) {
+    unused(p_input);
+    unused(p_output);
+    return true;
+}
+
+static Vector4f SampleMap(const SwBindings& p_bindings, int p_slot, const Vector2f& p_uv, const Vector4f& p_default) {
+    const SwGpuTexture* texture = p_bindings.textures[p_slot];
+    return texture ? texture->Sample(p_uv, AddressMode::WRAP) : p_default;
+}
+
+static void SampleMetallicRoughness(const SwBindings& p_bindings,
+                                    const MaterialConstantBuffer& p_material,
+                                    const Vector2f& p_uv,
+                                    float& p_metallic,
+                                    float& p_roughness) {
+    p_metallic = p_material.c_metallic;
+    p_roughness = p_material.c_roughness;
+    if (p_material.c_hasMaterialMap != 0) {
+        if (const SwGpuTexture* texture = p_bindings.textures[GetMaterialMapSlot()]; texture) {
+            const Vector4f value = texture->Sample(p_uv, AddressMode::WRAP);
+            p_metallic = value.b;
+            p_roughness = value.g;
+        }
+    }
+}
+
+bool SwGbufferPipeline::ProcessFragment(const VSOutput& p_input, PSOutput& p_output) {
+    DEV_ASSERT(m_material);
+    const MaterialConstantBuffer& material = *m_material;
+
+    Vector4f color = material.c_baseColor;
+    if (material.c_hasBaseColorMap) {
+        color = SampleMap(*m_bindings, GetBaseColorMapSlot(), p_input.uv, color);
+    }
+
+    if (color.a <= 0.0f) {
+        return false;
+    }
+
+    float metallic;
+    float roughness;
+    SampleMetallicRoughness(*m_bindings, material, p_input.uv, metallic, roughness);
+
+    const Vector3f N = normalize(Vector3f(p_input.normal.xyz));
+
+    p_output.color[0] = color;
+    p_output.color[1] = Vector4f(0.5f * N + 0.5f, 1.0f);
+    p_output.color[2] = Vector4f(material.c_emissivePower, roughness, metallic, 1.0f);
+    return true;
+}
+
+bool SwForwardPipeline::ProcessFragment(const VSOutput& p_input, PSOutput& p_output) {
+    DEV_ASSERT(m_material);
+    const MaterialConstantBuffer& material = *m_material;
+    const PerFrameConstantBuffer& frame = *m_bindings->Get<PerFrameConstantBuffer>();
+
+    const Vector4f world_position = frame.c_invCamView * Vector4f(p_input.world_position.xyz, 1.0f);
+
+    Vector4f color = material.c_baseColor;
+    if (material.c_hasBaseColorMap) {
+        color = SampleMap(*m_bindings, GetBaseColorMapSlot(), p_input.uv, color);
+    }
+
+    float metallic;
+    float roughness;
+    SampleMetallicRoughness(*m_bindings, material, p_input.uv, metallic, roughness);
+
+    const Vector3f N = normalize(Vector3f(p_input.normal.xyz));
+
+    // t1 is the shadow map
+    const Vector3f lighting = ComputeDirectLighting(frame,
+                                                    m_bindings->textures[1],
+                                                    color.xyz,
+                                                    world_position.xyz,
+                                                    N,
+                                                    metallic,
+                                                    roughness);
+    p_output.color[0] = Vector4f(lighting, color.a);
+    return true;
+}
+
+VSOutput SwScreenPipeline::ProcessVertex(const VSInput& p_input) {
+    VSOutput output;
+    output.position = p_input.position;
+    output.uv = p_input.uv;
+    return output;
+}
+
+static Vector3f NdcToViewPos(const PerFrameConstantBuffer& p_frame, const Vector2f& p_uv, float p_depth) {
+    const Vector2f ndc = 2.0f * p_uv - 1.0f;
+    const Vector4f view_position = p_frame.c_invCamProj * Vector4f(ndc.x, ndc.y, p_depth, 1.0f);
+    return Vector3f(view_position.xyz) / view_position.w;
+}
+
+bool SwLightingPipeline::ProcessFragment(const VSOutput& p_input, PSOutput& p_output) {
+    const PerFrameConstantBuffer& frame = *m_bindings->Get<PerFrameConstantBuffer>();
+    const SwGpuTexture* const* textures = m_bindings->textures;
+    // t0 to t3 are the gbuffer and its depth, t5 the shadow map
+    if (!textures[0] || !textures[1] || !textures[2] || !textures[3]) {
+        return false;
+    }
+
+    // the gbuffer has the size of the target, every pixel reads its own texel
+    const Vector2f uv = p_input.uv;
+    const Vector4f emissive_roughness_metallic = textures[2]->SamplePoint(uv, AddressMode::CLAMP);
+    if (emissive_roughness_metallic.a < 0.01f) {
+        return false;
+    }
+
+    const Vector3f base_color = textures[0]->SamplePoint(uv, AddressMode::CLAMP).xyz;
+    const float depth = textures[3]->SamplePoint(uv, AddressMode::CLAMP).x;
+    const Vector3f view_position = NdcToViewPos(frame, Vector2f(uv.x, 1.0f - uv.y), depth);
+    const Vector4f world_position = frame.c_invCamView * Vector4f(view_position, 1.0f);
+
+    const float emissive = emissive_roughness_metallic.r;
+    const float roughness = emissive_roughness_metallic.g;
+    const float metallic = emissive_roughness_metallic.b;
+
+    if (emissive > 0.0f) {
+        p_output.color[0] = Vector4f(emissive * base_color, 1.0f);
+        return true;
+    }
+
+    const Vector3f N = 2.0f * Vector3f(textures[1]->SamplePoint(uv, AddressMode::CLAMP).xyz) - 1.0f;
+
+    const Vector3f color = ComputeDirectLighting(frame,
+                                                 textures[5],
+                                                 base_color,
+                                                 world_position.xyz,
+                                                 N,
+                                                 metallic,
+                                                 roughness);
+    p_output.color[0] = Vector4f(color, 1.0f);
+    return true;
+}
+
+bool SwPostProcessPipeline::ProcessFragment(const VSOutput& p_input, PSOutput& p_output) {
+    const PerFrameConstantBuffer& frame = *m_bindings->Get<PerFrameConstantBuffer>();
+    const SwGpuTexture* lighting = m_bindings->textures[0];
+    const SwGpuTexture* highlight = m_bindings->textures[1];
+    const SwGpuTexture* bloom = m_bindings->textures[2];
+    if (!lighting) {
+        return false;
+    }
+
+    const Vector2f uv = p_input.uv;
+
+    // edge detection
+    if (highlight) {
+        static constexpr float sx[3][3] = { { 1.0f, 2.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { -1.0f, -2.0f, -1.0f } };
+        static constexpr float sy[3][3] = { { 1.0f, 0.0f, -1.0f }, { 2.0f, 0.0f, -2.0f }, { 1.0f, 0.0f, -1.0f } };
+
+        const Vector2f texel_size(1.0f / highlight->GetWidth(), 1.0f / highlight->GetHeight());
+        float gx = 0.0f;
+        float gy = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                const Vector2f offset(uv.x + texel_size.x * (i - 1), uv.y + texel_size.y * (j - 1));
+                const float value = highlight->Sample(offset, AddressMode::CLAMP).r;
+                gx += sx[i][j] * value;
+                gy += sy[i][j] * value;
+            }
+        }
+
+        if (std::sqrt(gx * gx + gy * gy) > 0.0f) {
+            p_output.color[0] = Vector4f(0.98f, 0.64f, 0.0f, 1.0f);
+            return true;
+        }
+    }
+
+    Vector3f hdr_color = lighting->Sample(uv, AddressMode::CLAMP).xyz;
+
+    if (frame.c_enableBloom == 1 && bloom) {
+        hdr_color += Vector3f(bloom->Sample(uv, AddressMode::CLAMP).xyz);
+    }
+
+    // tone mapping and gamma correction
+    const float gamma = 2.2f;
+    Vector3f color = hdr_color / (hdr_color + 1.0f);
+    color = Vector3f(std::pow(color.r, 1.0f / gamma),
+                     std::pow(color.g, 1.0f / gamma),
+                     std::pow(color.b, 1.0f / gamma));
+
+    p_output.color[0] = Vector4f(color, 1.0f);
+    return true;
+}
+
+void SwBloomSetupPipeline::ProcessThread(const Vector3i& p_id) {
+    const SwGpuTexture* input = m_bindings->textures[0];
+    SwGpuTexture* output = m_bindings->uavs[0];
+    if (!input || !output || p_id.x >= output->GetWidth() || p_id.y >= output->GetHeight()) {
+        return;
+    }
+
+    const Vector2f uv((float)p_id.x / output->GetWidth(), (float)p_id.y / output->GetHeight());
+    Vector3f color = input->Sample(uv, AddressMode::CLAMP).xyz;
+
+    const float luma = std::sqrt(dot(color, Vector3f(0.299f, 0.587f, 0.114f)));
+    const float THRESHOLD = 1.3f;
+    if (luma < THRESHOLD) {
+        color = Vector3f::Zero;
+    }
+
+    output->Store(p_id.x, p_id.y, Vector4f(color, 1.0f));
+}
+
+void SwBloomDownSamplePipeline::ProcessThread(const Vector3i& p_id) {
+    const SwGpuTexture* input = m_bindings->textures[0];
+    SwGpuTexture* output = m_bindings->uavs[0];
+    if (!input || !output || p_id.x >= output->GetWidth() || p_id.y >= output->GetHeight()) {
+        return;
+    }
+
+    const float x = 1.0f / input->GetWidth();
+    const float y = 1.0f / input->GetHeight();
+    const float u = (float)p_id.x / output->GetWidth() + 0.5f * x;
+    const float v = (float)p_id.y / output->GetHeight() + 0.5f * y;
+
+    auto sample = [&](float p_dx, float p_dy) {
+        return Vector3f(input->Sample(Vector2f(u + p_dx, v + p_dy), AddressMode::CLAMP).xyz);
+    };
+
+    // a - b - c
+    // - j - k -
+    // d - e - f
+    // - l - m -
+    // g - h - i
+    const Vector3f a = sample(-2 * x, 2 * y);
+    const Vector3f b = sample(0, 2 * y);
+    const Vector3f c = sample(2 * x, 2 * y);
+    const Vector3f d = sample(-2 * x, 0);
+    const Vector3f e = sample(0, 0);
+    const Vector3f f = sample(2 * x, 0);
+    const Vector3f g = sample(-2 * x, -2 * y);
+    const Vector3f h = sample(0, -2 * y);
+    const Vector3f i = sample(2 * x, -2 * y);
+    const Vector3f j = sample(-x, y);
+    const Vector3f k = sample(x, y);
+    const Vector3f l = sample(-x, -y);
+    const Vector3f m = sample(x, -y);
+
+    Vector3f color = e * 0.125f;
+    color += (a + c + g + i) * 0.03125f;
+    color += (b + d + f + h) * 0.0625f;
+    color += (j + k + l + m) * 0.125f;
+    color = max(color, Vector3f::Zero);
+
+    output->Store(p_id.x, p_id.y, Vector4f(color, 1.0f));
+}
+
+void SwBloomUpSamplePipeline::ProcessThread(const Vector3i& p_id) {
+    const SwGpuTexture* input = m_bindings->textures[0];
+    SwGpuTexture* output = m_bindings->uavs[0];
+    if (!input || !output || p_id.x >= output->GetWidth() || p_id.y >= output->GetHeight()) {
+        return;
+    }
+
+    const float u = (float)p_id.x / output->GetWidth() + 0.5f / input->GetWidth();
+    const float v = (float)p_id.y / output->GetHeight() + 0.5f / input->GetHeight();
+    const float radius = 0.005f;
+
+    auto sample = [&](float p_dx, float p_dy) {
+        return Vector3f(input->Sample(Vector2f(u + p_dx, v + p_dy), AddressMode::CLAMP).xyz);
+    };
+
+    // 3x3 tent filter
+    Vector3f upsample = sample(0, 0) * 4.0f;
+    upsample += (sample(0, radius) + sample(-radius, 0) + sample(radius, 0) + sample(0, -radius)) * 2.0f;
+    upsample += sample(-radius, radius) + sample(radius, radius) + sample(-radius, -radius) + sample(radius, -radius);
+    upsample *= 1.0f / 16.0f;
+
+    const Vector3f color = lerp(Vector3f(output->Load(p_id.x, p_id.y).xyz), upsample, 0.6f);
+    output->Store(p_id.x, p_id.y, Vector4f(color, 1.0f));
+}
+
+}  // namespace cave
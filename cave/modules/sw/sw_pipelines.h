@@ -0,0 +1,103 @@
+#pragma once
+#include "sw_renderer.h"
+
+namespace cave {
+
+#include "cbuffer.hlsl.h"
+
+// CPU ports of the shaders the 3D render graph draws with, see shader/hlsl for the originals.
+// Image based lighting, ssao and normal maps are not ported.
+
+// mesh.vs.hlsl, skinned meshes are drawn in bind pose
+class SwMeshPipeline : public SwPipeline {
+public:
+    using SwPipeline::SwPipeline;
+
+    void BeginDraw(const SwBindings& p_bindings, uint32_t p_instance) override;
+
+    VSOutput ProcessVertex(const VSInput& p_input) override;
+
+protected:
+    const MaterialConstantBuffer* m_material = nullptr;
+
+    Matrix4x4f m_worldMatrix;
+    Matrix4x4f m_worldViewMatrix;
+    Matrix4x4f m_projectionMatrix;
+};
+
+// depth only, for the prepass and the shadow map
+class SwDepthPipeline : public SwMeshPipeline {
+public:
+    SwDepthPipeline()
+        : SwMeshPipeline(0) {}
+
+    bool ProcessFragment(const VSOutput& p_input, PSOutput& p_output) override;
+};
+
+// gbuffer.ps.hlsl
+class SwGbufferPipeline : public SwMeshPipeline {
+public:
+    SwGbufferPipeline()
+        : SwMeshPipeline(VARYING_NORMAL | VARYING_UV) {}
+
+    bool ProcessFragment(const VSOutput& p_input, PSOutput& p_output) override;
+};
+
+// forward.ps.hlsl
+class SwForwardPipeline : public SwMeshPipeline {
+public:
+    SwForwardPipeline()
+        : SwMeshPipeline(VARYING_NORMAL | VARYING_UV | VARYING_WORLD_POSITION) {}
+
+    bool ProcessFragment(const VSOutput& p_input, PSOutput& p_output) override;
+};
+
+// screenspace_quad.vs.hlsl
+class SwScreenPipeline : public SwPipeline {
+public:
+    SwScreenPipeline()
+        : SwPipeline(VARYING_UV) {}
+
+    VSOutput ProcessVertex(const VSInput& p_input) override;
+};
+
+// lighting.ps.hlsl
+class SwLightingPipeline : public SwScreenPipeline {
+public:
+    bool ProcessFragment(const VSOutput& p_input, PSOutput& p_output) override;
+};
+
+// post_process.ps.hlsl
+class SwPostProcessPipeline : public SwScreenPipeline {
+public:
+    bool ProcessFragment(const VSOutput& p_input, PSOutput& p_output) override;
+};
+
+// bloom_setup.cs.hlsl
+class SwBloomSetupPipeline : public SwComputePipeline {
+public:
+    SwBloomSetupPipeline()
+        : SwComputePipeline(Vector3i(16, 16, 1)) {}
+
+    void ProcessThread(const Vector3i& p_id) override;
+};
+
+// bloom_downsample.cs.hlsl
+class SwBloomDownSamplePipeline : public SwComputePipeline {
+public:
+    SwBloomDownSamplePipeline()
+        : SwComputePipeline(Vector3i(16, 16, 1)) {}
+
+    void ProcessThread(const Vector3i& p_id) override;
+};
+
+// bloom_upsample.cs.hlsl
+class SwBloomUpSamplePipeline : public SwComputePipeline {
+public:
+    SwBloomUpSamplePipeline()
+        : SwComputePipeline(Vector3i(16, 16, 1)) {}
+
+    void ProcessThread(const Vector3i& p_id) override;
+};
+
+}  // namespace cave
@@ -1,295 +1,862 @@
 #include "sw_renderer.h"
 
+#include "engine/assets/image_asset.h"
 #include "engine/assets/mesh_asset.h"
-#include "engine/math/box.h"
+#include "engine/debugger/profiler.h"
+#include "engine/render_graph/common_passes.h"
+#include "engine/render_graph/render_graph_defines.h"
+#include "engine/renderer/graphics_dvars.h"
+#include "engine/renderer/pipeline_state_objects.h"
+#include "engine/renderer/sampler.h"
+#include "engine/runtime/application.h"
+#include "engine/runtime/render_system.h"
 #include "engine/systems/job_system/job_system.h"
 
+#include "sw_pipelines.h"
+
 namespace cave {
 
 // config
 static constexpr int TILE_SIZE = 32;
+// triangles are clipped against w = CLIP_W, so every vertex can be projected
+static constexpr float CLIP_W = 1e-5f;
 
-// barycentric
-// P = uA + vB + wC (where w = 1 - u - v)
-// P = uA + vB + C - uC - vC => (C - P) + u(A - C) + v(B - C) = 0
-// uCA + vCB + PC = 0
-// [u v 1] [CAx CBx PCx] = 0
-// [u v 1] [CAy CBy PCy] = 0
-// [u v 1] is the cross product
-
-/**
- * Perspective correct linear interpolation
- * https://stackoverflow.com/questions/24441631/how-exactly-does-opengl-do-perspectively-correct-linear-interpolation
- */
-static void NdcToViewport(Vector4f& p_position) {
-    DEV_ASSERT(p_position.w != 0.0f);
-    float inv_w = 1.0f / p_position.w;
-    p_position.x *= inv_w;
-    p_position.y *= inv_w;
-    p_position.z *= inv_w;
-    p_position.w = inv_w;
+template<typename FUNC>
+static void ParallelFor(uint32_t p_count, uint32_t p_group_size, const FUNC& p_func) {
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(p_count, p_group_size, [&](jobsystem::JobArgs p_args) { p_func(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    unused(p_group_size);
+    for (uint32_t i = 0; i < p_count; ++i) {
+        p_func(i);
+    }
+#endif
+}
 
-    p_position.x = 0.5f + 0.5f * p_position.x;
-    p_position.y = 0.5f + 0.5f * p_position.y;
+SwCommandContext::SwCommandContext(SwGraphicsManager& p_device, std::string_view p_name)
+    : EmptyGraphicsManager(p_name), m_device(p_device) {
+    CreatePipelineStates();
+    SetPipeline(nullptr);
 }
 
-OutTriangle SwGraphicsManager::ProcessTriangle(const VSInput& vs_in0,
-                                               const VSInput& vs_in1,
-                                               const VSInput& vs_in2) {
-    SwPipeline* pipeline = m_state.pipeline;
-    VSOutput vs_out0 = pipeline->ProcessVertex(vs_in0);
-    VSOutput vs_out1 = pipeline->ProcessVertex(vs_in1);
-    VSOutput vs_out2 = pipeline->ProcessVertex(vs_in2);
+SwCommandContext::~SwCommandContext() = default;
 
-    // TODO: front plane clipping
-    constexpr float t = 1.0f;
-    if (vs_out0.position.z / vs_out0.position.w > t ||
-        vs_out1.position.z / vs_out1.position.w > t ||
-        vs_out2.position.z / vs_out2.position.w > t) {
-        OutTriangle triangle;
-        triangle.discarded = true;
-        return triangle;
+FrameContext& SwCommandContext::GetCurrentFrame() {
+    return m_device.GetCurrentFrame();
+}
+
+std::shared_ptr<GpuTexture> SwCommandContext::FindTexture(std::string_view p_name) const {
+    return m_device.FindTexture(p_name);
+}
+
+void SwCommandContext::InheritBindings(const SwCommandContext& p_context) {
+    SetPipeline(nullptr);
+    m_state.rt = nullptr;
+    m_state.colorCount = 0;
+    m_state.depth = nullptr;
+    m_state.vertices = nullptr;
+    m_state.indices = nullptr;
+    m_state.bindings = p_context.m_state.bindings;
+}
+
+SwGraphicsManager::SwGraphicsManager()
+    : SwCommandContext(*this, "SwGraphicsManager") {
+    for (int i = 0; i < SW_RECORDING_CONTEXT_COUNT; ++i) {
+        m_contexts.emplace_back(std::make_unique<SwCommandContext>(*this));
     }
+}
 
-    NdcToViewport(vs_out0.position);
-    NdcToViewport(vs_out1.position);
-    NdcToViewport(vs_out2.position);
+SwGraphicsManager::~SwGraphicsManager() = default;
 
-    // face culling
-    Vector3f ab3d(vs_out0.position.x - vs_out1.position.x, vs_out0.position.y - vs_out1.position.y, vs_out0.position.z - vs_out1.position.z);
-    Vector3f ac3d(vs_out0.position.x - vs_out2.position.x, vs_out0.position.y - vs_out2.position.y, vs_out0.position.z - vs_out2.position.z);
-    Vector3f normal = cross(ab3d, ac3d);
+IGraphicsManager& SwGraphicsManager::BeginRecording(int p_index) {
+    DEV_ASSERT_INDEX(p_index, m_contexts.size());
+    // the frame wide buffers stay bound, the device context doesn't record while a level runs
+    SwCommandContext& context = *m_contexts[p_index];
+    context.InheritBindings(*this);
+    return context;
+}
 
-    if (normal.z < 0.0f) {  // Cull backface
-        OutTriangle triangle;
-        triangle.discarded = true;
-        return triangle;
+auto SwGraphicsManager::InitializeImpl() -> Result<void> {
+    // tools drive the renderer with their own pipelines, the render graph is only built when the
+    // application renders its scenes with the software backend
+    if (!m_app || m_app->GetSpecification().backend != Backend::SOFTWARE) {
+        return Result<void>();
     }
 
-    return OutTriangle{ vs_out0, vs_out1, vs_out2 };
+    CreateFrameConstantBuffers(*this, m_frameContext);
+
+    const Vector2i frame_size = DVAR_GET_IVEC2(resolution);
+    RenderGraphBuilderConfig config;
+    config.frameWidth = frame_size.x;
+    config.frameHeight = frame_size.y;
+    config.is_runtime = m_app->IsRuntime();
+
+    auto res = RenderGraphBuilderExt::Create3D(config, *this);
+    if (!res) {
+        return CAVE_ERROR(res.error());
+    }
+    m_renderGraph = *res;
+    return Result<void>();
 }
 
-static int TileNumber(int p_tile_size, int p_length) {
-    int rem = (p_length % p_tile_size) != 0;
-    return (p_length / p_tile_size) + rem;
+void SwGraphicsManager::Update(Scene* p_scene) {
+    unused(p_scene);
+
+    RenderFrame(m_app->GetRenderSystem()->GetFrameData());
+    PublishCreatedResources();
 }
 
-void SwGraphicsManager::ProcessFragment(OutTriangle& vs_out) {
-    SwRenderTarget* rt = m_state.rt;
-    SwPipeline* pipeline = m_state.pipeline;
+void SwGraphicsManager::RenderFrame(const FrameData* p_framedata) {
+    CAVE_PROFILE_EVENT();
 
-    const int width = rt->m_depthBuffer.m_width;
-    const int height = rt->m_depthBuffer.m_height;
-
-    const VSOutput& vs_out0 = vs_out.p0;
-    const VSOutput& vs_out1 = vs_out.p1;
-    const VSOutput& vs_out2 = vs_out.p2;
-    const Vector2f a(vs_out0.position.x * width, vs_out0.position.y * height);
-    const Vector2f b(vs_out1.position.x * width, vs_out1.position.y * height);
-    const Vector2f c(vs_out2.position.x * width, vs_out2.position.y * height);
-
-    // discard if A, B and C are on the same line
-    const Vector2f BA = a - b;
-    const Vector2f CA = a - c;
-    const Vector2f CB = b - c;
-    if (BA.x * CA.y == BA.y * CA.x) {
+    m_assetUploader.CreateRequestedResources(
+        p_framedata,
+        [&](const ImageAsset& p_image) {
+            GpuTextureDesc texture_desc{};
+            SamplerDesc sampler_desc{};
+            FillTextureAndSamplerDesc(&p_image, texture_desc, sampler_desc);
+            return CreateTexture(texture_desc, sampler_desc);
+        },
+        [&](const MeshAsset& p_mesh) { return CreateMesh(p_mesh); });
+
+    if (!p_framedata || !m_renderGraph) {
         return;
     }
 
-    auto& colorBuffer = rt->m_colorBuffer;
-    auto& depthBuffer = rt->m_depthBuffer;
-    const uint32_t varyingFlags = pipeline->GetVaryingFlags();
+    UploadFrameData(*this, m_frameContext, *p_framedata);
+    m_renderGraph->Execute(*p_framedata, *this);
+    TrimDrawBuffers();
+    for (auto& context : m_contexts) {
+        context->TrimDrawBuffers();
+    }
+}
 
-    const Rect screenBox(Vector2f::Zero, Vector2f(width, height));
-    Rect aabb{};
-    aabb.ExpandPoint(a);
-    aabb.ExpandPoint(b);
-    aabb.ExpandPoint(c);
-    aabb.IntersectBox(screenBox);
-    bool intersect = aabb.IsValid();
-    // discard if not intersect
-    if (!intersect) {
-        return;
+void SwCommandContext::TrimDrawBuffers() {
+    // one dense mesh mustn't pin its triangles for the rest of the session, a frame that
+    // draws it again grows the buffers again
+    const size_t keep = std::max<size_t>(m_frameSlotCount, SW_RETAINED_TRIANGLE_SLOTS);
+    if (m_triangles.capacity() > keep) {
+        m_triangles.resize(std::min(m_triangles.size(), keep));
+        m_triangles.shrink_to_fit();
     }
+    if (m_triangleTiles.capacity() > keep) {
+        m_triangleTiles.resize(std::min(m_triangleTiles.size(), keep));
+        m_triangleTiles.shrink_to_fit();
+    }
+    m_frameSlotCount = 0;
+}
 
-    // rasterization
-    Vector2f min = aabb.GetMin();
-    min.x = std::floor(min.x);
-    min.y = std::floor(min.y);
-    Vector2f max = aabb.GetMax();
-    max.x = std::ceil(max.x);
-    max.y = std::ceil(max.y);
-    for (int _y = (int)min.y; _y < (int)max.y; ++_y) {
-        for (int _x = (int)min.x; _x < (int)max.x; ++_x) {
-            Vector3f a_(CA.x, CB.x, c.x - _x);
-            Vector3f b_(CA.y, CB.y, c.y - _y);
-            Vector3f uvw = cross(a_, b_);
-            if (uvw.z == 0.0f) {
-                continue;
-            }
-            uvw /= uvw.z;
-            uvw.z -= (uvw.x + uvw.y);
-            Vector3f bCoord = uvw;
-
-            static const float epsilon = glm::epsilon<float>();
-            const float sum = bCoord.x + bCoord.y + bCoord.z;
-            const bool test = (bCoord.x >= 0.0f && bCoord.y >= 0.0f && bCoord.z >= 0.0f && std::abs(sum - 1.0f) <= epsilon);
-            if (test) {
-                // depth test
-                VSOutput output;
-                output.position = bCoord.x * vs_out0.position + bCoord.y * vs_out1.position + bCoord.z * vs_out2.position;
-                output.position.z = 0.5f * output.position.z + 0.5f;  // normalize to [0, 1]
-                const size_t index = (height - _y - 1) * width + _x;
-
-                float depth = output.position.z;
-
-                if (depthBuffer.m_buffer[index] < depth) {
-                    continue;
-                }
+void SwGraphicsManager::PublishCreatedResources() {
+    m_assetUploader.PublishCreatedResources();
+}
 
-                depthBuffer.m_buffer[index] = depth;
-                // corrected barycentric coordinates
-                float x = bCoord.x * vs_out0.position.w;
-                float y = bCoord.y * vs_out1.position.w;
-                float z = bCoord.z * vs_out2.position.w;
-                float xyzSum = x + y + z;
-                bCoord.x = x / xyzSum;
-                bCoord.y = y / xyzSum;
-                bCoord.z = z / xyzSum;
-
-                if (varyingFlags & VARYING_NORMAL) {
-                    output.normal = bCoord.x * vs_out0.normal + bCoord.y * vs_out1.normal + bCoord.z * vs_out2.normal;
-                    output.normal = normalize(output.normal);
-                }
-                if (varyingFlags & VARYING_COLOR) {
-                    output.color = bCoord.x * vs_out0.color + bCoord.y * vs_out1.color + bCoord.z * vs_out2.color;
-                }
-                if (varyingFlags & VARYING_UV) {
-                    // NOTE: slow here! probably due to unaligned simd operation
-                    output.uv = bCoord.x * vs_out0.uv + bCoord.y * vs_out1.uv + bCoord.z * vs_out2.uv;
-                }
-                if (varyingFlags & VARYING_WORLD_POSITION) {
-                    output.world_position = bCoord.x * vs_out0.world_position + bCoord.y * vs_out1.world_position + bCoord.z * vs_out2.world_position;
-                }
+void SwCommandContext::CreatePipelineStates() {
+    auto set = [&](PipelineStateName p_name,
+                   std::unique_ptr<SwPipeline> p_pipeline,
+                   const RasterizerDesc& p_rasterizer,
+                   const DepthStencilDesc& p_depth_stencil,
+                   const BlendDesc& p_blend) {
+        PipelineState& state = m_pipelineStates[p_name];
+        state.pipeline = std::move(p_pipeline);
+        state.rasterizer = &p_rasterizer;
+        state.depthStencil = &p_depth_stencil;
+        state.blend = &p_blend;
+    };
+
+    // same fixed function states as the pipeline state manager
+    set(PSO_PREPASS, std::make_unique<SwDepthPipeline>(), s_rasterizerFrontFace, s_depthReversedStencilEnabled, s_blendStateDefault);
+    set(PSO_DPETH, std::make_unique<SwDepthPipeline>(), s_rasterizerBackFace, s_depthStencilDefault, s_blendStateDefault);
+    set(PSO_GBUFFER, std::make_unique<SwGbufferPipeline>(), s_rasterizerFrontFace, s_depthReversedStencilDisabled, s_blendStateDefault);
+    set(PSO_GBUFFER_DOUBLE_SIDED, std::make_unique<SwGbufferPipeline>(), s_rasterizerDoubleSided, s_depthReversedStencilDisabled, s_blendStateDefault);
+    set(PSO_FORWARD_TRANSPARENT, std::make_unique<SwForwardPipeline>(), s_rasterizerDoubleSided, s_depthReversedStencilDisabled, s_transparent);
+    set(PSO_LIGHTING, std::make_unique<SwLightingPipeline>(), s_rasterizerFrontFace, s_depthStencilDisabled, s_blendStateDefault);
+    set(PSO_POST_PROCESS, std::make_unique<SwPostProcessPipeline>(), s_rasterizerFrontFace, s_depthStencilDisabled, s_blendStateDefault);
+
+    m_pipelineStates[PSO_BLOOM_SETUP].computePipeline = std::make_unique<SwBloomSetupPipeline>();
+    m_pipelineStates[PSO_BLOOM_DOWNSAMPLE].computePipeline = std::make_unique<SwBloomDownSamplePipeline>();
+    m_pipelineStates[PSO_BLOOM_UPSAMPLE].computePipeline = std::make_unique<SwBloomUpSamplePipeline>();
+}
 
-                // fragment shader
-                colorBuffer.m_buffer[index] = Vector4f(pipeline->ProcessFragment(output), 1.0f);
-            }
-        }
-    }
+void SwCommandContext::SetPipeline(SwPipeline* p_pipeline) {
+    m_state.pipeline = p_pipeline;
+    m_state.computePipeline = nullptr;
+    m_state.rasterizer = &s_rasterizerFrontFace;
+    m_state.depthStencil = &s_depthStencilDefault;
+    m_state.blend = &s_blendStateDefault;
 }
 
-void SwGraphicsManager::DrawArrayInternal(std::vector<OutTriangle>& trigs) {
-    // remove invalid triangles
-    trigs.erase(remove_if(trigs.begin(),
-                          trigs.end(),
-                          [](OutTriangle& trig) { return trig.discarded; }),
-                trigs.end());
+void SwCommandContext::SetPipelineState(PipelineStateName p_name) {
+    SetPipelineStateImpl(p_name);
+}
 
-    SwRenderTarget* rt = m_state.rt;
-    const int width = rt->m_depthBuffer.m_width;
-    const int height = rt->m_depthBuffer.m_height;
+void SwCommandContext::SetPipelineStateImpl(PipelineStateName p_name) {
+    ERR_FAIL_INDEX(p_name, PSO_NAME_MAX);
+
+    // passes without a software pipeline draw nothing
+    const PipelineState& state = m_pipelineStates[p_name];
+    SetPipeline(state.pipeline.get());
+    m_state.computePipeline = state.computePipeline.get();
+    if (state.pipeline) {
+        m_state.rasterizer = state.rasterizer;
+        m_state.depthStencil = state.depthStencil;
+        m_state.blend = state.blend;
+    }
+}
 
-    const int col = TileNumber(TILE_SIZE, width);
-    const int row = TileNumber(TILE_SIZE, height);
+void SwCommandContext::setRenderTarget(SwRenderTarget* renderTarget) {
+    m_state.rt = renderTarget;
+    m_state.colorCount = 0;
+    m_state.depth = nullptr;
+    if (renderTarget->m_useColor) {
+        m_state.colors[m_state.colorCount++] = &renderTarget->m_colorBuffer;
+    }
+    if (renderTarget->m_useDepth) {
+        m_state.depth = &renderTarget->m_depthBuffer;
+    }
+}
 
-    jobsystem::Context ctx;
-    ctx.Dispatch(row, 1, [&](jobsystem::JobArgs) {
-        for (int c = 0; c < col; ++c) {
-            for (OutTriangle& triangle : trigs) {
-                ProcessFragment(triangle);
-            }
-        }
-    });
+void SwCommandContext::SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) {
+    unused(p_mip_level);
 
-    ctx.Wait();
-}
+    m_state.rt = nullptr;
+    m_state.colorCount = 0;
+    m_state.depth = nullptr;
+    if (!p_framebuffer) {
+        return;
+    }
 
-void SwGraphicsManager::SetPipelineStateImpl(PipelineStateName p_name) {
-    unused(p_name);
+    const auto& desc = p_framebuffer->desc;
+    DEV_ASSERT(desc.colorAttachments.size() <= SW_MAX_COLOR_ATTACHMENTS);
+    for (const auto& attachment : desc.colorAttachments) {
+        auto texture = static_cast<SwGpuTexture*>(attachment.get());
+        const int face = glm::min(p_index, (int)texture->m_color.size() - 1);
+        m_state.colors[m_state.colorCount++] = &texture->m_color[face];
+    }
+    if (desc.depthAttachment) {
+        auto texture = static_cast<SwGpuTexture*>(desc.depthAttachment.get());
+        const int face = glm::min(p_index, (int)texture->m_depth.size() - 1);
+        m_state.depth = &texture->m_depth[face];
+    }
 }
 
-void SwGraphicsManager::Clear(const Framebuffer* p_framebuffer,
+void SwCommandContext::Clear(const Framebuffer* p_framebuffer,
                               ClearFlags p_flags,
                               const float* p_clear_color,
                               float p_clear_depth,
-                              uint8_t,
-                              int) {
-    unused(p_framebuffer);
+                              uint8_t p_clear_stencil,
+                              int p_index) {
+    unused(p_clear_stencil);
+
+    const Vector4f clear_color = p_clear_color ? Vector4f(p_clear_color[0], p_clear_color[1], p_clear_color[2], p_clear_color[3])
+                                               : Vector4f::Zero;
+
+    // without a framebuffer, clear the targets set with setRenderTarget()
+    if (!p_framebuffer) {
+        if (p_flags & CLEAR_COLOR_BIT) {
+            for (uint32_t i = 0; i < m_state.colorCount; ++i) {
+                m_state.colors[i]->clear(clear_color);
+            }
+        }
+        if ((p_flags & CLEAR_DEPTH_BIT) && m_state.depth) {
+            m_state.depth->clear(p_clear_depth);
+        }
+        return;
+    }
 
-    if (p_flags & ClearFlags::CLEAR_COLOR_BIT) {
-        auto clear_color = reinterpret_cast<const Vector4f*>(p_clear_color);
-        m_state.rt->m_colorBuffer.clear(*clear_color);
+    const auto& desc = p_framebuffer->desc;
+    if (p_flags & CLEAR_COLOR_BIT) {
+        for (const auto& attachment : desc.colorAttachments) {
+            auto texture = static_cast<SwGpuTexture*>(attachment.get());
+            for (int face = 0; face < (int)texture->m_color.size(); ++face) {
+                texture->Clear(clear_color, face);
+            }
+        }
     }
-    if (p_flags & ClearFlags::CLEAR_DEPTH_BIT) {
-        m_state.rt->m_depthBuffer.clear(p_clear_depth);
+    if ((p_flags & CLEAR_DEPTH_BIT) && desc.depthAttachment) {
+        static_cast<SwGpuTexture*>(desc.depthAttachment.get())->ClearDepth(p_clear_depth, p_index);
     }
 }
 
-void SwGraphicsManager::DrawElements(uint32_t p_count, uint32_t p_offset) {
-    DEV_ASSERT(p_count % 3 == 0);
-    DEV_ASSERT(p_offset % 3 == 0);
+auto SwGraphicsManager::CreateConstantBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuConstantBuffer>> {
+    auto buffer = std::make_shared<SwConstantBuffer>(p_desc);
+    if (p_desc.initial_data) {
+        memcpy(buffer->m_data.data(), p_desc.initial_data, buffer->m_data.size());
+    }
+    return buffer;
+}
 
-    const int triangle_count = static_cast<int>(p_count) / 3;
-    std::vector<OutTriangle> triangles(triangle_count);
+void SwCommandContext::UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
+    UpdateConstantBufferRange(p_buffer, p_data, p_size, 0);
+}
 
-    jobsystem::Context ctx;
-    ctx.Dispatch(triangle_count, 8, [&](jobsystem::JobArgs args) {
-        const uint32_t idx = args.jobIndex;
-        const VSInput* vertices = m_state.vertices;
-        const uint32_t* indices = m_state.indices;
-        const VSInput& p0 = vertices[indices[idx * 3 + 0]];
-        const VSInput& p1 = vertices[indices[idx * 3 + 1]];
-        const VSInput& p2 = vertices[indices[idx * 3 + 2]];
-        triangles[idx] = ProcessTriangle(p0, p1, p2);
-    });
-    ctx.Wait();
+void SwCommandContext::UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) {
+    auto buffer = static_cast<const SwConstantBuffer*>(p_buffer);
+    ERR_FAIL_COND_MSG(p_offset + p_size > buffer->m_data.size(), "constant buffer update out of range");
+    memcpy(buffer->m_data.data() + p_offset, p_data, p_size);
+}
 
-    DrawArrayInternal(triangles);
+void SwCommandContext::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
+    auto buffer = static_cast<const SwConstantBuffer*>(p_buffer);
+    ERR_FAIL_INDEX(buffer->GetSlot(), SW_MAX_CONSTANT_BUFFERS);
+    ERR_FAIL_COND_MSG(p_offset + p_size > buffer->m_data.size(), "constant buffer range out of range");
+    m_state.bindings.constantBuffers[buffer->GetSlot()] = buffer->m_data.data() + p_offset;
 }
 
-void SwGraphicsManager::DrawArrays(uint32_t p_count, uint32_t p_offsest) {
-    DEV_ASSERT(p_count % 3 == 0);
-    DEV_ASSERT(p_offsest % 3 == 0);
+void SwCommandContext::BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) {
+    unused(p_dimension);
+    ERR_FAIL_INDEX(p_slot, SW_MAX_TEXTURES);
+    m_state.bindings.textures[p_slot] = SwGpuTexture::FromHandle(p_handle);
+}
 
-    const int triangle_count = static_cast<int>(p_count) / 3;
-    std::vector<OutTriangle> triangles(triangle_count);
+void SwCommandContext::UnbindTexture(Dimension p_dimension, int p_slot) {
+    unused(p_dimension);
+    ERR_FAIL_INDEX(p_slot, SW_MAX_TEXTURES);
+    m_state.bindings.textures[p_slot] = nullptr;
+}
 
-    jobsystem::Context ctx;
-    ctx.Dispatch(triangle_count, 8, [&](jobsystem::JobArgs args) {
-        const uint32_t idx = args.jobIndex;
-        const VSInput* vertices = m_state.vertices;
-        const VSInput& p0 = vertices[idx * 3 + 0];
-        const VSInput& p1 = vertices[idx * 3 + 1];
-        const VSInput& p2 = vertices[idx * 3 + 2];
-        triangles[idx] = ProcessTriangle(p0, p1, p2);
-    });
-    ctx.Wait();
+void SwCommandContext::BindUnorderedAccessView(uint32_t p_slot, GpuTexture* p_texture) {
+    ERR_FAIL_INDEX(p_slot, (uint32_t)SW_MAX_UAVS);
+    m_state.bindings.uavs[p_slot] = static_cast<SwGpuTexture*>(p_texture);
+}
+
+void SwCommandContext::UnbindUnorderedAccessView(uint32_t p_slot) {
+    ERR_FAIL_INDEX(p_slot, (uint32_t)SW_MAX_UAVS);
+    m_state.bindings.uavs[p_slot] = nullptr;
+}
+
+std::shared_ptr<Framebuffer> SwGraphicsManager::CreateFramebuffer(const FramebufferDesc& p_desc) {
+    return std::make_shared<Framebuffer>(p_desc);
+}
+
+std::shared_ptr<GpuTexture> SwGraphicsManager::CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) {
+    // textures are sampled with the sampler of the shader
+    unused(p_sampler_desc);
 
-    DrawArrayInternal(triangles);
+    auto texture = std::make_shared<SwGpuTexture>(p_texture_desc);
+    if (p_texture_desc.type != AttachmentType::NONE) {
+        m_resourceLookup[texture->desc.name] = texture;
+    }
+    return texture;
+}
+
+std::shared_ptr<GpuTexture> SwGraphicsManager::CreateTexture(ImageAsset* p_image) {
+    DEV_ASSERT(p_image);
+
+    GpuTextureDesc texture_desc{};
+    SamplerDesc sampler_desc{};
+    FillTextureAndSamplerDesc(p_image, texture_desc, sampler_desc);
+    p_image->gpu_texture = CreateTexture(texture_desc, sampler_desc);
+    return p_image->gpu_texture;
+}
+
+std::shared_ptr<GpuTexture> SwGraphicsManager::FindTexture(std::string_view p_name) const {
+    auto it = m_resourceLookup.find(p_name);
+    if (it == m_resourceLookup.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void SwGraphicsManager::RequestTexture(std::shared_ptr<ImageAsset> p_image) {
+    m_assetUploader.RequestTexture(std::move(p_image));
+}
+
+void SwGraphicsManager::RequestMesh(std::shared_ptr<MeshAsset> p_mesh) {
+    m_assetUploader.RequestMesh(std::move(p_mesh));
+}
+
+uint64_t SwGraphicsManager::GetFinalImage() const {
+    if (auto texture = FindTexture(RG_RES_POST_PROCESS); texture) {
+        return texture->GetHandle();
+    }
+    return 0;
 }
 
 auto SwGraphicsManager::CreateMesh(const MeshAsset& p_mesh) -> Result<std::shared_ptr<GpuMesh>> {
     GpuMeshDesc desc;
     desc.drawCount = static_cast<uint32_t>(p_mesh.indices.size());
     auto mesh = std::make_shared<SwMesh>(desc);
-    unused(p_mesh);
     mesh->indices = p_mesh.indices;
+    // LOD levels follow the full mesh, as in the gpu index buffers
+    mesh->indices.insert(mesh->indices.end(), p_mesh.lod_indices.begin(), p_mesh.lod_indices.end());
     mesh->vertices.resize(p_mesh.positions.size());
 
+    const bool has_normals = p_mesh.normals.size() == p_mesh.positions.size();
+    const bool has_uvs = p_mesh.texcoords_0.size() == p_mesh.positions.size();
     for (size_t i = 0; i < mesh->vertices.size(); ++i) {
         mesh->vertices[i].position = Vector4f(p_mesh.positions[i], 1.0f);
-        mesh->vertices[i].normal = Vector4f(p_mesh.normals[i], 0.0f);
-        mesh->vertices[i].uv = p_mesh.texcoords_0[i];
+        mesh->vertices[i].normal = has_normals ? Vector4f(p_mesh.normals[i], 0.0f) : Vector4f::Zero;
+        mesh->vertices[i].uv = has_uvs ? p_mesh.texcoords_0[i] : Vector2f::Zero;
     }
 
     return mesh;
 }
 
-void SwGraphicsManager::SetMesh(const GpuMesh* p_mesh) {
+void SwCommandContext::SetMesh(const GpuMesh* p_mesh) {
+    // no mesh is the screen quad, drawn with DrawArrays(6)
+    if (!p_mesh) {
+        static const VSInput s_quad[6] = {
+            { Vector4f(-1.0f, +1.0f, 0.0f, 1.0f), Vector4f::Zero, Vector2f(0.0f, 0.0f) },
+            { Vector4f(+1.0f, -1.0f, 0.0f, 1.0f), Vector4f::Zero, Vector2f(1.0f, 1.0f) },
+            { Vector4f(+1.0f, +1.0f, 0.0f, 1.0f), Vector4f::Zero, Vector2f(1.0f, 0.0f) },
+            { Vector4f(-1.0f, +1.0f, 0.0f, 1.0f), Vector4f::Zero, Vector2f(0.0f, 0.0f) },
+            { Vector4f(-1.0f, -1.0f, 0.0f, 1.0f), Vector4f::Zero, Vector2f(0.0f, 1.0f) },
+            { Vector4f(+1.0f, -1.0f, 0.0f, 1.0f), Vector4f::Zero, Vector2f(1.0f, 1.0f) },
+        };
+        m_state.vertices = s_quad;
+        m_state.indices = nullptr;
+        return;
+    }
+
     const SwMesh* mesh = static_cast<const SwMesh*>(p_mesh);
     m_state.vertices = mesh->vertices.data();
     m_state.indices = mesh->indices.data();
 }
 
+void SwCommandContext::DrawElements(uint32_t p_count, uint32_t p_offset) {
+    Draw(1, p_count, p_offset, true);
+}
+
+void SwCommandContext::DrawElementsInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset) {
+    Draw(p_instance_count, p_count, p_offset, true);
+}
+
+void SwCommandContext::DrawArrays(uint32_t p_count, uint32_t p_offset) {
+    Draw(1, p_count, p_offset, false);
+}
+
+void SwCommandContext::Draw(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset, bool p_indexed) {
+    DEV_ASSERT(p_count % 3 == 0);
+
+    SwPipeline* pipeline = m_state.pipeline;
+    if (!pipeline || !m_state.vertices || (p_indexed && !m_state.indices)) {
+        return;
+    }
+
+    // all the bound targets have the same size
+    if (m_state.colorCount > 0) {
+        m_state.width = m_state.colors[0]->m_width;
+        m_state.height = m_state.colors[0]->m_height;
+    } else if (m_state.depth) {
+        m_state.width = m_state.depth->m_width;
+        m_state.height = m_state.depth->m_height;
+    } else {
+        return;
+    }
+
+    const uint32_t triangle_count = p_count / 3;
+    for (uint32_t instance = 0; instance < p_instance_count; ++instance) {
+        pipeline->BeginDraw(m_state.bindings, instance);
+
+        // a clipped triangle can become two, every slot is written by ProcessTriangle()
+        const uint32_t slot_count = 2 * triangle_count;
+        m_frameSlotCount = std::max(m_frameSlotCount, slot_count);
+        if (m_triangles.size() < slot_count) {
+            m_triangles.resize(slot_count);
+        }
+        OutTriangle* triangles = m_triangles.data();
+        ParallelFor(triangle_count, 64, [&](uint32_t p_index) {
+            const VSInput* vertices = m_state.vertices;
+            uint32_t i0 = p_offset + 3 * p_index;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + 2;
+            if (p_indexed) {
+                i0 = m_state.indices[i0];
+                i1 = m_state.indices[i1];
+                i2 = m_state.indices[i2];
+            }
+            ProcessTriangle(vertices[i0], vertices[i1], vertices[i2], &triangles[2 * p_index]);
+        });
+
+        DrawArrayInternal(triangles, slot_count);
+    }
+}
+
+void SwCommandContext::Dispatch(uint32_t p_num_groups_x, uint32_t p_num_groups_y, uint32_t p_num_groups_z) {
+    SwComputePipeline* pipeline = m_state.computePipeline;
+    if (!pipeline) {
+        return;
+    }
+
+    pipeline->BeginDispatch(m_state.bindings);
+
+    const Vector3i& local_size = pipeline->GetLocalSize();
+    const uint32_t group_count = p_num_groups_x * p_num_groups_y * p_num_groups_z;
+    ParallelFor(group_count, 1, [&](uint32_t p_group) {
+        const int group_x = p_group % p_num_groups_x;
+        const int group_y = (p_group / p_num_groups_x) % p_num_groups_y;
+        const int group_z = p_group / (p_num_groups_x * p_num_groups_y);
+        for (int z = 0; z < local_size.z; ++z) {
+            for (int y = 0; y < local_size.y; ++y) {
+                for (int x = 0; x < local_size.x; ++x) {
+                    pipeline->ProcessThread(Vector3i(group_x * local_size.x + x,
+                                                     group_y * local_size.y + y,
+                                                     group_z * local_size.z + z));
+                }
+            }
+        }
+    });
+}
+
+static VSOutput LerpVertex(const VSOutput& p_a, const VSOutput& p_b, float p_t) {
+    VSOutput out;
+    out.position = lerp(p_a.position, p_b.position, p_t);
+    out.world_position = lerp(p_a.world_position, p_b.world_position, p_t);
+    out.normal = lerp(p_a.normal, p_b.normal, p_t);
+    out.color = lerp(p_a.color, p_b.color, p_t);
+    out.uv = lerp(p_a.uv, p_b.uv, p_t);
+    return out;
+}
+
+// Sutherland-Hodgman against w = CLIP_W, returns the vertex count of the convex polygon, 0, 3 or 4
+static int ClipTriangle(const VSOutput* p_in, VSOutput* p_out) {
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        const VSOutput& a = p_in[i];
+        const VSOutput& b = p_in[(i + 1) % 3];
+        const bool a_inside = a.position.w >= CLIP_W;
+        const bool b_inside = b.position.w >= CLIP_W;
+        if (a_inside) {
+            p_out[count++] = a;
+        }
+        if (a_inside != b_inside) {
+            const float t = (CLIP_W - a.position.w) / (b.position.w - a.position.w);
+            p_out[count++] = LerpVertex(a, b, t);
+        }
+    }
+    return count;
+}
+
+// to pixels, y points down and row 0 is the top of the target. w keeps 1 / w for perspective
+// correct interpolation
+static void ClipToScreen(Vector4f& p_position, float p_width, float p_height) {
+    const float inv_w = 1.0f / p_position.w;
+    p_position.x = (0.5f + 0.5f * p_position.x * inv_w) * p_width;
+    p_position.y = (0.5f - 0.5f * p_position.y * inv_w) * p_height;
+    p_position.z *= inv_w;
+    p_position.w = inv_w;
+}
+
+void SwCommandContext::ProcessTriangle(const VSInput& vs_in0,
+                                        const VSInput& vs_in1,
+                                        const VSInput& vs_in2,
+                                        OutTriangle* p_out) {
+    p_out[0].discarded = true;
+    p_out[1].discarded = true;
+
+    SwPipeline* pipeline = m_state.pipeline;
+    const VSOutput vs_out[3] = {
+        pipeline->ProcessVertex(vs_in0),
+        pipeline->ProcessVertex(vs_in1),
+        pipeline->ProcessVertex(vs_in2),
+    };
+
+    VSOutput polygon[4];
+    const int count = ClipTriangle(vs_out, polygon);
+    if (count < 3) {
+        return;
+    }
+
+    float area = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        ClipToScreen(polygon[i].position, (float)m_state.width, (float)m_state.height);
+    }
+    for (int i = 0; i < count; ++i) {
+        const Vector4f& a = polygon[i].position;
+        const Vector4f& b = polygon[(i + 1) % count].position;
+        area += a.x * b.y - b.x * a.y;
+    }
+    if (area == 0.0f) {
+        return;
+    }
+
+    // face culling, y points down so counter clockwise triangles have a negative area
+    const RasterizerDesc& rasterizer = *m_state.rasterizer;
+    const bool front_face = rasterizer.frontCounterClockwise ? area < 0.0f : area > 0.0f;
+    switch (rasterizer.cullMode) {
+        case CullMode::BACK:
+            if (!front_face) {
+                return;
+            }
+            break;
+        case CullMode::FRONT:
+            if (front_face) {
+                return;
+            }
+            break;
+        case CullMode::FRONT_AND_BACK:
+            return;
+        default:
+            break;
+    }
+
+    p_out[0] = OutTriangle{ polygon[0], polygon[1], polygon[2], false };
+    if (count == 4) {
+        p_out[1] = OutTriangle{ polygon[0], polygon[2], polygon[3], false };
+    }
+}
+
+static int TileNumber(int p_tile_size, int p_length) {
+    int rem = (p_length % p_tile_size) != 0;
+    return (p_length / p_tile_size) + rem;
+}
+
+static float EdgeFunction(const Vector4f& p_a, const Vector4f& p_b, float p_x, float p_y) {
+    return (p_b.x - p_a.x) * (p_y - p_a.y) - (p_b.y - p_a.y) * (p_x - p_a.x);
+}
+
+// top left fill rule, for edges of a triangle with a positive area
+static bool IsTopLeft(const Vector4f& p_from, const Vector4f& p_to) {
+    return (p_from.y == p_to.y && p_to.x > p_from.x) || p_to.y < p_from.y;
+}
+
+static bool DepthTest(ComparisonFunc p_func, float p_depth, float p_stored) {
+    switch (p_func) {
+        case ComparisonFunc::NEVER:
+            return false;
+        case ComparisonFunc::LESS:
+            return p_depth < p_stored;
+        case ComparisonFunc::EQUAL:
+            return p_depth == p_stored;
+        case ComparisonFunc::LESS_EQUAL:
+            return p_depth <= p_stored;
+        case ComparisonFunc::GREATER:
+            return p_depth > p_stored;
+        case ComparisonFunc::NOT_EQUAL:
+            return p_depth != p_stored;
+        case ComparisonFunc::GREATER_EQUAL:
+            return p_depth >= p_stored;
+        default:
+            return true;
+    }
+}
+
+static Vector4f BlendFactor(Blend p_blend, const Vector4f& p_src) {
+    switch (p_blend) {
+        case Blend::BLEND_ZERO:
+            return Vector4f::Zero;
+        case Blend::BLEND_SRC_ALPHA:
+            return Vector4f(p_src.a);
+        case Blend::BLEND_INV_SRC_ALPHA:
+            return Vector4f(1.0f - p_src.a);
+        default:
+            return Vector4f(1.0f);
+    }
+}
+
+static void WriteColor(const RenderTargetBlendDesc& p_desc, const Vector4f& p_src, Vector4f& p_dest) {
+    Vector4f color = p_src;
+    if (p_desc.blendEnabled) {
+        const Vector4f src = p_src * BlendFactor(p_desc.blendSrc, p_src);
+        const Vector4f dest = p_dest * BlendFactor(p_desc.blendDest, p_src);
+        color = p_desc.blendOp == BlendOp::BLEND_OP_SUB ? src - dest : src + dest;
+    }
+
+    const ColorWriteEnable mask = p_desc.colorWriteMask;
+    if (mask == COLOR_WRITE_ENABLE_ALL) {
+        p_dest = color;
+        return;
+    }
+    if (mask & COLOR_WRITE_ENABLE_RED) {
+        p_dest.r = color.r;
+    }
+    if (mask & COLOR_WRITE_ENABLE_GREEN) {
+        p_dest.g = color.g;
+    }
+    if (mask & COLOR_WRITE_ENABLE_BLUE) {
+        p_dest.b = color.b;
+    }
+    if (mask & COLOR_WRITE_ENABLE_ALPHA) {
+        p_dest.a = color.a;
+    }
+}
+
+void SwCommandContext::ProcessFragment(const OutTriangle& vs_out, int p_min_x, int p_min_y, int p_max_x, int p_max_y) {
+    SwPipeline* pipeline = m_state.pipeline;
+    const int width = m_state.width;
+
+    const VSOutput* vs_out0 = &vs_out.p0;
+    const VSOutput* vs_out1 = &vs_out.p1;
+    const VSOutput* vs_out2 = &vs_out.p2;
+    float area = EdgeFunction(vs_out0->position, vs_out1->position, vs_out2->position.x, vs_out2->position.y);
+    if (area == 0.0f) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(vs_out1, vs_out2);
+        area = -area;
+    }
+
+    const Vector4f& a = vs_out0->position;
+    const Vector4f& b = vs_out1->position;
+    const Vector4f& c = vs_out2->position;
+
+    const int min_x = glm::max(p_min_x, (int)std::floor(glm::min(a.x, glm::min(b.x, c.x))));
+    const int max_x = glm::min(p_max_x, (int)std::ceil(glm::max(a.x, glm::max(b.x, c.x))));
+    const int min_y = glm::max(p_min_y, (int)std::floor(glm::min(a.y, glm::min(b.y, c.y))));
+    const int max_y = glm::min(p_max_y, (int)std::ceil(glm::max(a.y, glm::max(b.y, c.y))));
+    if (min_x >= max_x || min_y >= max_y) {
+        return;
+    }
+
+    const bool top_left0 = IsTopLeft(b, c);
+    const bool top_left1 = IsTopLeft(c, a);
+    const bool top_left2 = IsTopLeft(a, b);
+    const float inv_area = 1.0f / area;
+
+    const DepthStencilDesc& depth_stencil = *m_state.depthStencil;
+    const bool depth_test = m_state.depth && depth_stencil.depthEnabled;
+    const BlendDesc& blend = *m_state.blend;
+    const uint32_t varying_flags = pipeline->GetVaryingFlags();
+
+    for (int y = min_y; y < max_y; ++y) {
+        const float py = y + 0.5f;
+        for (int x = min_x; x < max_x; ++x) {
+            const float px = x + 0.5f;
+            const float w0 = EdgeFunction(b, c, px, py);
+            const float w1 = EdgeFunction(c, a, px, py);
+            const float w2 = EdgeFunction(a, b, px, py);
+            if ((w0 < 0.0f || (w0 == 0.0f && !top_left0)) ||
+                (w1 < 0.0f || (w1 == 0.0f && !top_left1)) ||
+                (w2 < 0.0f || (w2 == 0.0f && !top_left2))) {
+                continue;
+            }
+
+            const float l0 = w0 * inv_area;
+            const float l1 = w1 * inv_area;
+            const float l2 = w2 * inv_area;
+
+            // depth is linear in screen space
+            const float depth = l0 * a.z + l1 * b.z + l2 * c.z;
+            if (depth < 0.0f || depth > 1.0f) {
+                continue;
+            }
+
+            const int index = y * width + x;
+            if (depth_test && !DepthTest(depth_stencil.depthFunc, depth, m_state.depth->m_buffer[index])) {
+                continue;
+            }
+
+            // perspective correct barycentric coordinates
+            float p0 = l0 * a.w;
+            float p1 = l1 * b.w;
+            float p2 = l2 * c.w;
+            const float inv_w = p0 + p1 + p2;
+            p0 /= inv_w;
+            p1 /= inv_w;
+            p2 /= inv_w;
+
+            VSOutput input;
+            input.position = Vector4f(px, py, depth, inv_w);
+            if (varying_flags & VARYING_NORMAL) {
+                input.normal = p0 * vs_out0->normal + p1 * vs_out1->normal + p2 * vs_out2->normal;
+            }
+            if (varying_flags & VARYING_COLOR) {
+                input.color = p0 * vs_out0->color + p1 * vs_out1->color + p2 * vs_out2->color;
+            }
+            if (varying_flags & VARYING_UV) {
+                input.uv = p0 * vs_out0->uv + p1 * vs_out1->uv + p2 * vs_out2->uv;
+            }
+            if (varying_flags & VARYING_WORLD_POSITION) {
+                input.world_position = p0 * vs_out0->world_position + p1 * vs_out1->world_position + p2 * vs_out2->world_position;
+            }
+
+            PSOutput output;
+            if (!pipeline->ProcessFragment(input, output)) {
+                continue;
+            }
+
+            if (depth_test) {
+                m_state.depth->m_buffer[index] = depth;
+            }
+            for (uint32_t i = 0; i < m_state.colorCount; ++i) {
+                const RenderTargetBlendDesc& desc = blend.independentBlendEnable ? blend.renderTargets[i] : blend.renderTargets[0];
+                WriteColor(desc, output.color[i], m_state.colors[i]->m_buffer[index]);
+            }
+        }
+    }
+}
+
+void SwCommandContext::DrawArrayInternal(const OutTriangle* trigs, uint32_t p_count) {
+    const int width = m_state.width;
+    const int height = m_state.height;
+    const int tile_x_count = TileNumber(TILE_SIZE, width);
+    const int tile_y_count = TileNumber(TILE_SIZE, height);
+    const uint32_t tile_count = tile_x_count * tile_y_count;
+
+    // tiles overlapped by the screen bounds of each triangle, none for the discarded ones
+    m_triangleTiles.resize(p_count);
+    ParallelFor(p_count, 256, [&](uint32_t p_index) {
+        const OutTriangle& triangle = trigs[p_index];
+        Vector4i& tiles = m_triangleTiles[p_index];
+        tiles = Vector4i::Zero;
+        if (triangle.discarded) {
+            return;
+        }
+
+        const Vector4f& a = triangle.p0.position;
+        const Vector4f& b = triangle.p1.position;
+        const Vector4f& c = triangle.p2.position;
+        const int min_x = glm::max(0, (int)std::floor(glm::min(a.x, glm::min(b.x, c.x))));
+        const int max_x = glm::min(width, (int)std::ceil(glm::max(a.x, glm::max(b.x, c.x))));
+        const int min_y = glm::max(0, (int)std::floor(glm::min(a.y, glm::min(b.y, c.y))));
+        const int max_y = glm::min(height, (int)std::ceil(glm::max(a.y, glm::max(b.y, c.y))));
+        if (min_x >= max_x || min_y >= max_y) {
+            return;
+        }
+
+        tiles = Vector4i(min_x / TILE_SIZE,
+                         min_y / TILE_SIZE,
+                         (max_x - 1) / TILE_SIZE + 1,
+                         (max_y - 1) / TILE_SIZE + 1);
+    });
+
+    // count the triangles of every tile, then fill the bins in submission order
+    m_binOffsets.assign(tile_count + 1, 0);
+    for (const Vector4i& tiles : m_triangleTiles) {
+        for (int y = tiles.y; y < tiles.w; ++y) {
+            for (int x = tiles.x; x < tiles.z; ++x) {
+                ++m_binOffsets[y * tile_x_count + x + 1];
+            }
+        }
+    }
+    for (uint32_t tile = 0; tile < tile_count; ++tile) {
+        m_binOffsets[tile + 1] += m_binOffsets[tile];
+    }
+    if (m_binOffsets[tile_count] == 0) {
+        return;
+    }
+
+    m_binTriangles.resize(m_binOffsets[tile_count]);
+    m_binCursors.assign(m_binOffsets.begin(), m_binOffsets.end() - 1);
+    for (uint32_t index = 0; index < p_count; ++index) {
+        const Vector4i& tiles = m_triangleTiles[index];
+        for (int y = tiles.y; y < tiles.w; ++y) {
+            for (int x = tiles.x; x < tiles.z; ++x) {
+                m_binTriangles[m_binCursors[y * tile_x_count + x]++] = index;
+            }
+        }
+    }
+
+    // one job per tile, so a pixel is only written by one job and the triangles touching it
+    // are shaded in submission order
+    ParallelFor(tile_count, 1, [&](uint32_t p_tile) {
+        const uint32_t begin = m_binOffsets[p_tile];
+        const uint32_t end = m_binOffsets[p_tile + 1];
+        if (begin == end) {
+            return;
+        }
+
+        const int min_x = (p_tile % tile_x_count) * TILE_SIZE;
+        const int min_y = (p_tile / tile_x_count) * TILE_SIZE;
+        const int max_x = glm::min(width, min_x + TILE_SIZE);
+        const int max_y = glm::min(height, min_y + TILE_SIZE);
+        for (uint32_t i = begin; i < end; ++i) {
+            ProcessFragment(trigs[m_binTriangles[i]], min_x, min_y, max_x, max_y);
+        }
+    });
+}
+
 }  // namespace cave
@@ -1,12 +1,25 @@
 #pragma once
-#include "engine/renderer/gpu_resource.h"
 #include "engine/empty/empty_graphics_manager.h"
+#include "engine/renderer/asset_uploader.h"
+#include "engine/renderer/gpu_resource.h"
+#include "engine/renderer/pipeline_state.h"
 
 // @TODO: refactor
 #include "render_target.h"
+#include "sw_resources.h"
 
 namespace cave {
 
+// slots of the software backend, enough for the passes of the 3D render graph
+inline constexpr int SW_MAX_COLOR_ATTACHMENTS = 4;
+inline constexpr int SW_MAX_CONSTANT_BUFFERS = 8;
+inline constexpr int SW_MAX_TEXTURES = 64;
+inline constexpr int SW_MAX_UAVS = 8;
+// triangle slots the draw buffers keep across frames, a frame that needed more frees the rest
+inline constexpr uint32_t SW_RETAINED_TRIANGLE_SLOTS = 64 * 1024;
+// contexts the passes of a render graph level are recorded on concurrently
+inline constexpr int SW_RECORDING_CONTEXT_COUNT = 4;
+
 enum VaryingFlag : uint8_t {
     VARYING_COLOR = 1u << 0,
     VARYING_NORMAL = 1u << 1,
@@ -28,18 +41,66 @@ struct alignas(16) VSOutput {
     Vector2f uv;
 };
 
+struct PSOutput {
+    Vector4f color[SW_MAX_COLOR_ATTACHMENTS];
+};
+
+// what is bound when a draw or a dispatch is issued, constant buffers point to the bound range
+struct SwBindings {
+    const uint8_t* constantBuffers[SW_MAX_CONSTANT_BUFFERS]{};
+    const SwGpuTexture* textures[SW_MAX_TEXTURES]{};
+    SwGpuTexture* uavs[SW_MAX_UAVS]{};
+
+    template<typename T>
+    const T* Get() const {
+        return reinterpret_cast<const T*>(constantBuffers[T::GetUniformBufferSlot()]);
+    }
+};
+
 class SwPipeline {
 public:
     SwPipeline(uint8_t varyingFlags)
         : m_varying_flags(varyingFlags) {}
 
+    virtual ~SwPipeline() = default;
+
+    // called before the vertices of a draw, once per instance
+    virtual void BeginDraw(const SwBindings& p_bindings, uint32_t p_instance) {
+        unused(p_instance);
+        m_bindings = &p_bindings;
+    }
+
     virtual VSOutput ProcessVertex(const VSInput& input) = 0;
 
-    virtual Vector3f ProcessFragment(const VSOutput& input) = 0;
+    // returns false if the fragment is discarded
+    virtual bool ProcessFragment(const VSOutput& input, PSOutput& output) = 0;
 
     uint8_t GetVaryingFlags() const { return m_varying_flags; }
 
     const uint8_t m_varying_flags;
+
+protected:
+    const SwBindings* m_bindings = nullptr;
+};
+
+// compute shaders run as CPU kernels, one call per thread of the dispatch
+class SwComputePipeline {
+public:
+    SwComputePipeline(const Vector3i& p_local_size)
+        : m_localSize(p_local_size) {}
+
+    virtual ~SwComputePipeline() = default;
+
+    virtual void BeginDispatch(const SwBindings& p_bindings) { m_bindings = &p_bindings; }
+
+    // p_id is the dispatch thread id
+    virtual void ProcessThread(const Vector3i& p_id) = 0;
+
+    const Vector3i& GetLocalSize() const { return m_localSize; }
+
+protected:
+    const Vector3i m_localSize;
+    const SwBindings* m_bindings = nullptr;
 };
 
 struct SwMesh : GpuMesh {
@@ -54,10 +115,21 @@ struct OutTriangle {
     int discarded = false;
 };
 
-class SwGraphicsManager : public EmptyGraphicsManager {
+class SwGraphicsManager;
+
+// What the passes bind and draw with. The binding state, the pipelines and the draw buffers belong
+// to the context, so the render graph can record independent passes on several contexts at once.
+// Resources belong to the graphics manager, which records on a context of its own.
+class SwCommandContext : public EmptyGraphicsManager {
 public:
-    SwGraphicsManager()
-        : EmptyGraphicsManager("SwGraphicsManager") {}
+    SwCommandContext(SwGraphicsManager& p_device, std::string_view p_name = "SwCommandContext");
+    ~SwCommandContext() override;
+
+    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) override;
+    void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) override;
+    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override;
+
+    void SetRenderTarget(const Framebuffer* p_framebuffer, int p_index = 0, int p_mip_level = 0) override;
 
     void Clear(const Framebuffer* p_framebuffer,
                ClearFlags p_flags,
@@ -66,44 +138,157 @@ public:
                uint8_t p_clear_stencil = 0,
                int p_index = 0) override;
 
+    void SetPipelineState(PipelineStateName p_name) override;
     void SetPipelineStateImpl(PipelineStateName p_name) override;
 
     void DrawElements(uint32_t p_count, uint32_t p_offset = 0) override;
+    void DrawElementsInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset = 0) override;
 
     void DrawArrays(uint32_t p_count, uint32_t p_offset = 0) override;
 
-    auto CreateMesh(const MeshAsset& p_mesh) -> Result<std::shared_ptr<GpuMesh>> override;
+    void Dispatch(uint32_t p_num_groups_x, uint32_t p_num_groups_y, uint32_t p_num_groups_z) override;
+    void BindUnorderedAccessView(uint32_t p_slot, GpuTexture* p_texture) override;
+    void UnbindUnorderedAccessView(uint32_t p_slot) override;
 
     void SetMesh(const GpuMesh* p_mesh) override;
 
+    std::shared_ptr<GpuTexture> FindTexture(std::string_view p_name) const override;
+    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) override;
+    void UnbindTexture(Dimension p_dimension, int p_slot) override;
+
+    Backend GetBackend() const override { return Backend::SOFTWARE; }
+
+    FrameContext& GetCurrentFrame() override;
+
     //---------------------------------
     // @TODO: refactor
     struct RenderState {
         SwPipeline* pipeline = nullptr;
+        SwComputePipeline* computePipeline = nullptr;
+        // fixed function state of the pipeline state object, pipelines set with SetPipeline()
+        // use the default states
+        const RasterizerDesc* rasterizer = nullptr;
+        const DepthStencilDesc* depthStencil = nullptr;
+        const BlendDesc* blend = nullptr;
+
         SwRenderTarget* rt = nullptr;
+        SwTexture<Vector4f>* colors[SW_MAX_COLOR_ATTACHMENTS]{};
+        uint32_t colorCount = 0;
+        SwTexture<float>* depth = nullptr;
+        // size of the bound targets, set when a draw starts
+        int width = 0;
+        int height = 0;
 
         const VSInput* vertices = nullptr;
         const uint32_t* indices = nullptr;
+
+        SwBindings bindings;
     };
 
     RenderState m_state;
 
-    void SetPipeline(SwPipeline* p_pipeline) { m_state.pipeline = p_pipeline; }
-    void setRenderTarget(SwRenderTarget* renderTarget) { m_state.rt = renderTarget; }
+    void SetPipeline(SwPipeline* p_pipeline);
+    void setRenderTarget(SwRenderTarget* renderTarget);
 
     void setSize(int width, int height) {
         DEV_ASSERT(width > 0 && height > 0);
         m_state.rt->resize(width, height);
     }
 
+    // a context recording a pass of the render graph starts with the bindings of p_context
+    void InheritBindings(const SwCommandContext& p_context);
+
+    void TrimDrawBuffers();
+
+protected:
+    SwGraphicsManager& m_device;
+
+private:
+    struct PipelineState {
+        std::unique_ptr<SwPipeline> pipeline;
+        std::unique_ptr<SwComputePipeline> computePipeline;
+        const RasterizerDesc* rasterizer = nullptr;
+        const DepthStencilDesc* depthStencil = nullptr;
+        const BlendDesc* blend = nullptr;
+    };
+
+    void CreatePipelineStates();
+
+    void Draw(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset, bool p_indexed);
+
+    // rasterizes the part of the triangle inside [p_min_x, p_max_x) x [p_min_y, p_max_y)
+    void ProcessFragment(const OutTriangle& vs_out, int p_min_x, int p_min_y, int p_max_x, int p_max_y);
+
+    void DrawArrayInternal(const OutTriangle* trigs, uint32_t p_count);
+
+    // writes the clipped triangles to p_out[0] and p_out[1]
+    void ProcessTriangle(const VSInput& vs_in0,
+                         const VSInput& vs_in1,
+                         const VSInput& vs_in2,
+                         OutTriangle* p_out);
+
+    // pipelines keep the bindings of the draw, every context has its own
+    std::array<PipelineState, PSO_NAME_MAX> m_pipelineStates;
+
+    // clipped triangles of the current draw, two slots per input triangle
+    std::vector<OutTriangle> m_triangles;
+    // tile bins of the current draw, the triangles of tile i are
+    // m_binTriangles[m_binOffsets[i], m_binOffsets[i + 1]) in submission order.
+    // the buffers are kept across draws so large meshes do not allocate every frame
+    std::vector<Vector4i> m_triangleTiles;
+    std::vector<uint32_t> m_binOffsets;
+    std::vector<uint32_t> m_binCursors;
+    std::vector<uint32_t> m_binTriangles;
+    // most triangle slots a draw of the current frame used
+    uint32_t m_frameSlotCount{ 0 };
+};
+
+class SwGraphicsManager : public SwCommandContext {
+public:
+    SwGraphicsManager();
+    ~SwGraphicsManager() override;
+
+    auto InitializeImpl() -> Result<void> override;
+    void Update(Scene* p_scene) override;
+
+    void RenderFrame(const FrameData* p_framedata) override;
+    void PublishCreatedResources() override;
+
+    auto CreateConstantBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuConstantBuffer>> override;
+
+    auto CreateMesh(const MeshAsset& p_mesh) -> Result<std::shared_ptr<GpuMesh>> override;
+
+    std::shared_ptr<Framebuffer> CreateFramebuffer(const FramebufferDesc& p_desc) override;
+
+    std::shared_ptr<GpuTexture> CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) override;
+    std::shared_ptr<GpuTexture> CreateTexture(ImageAsset* p_image) override;
+    std::shared_ptr<GpuTexture> FindTexture(std::string_view p_name) const override;
+
+    void RequestTexture(std::shared_ptr<ImageAsset> p_image) override;
+    void RequestMesh(std::shared_ptr<MeshAsset> p_mesh) override;
+
+    uint64_t GetFinalImage() const override;
+
+    RenderGraphName GetActiveRenderGraphName() const override { return RenderGraphName::SCENE3D; }
+    RenderGraph* GetActiveRenderGraph() override { return m_renderGraph.get(); }
+
+    FrameContext& GetCurrentFrame() override { return m_frameContext; }
+
+    int GetRecordingContextCount() const override { return static_cast<int>(m_contexts.size()); }
+    IGraphicsManager& BeginRecording(int p_index) override;
+
+    // the graph the frames are rendered with, created by Initialize() when the application runs
+    // with the software backend, tools and tests can set their own
+    void SetRenderGraph(std::shared_ptr<RenderGraph> p_graph) { m_renderGraph = std::move(p_graph); }
+
 private:
-    void ProcessFragment(OutTriangle& vs_out);
+    // the passes of a render graph level record concurrently, one context per pass
+    std::vector<std::unique_ptr<SwCommandContext>> m_contexts;
 
-    void DrawArrayInternal(std::vector<OutTriangle>& trigs);
+    std::shared_ptr<RenderGraph> m_renderGraph;
+    std::unordered_map<std::string_view, std::shared_ptr<GpuTexture>> m_resourceLookup;
 
-    OutTriangle ProcessTriangle(const VSInput& vs_in0,
-                                const VSInput& vs_in1,
-                                const VSInput& vs_in2);
+    AssetUploader m_assetUploader;
 };
 
 }  // namespace cave
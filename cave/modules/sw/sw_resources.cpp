@@ -0,0 +1,181 @@
+#include "sw_resources.h"
+
+#include <glm/gtc/packing.hpp>
+
+namespace cave {
+
+static bool IsDepthFormat(PixelFormat p_format) {
+    switch (p_format) {
+        case PixelFormat::D32_FLOAT:
+        case PixelFormat::R24G8_TYPELESS:
+        case PixelFormat::D24_UNORM_S8_UINT:
+        case PixelFormat::R32G8X24_TYPELESS:
+        case PixelFormat::D32_FLOAT_S8X24_UINT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+SwGpuTexture::SwGpuTexture(const GpuTextureDesc& p_desc)
+    : GpuTexture(p_desc), m_isDepth(IsDepthFormat(p_desc.format)) {
+    DEV_ASSERT(desc.width > 0 && desc.height > 0);
+
+    const int width = GetWidth();
+    const int height = GetHeight();
+    // 3D textures keep their slices as faces
+    const uint32_t face_count = glm::max(glm::max(desc.arraySize, desc.depth), 1u);
+    if (m_isDepth) {
+        m_depth.resize(face_count);
+        for (auto& face : m_depth) {
+            face.resize(width, height);
+        }
+    } else {
+        m_color.resize(face_count);
+        for (auto& face : m_color) {
+            face.resize(width, height);
+        }
+    }
+
+    if (desc.initialData) {
+        Upload(desc.initialData);
+    }
+}
+
+void SwGpuTexture::Upload(const void* p_data) {
+    const PixelFormat format = desc.format;
+    ERR_FAIL_COND_MSG(m_isDepth, "initial data of depth textures is not supported");
+    switch (format) {
+        case PixelFormat::R8_UINT:
+        case PixelFormat::R8G8_UINT:
+        case PixelFormat::R8G8B8_UINT:
+        case PixelFormat::R8G8B8A8_UINT:
+        case PixelFormat::R8G8B8A8_UNORM:
+        case PixelFormat::R8G8B8A8_UNORM_SRGB:
+        case PixelFormat::R16_FLOAT:
+        case PixelFormat::R16G16_FLOAT:
+        case PixelFormat::R16G16B16_FLOAT:
+        case PixelFormat::R16G16B16A16_FLOAT:
+        case PixelFormat::R32_FLOAT:
+        case PixelFormat::R32G32_FLOAT:
+        case PixelFormat::R32G32B32_FLOAT:
+        case PixelFormat::R32G32B32A32_FLOAT:
+            break;
+        default:
+            LOG_WARN("initial data of texture '{}' ignored, format not supported", desc.name);
+            return;
+    }
+
+    const uint32_t channel_size = ChannelSize(format);
+    const uint32_t channel_count = ChannelCount(format);
+    const bool srgb = format == PixelFormat::R8G8B8A8_UNORM_SRGB;
+
+    auto read_channel = [&](const uint8_t* p_src) -> float {
+        switch (channel_size) {
+            case sizeof(uint8_t):
+                return *p_src / 255.0f;
+            case sizeof(uint16_t): {
+                uint16_t half;
+                memcpy(&half, p_src, sizeof(half));
+                return glm::unpackHalf1x16(half);
+            }
+            default: {
+                float value;
+                memcpy(&value, p_src, sizeof(value));
+                return value;
+            }
+        }
+    };
+
+    const uint8_t* src = static_cast<const uint8_t*>(p_data);
+    for (auto& face : m_color) {
+        for (Vector4f& texel : face.m_buffer) {
+            texel = Vector4f(0.0f, 0.0f, 0.0f, 1.0f);
+            for (uint32_t channel = 0; channel < channel_count; ++channel) {
+                const float value = read_channel(src);
+                // alpha stays linear
+                texel[channel] = (srgb && channel < 3) ? SrgbToLinear(value) : value;
+                src += channel_size;
+            }
+        }
+    }
+}
+
+void SwGpuTexture::Clear(const Vector4f& p_color, int p_face) {
+    ERR_FAIL_INDEX(p_face, (int)m_color.size());
+    m_color[p_face].clear(p_color);
+}
+
+void SwGpuTexture::ClearDepth(float p_depth, int p_face) {
+    ERR_FAIL_INDEX(p_face, (int)m_depth.size());
+    m_depth[p_face].clear(p_depth);
+}
+
+Vector4f SwGpuTexture::Load(int p_x, int p_y, int p_face) const {
+    if (p_x < 0 || p_y < 0 || p_x >= GetWidth() || p_y >= GetHeight()) {
+        return Vector4f::Zero;
+    }
+
+    const int index = p_y * GetWidth() + p_x;
+    if (m_isDepth) {
+        return Vector4f(m_depth[p_face].m_buffer[index], 0.0f, 0.0f, 1.0f);
+    }
+    return m_color[p_face].m_buffer[index];
+}
+
+void SwGpuTexture::Store(int p_x, int p_y, const Vector4f& p_value, int p_face) {
+    if (p_x < 0 || p_y < 0 || p_x >= GetWidth() || p_y >= GetHeight()) {
+        return;
+    }
+
+    const int index = p_y * GetWidth() + p_x;
+    if (m_isDepth) {
+        m_depth[p_face].m_buffer[index] = p_value.x;
+    } else {
+        m_color[p_face].m_buffer[index] = p_value;
+    }
+}
+
+// -1 for a border texel
+static int AddressTexel(int p_coord, int p_size, AddressMode p_address) {
+    switch (p_address) {
+        case AddressMode::WRAP: {
+            const int coord = p_coord % p_size;
+            return coord < 0 ? coord + p_size : coord;
+        }
+        case AddressMode::CLAMP:
+            return glm::clamp(p_coord, 0, p_size - 1);
+        default:
+            return (p_coord < 0 || p_coord >= p_size) ? -1 : p_coord;
+    }
+}
+
+Vector4f SwGpuTexture::Sample(const Vector2f& p_uv, AddressMode p_address, int p_face) const {
+    const int width = GetWidth();
+    const int height = GetHeight();
+
+    // texel centers are at half coordinates
+    const float fx = p_uv.x * width - 0.5f;
+    const float fy = p_uv.y * height - 0.5f;
+    const float floor_x = std::floor(fx);
+    const float floor_y = std::floor(fy);
+    const float tx = fx - floor_x;
+    const float ty = fy - floor_y;
+
+    const int x0 = AddressTexel(static_cast<int>(floor_x), width, p_address);
+    const int x1 = AddressTexel(static_cast<int>(floor_x) + 1, width, p_address);
+    const int y0 = AddressTexel(static_cast<int>(floor_y), height, p_address);
+    const int y1 = AddressTexel(static_cast<int>(floor_y) + 1, height, p_address);
+
+    const Vector4f top = lerp(Load(x0, y0, p_face), Load(x1, y0, p_face), tx);
+    const Vector4f bottom = lerp(Load(x0, y1, p_face), Load(x1, y1, p_face), tx);
+    return lerp(top, bottom, ty);
+}
+
+Vector4f SwGpuTexture::SamplePoint(const Vector2f& p_uv, AddressMode p_address, int p_face) const {
+    const int x = AddressTexel(static_cast<int>(std::floor(p_uv.x * GetWidth())), GetWidth(), p_address);
+    const int y = AddressTexel(static_cast<int>(std::floor(p_uv.y * GetHeight())), GetHeight(), p_address);
+    return Load(x, y, p_face);
+}
+
+}  // namespace cave
@@ -0,0 +1,54 @@
+#pragma once
+#include "engine/renderer/gpu_resource.h"
+#include "engine/renderer/graphics_defines.h"
+
+#include "sampler.h"
+
+namespace cave {
+
+// Texture in system memory, the handle is the address of the texture so it can be bound like a
+// gpu texture. Only mip 0 is allocated, every face or array slice has its own image.
+struct SwGpuTexture : GpuTexture {
+    SwGpuTexture(const GpuTextureDesc& p_desc);
+
+    uint64_t GetResidentHandle() const override { return 0; }
+    uint64_t GetHandle() const override { return reinterpret_cast<uint64_t>(this); }
+    uint64_t GetUavHandle() const override { return GetHandle(); }
+
+    int GetWidth() const { return static_cast<int>(desc.width); }
+    int GetHeight() const { return static_cast<int>(desc.height); }
+    bool IsDepth() const { return m_isDepth; }
+
+    void Clear(const Vector4f& p_color, int p_face = 0);
+    void ClearDepth(float p_depth, int p_face = 0);
+
+    // out of range loads return zero and out of range stores are dropped, like texture loads and
+    // uav writes on the gpu
+    Vector4f Load(int p_x, int p_y, int p_face = 0) const;
+    void Store(int p_x, int p_y, const Vector4f& p_value, int p_face = 0);
+
+    // uv (0, 0) is the top left corner of row 0
+    Vector4f Sample(const Vector2f& p_uv, AddressMode p_address, int p_face = 0) const;
+    Vector4f SamplePoint(const Vector2f& p_uv, AddressMode p_address, int p_face = 0) const;
+
+    static SwGpuTexture* FromHandle(uint64_t p_handle) { return reinterpret_cast<SwGpuTexture*>(p_handle); }
+
+    // depth formats are stored in m_depth, the others in m_color
+    std::vector<SwTexture<Vector4f>> m_color;
+    std::vector<SwTexture<float>> m_depth;
+
+private:
+    void Upload(const void* p_data);
+
+    bool m_isDepth;
+};
+
+struct SwConstantBuffer : GpuConstantBuffer {
+    SwConstantBuffer(const GpuBufferDesc& p_desc)
+        : GpuConstantBuffer(p_desc), m_data(capacity) {}
+
+    // updated through const buffers like the gpu buffers, draws read the bound range in place
+    mutable std::vector<uint8_t> m_data;
+};
+
+}  // namespace cave
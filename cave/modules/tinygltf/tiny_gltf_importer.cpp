@@ -657,6 +657,12 @@ void TinyGltfImporter::ProcessAnimation(const tinygltf::Animation& p_anim) {
             LOG_WARN("Unkown target path {}", channel.target_path);
         }
     }
+
+    const size_t key_count = samplers.empty() ? 0 : samplers.front().keyframe_times.size();
+    if (animation.Compress()) {
+        const auto& clip = animation.GetCompressedClip();
+        LOG_VERBOSE("animation '{}' compressed, {} -> {} keys, {} bytes", tag, key_count, clip.GetKeyCount(), clip.GetMemoryUsage());
+    }
 }
 
 }  // namespace cave
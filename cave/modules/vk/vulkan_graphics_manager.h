@@ -19,7 +19,7 @@ public:
     void SetStencilRef(uint32_t p_ref) override {}
     void SetBlendState(const BlendDesc& p_desc, const float* p_factor, uint32_t p_mask) override {}
 
-    void SetRenderTarget(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) override {}
+    void SetRenderTargetImpl(const Framebuffer* p_framebuffer, int p_index, int p_mip_level) override {}
     void UnsetRenderTarget() override {}
     void BeginDrawPass(const Framebuffer* p_framebuffer) override {}
     void EndDrawPass(const Framebuffer* p_framebuffer) override {}
@@ -38,7 +38,7 @@ public:
         return nullptr;
     }
 
-    void SetMesh(const GpuMesh* p_mesh) override {}
+    void SetMeshImpl(const GpuMesh* p_mesh) override {}
 
     void DrawElements(uint32_t p_count, uint32_t p_offset) override {}
     void DrawElementsInstanced(uint32_t p_instance_count, uint32_t p_count, uint32_t p_offset) override {}
@@ -57,13 +57,14 @@ public:
     void BindStructuredBufferSRV(int p_slot, const GpuStructuredBuffer* p_buffer) override {}
     void UnbindStructuredBufferSRV(int p_slot) override {}
 
-    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) override {}
-    void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override {}
+    void UpdateConstantBufferImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) override {}
+    void UpdateConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size, size_t p_offset) override {}
+    void BindConstantBufferRangeImpl(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override {}
 
-    void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) override {}
-    void UnbindTexture(Dimension p_dimension, int p_slot) override {}
+    void BindTextureImpl(Dimension p_dimension, uint64_t p_handle, int p_slot) override {}
+    void UnbindTextureImpl(Dimension p_dimension, int p_slot) override {}
 
-    void GenerateMipmap(const GpuTexture* p_texture) override {}
+    void GenerateMipmapImpl(const GpuTexture* p_texture) override {}
 
     std::shared_ptr<Framebuffer> CreateFramebuffer(const FramebufferDesc& p_subpass_desc) override { return nullptr; }
 
@@ -134,11 +134,24 @@ CBUFFER(MaterialConstantBuffer, 2) {
     Matrix4x4f _material_padding_4;
 };
 
-// @TODO: change to unordered access buffer
+// 3x4 matrices, three rows per bone, read with LoadBoneMatrix()
 CBUFFER(BoneConstantBuffer, 3) {
-    Matrix4x4f c_bones[MAX_BONE_COUNT];
+    Vector4f c_bones[MAX_BONE_COUNT * 3];
 };
 
+#if defined(HLSL_LANG)
+float4x4 LoadBoneMatrix(int p_index) {
+    const int row = p_index * 3;
+    return float4x4(c_bones[row], c_bones[row + 1], c_bones[row + 2], float4(0.0, 0.0, 0.0, 1.0));
+}
+#elif defined(GLSL_LANG)
+mat4 LoadBoneMatrix(int p_index) {
+    int row = p_index * 3;
+    // mat4() takes columns
+    return transpose(mat4(c_bones[row], c_bones[row + 1], c_bones[row + 2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+#endif
+
 CBUFFER(PointShadowConstantBuffer, 4) {
     Matrix4x4f c_pointLightMatrix;  // 64
     Vector3f c_pointLightPosition;  // 12
@@ -162,7 +175,12 @@ CBUFFER(PerFrameConstantBuffer, 5) {
     Matrix4x4f c_invCamProj;
     Matrix4x4f c_invCamView;
 
-    Vector4f _per_frame_padding_2;
+    // cluster slice of a view depth d is log2(d) * c_clusterSliceScale + c_clusterSliceBias
+    float c_clusterSliceScale;
+    float c_clusterSliceBias;
+    int c_clusteredLighting;  // point lights are read from the light clusters
+    int c_pointLightCount;    // 16
+
     Vector4f _per_frame_padding_3;
     Vector4f _per_frame_padding_4;
     Vector3f c_sunPosition;
@@ -1,5 +1,6 @@
 /// File: lighting.glsl
 #include "../pbr.hlsl.h"
+#include "../shader_resource_defines.hlsl.h"
 #include "shadow.glsl"
 
 #ifdef DISABLE_VXGI
@@ -109,6 +110,40 @@ vec3 area_light(mat3 Minv, vec3 N, vec3 V, vec3 world_position, vec4 p_t2, vec3
     return (specular + kD * diffuse);
 }
 
+// point lights of the cluster the position falls in, the lookup matches LightClusterBuilder::FindCluster
+vec3 clustered_point_lighting(vec3 world_position, vec3 N, vec3 V, vec3 F0, float roughness, float metallic, vec3 base_color) {
+    const vec4 view_position = c_camView * vec4(world_position, 1.0);
+    const vec4 clip_position = c_camProj * view_position;
+    const vec2 ndc = clip_position.xy / clip_position.w;
+    const float depth = max(-view_position.z, 1e-4);
+
+    const int x = clamp(int(floor((0.5 * ndc.x + 0.5) * LIGHT_CLUSTER_X)), 0, LIGHT_CLUSTER_X - 1);
+    const int y = clamp(int(floor((0.5 * ndc.y + 0.5) * LIGHT_CLUSTER_Y)), 0, LIGHT_CLUSTER_Y - 1);
+    const int z = clamp(int(floor(log2(depth) * c_clusterSliceScale + c_clusterSliceBias)), 0, LIGHT_CLUSTER_Z - 1);
+    const uint cluster = GlobalLightClusters[(z * LIGHT_CLUSTER_Y + y) * LIGHT_CLUSTER_X + x];
+    const uint first = cluster & LIGHT_CLUSTER_OFFSET_MASK;
+    const uint count = cluster >> LIGHT_CLUSTER_OFFSET_BITS;
+
+    vec3 Lo = vec3(0.0);
+    for (uint i = 0; i < count; ++i) {
+        GpuPointLight light = GlobalPointLights[GlobalLightIndices[first + i]];
+        vec3 delta = -world_position + light.position;
+        float dist = length(delta);
+        if (dist > light.max_distance) {
+            continue;
+        }
+
+        float atten = (light.atten_constant + light.atten_linear * dist +
+                       light.atten_quadratic * (dist * dist));
+        atten = 1.0 / atten;
+        if (atten > 0.01) {
+            vec3 L = normalize(delta);
+            Lo += atten * lighting(N, L, V, light.color, F0, roughness, metallic, base_color);
+        }
+    }
+    return Lo;
+}
+
 vec3 compute_lighting(sampler2D shadow_map,
                       vec3 base_color,
                       vec3 world_position,
@@ -188,6 +223,10 @@ vec3 compute_lighting(sampler2D shadow_map,
         Lo += (1.0 - shadow) * direct_lighting;
     }
 
+    if (c_clusteredLighting != 0) {
+        Lo += clustered_point_lighting(world_position, N, V, F0, roughness, metallic, base_color);
+    }
+
     // ambient
 
     vec3 F = FresnelSchlickRoughness(NdotV, F0, roughness);
@@ -14,14 +14,14 @@ void main() {
     mat4 world_matrix;
     switch (c_meshFlag) {
         case MESH_HAS_BONE: {
-            mat4 bone_matrix = c_bones[in_bone_id.x] * in_bone_weight.x;
-            bone_matrix += c_bones[in_bone_id.y] * in_bone_weight.y;
-            bone_matrix += c_bones[in_bone_id.z] * in_bone_weight.z;
-            bone_matrix += c_bones[in_bone_id.w] * in_bone_weight.w;
+            mat4 bone_matrix = LoadBoneMatrix(in_bone_id.x) * in_bone_weight.x;
+            bone_matrix += LoadBoneMatrix(in_bone_id.y) * in_bone_weight.y;
+            bone_matrix += LoadBoneMatrix(in_bone_id.z) * in_bone_weight.z;
+            bone_matrix += LoadBoneMatrix(in_bone_id.w) * in_bone_weight.w;
             world_matrix = c_worldMatrix * bone_matrix;
         } break;
         case MESH_HAS_INSTANCE: {
-            world_matrix = c_bones[gl_InstanceID];
+            world_matrix = LoadBoneMatrix(gl_InstanceID);
         } break;
         default: {
             world_matrix = c_worldMatrix;
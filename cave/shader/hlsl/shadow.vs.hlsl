@@ -8,14 +8,14 @@ float4 main(VS_INPUT_MESH input,
     float4x4 world_matrix;
     switch (c_meshFlag) {
         case MESH_HAS_BONE: {
-            float4x4 bone_matrix = c_bones[input.boneIndex.x] * input.boneWeight.x;
-            bone_matrix += c_bones[input.boneIndex.y] * input.boneWeight.y;
-            bone_matrix += c_bones[input.boneIndex.z] * input.boneWeight.z;
-            bone_matrix += c_bones[input.boneIndex.w] * input.boneWeight.w;
+            float4x4 bone_matrix = LoadBoneMatrix(input.boneIndex.x) * input.boneWeight.x;
+            bone_matrix += LoadBoneMatrix(input.boneIndex.y) * input.boneWeight.y;
+            bone_matrix += LoadBoneMatrix(input.boneIndex.z) * input.boneWeight.z;
+            bone_matrix += LoadBoneMatrix(input.boneIndex.w) * input.boneWeight.w;
             world_matrix = mul(c_worldMatrix, bone_matrix);
         } break;
         case MESH_HAS_INSTANCE: {
-            world_matrix = c_bones[instance_id];
+            world_matrix = LoadBoneMatrix((int)instance_id);
         } break;
         default: {
             world_matrix = c_worldMatrix;
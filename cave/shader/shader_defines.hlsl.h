@@ -36,6 +36,17 @@
 #define MESH_HAS_BONE     (1)
 #define MESH_HAS_INSTANCE (2)
 
+// clustered lighting, screen tiles by exponential view depth slices
+#define LIGHT_CLUSTER_X            16
+#define LIGHT_CLUSTER_Y            8
+#define LIGHT_CLUSTER_Z            24
+#define LIGHT_CLUSTER_COUNT        (LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z)
+#define MAX_CLUSTERED_LIGHT_COUNT  4096
+#define MAX_LIGHT_INDEX_COUNT      (LIGHT_CLUSTER_COUNT * 64)
+// a cluster is packed as (light count << LIGHT_CLUSTER_OFFSET_BITS) | first index
+#define LIGHT_CLUSTER_OFFSET_BITS  19
+#define LIGHT_CLUSTER_OFFSET_MASK  ((1u << LIGHT_CLUSTER_OFFSET_BITS) - 1u)
+
 // SSAO
 #define SSAO_KERNEL_SIZE (64)
 #define SSAO_NOISE_SIZE  (4)
@@ -60,7 +60,21 @@ struct GpuPtMaterial {
     float metallic;
 };
 
+// point light of the clustered lighting
+struct GpuPointLight {
+    Vector3f position;
+    float max_distance;
+
+    Vector3f color;
+    float atten_constant;
+
+    float atten_linear;
+    float atten_quadratic;
+    Vector2f _padding;
+};
+
 #ifdef __cplusplus
+static_assert(sizeof(GpuPointLight) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtBvh) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtVertex) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtIndex) % sizeof(Vector4f) == 0);
@@ -68,6 +82,12 @@ static_assert(sizeof(GpuPtMesh) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtMaterial) % sizeof(Vector4f) == 0);
 #endif  // __cplusplus
 
+// packed clusters index GlobalLightIndices, which index GlobalPointLights
+#define LIGHT_CLUSTER_SBUFFER_LIST                         \
+    SBUFFER(GpuPointLight, GlobalPointLights, 26, 501)     \
+    SBUFFER(uint, GlobalLightClusters, 27, 500)            \
+    SBUFFER(uint, GlobalLightIndices, 28, 499)
+
 #define SBUFFER_LIST                                         \
     SBUFFER(ParticleCounter, GlobalParticleCounter, 16, 511) \
     SBUFFER(int, GlobalDeadIndices, 17, 510)                 \
@@ -78,6 +98,7 @@ static_assert(sizeof(GpuPtMaterial) % sizeof(Vector4f) == 0);
     SBUFFER(GpuPtIndex, GlobalPtIndices, 22, 505)            \
     SBUFFER(GpuPtBvh, GlobalPtBvhs, 23, 504)                 \
     SBUFFER(GpuPtMesh, GlobalPtMeshes, 24, 503)              \
-    SBUFFER(GpuPtMaterial, GlobalPtMaterials, 25, 502)
+    SBUFFER(GpuPtMaterial, GlobalPtMaterials, 25, 502)    \
+    LIGHT_CLUSTER_SBUFFER_LIST
 
 #endif
@@ -0,0 +1,98 @@
+import argparse
+import json
+import sys
+
+# compares two Google Benchmark json outputs and reports regressions
+# usage: python check_benchmark_regression.py baseline.json current.json [--threshold 0.1]
+
+time_unit_to_ns = {
+    'ns': 1.0,
+    'us': 1e3,
+    'ms': 1e6,
+    's': 1e9,
+}
+
+def load_benchmarks(path, metric):
+    with open(path, 'r') as f:
+        data = json.load(f)
+
+    result = {}
+    for bench in data.get('benchmarks', []):
+        # when running with repetitions, only compare the mean
+        run_type = bench.get('run_type', 'iteration')
+        if run_type == 'aggregate':
+            if bench.get('aggregate_name') != 'mean':
+                continue
+            name = bench['run_name']
+        else:
+            name = bench['name']
+            if name in result:
+                continue
+
+        scale = time_unit_to_ns[bench.get('time_unit', 'ns')]
+        result[name] = bench[metric] * scale
+    return result
+
+def format_time(ns):
+    if ns >= 1e6:
+        return f'{ns / 1e6:.3f} ms'
+    if ns >= 1e3:
+        return f'{ns / 1e3:.3f} us'
+    return f'{ns:.3f} ns'
+
+def print_pairs(benchmarks):
+    pairs = []
+    for name, time in benchmarks.items():
+        if not name.endswith('_Engine'):
+            continue
+        glm_name = name[:-len('_Engine')] + '_Glm'
+        if glm_name in benchmarks and benchmarks[glm_name] > 0:
+            pairs.append((name[:-len('_Engine')], time / benchmarks[glm_name]))
+
+    if not pairs:
+        return
+
+    print()
+    print(f'{"engine/glm":<40} {"ratio":>8}')
+    for name, ratio in sorted(pairs):
+        print(f'{name:<40} {ratio:>8.2f}x')
+
+def main():
+    parser = argparse.ArgumentParser(description='Check benchmark results against a baseline')
+    parser.add_argument('baseline', help='baseline json produced by --benchmark_out')
+    parser.add_argument('current', help='current json produced by --benchmark_out')
+    parser.add_argument('--threshold', type=float, default=0.1, help='allowed slowdown, 0.1 means 10%%')
+    parser.add_argument('--metric', default='cpu_time', choices=['cpu_time', 'real_time'])
+    args = parser.parse_args()
+
+    baseline = load_benchmarks(args.baseline, args.metric)
+    current = load_benchmarks(args.current, args.metric)
+
+    regressions = []
+    print(f'{"benchmark":<40} {"baseline":>14} {"current":>14} {"change":>9}')
+    for name, time in current.items():
+        if name not in baseline:
+            print(f'{name:<40} {"-":>14} {format_time(time):>14} {"new":>9}')
+            continue
+
+        old_time = baseline[name]
+        change = (time - old_time) / old_time if old_time > 0 else 0.0
+        marker = ''
+        if change > args.threshold:
+            regressions.append(name)
+            marker = ' <-- regression'
+        print(f'{name:<40} {format_time(old_time):>14} {format_time(time):>14} {change * 100.0:>+8.1f}%{marker}')
+
+    print_pairs(current)
+
+    if regressions:
+        print()
+        print(f'{len(regressions)} benchmark(s) regressed more than {args.threshold * 100.0:.1f}%:')
+        for name in regressions:
+            print(f'  {name}')
+        return 1
+
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
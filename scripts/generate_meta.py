@@ -24,6 +24,7 @@ FILES = [
     # components
     'scene/collider_component.h',
     'scene/camera_component.h',
+    'scene/compressed_animation_clip.h',
     'scene/light_component.h',
     'scene/lua_script_component.h',
     'scene/material_component.h',